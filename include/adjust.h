@@ -0,0 +1,78 @@
+/*!
+\file adjust.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace colorpp
+{
+
+/*!
+	\brief Adjustment models enum
+*/
+enum class AdjustEnum
+{
+	Luminance = 0,	// luminance preserving, all adjustments fused into one affine matrix
+	Hsv = 1,	// same result as editing hue, saturation and value of HSV
+	Hsl = 2	// same result as editing hue, saturation and lightness of HSL
+};
+
+/*!
+	\brief Image adjustment parameters
+	\details Applied in the order hue, saturation, brightness, contrast.
+*/
+typedef struct _AdjustParams
+{
+	AdjustEnum Mode;
+	double Hue;	// rotation in degrees
+	double Saturation;	// saturation factor, 1.0 - unchanged, 0 - gray
+	double Brightness;	// factor of the value (Hsv), lightness (Hsl) or all channels (Luminance)
+	double Contrast;	// channel slope around 0.5
+	double Luma[3];	// luminance weights of the channels (Luminance)
+} AdjustParams;
+
+/*!
+	\brief Create adjustment parameters without any change
+	\details Luma weights are BT.709 ones.
+	\param[in] mode - adjustment model (see AdjustEnum)
+	\return adjustment parameters
+*/
+AdjustParams get_adjust_params(AdjustEnum mode = AdjustEnum::Luminance);
+
+/*!
+	\brief Get the fused matrix of the Luminance model
+	\details out[j] = in[0] * m[0][j] + in[1] * m[1][j] + in[2] * m[2][j] + m[3][j],
+		the library matrix convention with an offset row.
+	\param[in] params - adjustment parameters
+	\param[out] m - affine matrix
+*/
+void get_adjust_matrix(const AdjustParams& params, double m[4][3]);
+
+/*!
+    \brief Batch adjustment of interleaved RGB in a single pass
+	\details Luminance model is one affine matrix per pixel. HSV and HSL models work
+		on the channel maximum and minimum without branching on the hue sextant, giving the
+		result of the HSV/HSL round trip without computing the color models.
+    \param[in] src - RGB in 0..1.0 range, 3 * count floats
+    \param[out] dst - adjusted RGB clamped to 0..1.0, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+	\param[in] params - adjustment parameters
+*/
+void adjust(const float* src, float* dst, size_t count, const AdjustParams& params);
+
+/*!
+    \brief Batch adjustment of interleaved 8-bit RGB in a single pass
+	\details Codes are taken at the centers of the from_dbl bins and truncated back,
+		so neutral parameters keep the image unchanged.
+    \param[in] src - source pixels, 3 * count bytes
+    \param[out] dst - adjusted pixels, 3 * count bytes (may alias src)
+    \param[in] count - number of pixels
+	\param[in] params - adjustment parameters
+*/
+void adjust(const unsigned char* src, unsigned char* dst, size_t count, const AdjustParams& params);
+
+}
@@ -0,0 +1,128 @@
+/*!
+\file arena.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace colorpp
+{
+
+/*!
+	\brief Huge page modes of large scratch blocks enum
+*/
+enum class HugePageEnum
+{
+	None = 0,	// regular pages
+	Transparent = 1,	// transparent huge pages requested with madvise
+	Explicit = 2	// MAP_HUGETLB pages from the reserved pool, regular pages if it is empty
+};
+
+/*!
+	\brief Scratch memory counters, summed over the threads
+*/
+typedef struct _ArenaStats
+{
+	uint64_t InUse;	// bytes of the blocks held by buffers
+	uint64_t Peak;	// maximum of InUse since the last reset
+	uint64_t Reserved;	// bytes of all the blocks, held and cached
+	uint64_t HugePages;	// bytes of the blocks on huge pages
+	uint64_t Allocations;	// buffers created
+	uint64_t Misses;	// buffers that needed a new block
+} ArenaStats;
+
+/*!
+	\brief Set the huge page mode of large scratch blocks
+	\details Huge pages are supported on Linux, other systems use regular pages.
+		Explicit huge page blocks are rounded up to whole huge pages.
+	\param[in] mode - huge page mode (see HugePageEnum)
+	\param[in] threshold - smallest block on huge pages in bytes
+*/
+void set_arena_huge_pages(HugePageEnum mode, size_t threshold = 2 << 20);
+
+/*!
+	\brief Set the maximum of the cached scratch memory per thread
+	\details Blocks that don't fit under the limit are freed when their buffer is released,
+		the default is 64 MiB.
+	\param[in] bytes - cached bytes of a thread, larger blocks are freed on release
+*/
+void set_arena_cache_limit(size_t bytes);
+
+/*!
+	\brief Get the scratch memory counters
+	\return counters
+*/
+ArenaStats get_arena_stats();
+
+/*!
+	\brief Reset the peak of the scratch memory to the memory in use
+*/
+void reset_arena_peak();
+
+/*!
+	\brief Free the cached scratch blocks of all the threads
+	\details Blocks held by buffers are kept. Blocks of a thread are also freed when the thread ends.
+*/
+void release_arena_memory();
+
+namespace detail
+{
+
+struct ArenaBlock
+{
+	void* data;
+	size_t size;	// capacity in bytes, a power of two
+	int kind;	// how the block was allocated
+};
+
+ArenaBlock arena_allocate(size_t size);
+void arena_release(const ArenaBlock& block);
+
+}
+
+/*!
+	\brief Scratch buffer from the thread arena
+	\details Blocks are 64-byte aligned, sized in powers of two and cached by the thread
+		after use, so repeated calls of the batch functions don't allocate. The buffer
+		must be released by the thread that created it, which scoped use guarantees.
+		Contents are not initialized.
+*/
+template<typename T>
+class ArenaBuffer
+{
+	static_assert(std::is_trivial<T>::value, "arena buffers hold trivial types");
+public:
+	explicit ArenaBuffer(size_t count) : block_(detail::arena_allocate(count * sizeof(T))), count_(count)
+	{
+	}
+	~ArenaBuffer()
+	{
+		detail::arena_release(block_);
+	}
+	ArenaBuffer(const ArenaBuffer&) = delete;
+	ArenaBuffer& operator=(const ArenaBuffer&) = delete;
+
+	T* data() const
+	{
+		return static_cast<T*>(block_.data);
+	}
+	size_t size() const
+	{
+		return count_;
+	}
+	T& operator[](size_t i) const
+	{
+		return data()[i];
+	}
+
+private:
+	detail::ArenaBlock block_;
+	size_t count_;
+};
+
+}
@@ -0,0 +1,54 @@
+/*!
+\file cct.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include "rgb.h"
+
+namespace colorpp
+{
+
+/*!
+	\brief Correlated color temperature locus enum
+*/
+enum class LocusEnum
+{
+	Daylight = 0,	// CIE daylight locus, 4000..25000 K
+	Planckian = 1	// black body locus, 1667..25000 K
+};
+
+/*!
+    \brief Chromaticity of a correlated color temperature
+	\details Uses a table precomputed on the first call and interpolated in
+		reciprocal temperature, so it is cheap enough to call per frame.
+	\param[in] cct - correlated color temperature in Kelvin
+	\param[out] x - x chromaticity
+	\param[out] y - y chromaticity
+	\param[in] locus - daylight or Planckian locus (see LocusEnum)
+	\return false if cct is out of the locus range (the nearest end is used)
+*/
+bool cct_to_xy(double cct, double& x, double& y, LocusEnum locus = LocusEnum::Daylight);
+
+/*!
+    \brief Reference white of a correlated color temperature
+	\param[in] cct - correlated color temperature in Kelvin
+	\param[out] white - XYZ of the white with Y = 1
+	\param[in] locus - daylight or Planckian locus (see LocusEnum)
+	\return false if cct is out of the locus range (the nearest end is used)
+*/
+bool cct_to_white(double cct, XYZ white, LocusEnum locus = LocusEnum::Daylight);
+
+/*!
+    \brief Correlated color temperature of a color (Robertson's method)
+	\param[in] x - x channel
+  	\param[in] y - y channel
+  	\param[in] z - z channel
+	\return temperature in Kelvin or -1 if the color is farther than Duv 0.05 from the
+		Planckian locus or below 1666.7 K
+*/
+double xyz_to_cct(double x, double y, double z);
+
+}
@@ -0,0 +1,61 @@
+/*!
+\file cmyk.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace colorpp
+{
+
+/*
+	Naive device CMYK: full gray component replacement (K = 1 - max) without ink
+	limits or a printer profile, the usual CMYK of web tools and CSS device-cmyk().
+*/
+
+/*!
+    \brief Conversion from RGB to CMYK color model
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] c - cyan channel in 0..1.0 range
+  	\param[out] m - magenta channel in 0..1.0 range
+  	\param[out] y - yellow channel in 0..1.0 range
+  	\param[out] k - black channel in 0..1.0 range
+*/
+void rgb_to_cmyk(double r, double g, double b,
+	double& c, double& m, double& y, double& k);
+
+/*!
+    \brief Conversion from CMYK to RGB color model
+ 	\param[in] c - cyan channel in 0..1.0 range
+  	\param[in] m - magenta channel in 0..1.0 range
+  	\param[in] y - yellow channel in 0..1.0 range
+  	\param[in] k - black channel in 0..1.0 range
+    \param[out] r - red channel in 0..1.0 range
+	\param[out] g - green channel in 0..1.0 range
+ 	\param[out] b - blue channel in 0..1.0 range
+*/
+void cmyk_to_rgb(double c, double m, double y, double k,
+	double& r, double& g, double& b);
+
+/*!
+    \brief Batch conversion from RGB to CMYK color model
+    \param[in] src - RGB in 0..1.0 range, 3 * count floats
+    \param[out] dst - CMYK in 0..1.0 range, 4 * count floats
+    \param[in] count - number of pixels
+*/
+void rgb_to_cmyk(const float* src, float* dst, size_t count);
+
+/*!
+    \brief Batch conversion from CMYK to RGB color model
+    \param[in] src - CMYK in 0..1.0 range, 4 * count floats
+    \param[out] dst - RGB in 0..1.0 range, 3 * count floats
+    \param[in] count - number of pixels
+*/
+void cmyk_to_rgb(const float* src, float* dst, size_t count);
+
+}
@@ -31,9 +31,18 @@ THE SOFTWARE.
 */
 #pragma once
 
+#include <algorithm>
+#include <ostream>
+#include <type_traits>
+
 #include "hsv.h"
 #include "hsl.h"
+#include "hsi.h"
+#include "hwb.h"
+#include "cmyk.h"
+#include "oklab.h"
 #include "rgb.h"
+#include "ycbcr.h"
 
 namespace colorpp
 {
@@ -51,6 +60,8 @@ using word = base_type<unsigned short, 0, 65535>;
 using byte = base_type<unsigned char, 0, 255>;
 using byte100 = base_type<unsigned char, 0, 100>;
 using word360 = base_type<unsigned short, 0, 360>;
+using byte235 = base_type<unsigned char, 16, 235>;
+using byte240 = base_type<unsigned char, 16, 240>;
 
 //======================== helpers ======================== 
 template<typename T>
@@ -58,7 +69,7 @@ double get_dbl(typename T::type v)
 {
 	if (std::is_same<T, dbl>::value)
 		return v;
-	double result = v;
+	double result = v - T::min();
 	return result/(T::max() - T::min() + (std::is_integral<typename T::type>::value? 1: 0.));
 }
 template<typename T>
@@ -66,13 +77,28 @@ typename T::type from_dbl(double v)
 {
 	if (std::is_same<T, dbl>::value)
 		return static_cast<typename T::type>(v);
-	return static_cast<typename T::type>(T::min() + v * (T::max() - T::min() + (std::is_integral<typename T::type>::value? 1: 0.)));
+	double result = T::min() + v * (T::max() - T::min() + (std::is_integral<typename T::type>::value? 1: 0.));
+	// out of range values (e.g. out of gamut YCbCr) must not wrap around
+	result = std::min(std::max(result, static_cast<double>(T::min())), static_cast<double>(T::max()));
+	return static_cast<typename T::type>(result);
 }
 
 template<typename Th, typename Tsv>
 class hsv_base;
 template<typename Th, typename Tsl>
 class hsl_base;
+template<typename Th, typename Twb>
+class hwb_base;
+template<typename Ty, typename Tc, YCbCrEnum matrix>
+class ycbcr_base;
+template<typename Tl, typename Tab>
+class oklab_base;
+template<typename Tlc, typename Th>
+class oklch_base;
+template<typename Th, typename Tsi>
+class hsi_base;
+template<typename T>
+class cmyk_base;
 
 //========================== RGB ========================== 
 template<typename T>
@@ -93,6 +119,36 @@ public: // constructors/operators
 	{
 		operator=(hsl);
 	}
+	template<typename Ty, typename Tc, YCbCrEnum matrix>
+	rgb_base(const ycbcr_base<Ty, Tc, matrix>& ycbcr)
+	{
+		operator=(ycbcr);
+	}
+	template<typename Tl, typename Tab>
+	rgb_base(const oklab_base<Tl, Tab>& oklab)
+	{
+		operator=(oklab);
+	}
+	template<typename Tlc, typename Th>
+	rgb_base(const oklch_base<Tlc, Th>& oklch)
+	{
+		operator=(oklch);
+	}
+	template<typename Th, typename Twb>
+	rgb_base(const hwb_base<Th, Twb>& hwb)
+	{
+		operator=(hwb);
+	}
+	template<typename Th, typename Tsi>
+	rgb_base(const hsi_base<Th, Tsi>& hsi)
+	{
+		operator=(hsi);
+	}
+	template<typename T2>
+	rgb_base(const cmyk_base<T2>& cmyk)
+	{
+		operator=(cmyk);
+	}
 
 	//operators
 	rgb_base& operator=(const rgb_base&) = default;
@@ -127,6 +183,89 @@ public: // constructors/operators
 		b_ = from_dbl<T>(b);
 		return *this;
 	}
+	template<typename Ty, typename Tc, YCbCrEnum matrix>
+	rgb_base& operator=(const ycbcr_base<Ty, Tc, matrix>& ycbcr)
+	{
+		double r = 0;
+		double g = 0;
+		double b = 0;
+		ycbcr_to_rgb(get_dbl<Ty>(ycbcr.get_luma()),
+			get_dbl<Tc>(ycbcr.get_cb()),
+			get_dbl<Tc>(ycbcr.get_cr()),
+			r, g, b, matrix);
+		r_ = from_dbl<T>(r);
+		g_ = from_dbl<T>(g);
+		b_ = from_dbl<T>(b);
+		return *this;
+	}
+	// sRGB, out of gamut colors are clipped
+	template<typename Tl, typename Tab>
+	rgb_base& operator=(const oklab_base<Tl, Tab>& oklab)
+	{
+		double r = 0;
+		double g = 0;
+		double b = 0;
+		oklab_to_rgb(get_dbl<Tl>(oklab.get_lightness()),
+			get_dbl<Tab>(oklab.get_a()),
+			get_dbl<Tab>(oklab.get_b()),
+			r, g, b);
+		r_ = from_dbl<T>(std::min(std::max(r, 0.), 1.));
+		g_ = from_dbl<T>(std::min(std::max(g, 0.), 1.));
+		b_ = from_dbl<T>(std::min(std::max(b, 0.), 1.));
+		return *this;
+	}
+	template<typename Tlc, typename Th>
+	rgb_base& operator=(const oklch_base<Tlc, Th>& oklch)
+	{
+		return operator=(oklab_base<dbl, dbl>(oklch));
+	}
+	template<typename Th, typename Twb>
+	rgb_base& operator=(const hwb_base<Th, Twb>& hwb)
+	{
+		double r = 0;
+		double g = 0;
+		double b = 0;
+		hwb_to_rgb(get_dbl<Th>(hwb.get_hue()),
+			get_dbl<Twb>(hwb.get_whiteness()),
+			get_dbl<Twb>(hwb.get_blackness()),
+			r, g, b);
+		r_ = from_dbl<T>(r);
+		g_ = from_dbl<T>(g);
+		b_ = from_dbl<T>(b);
+		return *this;
+	}
+	// out of gamut colors are clipped
+	template<typename Th, typename Tsi>
+	rgb_base& operator=(const hsi_base<Th, Tsi>& hsi)
+	{
+		double r = 0;
+		double g = 0;
+		double b = 0;
+		hsi_to_rgb(get_dbl<Th>(hsi.get_hue()),
+			get_dbl<Tsi>(hsi.get_saturation()),
+			get_dbl<Tsi>(hsi.get_intensity()),
+			r, g, b);
+		r_ = from_dbl<T>(std::min(std::max(r, 0.), 1.));
+		g_ = from_dbl<T>(std::min(std::max(g, 0.), 1.));
+		b_ = from_dbl<T>(std::min(std::max(b, 0.), 1.));
+		return *this;
+	}
+	template<typename T2>
+	rgb_base& operator=(const cmyk_base<T2>& cmyk)
+	{
+		double r = 0;
+		double g = 0;
+		double b = 0;
+		cmyk_to_rgb(get_dbl<T2>(cmyk.get_cyan()),
+			get_dbl<T2>(cmyk.get_magenta()),
+			get_dbl<T2>(cmyk.get_yellow()),
+			get_dbl<T2>(cmyk.get_black()),
+			r, g, b);
+		r_ = from_dbl<T>(r);
+		g_ = from_dbl<T>(g);
+		b_ = from_dbl<T>(b);
+		return *this;
+	}
 
 public: // get/set
 	typename T::type get_red() const { return r_; }
@@ -148,6 +287,36 @@ public: // get/set
 	{
 		operator=(hsl);
 	}
+	template<typename Ty, typename Tc, YCbCrEnum matrix>
+	void set_ycbcr(const ycbcr_base<Ty, Tc, matrix>& ycbcr)
+	{
+		operator=(ycbcr);
+	}
+	template<typename Tl, typename Tab>
+	void set_oklab(const oklab_base<Tl, Tab>& oklab)
+	{
+		operator=(oklab);
+	}
+	template<typename Tlc, typename Th>
+	void set_oklch(const oklch_base<Tlc, Th>& oklch)
+	{
+		operator=(oklch);
+	}
+	template<typename Th, typename Twb>
+	void set_hwb(const hwb_base<Th, Twb>& hwb)
+	{
+		operator=(hwb);
+	}
+	template<typename Th, typename Tsi>
+	void set_hsi(const hsi_base<Th, Tsi>& hsi)
+	{
+		operator=(hsi);
+	}
+	template<typename T2>
+	void set_cmyk(const cmyk_base<T2>& cmyk)
+	{
+		operator=(cmyk);
+	}
 
 	friend std::ostream& operator << (std::ostream& os, const rgb_base& v)
 	{
@@ -177,6 +346,16 @@ public: // constructors/operators
 	{
 		operator=(rgb);
 	}
+	template<typename Th2, typename Tsl>
+	hsv_base(const hsl_base<Th2, Tsl>& hsl)
+	{
+		operator=(hsl);
+	}
+	template<typename Th2, typename Twb>
+	hsv_base(const hwb_base<Th2, Twb>& hwb)
+	{
+		operator=(hwb);
+	}
 
 	//operators
 	hsv_base& operator=(const hsv_base&) = default;
@@ -196,6 +375,38 @@ public: // constructors/operators
 		v_ = from_dbl<Tsv>(v);
 		return *this;
 	}
+	// direct conversion, the hue is copied if the types match
+	template<typename Th2, typename Tsl>
+	hsv_base& operator=(const hsl_base<Th2, Tsl>& hsl)
+	{
+		double h = 0;
+		double s = 0;
+		double v = 0;
+		hsl_to_hsv(get_dbl<Th2>(hsl.get_hue()),
+			get_dbl<Tsl>(hsl.get_saturation()),
+			get_dbl<Tsl>(hsl.get_lightness()),
+			h, s, v);
+		h_ = std::is_same<Th, Th2>::value ? static_cast<typename Th::type>(hsl.get_hue()) : from_dbl<Th>(h);
+		s_ = from_dbl<Tsv>(s);
+		v_ = from_dbl<Tsv>(v);
+		return *this;
+	}
+	// direct conversion, the hue is copied if the types match
+	template<typename Th2, typename Twb>
+	hsv_base& operator=(const hwb_base<Th2, Twb>& hwb)
+	{
+		double h = 0;
+		double s = 0;
+		double v = 0;
+		hwb_to_hsv(get_dbl<Th2>(hwb.get_hue()),
+			get_dbl<Twb>(hwb.get_whiteness()),
+			get_dbl<Twb>(hwb.get_blackness()),
+			h, s, v);
+		h_ = std::is_same<Th, Th2>::value ? static_cast<typename Th::type>(hwb.get_hue()) : from_dbl<Th>(h);
+		s_ = from_dbl<Tsv>(s);
+		v_ = from_dbl<Tsv>(v);
+		return *this;
+	}
 
 public: // get/set
 	typename Th::type get_hue() const { return h_; }
@@ -247,6 +458,11 @@ public: // constructors/operators
 	{
 		operator=(rgb);
 	}
+	template<typename Th2, typename Tsv>
+	hsl_base(const hsv_base<Th2, Tsv>& hsv)
+	{
+		operator=(hsv);
+	}
 
 	//operators
 	hsl_base& operator=(const hsl_base&) = default;
@@ -266,6 +482,22 @@ public: // constructors/operators
 		l_ = from_dbl<Tsl>(l);
 		return *this;
 	}
+	// direct conversion, the hue is copied if the types match
+	template<typename Th2, typename Tsv>
+	hsl_base& operator=(const hsv_base<Th2, Tsv>& hsv)
+	{
+		double h = 0;
+		double s = 0;
+		double l = 0;
+		hsv_to_hsl(get_dbl<Th2>(hsv.get_hue()),
+			get_dbl<Tsv>(hsv.get_saturation()),
+			get_dbl<Tsv>(hsv.get_value()),
+			h, s, l);
+		h_ = std::is_same<Th, Th2>::value ? static_cast<typename Th::type>(hsv.get_hue()) : from_dbl<Th>(h);
+		s_ = from_dbl<Tsl>(s);
+		l_ = from_dbl<Tsl>(l);
+		return *this;
+	}
 
 public: // get/set
 	typename Th::type get_hue() const { return h_; }
@@ -303,12 +535,501 @@ private:
 	typename Tsl::type l_{Tsl::min()};
 };
 
+//========================= YCbCr ========================= 
+template<typename Ty, typename Tc, YCbCrEnum matrix = YCbCrEnum::Bt709>
+class ycbcr_base
+{
+public: // constructors/operators
+	ycbcr_base() = default;
+	ycbcr_base(const ycbcr_base&) = default;
+	ycbcr_base(ycbcr_base&&) noexcept = default;
+	ycbcr_base(typename Ty::type y, typename Tc::type cb, typename Tc::type cr) : y_(y), cb_(cb), cr_(cr) {}
+	template<typename T>
+	ycbcr_base(const rgb_base<T>& rgb)
+	{
+		operator=(rgb);
+	}
+
+	//operators
+	ycbcr_base& operator=(const ycbcr_base&) = default;
+	ycbcr_base& operator=(ycbcr_base&&) noexcept = default;
+	template<typename T>
+	ycbcr_base& operator=(const rgb_base<T>& rgb)
+	{
+		double y = 0;
+		double cb = 0;
+		double cr = 0;
+		rgb_to_ycbcr(get_dbl<T>(rgb.get_red()),
+			get_dbl<T>(rgb.get_green()),
+			get_dbl<T>(rgb.get_blue()),
+			y, cb, cr, matrix);
+		y_ = from_dbl<Ty>(y);
+		cb_ = from_dbl<Tc>(cb);
+		cr_ = from_dbl<Tc>(cr);
+		return *this;
+	}
+
+public: // get/set
+	typename Ty::type get_luma() const { return y_; }
+	void set_luma(typename Ty::type y) { y_ = y; }
+
+	typename Tc::type get_cb() const { return cb_; }
+	void set_cb(typename Tc::type cb) { cb_ = cb; }
+
+	typename Tc::type get_cr() const { return cr_; }
+	void set_cr(typename Tc::type cr) { cr_ = cr; }
+
+	template<typename T>
+	void set_rgb(const rgb_base<T>& rgb)
+	{
+		operator=(rgb);
+	}
+
+	friend std::ostream& operator << (std::ostream& os, const ycbcr_base& v)
+	{
+		if (std::is_same<typename Ty::type, unsigned char>::value)
+			os << static_cast<int>(v.y_);
+		else
+			os << v.y_;
+		os << ",";
+		if (std::is_same<typename Tc::type, unsigned char>::value)
+			os << static_cast<int>(v.cb_) << "," << static_cast<int>(v.cr_);
+		else
+			os << v.cb_ << "," << v.cr_;
+		return os;
+	}
+
+private:
+	typename Ty::type y_{Ty::min()};
+	typename Tc::type cb_{Tc::min()};
+	typename Tc::type cr_{Tc::min()};
+};
+
+//========================== HWB ========================== 
+template<typename Th, typename Twb>
+class hwb_base
+{
+public: // constructors/operators
+	hwb_base() = default;
+	hwb_base(const hwb_base&) = default;
+	hwb_base(hwb_base&&) noexcept = default;
+	hwb_base(typename Th::type h, typename Twb::type w, typename Twb::type b) : h_(h), w_(w), b_(b) {}
+	template<typename T>
+	hwb_base(const rgb_base<T>& rgb)
+	{
+		operator=(rgb);
+	}
+	template<typename Th2, typename Tsv>
+	hwb_base(const hsv_base<Th2, Tsv>& hsv)
+	{
+		operator=(hsv);
+	}
+
+	//operators
+	hwb_base& operator=(const hwb_base&) = default;
+	hwb_base& operator=(hwb_base&&) noexcept = default;
+	template<typename T>
+	hwb_base& operator=(const rgb_base<T>& rgb)
+	{
+		double h = 0;
+		double w = 0;
+		double b = 0;
+		rgb_to_hwb(get_dbl<T>(rgb.get_red()),
+			get_dbl<T>(rgb.get_green()),
+			get_dbl<T>(rgb.get_blue()),
+			h, w, b);
+		h_ = from_dbl<Th>(h);
+		w_ = from_dbl<Twb>(w);
+		b_ = from_dbl<Twb>(b);
+		return *this;
+	}
+	// direct conversion, the hue is copied if the types match
+	template<typename Th2, typename Tsv>
+	hwb_base& operator=(const hsv_base<Th2, Tsv>& hsv)
+	{
+		double h = 0;
+		double w = 0;
+		double b = 0;
+		hsv_to_hwb(get_dbl<Th2>(hsv.get_hue()),
+			get_dbl<Tsv>(hsv.get_saturation()),
+			get_dbl<Tsv>(hsv.get_value()),
+			h, w, b);
+		h_ = std::is_same<Th, Th2>::value ? static_cast<typename Th::type>(hsv.get_hue()) : from_dbl<Th>(h);
+		w_ = from_dbl<Twb>(w);
+		b_ = from_dbl<Twb>(b);
+		return *this;
+	}
+
+public: // get/set
+	typename Th::type get_hue() const { return h_; }
+	void set_hue(typename Th::type h) { h_ = h; }
+
+	typename Twb::type get_whiteness() const { return w_; }
+	void set_whiteness(typename Twb::type w) { w_ = w; }
+
+	typename Twb::type get_blackness() const { return b_; }
+	void set_blackness(typename Twb::type b) { b_ = b; }
+
+	template<typename T>
+	void set_rgb(const rgb_base<T>& rgb)
+	{
+		operator=(rgb);
+	}
+
+	friend std::ostream& operator << (std::ostream& os, const hwb_base& v)
+	{
+		if (std::is_same<typename Th::type, unsigned char>::value)
+			os << static_cast<int>(v.h_);
+		else
+			os << v.h_;
+		os << ",";
+		if (std::is_same<typename Twb::type, unsigned char>::value)
+			os << static_cast<int>(v.w_) << "," << static_cast<int>(v.b_);
+		else
+			os << v.w_ << "," << v.b_;
+		return os;
+	}
+
+private:
+	typename Th::type h_{Th::min()};
+	typename Twb::type w_{Twb::min()};
+	typename Twb::type b_{Twb::min()};
+};
+
+//========================== HSI ========================== 
+template<typename Th, typename Tsi>
+class hsi_base
+{
+public: // constructors/operators
+	hsi_base() = default;
+	hsi_base(const hsi_base&) = default;
+	hsi_base(hsi_base&&) noexcept = default;
+	hsi_base(typename Th::type h, typename Tsi::type s, typename Tsi::type i) : h_(h), s_(s), i_(i) {}
+	template<typename T>
+	hsi_base(const rgb_base<T>& rgb)
+	{
+		operator=(rgb);
+	}
+
+	//operators
+	hsi_base& operator=(const hsi_base&) = default;
+	hsi_base& operator=(hsi_base&&) noexcept = default;
+	template<typename T>
+	hsi_base& operator=(const rgb_base<T>& rgb)
+	{
+		double h = 0;
+		double s = 0;
+		double i = 0;
+		rgb_to_hsi(get_dbl<T>(rgb.get_red()),
+			get_dbl<T>(rgb.get_green()),
+			get_dbl<T>(rgb.get_blue()),
+			h, s, i);
+		h_ = from_dbl<Th>(h);
+		s_ = from_dbl<Tsi>(s);
+		i_ = from_dbl<Tsi>(i);
+		return *this;
+	}
+
+public: // get/set
+	typename Th::type get_hue() const { return h_; }
+	void set_hue(typename Th::type h) { h_ = h; }
+
+	typename Tsi::type get_saturation() const { return s_; }
+	void set_saturation(typename Tsi::type s) { s_ = s; }
+
+	typename Tsi::type get_intensity() const { return i_; }
+	void set_intensity(typename Tsi::type i) { i_ = i; }
+
+	template<typename T>
+	void set_rgb(const rgb_base<T>& rgb)
+	{
+		operator=(rgb);
+	}
+
+	friend std::ostream& operator << (std::ostream& os, const hsi_base& v)
+	{
+		if (std::is_same<typename Th::type, unsigned char>::value)
+			os << static_cast<int>(v.h_);
+		else
+			os << v.h_;
+		os << ",";
+		if (std::is_same<typename Tsi::type, unsigned char>::value)
+			os << static_cast<int>(v.s_) << "," << static_cast<int>(v.i_);
+		else
+			os << v.s_ << "," << v.i_;
+		return os;
+	}
+
+private:
+	typename Th::type h_{Th::min()};
+	typename Tsi::type s_{Tsi::min()};
+	typename Tsi::type i_{Tsi::min()};
+};
+
+//========================= CMYK ========================== 
+template<typename T>
+class cmyk_base
+{
+public: // constructors/operators
+	cmyk_base() = default;
+	cmyk_base(const cmyk_base&) = default;
+	cmyk_base(cmyk_base&&) noexcept = default;
+	cmyk_base(typename T::type c, typename T::type m, typename T::type y, typename T::type k) : c_(c), m_(m), y_(y), k_(k) {}
+	template<typename T2>
+	cmyk_base(const rgb_base<T2>& rgb)
+	{
+		operator=(rgb);
+	}
+
+	//operators
+	cmyk_base& operator=(const cmyk_base&) = default;
+	cmyk_base& operator=(cmyk_base&&) noexcept = default;
+	template<typename T2>
+	cmyk_base& operator=(const rgb_base<T2>& rgb)
+	{
+		double c = 0;
+		double m = 0;
+		double y = 0;
+		double k = 0;
+		rgb_to_cmyk(get_dbl<T2>(rgb.get_red()),
+			get_dbl<T2>(rgb.get_green()),
+			get_dbl<T2>(rgb.get_blue()),
+			c, m, y, k);
+		c_ = from_dbl<T>(c);
+		m_ = from_dbl<T>(m);
+		y_ = from_dbl<T>(y);
+		k_ = from_dbl<T>(k);
+		return *this;
+	}
+
+public: // get/set
+	typename T::type get_cyan() const { return c_; }
+	void set_cyan(typename T::type c) { c_ = c; }
+
+	typename T::type get_magenta() const { return m_; }
+	void set_magenta(typename T::type m) { m_ = m; }
+
+	typename T::type get_yellow() const { return y_; }
+	void set_yellow(typename T::type y) { y_ = y; }
+
+	typename T::type get_black() const { return k_; }
+	void set_black(typename T::type k) { k_ = k; }
+
+	template<typename T2>
+	void set_rgb(const rgb_base<T2>& rgb)
+	{
+		operator=(rgb);
+	}
+
+	friend std::ostream& operator << (std::ostream& os, const cmyk_base& v)
+	{
+		if (std::is_same<typename T::type, unsigned char>::value)
+			return os << static_cast<int>(v.c_) << ","
+				<< static_cast<int>(v.m_) << ","
+				<< static_cast<int>(v.y_) << ","
+				<< static_cast<int>(v.k_);
+		return os << v.c_ << "," << v.m_ << "," << v.y_ << "," << v.k_;
+	}
+
+private:
+	typename T::type c_{T::min()};
+	typename T::type m_{T::min()};
+	typename T::type y_{T::min()};
+	typename T::type k_{T::min()};
+};
+
+//========================= Oklab ========================= 
+// sRGB only, the channels are normalized as described in oklab.h
+template<typename Tl, typename Tab>
+class oklab_base
+{
+public: // constructors/operators
+	oklab_base() = default;
+	oklab_base(const oklab_base&) = default;
+	oklab_base(oklab_base&&) noexcept = default;
+	oklab_base(typename Tl::type l, typename Tab::type a, typename Tab::type b) : l_(l), a_(a), b_(b) {}
+	template<typename T>
+	oklab_base(const rgb_base<T>& rgb)
+	{
+		operator=(rgb);
+	}
+	template<typename Tlc, typename Th>
+	oklab_base(const oklch_base<Tlc, Th>& oklch)
+	{
+		operator=(oklch);
+	}
+
+	//operators
+	oklab_base& operator=(const oklab_base&) = default;
+	oklab_base& operator=(oklab_base&&) noexcept = default;
+	template<typename T>
+	oklab_base& operator=(const rgb_base<T>& rgb)
+	{
+		double l = 0;
+		double a = 0;
+		double b = 0;
+		rgb_to_oklab(get_dbl<T>(rgb.get_red()),
+			get_dbl<T>(rgb.get_green()),
+			get_dbl<T>(rgb.get_blue()),
+			l, a, b);
+		l_ = from_dbl<Tl>(l);
+		a_ = from_dbl<Tab>(a);
+		b_ = from_dbl<Tab>(b);
+		return *this;
+	}
+	template<typename Tlc, typename Th>
+	oklab_base& operator=(const oklch_base<Tlc, Th>& oklch)
+	{
+		double l = 0;
+		double a = 0;
+		double b = 0;
+		oklch_to_oklab(get_dbl<Tlc>(oklch.get_lightness()),
+			get_dbl<Tlc>(oklch.get_chroma()),
+			get_dbl<Th>(oklch.get_hue()),
+			l, a, b);
+		l_ = from_dbl<Tl>(l);
+		a_ = from_dbl<Tab>(a);
+		b_ = from_dbl<Tab>(b);
+		return *this;
+	}
+
+public: // get/set
+	typename Tl::type get_lightness() const { return l_; }
+	void set_lightness(typename Tl::type l) { l_ = l; }
+
+	typename Tab::type get_a() const { return a_; }
+	void set_a(typename Tab::type a) { a_ = a; }
+
+	typename Tab::type get_b() const { return b_; }
+	void set_b(typename Tab::type b) { b_ = b; }
+
+	template<typename T>
+	void set_rgb(const rgb_base<T>& rgb)
+	{
+		operator=(rgb);
+	}
+
+	friend std::ostream& operator << (std::ostream& os, const oklab_base& v)
+	{
+		if (std::is_same<typename Tl::type, unsigned char>::value)
+			os << static_cast<int>(v.l_);
+		else
+			os << v.l_;
+		os << ",";
+		if (std::is_same<typename Tab::type, unsigned char>::value)
+			os << static_cast<int>(v.a_) << "," << static_cast<int>(v.b_);
+		else
+			os << v.a_ << "," << v.b_;
+		return os;
+	}
+
+private:
+	typename Tl::type l_{Tl::min()};
+	typename Tab::type a_{Tab::min()};
+	typename Tab::type b_{Tab::min()};
+};
+
+//========================= Oklch ========================= 
+template<typename Tlc, typename Th>
+class oklch_base
+{
+public: // constructors/operators
+	oklch_base() = default;
+	oklch_base(const oklch_base&) = default;
+	oklch_base(oklch_base&&) noexcept = default;
+	oklch_base(typename Tlc::type l, typename Tlc::type c, typename Th::type h) : l_(l), c_(c), h_(h) {}
+	template<typename T>
+	oklch_base(const rgb_base<T>& rgb)
+	{
+		operator=(rgb);
+	}
+	template<typename Tl, typename Tab>
+	oklch_base(const oklab_base<Tl, Tab>& oklab)
+	{
+		operator=(oklab);
+	}
+
+	//operators
+	oklch_base& operator=(const oklch_base&) = default;
+	oklch_base& operator=(oklch_base&&) noexcept = default;
+	template<typename T>
+	oklch_base& operator=(const rgb_base<T>& rgb)
+	{
+		return operator=(oklab_base<dbl, dbl>(rgb));
+	}
+	template<typename Tl, typename Tab>
+	oklch_base& operator=(const oklab_base<Tl, Tab>& oklab)
+	{
+		double l = 0;
+		double c = 0;
+		double h = 0;
+		oklab_to_oklch(get_dbl<Tl>(oklab.get_lightness()),
+			get_dbl<Tab>(oklab.get_a()),
+			get_dbl<Tab>(oklab.get_b()),
+			l, c, h);
+		l_ = from_dbl<Tlc>(l);
+		c_ = from_dbl<Tlc>(c);
+		h_ = from_dbl<Th>(h);
+		return *this;
+	}
+
+public: // get/set
+	typename Tlc::type get_lightness() const { return l_; }
+	void set_lightness(typename Tlc::type l) { l_ = l; }
+
+	typename Tlc::type get_chroma() const { return c_; }
+	void set_chroma(typename Tlc::type c) { c_ = c; }
+
+	typename Th::type get_hue() const { return h_; }
+	void set_hue(typename Th::type h) { h_ = h; }
+
+	template<typename T>
+	void set_rgb(const rgb_base<T>& rgb)
+	{
+		operator=(rgb);
+	}
+
+	friend std::ostream& operator << (std::ostream& os, const oklch_base& v)
+	{
+		if (std::is_same<typename Tlc::type, unsigned char>::value)
+			os << static_cast<int>(v.l_) << "," << static_cast<int>(v.c_);
+		else
+			os << v.l_ << "," << v.c_;
+		os << ",";
+		if (std::is_same<typename Th::type, unsigned char>::value)
+			os << static_cast<int>(v.h_);
+		else
+			os << v.h_;
+		return os;
+	}
+
+private:
+	typename Tlc::type l_{Tlc::min()};
+	typename Tlc::type c_{Tlc::min()};
+	typename Th::type h_{Th::min()};
+};
+
 using rgb = rgb_base<dbl>;
 using rgb256 = rgb_base<byte>;
 using hsv = hsv_base<dbl, dbl>;
 using hsv360_100 = hsv_base<word360, byte100>;
 using hsl = hsl_base<dbl, dbl>;
 using hsl360_100 = hsl_base<word360, byte100>;
+using ycbcr = ycbcr_base<dbl, dbl>;
+using ycbcr256 = ycbcr_base<byte, byte>;
+using ycbcr601 = ycbcr_base<byte235, byte240, YCbCrEnum::Bt601>;
+using ycbcr709 = ycbcr_base<byte235, byte240, YCbCrEnum::Bt709>;
+using hwb = hwb_base<dbl, dbl>;
+using hwb360_100 = hwb_base<word360, byte100>;
+using hsi = hsi_base<dbl, dbl>;
+using hsi360_100 = hsi_base<word360, byte100>;
+using cmyk = cmyk_base<dbl>;
+using cmyk100 = cmyk_base<byte100>;
+using cmyk256 = cmyk_base<byte>;
+using oklab = oklab_base<dbl, dbl>;
+using oklab256 = oklab_base<byte, byte>;
+using oklch = oklch_base<dbl, dbl>;
+using oklch100_360 = oklch_base<byte100, word360>;
 
 } // end namespace colorpp
 
@@ -0,0 +1,109 @@
+/*!
+\file color_lut.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include "color.h"
+
+namespace colorpp
+{
+
+/*!
+	\brief Exhaustive conversion tables enum
+*/
+enum class ColorLutEnum
+{
+	RgbToHsv = 0,	// rgb256 -> hsv360_100, 2^24 packed entries of 3 bytes
+	RgbToHsl = 1,	// rgb256 -> hsl360_100, 2^24 packed entries of 3 bytes
+	HsvToRgb = 2,	// hsv360_100 -> rgb256, 361 * 101 * 101 entries of 3 bytes
+	HslToRgb = 3	// hsl360_100 -> rgb256, 361 * 101 * 101 entries of 3 bytes
+};
+
+/*!
+	\brief Build a conversion table now instead of on the first use
+	\details Tables are built once, in parallel on the library threads, and kept
+		until the program ends. Concurrent first uses wait for a single build. With the
+		table cache on (see lut_cache.h) tables are mapped from the cache files.
+	\param[in] lut - conversion table (see ColorLutEnum)
+*/
+void build_color_lut(ColorLutEnum lut);
+
+/*!
+	\brief Get the memory held by a conversion table
+	\param[in] lut - conversion table (see ColorLutEnum)
+	\return size in bytes, 0 before the table is built
+*/
+size_t get_color_lut_memory(ColorLutEnum lut);
+
+/*!
+	\brief Table-driven conversion from rgb256 to hsv360_100
+	\details Bit-identical to the hsv360_100(rgb256) constructor.
+	\param[in] rgb - source color
+	\return converted color
+*/
+hsv360_100 lut_rgb_to_hsv(const rgb256& rgb);
+
+/*!
+	\brief Table-driven conversion from rgb256 to hsl360_100
+	\details Bit-identical to the hsl360_100(rgb256) constructor.
+	\param[in] rgb - source color
+	\return converted color
+*/
+hsl360_100 lut_rgb_to_hsl(const rgb256& rgb);
+
+/*!
+	\brief Table-driven conversion from hsv360_100 to rgb256
+	\details Bit-identical to the rgb256(hsv360_100) constructor; components out of
+		the type ranges are converted by the constructor.
+	\param[in] hsv - source color
+	\return converted color
+*/
+rgb256 lut_hsv_to_rgb(const hsv360_100& hsv);
+
+/*!
+	\brief Table-driven conversion from hsl360_100 to rgb256
+	\details Bit-identical to the rgb256(hsl360_100) constructor; components out of
+		the type ranges are converted by the constructor.
+	\param[in] hsl - source color
+	\return converted color
+*/
+rgb256 lut_hsl_to_rgb(const hsl360_100& hsl);
+
+/*!
+    \brief Batch table-driven conversion from rgb256 to hsv360_100
+    \param[in] src - source colors
+    \param[out] dst - converted colors
+    \param[in] count - number of colors
+*/
+void lut_rgb_to_hsv(const rgb256* src, hsv360_100* dst, size_t count);
+
+/*!
+    \brief Batch table-driven conversion from rgb256 to hsl360_100
+    \param[in] src - source colors
+    \param[out] dst - converted colors
+    \param[in] count - number of colors
+*/
+void lut_rgb_to_hsl(const rgb256* src, hsl360_100* dst, size_t count);
+
+/*!
+    \brief Batch table-driven conversion from hsv360_100 to rgb256
+    \param[in] src - source colors
+    \param[out] dst - converted colors
+    \param[in] count - number of colors
+*/
+void lut_hsv_to_rgb(const hsv360_100* src, rgb256* dst, size_t count);
+
+/*!
+    \brief Batch table-driven conversion from hsl360_100 to rgb256
+    \param[in] src - source colors
+    \param[out] dst - converted colors
+    \param[in] count - number of colors
+*/
+void lut_hsl_to_rgb(const hsl360_100* src, rgb256* dst, size_t count);
+
+}
@@ -0,0 +1,549 @@
+/*!
+\file convert.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+#include "color.h"
+
+namespace colorpp
+{
+
+namespace detail
+{
+
+// color models, the vertices of the conversion graph
+struct rgb_model {};
+struct hsv_model {};
+struct hsl_model {};
+template<YCbCrEnum matrix>
+struct ycbcr_model {};
+struct oklab_model {};
+struct oklch_model {};
+struct hwb_model {};
+struct hsi_model {};
+struct cmyk_model {};
+
+template<typename... M>
+struct model_list {};
+
+// models a path may pass through
+using all_models = model_list<rgb_model, hsv_model, hsl_model,
+	ycbcr_model<YCbCrEnum::Bt601>, ycbcr_model<YCbCrEnum::Bt709>, ycbcr_model<YCbCrEnum::Bt2020>,
+	oklab_model, oklch_model, hwb_model, hsi_model, cmyk_model>;
+
+// longest path searched, longer paths are treated as missing
+const int MaxConversionSteps = 3;
+const int NoConversionPath = 1000;
+// channels of the intermediate values, 4 for CMYK
+const int MaxChannels = 4;
+
+// channels of a color type in 0..1.0 range
+template<typename C>
+struct color_traits;
+
+template<typename T>
+struct color_traits<rgb_base<T>>
+{
+	using model = rgb_model;
+	static void get(const rgb_base<T>& c, double v[3])
+	{
+		v[0] = get_dbl<T>(c.get_red());
+		v[1] = get_dbl<T>(c.get_green());
+		v[2] = get_dbl<T>(c.get_blue());
+	}
+	static rgb_base<T> put(const double v[3])
+	{
+		return rgb_base<T>(from_dbl<T>(v[0]), from_dbl<T>(v[1]), from_dbl<T>(v[2]));
+	}
+};
+
+template<typename Th, typename Tsv>
+struct color_traits<hsv_base<Th, Tsv>>
+{
+	using model = hsv_model;
+	static void get(const hsv_base<Th, Tsv>& c, double v[3])
+	{
+		v[0] = get_dbl<Th>(c.get_hue());
+		v[1] = get_dbl<Tsv>(c.get_saturation());
+		v[2] = get_dbl<Tsv>(c.get_value());
+	}
+	static hsv_base<Th, Tsv> put(const double v[3])
+	{
+		return hsv_base<Th, Tsv>(from_dbl<Th>(v[0]), from_dbl<Tsv>(v[1]), from_dbl<Tsv>(v[2]));
+	}
+};
+
+template<typename Th, typename Tsl>
+struct color_traits<hsl_base<Th, Tsl>>
+{
+	using model = hsl_model;
+	static void get(const hsl_base<Th, Tsl>& c, double v[3])
+	{
+		v[0] = get_dbl<Th>(c.get_hue());
+		v[1] = get_dbl<Tsl>(c.get_saturation());
+		v[2] = get_dbl<Tsl>(c.get_lightness());
+	}
+	static hsl_base<Th, Tsl> put(const double v[3])
+	{
+		return hsl_base<Th, Tsl>(from_dbl<Th>(v[0]), from_dbl<Tsl>(v[1]), from_dbl<Tsl>(v[2]));
+	}
+};
+
+template<typename Ty, typename Tc, YCbCrEnum matrix>
+struct color_traits<ycbcr_base<Ty, Tc, matrix>>
+{
+	using model = ycbcr_model<matrix>;
+	static void get(const ycbcr_base<Ty, Tc, matrix>& c, double v[3])
+	{
+		v[0] = get_dbl<Ty>(c.get_luma());
+		v[1] = get_dbl<Tc>(c.get_cb());
+		v[2] = get_dbl<Tc>(c.get_cr());
+	}
+	static ycbcr_base<Ty, Tc, matrix> put(const double v[3])
+	{
+		return ycbcr_base<Ty, Tc, matrix>(from_dbl<Ty>(v[0]), from_dbl<Tc>(v[1]), from_dbl<Tc>(v[2]));
+	}
+};
+
+template<typename Tl, typename Tab>
+struct color_traits<oklab_base<Tl, Tab>>
+{
+	using model = oklab_model;
+	static void get(const oklab_base<Tl, Tab>& c, double v[3])
+	{
+		v[0] = get_dbl<Tl>(c.get_lightness());
+		v[1] = get_dbl<Tab>(c.get_a());
+		v[2] = get_dbl<Tab>(c.get_b());
+	}
+	static oklab_base<Tl, Tab> put(const double v[3])
+	{
+		return oklab_base<Tl, Tab>(from_dbl<Tl>(v[0]), from_dbl<Tab>(v[1]), from_dbl<Tab>(v[2]));
+	}
+};
+
+template<typename Tlc, typename Th>
+struct color_traits<oklch_base<Tlc, Th>>
+{
+	using model = oklch_model;
+	static void get(const oklch_base<Tlc, Th>& c, double v[3])
+	{
+		v[0] = get_dbl<Tlc>(c.get_lightness());
+		v[1] = get_dbl<Tlc>(c.get_chroma());
+		v[2] = get_dbl<Th>(c.get_hue());
+	}
+	static oklch_base<Tlc, Th> put(const double v[3])
+	{
+		return oklch_base<Tlc, Th>(from_dbl<Tlc>(v[0]), from_dbl<Tlc>(v[1]), from_dbl<Th>(v[2]));
+	}
+};
+
+template<typename Th, typename Twb>
+struct color_traits<hwb_base<Th, Twb>>
+{
+	using model = hwb_model;
+	static void get(const hwb_base<Th, Twb>& c, double v[3])
+	{
+		v[0] = get_dbl<Th>(c.get_hue());
+		v[1] = get_dbl<Twb>(c.get_whiteness());
+		v[2] = get_dbl<Twb>(c.get_blackness());
+	}
+	static hwb_base<Th, Twb> put(const double v[3])
+	{
+		return hwb_base<Th, Twb>(from_dbl<Th>(v[0]), from_dbl<Twb>(v[1]), from_dbl<Twb>(v[2]));
+	}
+};
+
+template<typename Th, typename Tsi>
+struct color_traits<hsi_base<Th, Tsi>>
+{
+	using model = hsi_model;
+	static void get(const hsi_base<Th, Tsi>& c, double v[3])
+	{
+		v[0] = get_dbl<Th>(c.get_hue());
+		v[1] = get_dbl<Tsi>(c.get_saturation());
+		v[2] = get_dbl<Tsi>(c.get_intensity());
+	}
+	static hsi_base<Th, Tsi> put(const double v[3])
+	{
+		return hsi_base<Th, Tsi>(from_dbl<Th>(v[0]), from_dbl<Tsi>(v[1]), from_dbl<Tsi>(v[2]));
+	}
+};
+
+template<typename T>
+struct color_traits<cmyk_base<T>>
+{
+	using model = cmyk_model;
+	static void get(const cmyk_base<T>& c, double v[4])
+	{
+		v[0] = get_dbl<T>(c.get_cyan());
+		v[1] = get_dbl<T>(c.get_magenta());
+		v[2] = get_dbl<T>(c.get_yellow());
+		v[3] = get_dbl<T>(c.get_black());
+	}
+	static cmyk_base<T> put(const double v[4])
+	{
+		return cmyk_base<T>(from_dbl<T>(v[0]), from_dbl<T>(v[1]), from_dbl<T>(v[2]), from_dbl<T>(v[3]));
+	}
+};
+
+// direct conversions, the edges of the conversion graph
+template<typename From, typename To>
+struct model_edge : std::false_type {};
+
+template<>
+struct model_edge<rgb_model, hsv_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		rgb_to_hsv(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<>
+struct model_edge<hsv_model, rgb_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		hsv_to_rgb(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<>
+struct model_edge<rgb_model, hsl_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		rgb_to_hsl(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<>
+struct model_edge<hsl_model, rgb_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		hsl_to_rgb(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<YCbCrEnum matrix>
+struct model_edge<rgb_model, ycbcr_model<matrix>> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		rgb_to_ycbcr(in[0], in[1], in[2], out[0], out[1], out[2], matrix);
+	}
+};
+
+template<YCbCrEnum matrix>
+struct model_edge<ycbcr_model<matrix>, rgb_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		ycbcr_to_rgb(in[0], in[1], in[2], out[0], out[1], out[2], matrix);
+	}
+};
+
+template<>
+struct model_edge<hsv_model, hsl_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		hsv_to_hsl(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<>
+struct model_edge<hsl_model, hsv_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		hsl_to_hsv(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<>
+struct model_edge<rgb_model, oklab_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		rgb_to_oklab(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+// out of gamut colors are clipped like the rgb_base constructors do
+template<>
+struct model_edge<oklab_model, rgb_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		oklab_to_rgb(in[0], in[1], in[2], out[0], out[1], out[2]);
+		for (int i = 0; i < 3; ++i)
+			out[i] = std::min(std::max(out[i], 0.), 1.);
+	}
+};
+
+template<>
+struct model_edge<oklab_model, oklch_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		oklab_to_oklch(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<>
+struct model_edge<oklch_model, oklab_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		oklch_to_oklab(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<>
+struct model_edge<rgb_model, hwb_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		rgb_to_hwb(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<>
+struct model_edge<hwb_model, rgb_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		hwb_to_rgb(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<>
+struct model_edge<hsv_model, hwb_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		hsv_to_hwb(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<>
+struct model_edge<hwb_model, hsv_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		hwb_to_hsv(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+template<>
+struct model_edge<rgb_model, hsi_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		rgb_to_hsi(in[0], in[1], in[2], out[0], out[1], out[2]);
+	}
+};
+
+// out of gamut colors are clipped like the rgb_base constructors do
+template<>
+struct model_edge<hsi_model, rgb_model> : std::true_type
+{
+	static void apply(const double in[3], double out[3])
+	{
+		hsi_to_rgb(in[0], in[1], in[2], out[0], out[1], out[2]);
+		for (int i = 0; i < 3; ++i)
+			out[i] = std::min(std::max(out[i], 0.), 1.);
+	}
+};
+
+template<>
+struct model_edge<rgb_model, cmyk_model> : std::true_type
+{
+	static void apply(const double in[3], double out[4])
+	{
+		rgb_to_cmyk(in[0], in[1], in[2], out[0], out[1], out[2], out[3]);
+	}
+};
+
+template<>
+struct model_edge<cmyk_model, rgb_model> : std::true_type
+{
+	static void apply(const double in[4], double out[3])
+	{
+		cmyk_to_rgb(in[0], in[1], in[2], in[3], out[0], out[1], out[2]);
+	}
+};
+
+// shortest path of at most depth steps
+template<typename From, typename To, int depth,
+	bool same = std::is_same<From, To>::value, bool last = depth == 0>
+struct model_path;
+
+// one step to Next and the shortest path from there, only instantiated along the edges
+template<typename From, typename Next, typename To, int depth, bool edge = model_edge<From, Next>::value>
+struct model_hop
+{
+	static const int length = NoConversionPath;
+	static void apply(const double*, double*) {}
+};
+
+template<typename From, typename Next, typename To, int depth>
+struct model_hop<From, Next, To, depth, true>
+{
+	using rest = model_path<Next, To, depth - 1>;
+	static const int length = rest::length >= NoConversionPath ? NoConversionPath : rest::length + 1;
+	static void apply(const double in[3], double out[3])
+	{
+		double v[MaxChannels];
+		model_edge<From, Next>::apply(in, v);
+		rest::apply(v, out);
+	}
+};
+
+// the shortest of the hops through the models of the list, the first one on a tie
+template<typename From, typename To, int depth, typename List>
+struct best_hop;
+
+template<typename From, typename To, int depth>
+struct best_hop<From, To, depth, model_list<>>
+{
+	static const int length = NoConversionPath;
+	static void apply(const double*, double*) {}
+};
+
+template<typename From, typename To, int depth, typename M, typename... Rest>
+struct best_hop<From, To, depth, model_list<M, Rest...>>
+{
+	using first = model_hop<From, M, To, depth>;
+	using others = best_hop<From, To, depth, model_list<Rest...>>;
+	using best = typename std::conditional<(first::length <= others::length), first, others>::type;
+	static const int length = best::length;
+	static void apply(const double in[3], double out[3])
+	{
+		best::apply(in, out);
+	}
+};
+
+template<typename From, typename To, int depth>
+struct model_path<From, To, depth, false, false>
+{
+	using hop = best_hop<From, To, depth, all_models>;
+	static const int length = hop::length;
+	static void apply(const double in[3], double out[3])
+	{
+		hop::apply(in, out);
+	}
+};
+
+template<typename From, typename To, int depth, bool last>
+struct model_path<From, To, depth, true, last>
+{
+	static const int length = 0;
+	static void apply(const double in[3], double out[3])
+	{
+		for (int i = 0; i < MaxChannels; ++i)
+			out[i] = in[i];
+	}
+};
+
+template<typename From, typename To, int depth>
+struct model_path<From, To, depth, false, true>
+{
+	static const int length = NoConversionPath;
+	static void apply(const double*, double*) {}
+};
+
+// hue type of the hue models, void for the others
+template<typename C>
+struct hue_of
+{
+	using type = void;
+};
+
+template<typename Th, typename Tsv>
+struct hue_of<hsv_base<Th, Tsv>>
+{
+	using type = Th;
+};
+
+template<typename Th, typename Tsl>
+struct hue_of<hsl_base<Th, Tsl>>
+{
+	using type = Th;
+};
+
+// HWB has the HSV hue, the HSI hue is an angle of its own
+template<typename Th, typename Twb>
+struct hue_of<hwb_base<Th, Twb>>
+{
+	using type = Th;
+};
+
+// paths between hue models keep the hue, quantized hues are copied like the constructors do
+// (get_dbl and from_dbl don't round trip every word360 value)
+template<typename To, typename From, bool copy = !std::is_void<typename hue_of<From>::type>::value &&
+	std::is_same<typename hue_of<From>::type, typename hue_of<To>::type>::value>
+struct hue_copy
+{
+	static void apply(const From&, To&) {}
+};
+
+template<typename To, typename From>
+struct hue_copy<To, From, true>
+{
+	static void apply(const From& from, To& to)
+	{
+		to.set_hue(from.get_hue());
+	}
+};
+
+template<typename From, typename To>
+using conversion_path = model_path<typename color_traits<From>::model, typename color_traits<To>::model,
+	MaxConversionSteps>;
+
+}
+
+/*!
+	\brief Get the number of model conversions between two color types
+	\details Resolved at compile time: 0 for the same model (requantization only),
+		1 for a direct conversion, 2 for a path through RGB and so on.
+	\return number of conversions
+*/
+template<typename To, typename From>
+constexpr int get_conversion_steps()
+{
+	return detail::conversion_path<From, To>::length;
+}
+
+/*!
+	\brief Conversion between any two color types
+	\details The shortest path through the model graph is found at compile time and
+		its conversions are chained in double precision: the result is quantized once,
+		so hsv360_100 -> hsl360_100 doesn't lose precision in an intermediate rgb256.
+		One-step conversions give the same result as the constructors.
+	\param[in] from - source color
+	\return converted color
+*/
+template<typename To, typename From>
+To convert(const From& from)
+{
+	using path = detail::conversion_path<From, To>;
+	static_assert(path::length < detail::NoConversionPath, "no conversion path between the color models");
+	double in[detail::MaxChannels] = {};
+	double out[detail::MaxChannels];
+	detail::color_traits<From>::get(from, in);
+	path::apply(in, out);
+	auto to = detail::color_traits<To>::put(out);
+	detail::hue_copy<To, From>::apply(from, to);
+	return to;
+}
+
+}
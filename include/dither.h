@@ -0,0 +1,61 @@
+/*!
+\file dither.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace colorpp
+{
+
+/*!
+	\brief Dithering methods enum
+*/
+enum class DitherEnum
+{
+	None = 0,	// truncation, as from_dbl does
+	Bayer = 1,	// ordered, 16x16 Bayer matrix
+	BlueNoise = 2,	// ordered, 64x64 void-and-cluster blue noise
+	FloydSteinberg = 3	// error diffusion
+};
+
+/*!
+    \brief Batch quantization of 0..1.0 samples to 8-bit with dithering
+	\details Follows the from_dbl convention: code k covers [k / 256, (k + 1) / 256).
+		Ordered dithering is a vectorizable threshold per sample; error diffusion
+		runs rows in a pipeline on the library threads, each row trailing the
+		previous one by a block of pixels.
+    \param[in] src - interleaved source rows
+    \param[in] src_stride - source row size in bytes
+    \param[out] dst - interleaved destination rows
+    \param[in] dst_stride - destination row size in bytes
+    \param[in] width - number of pixels in a row
+    \param[in] height - number of rows
+    \param[in] channels - 1..4 samples per pixel
+	\param[in] dither - dithering method (see DitherEnum)
+	\return false if the arguments are invalid
+*/
+bool quantize(const float* src, size_t src_stride, unsigned char* dst, size_t dst_stride,
+	size_t width, size_t height, size_t channels, DitherEnum dither);
+
+/*!
+    \brief Batch quantization of 0..1.0 samples to high bit depth with dithering
+	\details See quantize for 8-bit samples.
+    \param[in] src - interleaved source rows
+    \param[in] src_stride - source row size in bytes
+    \param[out] dst - interleaved destination rows
+    \param[in] dst_stride - destination row size in bytes
+    \param[in] width - number of pixels in a row
+    \param[in] height - number of rows
+    \param[in] channels - 1..4 samples per pixel
+	\param[in] dither - dithering method (see DitherEnum)
+	\param[in] bit_depth - 8..16 bits per sample
+	\return false if the arguments are invalid
+*/
+bool quantize(const float* src, size_t src_stride, unsigned short* dst, size_t dst_stride,
+	size_t width, size_t height, size_t channels, DitherEnum dither, int bit_depth = 16);
+
+}
@@ -0,0 +1,122 @@
+/*!
+\file gradient.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "rgb.h"
+
+namespace colorpp
+{
+
+/*!
+	\brief Gradient interpolation spaces enum
+*/
+enum class GradientEnum
+{
+	Rgb = 0,	// encoded RGB channels
+	Hsv = 1,	// HSV, hue along the shortest arc
+	Hsl = 2,	// HSL, hue along the shortest arc
+	Lab = 3	// CIE L*a*b* relative to the reference white of the RGB parameters
+};
+
+/*!
+	\brief Color stop of a gradient
+*/
+typedef struct _GradientStop
+{
+	double Position;	// 0..1.0
+	double Rgb[3];	// color in 0..1.0 range
+} GradientStop;
+
+/*!
+	\brief Gradient between color stops
+*/
+typedef struct _Gradient
+{
+	GradientEnum Space;
+	std::vector<GradientStop> Stops;	// ordered by Position
+	RgbParams Params;	// RGB color space of the stops (Lab)
+} Gradient;
+
+/*!
+	\brief Gradient baked into a lookup table
+	\details Entry i is the color at Low + i * (High - Low) / (Size - 1).
+*/
+typedef struct _GradientLut
+{
+	size_t Size;
+	double Low;	// sample value of the first entry
+	double High;	// sample value of the last entry
+	std::vector<float> Rgb;	// 3 * Size floats
+	std::vector<unsigned char> Rgb256;	// 3 * Size bytes (from_dbl convention)
+} GradientLut;
+
+/*!
+	\brief Create a gradient
+	\param[in] space - interpolation space (see GradientEnum)
+	\param[in] stops - color stops in any order
+	\param[in] count - number of stops
+	\param[in] params - RGB ColorSpace parameters of the stops
+	\return gradient, without stops if count is 0
+*/
+Gradient get_gradient(GradientEnum space, const GradientStop* stops, size_t count,
+	const RgbParams& params = get_rgb_params());
+
+/*!
+	\brief Color of a gradient
+	\details Positions before the first and after the last stop take their colors.
+	\param[in] gradient - gradient
+	\param[in] position - position in 0..1.0 range
+	\param[out] rgb - color in 0..1.0 range
+*/
+void get_gradient_color(const Gradient& gradient, double position, double rgb[3]);
+
+/*!
+	\brief Bake a gradient into a lookup table
+	\param[in] gradient - gradient
+	\param[in] size - number of entries, usually 256 or 4096
+	\param[in] low - sample value mapped to position 0
+	\param[in] high - sample value mapped to position 1.0
+	\return lookup table, empty if size < 2 or the gradient has no stops
+*/
+GradientLut bake_gradient(const Gradient& gradient, size_t size = 256, double low = 0.0, double high = 1.0);
+
+/*!
+    \brief Batch mapping of float samples to 8-bit RGB through a baked gradient
+	\details Samples take the nearest entry, out of range and NaN samples the end ones.
+    \param[in] src - samples
+    \param[out] dst - interleaved RGB, 3 * count bytes
+    \param[in] count - number of samples
+	\param[in] lut - baked gradient
+*/
+void map_gradient(const float* src, unsigned char* dst, size_t count, const GradientLut& lut);
+
+/*!
+    \brief Batch mapping of float samples to float RGB through a baked gradient
+    \param[in] src - samples
+    \param[out] dst - interleaved RGB, 3 * count floats
+    \param[in] count - number of samples
+	\param[in] lut - baked gradient
+*/
+void map_gradient(const float* src, float* dst, size_t count, const GradientLut& lut);
+
+/*!
+    \brief Batch mapping of integer samples to 8-bit RGB through a baked gradient
+	\details Code c is the sample value c / (2^bit_depth - 1), so Low = 0 and High = 1.0
+		span the full code range.
+    \param[in] src - samples in 0..2^bit_depth-1
+    \param[out] dst - interleaved RGB, 3 * count bytes
+    \param[in] count - number of samples
+	\param[in] lut - baked gradient
+	\param[in] bit_depth - 8..16 bits per sample
+*/
+void map_gradient(const unsigned short* src, unsigned char* dst, size_t count, const GradientLut& lut,
+	int bit_depth = 16);
+
+}
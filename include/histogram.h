@@ -0,0 +1,99 @@
+/*!
+\file histogram.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rgb.h"
+
+namespace colorpp
+{
+
+/*!
+	\brief Histogram channel spaces enum
+	\details Channels are binned uniformly over their range: HSV, HSL and RGB as
+		the rgb256 conversions compute them (i.e. 256 RGB bins are the codes and 361
+		hue bins are the word360 hues), L* over 0..100, a* and b* over -128..128
+		relative to the reference white of the RGB parameters.
+*/
+enum class HistogramEnum
+{
+	Rgb = 0,	// encoded R, G and B
+	Hsv = 1,	// H, S and V
+	Hsl = 2,	// H, S and L
+	Lab = 3	// CIE L*, a* and b*
+};
+
+/*!
+	\brief Hue averaging methods enum
+*/
+enum class HueMeanEnum
+{
+	Arithmetic = 0,	// mean of the hues in 0..1.0, red hues on both ends pull it to cyan
+	Circular = 1	// direction of the mean hue vector
+};
+
+/*!
+	\brief Moment statistics of an image
+*/
+typedef struct _ColorStats
+{
+	double Mean[3];	// mean RGB in 0..1.0 range, averaged in linear light and encoded again
+	double LinearMean[3];	// mean linear RGB
+	double LinearStdDev[3];	// standard deviation of linear RGB
+	double Luminance;	// mean relative luminance Y
+	double Hue;	// mean HSV hue of the chromatic pixels in 0..1.0 range
+	double HueSpread;	// standard deviation of the hues or 1 - length of the mean hue vector
+	double Saturation;	// mean HSV saturation
+	size_t Chromatic;	// number of pixels with a hue (saturation > 0)
+} ColorStats;
+
+/*!
+	\brief Batch histograms of the channels
+	\details Every thread counts its part of the pixels into private bins, merged at
+		the end, so there are no atomic operations.
+	\param[in] src - RGB pixels, 3 * count bytes
+	\param[in] count - number of pixels
+	\param[out] hist - 3 * bins counts, bins of the first channel first
+	\param[in] bins - number of bins per channel
+	\param[in] space - channel space (see HistogramEnum)
+	\param[in] params - RGB ColorSpace parameters (Lab)
+*/
+void get_channel_histograms(const unsigned char* src, size_t count, uint64_t* hist, size_t bins,
+	HistogramEnum space = HistogramEnum::Hsv, const RgbParams& params = get_rgb_params());
+
+/*!
+	\brief Batch 3D histogram of quantized colors
+	\details Bin (i, j, k) of the channels is hist[(i << 2 * bits) | (j << bits) | k], the
+		bins are counted as in get_channel_histograms.
+	\param[in] src - RGB pixels, 3 * count bytes
+	\param[in] count - number of pixels
+	\param[out] hist - 2^(3 * bits) counts
+	\param[in] bits - bits per channel, 1..6
+	\param[in] space - channel space (see HistogramEnum)
+	\param[in] params - RGB ColorSpace parameters (Lab)
+*/
+void get_histogram_3d(const unsigned char* src, size_t count, uint64_t* hist, int bits,
+	HistogramEnum space = HistogramEnum::Rgb, const RgbParams& params = get_rgb_params());
+
+/*!
+	\brief Moment statistics of an image
+	\details Channels are linearized with the transfer function of the RGB parameters,
+		so the mean color doesn't darken like the mean of the encoded values. Achromatic
+		pixels have no hue and don't take part in the hue mean. Pixels are summed in
+		fixed blocks in parallel, the results don't depend on the thread count.
+	\param[in] src - RGB pixels, 3 * count bytes
+	\param[in] count - number of pixels
+	\param[in] hue_mean - hue averaging method (see HueMeanEnum)
+	\param[in] params - RGB ColorSpace parameters
+	\return statistics, zeros if count is 0
+*/
+ColorStats get_color_stats(const unsigned char* src, size_t count,
+	HueMeanEnum hue_mean = HueMeanEnum::Circular, const RgbParams& params = get_rgb_params());
+
+}
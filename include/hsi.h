@@ -0,0 +1,65 @@
+/*!
+\file hsi.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace colorpp
+{
+
+/*
+	HSI as defined in computer vision (Gonzalez & Woods): the intensity is the mean of
+	the channels, the saturation 1 - min / I and the hue the angle of the color in the
+	chromaticity plane, starting at red. Unlike the hexcone hues of HSV and HSL it is
+	a true angle. The model isn't a cube: high saturations at high intensities are
+	out of the RGB gamut.
+*/
+
+/*!
+    \brief Conversion from RGB to HSI color model
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] h - hue channel in 0..1.0 range, 0 for grays
+  	\param[out] s - saturation channel in 0..1.0 range
+  	\param[out] i - intensity channel in 0..1.0 range
+*/
+void rgb_to_hsi(double r, double g, double b,
+	double& h, double& s, double& i);
+
+/*!
+    \brief Conversion from HSI to RGB color model
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] s - saturation channel in 0..1.0 range
+  	\param[in] i - intensity channel in 0..1.0 range
+    \param[out] r - red channel, out of gamut colors are out of 0..1.0 range
+	\param[out] g - green channel, out of gamut colors are out of 0..1.0 range
+ 	\param[out] b - blue channel, out of gamut colors are out of 0..1.0 range
+*/
+void hsi_to_rgb(double h, double s, double i,
+	double& r, double& g, double& b);
+
+/*!
+    \brief Batch conversion from RGB to HSI color model
+	\details The hue angle comes from a polynomial arctangent (error below 1e-7 turns)
+		instead of std::atan2 so the loop vectorizes.
+    \param[in] src - RGB in 0..1.0 range, 3 * count floats
+    \param[out] dst - HSI in 0..1.0 range, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void rgb_to_hsi(const float* src, float* dst, size_t count);
+
+/*!
+    \brief Batch conversion from HSI to RGB color model
+	\details Polynomial sine and cosine, as in rgb_to_hsi.
+    \param[in] src - HSI in 0..1.0 range, 3 * count floats
+    \param[out] dst - RGB clamped to 0..1.0, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void hsi_to_rgb(const float* src, float* dst, size_t count);
+
+}
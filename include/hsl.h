@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace colorpp 
 {
 
@@ -33,5 +35,25 @@ void rgb_to_hsl(double r, double g, double b,
 void hsl_to_rgb(double h, double s, double l,
 	double& r, double& g, double& b);
 
-}
+/*!
+    \brief Conversion from HSV to HSL color model
+	\details Closed form without an RGB intermediate, the hue is kept as is.
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] s - saturation channel in 0..1.0 range
+  	\param[in] v - value channel in 0..1.0 range
+ 	\param[out] hl - hue channel in 0..1.0 range
+  	\param[out] sl - saturation channel in 0..1.0 range
+  	\param[out] l - lightness channel in 0..1.0 range
+*/
+void hsv_to_hsl(double h, double s, double v,
+	double& hl, double& sl, double& l);
 
+/*!
+    \brief Batch conversion from HSV to HSL color model
+    \param[in] src - HSV in 0..1.0 range, 3 * count floats
+    \param[out] dst - HSL in 0..1.0 range, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void hsv_to_hsl(const float* src, float* dst, size_t count);
+
+}
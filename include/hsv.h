@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace colorpp 
 {
 
@@ -33,5 +35,25 @@ void rgb_to_hsv(double r, double g, double b,
 void hsv_to_rgb(double h, double s, double v, 
 	double& r, double& g, double& b);
 
-}
+/*!
+    \brief Conversion from HSL to HSV color model
+	\details Closed form without an RGB intermediate, the hue is kept as is.
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] s - saturation channel in 0..1.0 range
+  	\param[in] l - lightness channel in 0..1.0 range
+ 	\param[out] hv - hue channel in 0..1.0 range
+  	\param[out] sv - saturation channel in 0..1.0 range
+  	\param[out] v - value channel in 0..1.0 range
+*/
+void hsl_to_hsv(double h, double s, double l,
+	double& hv, double& sv, double& v);
 
+/*!
+    \brief Batch conversion from HSL to HSV color model
+    \param[in] src - HSL in 0..1.0 range, 3 * count floats
+    \param[out] dst - HSV in 0..1.0 range, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void hsl_to_hsv(const float* src, float* dst, size_t count);
+
+}
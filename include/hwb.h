@@ -0,0 +1,82 @@
+/*!
+\file hwb.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace colorpp
+{
+
+/*!
+    \brief Conversion from RGB to HWB color model (CSS Color 4)
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] h - hue channel in 0..1.0 range, the HSV hue
+  	\param[out] w - whiteness channel in 0..1.0 range
+  	\param[out] b_ - blackness channel in 0..1.0 range
+*/
+void rgb_to_hwb(double r, double g, double b,
+	double& h, double& w, double& b_);
+
+/*!
+    \brief Conversion from HWB to RGB color model (CSS Color 4)
+	\details Whiteness and blackness with a sum above 1.0 are scaled down to it, i.e.
+		the color is the gray w / (w + b).
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] w - whiteness channel in 0..1.0 range
+  	\param[in] b_ - blackness channel in 0..1.0 range
+    \param[out] r - red channel in 0..1.0 range
+	\param[out] g - green channel in 0..1.0 range
+ 	\param[out] b - blue channel in 0..1.0 range
+*/
+void hwb_to_rgb(double h, double w, double b_,
+	double& r, double& g, double& b);
+
+/*!
+    \brief Conversion from HSV to HWB color model
+	\details Closed form without an RGB intermediate, the hue is kept as is.
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] s - saturation channel in 0..1.0 range
+  	\param[in] v - value channel in 0..1.0 range
+ 	\param[out] hw - hue channel in 0..1.0 range
+  	\param[out] w - whiteness channel in 0..1.0 range
+  	\param[out] b - blackness channel in 0..1.0 range
+*/
+void hsv_to_hwb(double h, double s, double v,
+	double& hw, double& w, double& b);
+
+/*!
+    \brief Conversion from HWB to HSV color model
+	\details Closed form without an RGB intermediate, the hue is kept as is.
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] w - whiteness channel in 0..1.0 range
+  	\param[in] b - blackness channel in 0..1.0 range
+ 	\param[out] hv - hue channel in 0..1.0 range
+  	\param[out] s - saturation channel in 0..1.0 range
+  	\param[out] v - value channel in 0..1.0 range
+*/
+void hwb_to_hsv(double h, double w, double b,
+	double& hv, double& s, double& v);
+
+/*!
+    \brief Batch conversion from RGB to HWB color model
+    \param[in] src - RGB in 0..1.0 range, 3 * count floats
+    \param[out] dst - HWB in 0..1.0 range, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void rgb_to_hwb(const float* src, float* dst, size_t count);
+
+/*!
+    \brief Batch conversion from HWB to RGB color model
+    \param[in] src - HWB in 0..1.0 range, 3 * count floats
+    \param[out] dst - RGB in 0..1.0 range, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void hwb_to_rgb(const float* src, float* dst, size_t count);
+
+}
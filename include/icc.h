@@ -0,0 +1,105 @@
+/*!
+\file icc.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rgb.h"
+
+namespace colorpp
+{
+
+/*!
+	\brief Number of intervals of the sampled tone reproduction curves
+*/
+const size_t IccLutSize = 4096;
+
+/*!
+	\brief Compiled ICC v2/v4 RGB matrix/TRC profile
+	\details Params holds the colorant matrices with the PCS (D50) white as RefWhiteRGB
+		and RefWhite, so XYZ is PCS relative and set_ref_white works as usual.
+		When the TRCs are a pure gamma or sRGB, Params.TransferRGB carries them and
+		UseGamma is true; otherwise Params.GammaRGB is 1 (linear) and the curves are
+		sampled into ToLinear/ToEncoded on IccLutSize + 1 points.
+*/
+typedef struct _IccTransform
+{
+	RgbParams Params;
+	bool UseGamma;
+	std::vector<double> ToLinear[3];
+	std::vector<double> ToEncoded[3];
+	XYZ MediaWhite;	// wtpt tag
+	uint64_t Hash;	// hash of the profile data up to its declared size, finds the cache entries
+} IccTransform;
+
+/*!
+	\brief Parse an ICC matrix/TRC profile and compile the transform (not cached)
+	\param[in] data - profile data
+	\param[in] size - size of the data in bytes
+	\param[out] transform - compiled transform
+	\return false if the data is not an RGB matrix/TRC profile
+*/
+bool parse_icc_profile(const unsigned char* data, size_t size, IccTransform& transform);
+
+/*!
+	\brief Get the compiled transform of an in-memory ICC profile
+	\details Transforms are cached by the profile data up to its declared size, so profiles
+		embedded into many images are parsed and compiled only once.
+	\param[in] data - profile data
+	\param[in] size - size of the data in bytes
+	\return compiled transform or nullptr if the data is not an RGB matrix/TRC profile
+*/
+std::shared_ptr<const IccTransform> get_icc_transform(const unsigned char* data, size_t size);
+
+/*!
+	\brief Load an ICC profile file and get its compiled transform (see get_icc_transform)
+	\param[in] path - path of the local profile file
+	\return compiled transform or nullptr if the file can't be read or parsed
+*/
+std::shared_ptr<const IccTransform> load_icc_profile(const char* path);
+
+/*!
+	\brief Drop all the cached ICC transforms
+*/
+void clear_icc_cache();
+
+/*!
+	\brief Get the number of cached ICC transforms
+	\return number of transforms
+*/
+size_t get_icc_cache_size();
+
+/*!
+    \brief Conversion from profile RGB to XYZ color model
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] x - x channel in 0..1.0 range
+  	\param[out] y - y channel in 0..1.0 range
+  	\param[out] z - z channel in 0..1.0 range
+	\param[in] transform - compiled ICC transform
+*/
+void icc_rgb_to_xyz(double r, double g, double b,
+	double& x, double& y, double& z, const IccTransform& transform);
+
+/*!
+    \brief Conversion from XYZ to profile RGB color model
+	\param[in] x - x channel in 0..1.0 range
+  	\param[in] y - y channel in 0..1.0 range
+  	\param[in] z - z channel in 0..1.0 range
+    \param[out] r - red channel in 0..1.0 range
+	\param[out] g - green channel in 0..1.0 range
+ 	\param[out] b - blue channel in 0..1.0 range
+	\param[in] transform - compiled ICC transform
+*/
+void icc_xyz_to_rgb(double x, double y, double z,
+	double& r, double& g, double& b, const IccTransform& transform);
+
+}
@@ -0,0 +1,148 @@
+/*!
+\file jobs.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <utility>
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#include <coroutine>
+#define COLORPP_COROUTINES 1
+#endif
+
+namespace colorpp
+{
+
+namespace detail
+{
+
+/*!
+	\brief Queue a task on the job scheduler
+	\param[in] task - task function
+*/
+void submit_task(std::function<void()> task);
+
+/*!
+	\brief Queue a range job on the job scheduler
+	\param[in] count - number of items
+	\param[in] grain - minimal number of items in a part
+	\param[in] fn - part function, called as fn(begin, end)
+	\param[in] done - called once after the last part
+*/
+void submit_range(size_t count, size_t grain, std::function<void(size_t, size_t)> fn,
+	std::function<void()> done);
+
+}
+
+/*!
+	\brief Set the number of job scheduler threads
+	\details Waits for the queued jobs before the restart; jobs must not be
+		submitted concurrently with the call.
+	\param[in] count - number of threads (0 - hardware concurrency)
+*/
+void set_job_thread_count(unsigned count);
+
+/*!
+	\brief Get the number of job scheduler threads
+	\return number of threads
+*/
+unsigned get_job_thread_count();
+
+/*!
+	\brief Submit a job to the work stealing scheduler
+	\details Workers take queued jobs in small batches, so thousands of tiny jobs
+		cost one queue lock per batch. Batch kernels called from a job run serially
+		on the job thread. Don't wait for other jobs' futures inside a job.
+	\param[in] fn - job function
+	\return future of the job result
+*/
+template<typename F>
+auto submit(F&& fn) -> std::future<decltype(fn())>
+{
+	typedef decltype(fn()) Result;
+	auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(fn));
+	auto result = task->get_future();
+	detail::submit_task([task] { (*task)(); });
+	return result;
+}
+
+/*!
+	\brief Submit a range job split into parts over the scheduler threads
+	\details Ranges up to grain items are queued as a single job, larger ones are
+		split into a few parts per thread which idle workers steal.
+	\param[in] count - number of items
+	\param[in] grain - minimal number of items in a part
+	\param[in] fn - part function, called as fn(begin, end), must not throw
+	\return future that is ready when all the parts are done
+*/
+inline std::future<void> submit(size_t count, size_t grain, std::function<void(size_t, size_t)> fn)
+{
+	auto promise = std::make_shared<std::promise<void>>();
+	auto result = promise->get_future();
+	detail::submit_range(count, grain, std::move(fn), [promise] { promise->set_value(); });
+	return result;
+}
+
+#ifdef COLORPP_COROUTINES
+
+/*!
+	\brief Awaitable moving a coroutine onto a scheduler thread
+*/
+struct JobAwaitable
+{
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<> handle) const
+	{
+		detail::submit_task([handle] { handle.resume(); });
+	}
+	void await_resume() const noexcept {}
+};
+
+/*!
+	\brief Awaitable running a range job, the coroutine resumes on the thread of the last part
+*/
+struct RangeAwaitable
+{
+	size_t count;
+	size_t grain;
+	std::function<void(size_t, size_t)> fn;
+
+	bool await_ready() const noexcept { return count == 0; }
+	void await_suspend(std::coroutine_handle<> handle)
+	{
+		detail::submit_range(count, grain, std::move(fn), [handle] { handle.resume(); });
+	}
+	void await_resume() const noexcept {}
+};
+
+/*!
+	\brief co_await schedule() continues the coroutine on a scheduler thread
+	\return awaitable
+*/
+inline JobAwaitable schedule()
+{
+	return JobAwaitable();
+}
+
+/*!
+	\brief co_await submit_async(count, grain, fn) runs a range job without blocking a thread
+	\param[in] count - number of items
+	\param[in] grain - minimal number of items in a part
+	\param[in] fn - part function, called as fn(begin, end), must not throw
+	\return awaitable
+*/
+inline RangeAwaitable submit_async(size_t count, size_t grain, std::function<void(size_t, size_t)> fn)
+{
+	return RangeAwaitable{count, grain, std::move(fn)};
+}
+
+#endif
+
+}
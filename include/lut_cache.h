@@ -0,0 +1,85 @@
+/*!
+\file lut_cache.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace colorpp
+{
+
+/*!
+	\brief Table read from the cache or just built
+*/
+typedef struct _CachedTable
+{
+	const unsigned char* Data;	// nullptr if there is no table
+	size_t Size;	// size in bytes
+	bool IsMapped;	// true if the pages are mapped from a cache file
+	std::shared_ptr<const void> Holder;	// keeps the mapping or the memory alive
+} CachedTable;
+
+/*!
+	\brief Set the directory of the table cache
+	\details The cache is off by default, unless the COLORPP_LUT_CACHE environment
+		variable names a directory. Files of the directory are shared by processes:
+		every process maps the same read-only pages.
+	\param[in] dir - existing directory, empty to turn the cache off
+	\return false if the directory isn't writable (the cache is turned off)
+*/
+bool set_lut_cache_dir(const std::string& dir);
+
+/*!
+	\brief Get the directory of the table cache
+	\return directory, empty if the cache is off
+*/
+std::string get_lut_cache_dir();
+
+/*!
+	\brief Get the cache file name of a table
+	\param[in] key - parameters of the table, for example "color_lut/RgbToHsv"
+	\return file name in the cache directory, empty if the cache is off
+*/
+std::string get_lut_cache_path(const std::string& key);
+
+/*!
+	\brief Map a table from the cache read-only
+	\details The file is checked for the format version, byte order, build of the library
+		that wrote it (version, compiler and instruction sets), key, size and checksum
+		of the payload.
+	\param[in] key - parameters of the table
+	\param[in] size - expected size in bytes
+	\return table, without data if the file is missing or invalid
+*/
+CachedTable load_cached_table(const std::string& key, size_t size);
+
+/*!
+	\brief Store a table in the cache
+	\details The file is written under a temporary name and renamed, so readers
+		never see a partial file.
+	\param[in] key - parameters of the table
+	\param[in] data - table
+	\param[in] size - size in bytes
+	\return false if the cache is off or the file can't be written
+*/
+bool store_cached_table(const std::string& key, const void* data, size_t size);
+
+/*!
+	\brief Get a table from the cache, or build it and store it
+	\details Without the cache, or if the file is invalid or can't be written, the
+		table is built in memory, so the result doesn't depend on the cache state.
+	\param[in] key - parameters of the table
+	\param[in] size - size in bytes
+	\param[in] build - fills size bytes of the table
+	\return table
+*/
+CachedTable get_cached_table(const std::string& key, size_t size,
+	const std::function<void(unsigned char*)>& build);
+
+}
@@ -0,0 +1,112 @@
+/*!
+\file oklab.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace colorpp
+{
+
+/*
+	Oklab and Oklch are defined on sRGB (D65). Channels are kept in 0..1.0 range
+	like the other models: L as is, a and b as 0.5 + a / 0.8 (0.5 is neutral, 0 and
+	1.0 are -0.4 and 0.4, the 100% of CSS Color 4), C as C / 0.4 and the hue in turns.
+*/
+
+/*!
+    \brief Conversion from sRGB to Oklab color model
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] l - lightness channel in 0..1.0 range
+  	\param[out] a - green-red channel in 0..1.0 range (0.5 is neutral)
+  	\param[out] b_ - blue-yellow channel in 0..1.0 range (0.5 is neutral)
+*/
+void rgb_to_oklab(double r, double g, double b,
+	double& l, double& a, double& b_);
+
+/*!
+    \brief Conversion from Oklab to sRGB color model
+ 	\param[in] l - lightness channel in 0..1.0 range
+  	\param[in] a - green-red channel in 0..1.0 range (0.5 is neutral)
+  	\param[in] b_ - blue-yellow channel in 0..1.0 range (0.5 is neutral)
+    \param[out] r - red channel, out of gamut colors are out of 0..1.0 range
+	\param[out] g - green channel, out of gamut colors are out of 0..1.0 range
+ 	\param[out] b - blue channel, out of gamut colors are out of 0..1.0 range
+*/
+void oklab_to_rgb(double l, double a, double b_,
+	double& r, double& g, double& b);
+
+/*!
+    \brief Conversion from Oklab to Oklch color model
+ 	\param[in] l - lightness channel in 0..1.0 range
+  	\param[in] a - green-red channel in 0..1.0 range (0.5 is neutral)
+  	\param[in] b - blue-yellow channel in 0..1.0 range (0.5 is neutral)
+ 	\param[out] l_ - lightness channel in 0..1.0 range
+  	\param[out] c - chroma channel in 0..1.0 range
+  	\param[out] h - hue channel in 0..1.0 range, 0 for neutral colors
+*/
+void oklab_to_oklch(double l, double a, double b,
+	double& l_, double& c, double& h);
+
+/*!
+    \brief Conversion from Oklch to Oklab color model
+ 	\param[in] l - lightness channel in 0..1.0 range
+  	\param[in] c - chroma channel in 0..1.0 range
+  	\param[in] h - hue channel in 0..1.0 range
+ 	\param[out] l_ - lightness channel in 0..1.0 range
+  	\param[out] a - green-red channel in 0..1.0 range (0.5 is neutral)
+  	\param[out] b - blue-yellow channel in 0..1.0 range (0.5 is neutral)
+*/
+void oklch_to_oklab(double l, double c, double h,
+	double& l_, double& a, double& b);
+
+/*!
+    \brief Batch conversion from sRGB to Oklab color model
+	\details Decoded with the sRGB table of inv_compand, the cube root is computed
+		with Halley iterations instead of std::cbrt so the loop vectorizes.
+    \param[in] src - sRGB in 0..1.0 range, 3 * count floats
+    \param[out] dst - Oklab channels, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void rgb_to_oklab(const float* src, float* dst, size_t count);
+
+/*!
+    \brief Batch conversion from 8-bit sRGB to Oklab color model
+	\details Codes are decoded through a 256-entry table, both matrices and the cube
+		root run in the same pass.
+    \param[in] src - sRGB codes (value / 255), 3 * count bytes
+    \param[out] dst - Oklab channels, 3 * count floats
+    \param[in] count - number of pixels
+*/
+void rgb_to_oklab(const unsigned char* src, float* dst, size_t count);
+
+/*!
+    \brief Batch conversion from Oklab to sRGB color model
+    \param[in] src - Oklab channels, 3 * count floats
+    \param[out] dst - sRGB clamped to 0..1.0, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void oklab_to_rgb(const float* src, float* dst, size_t count);
+
+/*!
+    \brief Batch conversion from Oklab to Oklch color model
+    \param[in] src - Oklab channels, 3 * count floats
+    \param[out] dst - Oklch channels, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void oklab_to_oklch(const float* src, float* dst, size_t count);
+
+/*!
+    \brief Batch conversion from Oklch to Oklab color model
+    \param[in] src - Oklch channels, 3 * count floats
+    \param[out] dst - Oklab channels, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void oklch_to_oklab(const float* src, float* dst, size_t count);
+
+}
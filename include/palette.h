@@ -0,0 +1,75 @@
+/*!
+\file palette.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "color.h"
+
+namespace colorpp
+{
+
+/*!
+	\brief Palette extraction methods enum
+*/
+enum class PaletteEnum
+{
+	MedianCut = 0,	// boxes of the RGB histogram split at the median of the widest channel
+	KMeans = 1	// k-means in CIE L*a*b* with k-means++ seeding
+};
+
+/*!
+	\brief Palette extraction parameters
+*/
+typedef struct _PaletteParams
+{
+	PaletteEnum Method;
+	size_t Colors;	// maximum number of colors
+	int HistogramBits;	// bits per channel of the RGB histogram, 1..6
+	int MaxIterations;	// k-means iterations
+	double Tolerance;	// k-means stops when no center moves further (Delta E 1976)
+	unsigned Seed;	// k-means++ seeding
+	RgbParams Params;	// RGB color space of the pixels (k-means)
+} PaletteParams;
+
+/*!
+	\brief Color of a palette
+*/
+typedef struct _PaletteColor
+{
+	rgb256 Rgb;
+	hsv360_100 Hsv;
+	size_t Population;	// number of pixels
+} PaletteColor;
+
+/*!
+	\brief Get palette extraction parameters
+	\details 5 histogram bits, 20 k-means iterations, Delta E 0.1 tolerance, sRGB.
+	\param[in] method - extraction method (see PaletteEnum)
+	\param[in] colors - maximum number of colors
+	\return parameters
+*/
+PaletteParams get_palette_params(PaletteEnum method = PaletteEnum::KMeans, size_t colors = 8);
+
+/*!
+	\brief Extract the dominant colors of an image
+	\details Both methods work on the histogram of the pixels quantized to HistogramBits
+		per channel, built in parallel with private bins per thread, so their cost
+		hardly depends on the image size. Every histogram bin is represented by the mean
+		of its pixels. The k-means assignment steps run in parallel, the iterations stop
+		when the centers settle. The results are deterministic for the same parameters.
+	\param[in] src - RGB pixels, 3 * count bytes
+	\param[in] count - number of pixels
+	\param[in] params - extraction parameters
+	\return colors ordered by population, fewer than params.Colors if the image has fewer
+		distinct histogram bins
+*/
+std::vector<PaletteColor> get_palette(const unsigned char* src, size_t count,
+	const PaletteParams& params = get_palette_params());
+
+}
@@ -0,0 +1,39 @@
+/*!
+\file parallel.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace colorpp
+{
+
+/*!
+	\brief Set the number of threads used by the batch kernels
+	\param[in] count - number of threads including the calling one (0 - hardware concurrency)
+*/
+void set_thread_count(unsigned count);
+
+/*!
+	\brief Get the number of threads used by the batch kernels
+	\return number of threads including the calling one
+*/
+unsigned get_thread_count();
+
+/*!
+	\brief Run fn over [0, count) split into chunks on the library threads
+	\details The calling thread takes part in the work and returns when all chunks
+		are done. Nested calls from inside fn run serially on the current thread.
+		If fn throws, the remaining chunks are skipped and the first exception is
+		rethrown on the calling thread after all threads have left fn.
+	\param[in] count - number of items
+	\param[in] grain - minimal number of items in a chunk
+	\param[in] fn - chunk function, called as fn(begin, end)
+*/
+void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+}
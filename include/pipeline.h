@@ -0,0 +1,93 @@
+/*!
+\file pipeline.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "adjust.h"
+#include "rgb.h"
+
+namespace colorpp
+{
+
+/*!
+	\brief Stage of a conversion pipeline
+	\details Converts count pixels of 3 floats from src to dst; src and dst may alias.
+*/
+typedef std::function<void(const float* src, float* dst, size_t count)> PipelineStage;
+
+/*!
+	\brief Multi-stage conversion
+*/
+typedef struct _Pipeline
+{
+	std::vector<PipelineStage> Stages;	// applied in order
+	size_t StripPixels;	// pixels run through all the stages at once, 0 - tuned to the cache
+} Pipeline;
+
+/*!
+	\brief Get the strip size tuned to the cache
+	\details A strip of 3-float pixels fills half of the L2 cache of a core, so the
+		intermediate results of the stages stay in the cache.
+	\return number of pixels
+*/
+size_t get_strip_pixels();
+
+/*!
+	\brief Stage converting encoded RGB to XYZ
+	\details Same as rgb_to_xyz: decoding, the RGB matrix and the adaptation matrix,
+		the matrices fused into one. Channels are clamped to 0..1.0 before decoding.
+	\param[in] params - RGB ColorSpace parameters
+	\return stage
+*/
+PipelineStage get_rgb_to_xyz_stage(const RgbParams& params = get_rgb_params());
+
+/*!
+	\brief Stage converting XYZ to encoded RGB
+	\details Same as xyz_to_rgb, out of gamut channels are clamped to 0..1.0.
+	\param[in] params - RGB ColorSpace parameters
+	\return stage
+*/
+PipelineStage get_xyz_to_rgb_stage(const RgbParams& params = get_rgb_params());
+
+/*!
+	\brief Stage converting XYZ to CIE L*a*b*
+	\param[in] white - reference white
+	\return stage, L* in 0..100 range
+*/
+PipelineStage get_xyz_to_lab_stage(const XYZ white);
+
+/*!
+	\brief Stage converting CIE L*a*b* to XYZ
+	\param[in] white - reference white
+	\return stage
+*/
+PipelineStage get_lab_to_xyz_stage(const XYZ white);
+
+/*!
+	\brief Stage adjusting RGB (see adjust)
+	\param[in] params - adjustment parameters
+	\return stage
+*/
+PipelineStage get_adjust_stage(const AdjustParams& params);
+
+/*!
+	\brief Run the stages of a pipeline strip by strip
+	\details Every strip goes through all the stages before the next one, the strips
+		run in parallel on the library threads. Intermediate results stay in the
+		destination strip in the cache instead of streaming the whole frame through
+		memory once per stage. Stages are called from the library threads.
+	\param[in] pipeline - stages and strip size
+	\param[in] src - source pixels, 3 * count floats
+	\param[out] dst - converted pixels, 3 * count floats (may alias src)
+	\param[in] count - number of pixels
+*/
+void run_pipeline(const Pipeline& pipeline, const float* src, float* dst, size_t count);
+
+}
@@ -0,0 +1,114 @@
+/*!
+\file planar.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include "ycbcr.h"
+
+namespace colorpp
+{
+
+/*!
+	\brief Chroma subsampled planar YCbCr formats enum
+*/
+enum class PlanarEnum
+{
+	I420 = 0,	// 8-bit 4:2:0, Y plane, Cb plane, Cr plane
+	NV12 = 1,	// 8-bit 4:2:0, Y plane, interleaved CbCr plane
+	P010 = 2,	// 10-bit 4:2:0 in the high bits of 16-bit words, Y plane, interleaved CbCr plane
+	I422 = 3	// 8-bit 4:2:2, Y plane, Cb plane, Cr plane
+};
+
+/*!
+	\brief Planar YCbCr frame description
+	\details Chroma is MPEG-2 sited: horizontally co-sited with even luma columns,
+		vertically centered between luma rows for 4:2:0. Strides are in bytes.
+		planes[2] is unused for interleaved chroma formats.
+*/
+typedef struct _PlanarFrame
+{
+	PlanarEnum Format;
+	size_t Width;
+	size_t Height;
+	unsigned char* Planes[3];
+	size_t Strides[3];
+} PlanarFrame;
+
+/*!
+	\brief Get the size of a tightly packed planar frame
+	\param[in] format - planar format (see PlanarEnum)
+	\param[in] width - frame width in pixels
+	\param[in] height - frame height in pixels
+	\return size in bytes
+*/
+size_t get_planar_size(PlanarEnum format, size_t width, size_t height);
+
+/*!
+	\brief Describe a tightly packed planar frame placed in a single buffer
+	\param[in] format - planar format (see PlanarEnum)
+	\param[in] width - frame width in pixels
+	\param[in] height - frame height in pixels
+	\param[in] data - buffer of get_planar_size(format, width, height) bytes
+	\return frame description
+*/
+PlanarFrame get_planar_frame(PlanarEnum format, size_t width, size_t height, unsigned char* data);
+
+/*!
+    \brief Conversion from an 8-bit planar frame to interleaved 8-bit RGB
+	\details Chroma upsampling is fused into the conversion loop; rows are
+		processed in parallel on the library threads (see parallel.h).
+    \param[in] frame - source frame (I420, NV12 or I422)
+    \param[out] rgb - destination pixels
+    \param[in] rgb_stride - destination row stride in bytes
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the source (see RangeEnum)
+	\return false if the frame format does not match the sample type
+*/
+bool planar_to_rgb(const PlanarFrame& frame, unsigned char* rgb, size_t rgb_stride,
+	YCbCrEnum matrix = YCbCrEnum::Bt709, RangeEnum range = RangeEnum::Limited);
+
+/*!
+    \brief Conversion from a P010 frame to interleaved 10-bit RGB
+    \param[in] frame - source frame (P010)
+    \param[out] rgb - destination pixels in 0..1023
+    \param[in] rgb_stride - destination row stride in bytes
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the source (see RangeEnum)
+	\return false if the frame format does not match the sample type
+*/
+bool planar_to_rgb(const PlanarFrame& frame, unsigned short* rgb, size_t rgb_stride,
+	YCbCrEnum matrix = YCbCrEnum::Bt2020, RangeEnum range = RangeEnum::Limited);
+
+/*!
+    \brief Conversion from interleaved 8-bit RGB to an 8-bit planar frame
+	\details Chroma is filtered to its MPEG-2 sites inside the conversion loop: the two
+		rows are averaged, the columns filtered with [1 2 1] around the even ones.
+		Rows are processed in parallel on the library threads.
+    \param[in] rgb - source pixels
+    \param[in] rgb_stride - source row stride in bytes
+    \param[out] frame - destination frame (I420, NV12 or I422)
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the destination (see RangeEnum)
+	\return false if the frame format does not match the sample type
+*/
+bool rgb_to_planar(const unsigned char* rgb, size_t rgb_stride, const PlanarFrame& frame,
+	YCbCrEnum matrix = YCbCrEnum::Bt709, RangeEnum range = RangeEnum::Limited);
+
+/*!
+    \brief Conversion from interleaved 10-bit RGB to a P010 frame
+    \param[in] rgb - source pixels in 0..1023
+    \param[in] rgb_stride - source row stride in bytes
+    \param[out] frame - destination frame (P010)
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the destination (see RangeEnum)
+	\return false if the frame format does not match the sample type
+*/
+bool rgb_to_planar(const unsigned short* rgb, size_t rgb_stride, const PlanarFrame& frame,
+	YCbCrEnum matrix = YCbCrEnum::Bt2020, RangeEnum range = RangeEnum::Limited);
+
+}
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace colorpp 
 {
 
@@ -29,7 +31,22 @@ enum class RgbEnum
 	ProPhotoRgb = 12,
 	SmpteCRgb = 13,
 	sRGB = 14,
-	WideGamutRgb = 15
+	WideGamutRgb = 15,
+	Rec2020Rgb = 16,
+	Rec2100Pq = 17,
+	Rec2100Hlg = 18
+};
+
+/*!
+	\brief Transfer functions (companding) enum
+*/
+enum class TransferEnum
+{
+	Gamma = 0,	// pure power function with the GammaRGB exponent
+	sRGB = 1,	// IEC 61966-2-1
+	LStar = 2,	// CIE L*
+	PQ = 3,	// SMPTE ST 2084, linear 1.0 is 10000 cd/m2
+	HLG = 4	// ARIB STD-B67 (ITU-R BT.2100) OETF, scene linear 0..1.0
 };
 
 /*!
@@ -39,8 +56,10 @@ enum class AdaptationEnum
 {
 	amBradford = 0,
 	amVonKries = 1,
-//	amXYZScaling = 2,
-	amNone = 2
+	amXYZScaling = 2,
+	amCat02 = 3,	// CIECAM02
+	amCat16 = 4,	// CAM16
+	amNone = 5
 };
 
 /*!
@@ -67,15 +86,24 @@ using XYZ = double[3];
 
 /*!
 	\brief RGB ColorSpace parameters
+	\details GammaRGB keeps its legacy coding and selects the SDR curve: the exponent of a pure
+		power curve (> 0), sRGB (< 0) or L* (0). TransferRGB only overrides it with PQ or HLG
+		(see get_transfer); for the other curves it mirrors GammaRGB.
 */
 typedef struct _RgbParams
 {
 	XYZ RefWhiteRGB;
-	double GammaRGB;
+	double GammaRGB;	// gamma (> 0), sRGB (< 0) or L* (0)
+	TransferEnum TransferRGB;	// PQ and HLG, otherwise the curve of GammaRGB
 	Mtx3x3 MtxRGB2XYZ;
 	Mtx3x3 MtxXYZ2RGB;
 	AdaptationEnum AdaptationMethod;
 	XYZ RefWhite; // for adaptation
+	Mtx3x3 MtxAdaptation; // RefWhiteRGB to RefWhite, see update_adaptation
+	Mtx3x3 MtxInvAdaptation; // RefWhite to RefWhiteRGB
+	XYZ AdaptedWhiteRGB; // RefWhiteRGB, RefWhite and AdaptationMethod the matrices were built for
+	XYZ AdaptedWhite;
+	AdaptationEnum AdaptedMethod;
 	
 } RgbParams;
 
@@ -90,6 +118,143 @@ RgbParams get_rgb_params(RgbEnum color_space = RgbEnum::sRGB,
 	AdaptationEnum adaptation = AdaptationEnum::amBradford,
 	IlluminantEnum illuminant = IlluminantEnum::D50);
 
+/*!
+	\brief Create parameters for RGB color space adapted to an arbitrary reference white
+	\param[in] color_space - Color space (see RgbEnum)
+	\param[in] adaptation - Chromatic adaptation method (see AdaptationEnum)
+	\param[in] white - XYZ of the reference white (e.g. from cct_to_white)
+	\return RGB ColorSpace parameters
+*/
+RgbParams get_rgb_params(RgbEnum color_space, AdaptationEnum adaptation, const XYZ& white);
+
+/*!
+	\brief Change the reference white of existing parameters
+	\details Only the adaptation part is touched, so it is cheap to call per frame.
+	\param[in,out] params - RGB ColorSpace parameters
+	\param[in] white - XYZ of the reference white
+*/
+void set_ref_white(RgbParams& params, const XYZ& white);
+
+/*!
+	\brief Recompute the adaptation matrices of parameters
+	\details Conversions rebuild the matrices on every call once RefWhite, RefWhiteRGB or
+		AdaptationMethod differ from the ones they were built for, so call it after changing
+		them directly to keep conversions fast; get_rgb_params and set_ref_white do it themselves.
+	\param[in,out] params - RGB ColorSpace parameters
+*/
+void update_adaptation(RgbParams& params);
+
+/*!
+	\brief Invert a 3x3 matrix
+	\param[in] m - matrix, not singular
+	\param[out] i - inverse matrix
+*/
+void invert_matrix(const Mtx3x3 m, Mtx3x3 i);
+
+/*!
+	\brief Get the combined chromatic adaptation matrix between two whites
+	\param[in] method - Chromatic adaptation method (see AdaptationEnum)
+	\param[in] src_white - XYZ of the source white
+	\param[in] dst_white - XYZ of the destination white
+	\param[out] m - matrix in the library convention (x' = x * m[0][0] + y * m[1][0] + z * m[2][0]),
+		the identity for AdaptationEnum::amNone
+*/
+void get_adaptation_matrix(AdaptationEnum method, const XYZ& src_white, const XYZ& dst_white, Mtx3x3 m);
+
+/*!
+	\brief Get the RefWhiteRGB to RefWhite adaptation matrix of parameters
+	\details MtxAdaptation, or a new matrix if it is stale (see update_adaptation).
+	\param[in] params - RGB ColorSpace parameters
+	\param[out] m - matrix in the library convention
+*/
+void get_adaptation_matrix(const RgbParams& params, Mtx3x3 m);
+
+/*!
+	\brief Get the RefWhite to RefWhiteRGB adaptation matrix of parameters
+	\details MtxInvAdaptation, or a new matrix if it is stale (see update_adaptation).
+	\param[in] params - RGB ColorSpace parameters
+	\param[out] m - matrix in the library convention
+*/
+void get_inv_adaptation_matrix(const RgbParams& params, Mtx3x3 m);
+
+/*!
+    \brief Batch chromatic adaptation of interleaved XYZ
+	\details The cone matrices are combined once, so it costs a 3x3 product per pixel.
+    \param[in] src - source pixels, 3 * count floats
+    \param[out] dst - adapted pixels, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+	\param[in] src_white - XYZ of the source white
+	\param[in] dst_white - XYZ of the destination white
+	\param[in] method - Chromatic adaptation method (see AdaptationEnum)
+*/
+void adapt(const float* src, float* dst, size_t count, const XYZ& src_white, const XYZ& dst_white,
+	AdaptationEnum method = AdaptationEnum::amBradford);
+
+/*!
+	\brief Get the reference white of an illuminant
+	\param[in] illuminant - Illuminant (see IlluminantEnum)
+	\param[out] white - XYZ of the reference white with Y = 1
+*/
+void get_ref_white(IlluminantEnum illuminant, XYZ white);
+
+/*!
+	\brief Get the transfer function of a legacy GammaRGB value
+	\param[in] gamma - gamma (> 0), sRGB (< 0) or L* (0)
+	\return transfer function (see TransferEnum)
+*/
+TransferEnum get_transfer(double gamma);
+
+/*!
+	\brief Get the transfer function of RGB parameters
+	\details TransferRGB when it is PQ or HLG, otherwise the curve of GammaRGB,
+		so code editing GammaRGB only keeps working.
+	\param[in] params - RGB ColorSpace parameters
+	\return transfer function (see TransferEnum)
+*/
+TransferEnum get_transfer(const RgbParams& params);
+
+/*!
+	\brief Encode a linear value with a transfer function
+	\param[in] linear - linear value, negative values are mirrored
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] gamma - exponent of TransferEnum::Gamma
+	\return encoded value
+*/
+double compand(double linear, TransferEnum transfer, double gamma = 2.2);
+
+/*!
+	\brief Decode an encoded value with a transfer function
+	\param[in] companded - encoded value, negative values are mirrored
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] gamma - exponent of TransferEnum::Gamma
+	\return linear value
+*/
+double inv_compand(double companded, TransferEnum transfer, double gamma = 2.2);
+
+/*!
+	\brief Conversion from XYZ to CIE L*a*b*
+	\param[in] x - x channel
+	\param[in] y - y channel
+	\param[in] z - z channel
+	\param[out] l - L* in 0..100 range
+	\param[out] a - a* channel
+	\param[out] b - b* channel
+	\param[in] white - XYZ of the reference white
+*/
+void xyz_to_lab(double x, double y, double z, double& l, double& a, double& b, const XYZ white);
+
+/*!
+	\brief Conversion from CIE L*a*b* to XYZ
+	\param[in] l - L* in 0..100 range
+	\param[in] a - a* channel
+	\param[in] b - b* channel
+	\param[out] x - x channel
+	\param[out] y - y channel
+	\param[out] z - z channel
+	\param[in] white - XYZ of the reference white
+*/
+void lab_to_xyz(double l, double a, double b, double& x, double& y, double& z, const XYZ white);
+
 /*!
     \brief Conversion from RGB to XYZ color model
     \param[in] r - red channel in 0..1.0 range
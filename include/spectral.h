@@ -0,0 +1,104 @@
+/*!
+\file spectral.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "rgb.h"
+
+namespace colorpp
+{
+
+/*!
+	\brief Wavelengths of sampled spectra
+	\details Sample i is taken at Start + i * Step nm.
+*/
+typedef struct _SpectralFormat
+{
+	double Start;	// first wavelength in nm
+	double Step;	// sampling interval in nm
+	size_t Count;	// number of samples
+} SpectralFormat;
+
+/*!
+	\brief Weights of the spectral integration (ASTM E308 style)
+	\details The illuminant SPD multiplied by the CIE 1931 2 degree color matching functions
+		and the sampling interval, so integration is three dot products per spectrum.
+*/
+typedef struct _SpectralWeights
+{
+	SpectralFormat Format;	// sampling of the integrated spectra
+	size_t Stride;	// floats per row, Format.Count rounded up to the vector width
+	std::vector<float> Weights;	// X, Y and Z rows of Stride floats, zero padded
+	XYZ White;	// XYZ of the perfect reflecting diffuser, Y = 1.0
+} SpectralWeights;
+
+/*!
+	\brief Get a spectral format
+	\param[in] start - first wavelength in nm
+	\param[in] step - sampling interval in nm
+	\param[in] count - number of samples
+	\return format, 380..780 nm in 10 nm steps by default
+*/
+SpectralFormat get_spectral_format(double start = 380., double step = 10., size_t count = 41);
+
+/*!
+	\brief Get the relative spectral power distribution of an illuminant
+	\details A is computed from the Planck law, D50..D75 from the CIE daylight basis
+		functions at the chromaticity of the library white, E is flat. B and C are
+		interpolated from the CIE 10 nm tables, F2, F7 and F11 from the 5 nm ones:
+		sample them at 5 nm, coarser formats miss their mercury lines.
+	\param[in] illuminant - Illuminant (see IlluminantEnum)
+	\param[in] format - wavelengths
+	\param[out] spd - format.Count values, 100 at 560 nm
+	\return false for an unknown illuminant
+*/
+bool get_illuminant_spectrum(IlluminantEnum illuminant, const SpectralFormat& format, double* spd);
+
+/*!
+	\brief Get the integration weights of an illuminant
+	\details The rows are scaled so that the perfect reflecting diffuser integrates to the
+		library white of the illuminant exactly (see get_ref_white), the XYZ of reflectances
+		can be passed to xyz_to_rgb with the RGB parameters of the same white.
+	\param[in] illuminant - Illuminant (see IlluminantEnum)
+	\param[in] format - wavelengths of the integrated spectra
+	\param[out] weights - integration weights
+	\return false for an unknown illuminant
+*/
+bool get_spectral_weights(IlluminantEnum illuminant, const SpectralFormat& format, SpectralWeights& weights);
+
+/*!
+	\brief Get the integration weights of a custom illuminant
+	\details The white is the integrated SPD normalized to Y = 1.0.
+	\param[in] spd - relative spectral power distribution, format.Count values
+	\param[in] format - wavelengths of the SPD and the integrated spectra
+	\param[out] weights - integration weights
+	\return false if the SPD has no luminance
+*/
+bool get_spectral_weights(const double* spd, const SpectralFormat& format, SpectralWeights& weights);
+
+/*!
+	\brief Reflectance spectrum to XYZ
+	\param[in] spectrum - reflectance factors in 0..1.0 range, weights.Format.Count values
+	\param[out] xyz - XYZ, Y of the perfect reflecting diffuser is 1.0
+	\param[in] weights - integration weights
+*/
+void spectrum_to_xyz(const double* spectrum, XYZ xyz, const SpectralWeights& weights);
+
+/*!
+	\brief Batch reflectance spectra to XYZ
+	\details Every spectrum takes three dot products, accumulated in independent lanes so
+		the compiler vectorizes them; spectra are integrated in parallel.
+	\param[in] src - count spectra of weights.Format.Count floats each
+	\param[out] dst - XYZ, 3 * count floats
+	\param[in] count - number of spectra
+	\param[in] weights - integration weights
+*/
+void spectrum_to_xyz(const float* src, float* dst, size_t count, const SpectralWeights& weights);
+
+}
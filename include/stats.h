@@ -0,0 +1,158 @@
+/*!
+\file stats.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef COLORPP_STATS
+#include <atomic>
+#include <chrono>
+#endif
+
+namespace colorpp
+{
+
+/*!
+	\brief Counters of an instrumented entry point
+*/
+typedef struct _KernelStats
+{
+	std::string Name;
+	uint64_t Calls;
+	uint64_t Pixels;	// pixels or samples processed
+	uint64_t Nanoseconds;	// wall time inside the calls, nested calls included
+	uint64_t Clipped;	// values clamped to the output range
+} KernelStats;
+
+/*!
+	\brief Check if the library is built with instrumentation (COLORPP_STATS)
+	\return true if the counters are collected
+*/
+bool is_stats_enabled();
+
+/*!
+	\brief Get the counters of the entry points called so far
+	\return counters in the order of the first calls, empty without COLORPP_STATS
+*/
+std::vector<KernelStats> get_kernel_stats();
+
+/*!
+	\brief Reset the counters and drop the recorded trace events
+*/
+void reset_kernel_stats();
+
+/*!
+	\brief Turn on or off recording of trace events
+	\details Every instrumented call becomes an event, so recording is off by
+		default and limited to the first million events.
+	\param[in] enable - true to record
+*/
+void set_trace_enabled(bool enable);
+
+/*!
+	\brief Get the recorded events in the Chrome trace JSON format
+	\details The result is loaded by chrome://tracing or Perfetto.
+	\return JSON document
+*/
+std::string get_trace_json();
+
+/*!
+	\brief Write the recorded events to a Chrome trace JSON file
+	\param[in] path - file name
+	\return false if the file can't be written
+*/
+bool write_trace(const std::string& path);
+
+#ifdef COLORPP_STATS
+
+namespace detail
+{
+
+struct KernelCounter
+{
+	const char* name;
+	std::atomic<uint64_t> calls;
+	std::atomic<uint64_t> pixels;
+	std::atomic<uint64_t> nanoseconds;
+	std::atomic<uint64_t> clipped;
+};
+
+KernelCounter& get_kernel_counter(const char* name);
+
+void add_trace_event(const char* name, std::chrono::steady_clock::time_point start,
+	std::chrono::steady_clock::time_point end, size_t pixels);
+
+/*
+	Counts a call on the scope exit, so every return path of the entry point is covered.
+*/
+class KernelScope
+{
+public:
+	KernelScope(KernelCounter& counter, size_t pixels) :
+		counter_(counter), pixels_(pixels), start_(std::chrono::steady_clock::now())
+	{
+	}
+	~KernelScope()
+	{
+		auto end = std::chrono::steady_clock::now();
+		counter_.calls.fetch_add(1, std::memory_order_relaxed);
+		counter_.pixels.fetch_add(pixels_, std::memory_order_relaxed);
+		counter_.nanoseconds.fetch_add(static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count()), std::memory_order_relaxed);
+		add_trace_event(counter_.name, start_, end, pixels_);
+	}
+	void clipped(size_t count)
+	{
+		counter_.clipped.fetch_add(count, std::memory_order_relaxed);
+	}
+
+private:
+	KernelCounter& counter_;
+	size_t pixels_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+// number of values outside [lo, hi]
+template<typename T>
+size_t count_outside(const T* values, size_t count, T lo, T hi)
+{
+	size_t result = 0;
+	for (size_t i = 0; i < count; ++i)
+		result += (values[i] < lo) | (values[i] > hi);
+	return result;
+}
+
+// number of values outside [lo, hi] in rows of row_count values
+template<typename T>
+size_t count_outside(const T* rows, size_t stride, size_t row_count, size_t height, T lo, T hi)
+{
+	size_t result = 0;
+	for (size_t y = 0; y < height; ++y)
+		result += count_outside(reinterpret_cast<const T*>(reinterpret_cast<const char*>(rows) + y * stride),
+			row_count, lo, hi);
+	return result;
+}
+
+}
+
+#define COLORPP_STATS_SCOPE(name, pixels) \
+	static colorpp::detail::KernelCounter& colorpp_stats_counter = colorpp::detail::get_kernel_counter(name); \
+	colorpp::detail::KernelScope colorpp_stats_scope(colorpp_stats_counter, pixels)
+#define COLORPP_STATS_CLIPPED(count) colorpp_stats_scope.clipped(count)
+
+#else
+
+// instrumentation and its arguments compile to nothing
+#define COLORPP_STATS_SCOPE(name, pixels) do {} while (0)
+#define COLORPP_STATS_CLIPPED(count) do {} while (0)
+
+#endif
+
+}
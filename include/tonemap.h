@@ -0,0 +1,128 @@
+/*!
+\file tonemap.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include "rgb.h"
+
+namespace colorpp
+{
+
+/*!
+	\brief Tone mapping operators enum
+*/
+enum class ToneMapEnum
+{
+	Reinhard = 0,	// extended Reinhard with a white point
+	Hable = 1,	// Uncharted 2 filmic curve
+	Aces = 2,	// ACES filmic fit (Narkowicz)
+	Bt2390 = 3	// ITU-R BT.2390 EETF in the PQ domain
+};
+
+/*!
+	\brief Tone mapping application enum
+*/
+enum class ToneModeEnum
+{
+	Luminance = 0,	// the curve maps luminance, chromaticity is kept
+	PerChannel = 1	// the curve maps every channel
+};
+
+/*!
+	\brief Tone mapping parameters
+	\details Linear input has 1.0 at the SDR white and the output is in 0..1.0.
+		Zero WhitePoint, SourcePeak or a positive Key are taken from the image
+		statistics, see get_tone_stats.
+*/
+typedef struct _ToneMapParams
+{
+	ToneMapEnum Operator;
+	ToneModeEnum Mode;
+	double Exposure;	// linear scale applied before the curve
+	double Key;	// > 0 - exposure is Key / log-average luminance
+	double WhitePoint;	// exposed luminance mapped to 1.0 (Reinhard, Hable), 0 - maximum
+	double SourcePeak;	// BT.2390 mastering peak relative to the SDR white, 0 - maximum
+	double TargetNits;	// BT.2390 SDR white in cd/m2
+	double Luma[3];	// luminance weights of the channels
+} ToneMapParams;
+
+/*!
+	\brief Image statistics of the tone mapping pre-pass
+*/
+typedef struct _ToneStats
+{
+	double MaxLuminance;
+	double LogAverage;	// geometric mean of the luminance
+} ToneStats;
+
+/*!
+	\brief Create tone mapping parameters
+	\details Luma weights are BT.709 ones; use {0, 1, 0} for XYZ input.
+	\param[in] op - tone mapping operator (see ToneMapEnum)
+	\param[in] mode - luminance or per channel (see ToneModeEnum)
+	\return tone mapping parameters
+*/
+ToneMapParams get_tone_map_params(ToneMapEnum op = ToneMapEnum::Reinhard,
+	ToneModeEnum mode = ToneModeEnum::Luminance);
+
+/*!
+	\brief Tone curve of a single value
+	\param[in] value - linear value before the exposure
+	\param[in] params - tone mapping parameters with the statistics applied
+	\return mapped value in 0..1.0 range
+*/
+double tone_map(double value, const ToneMapParams& params);
+
+/*!
+	\brief Parallel pre-pass computing the image statistics
+	\param[in] src - interleaved linear RGB or XYZ, 3 * count floats
+	\param[in] count - number of pixels
+	\param[in] luma - luminance weights of the channels
+	\param[out] stats - image statistics
+*/
+void get_tone_stats(const float* src, size_t count, const double luma[3], ToneStats& stats);
+
+/*!
+	\brief Resolve the statistics dependent parameters
+	\param[in,out] params - tone mapping parameters
+	\param[in] stats - image statistics
+*/
+void set_tone_stats(ToneMapParams& params, const ToneStats& stats);
+
+/*!
+	\brief Check if the parameters need the statistics pre-pass
+	\param[in] params - tone mapping parameters
+	\return true if set_tone_stats must be called before mapping
+*/
+bool need_tone_stats(const ToneMapParams& params);
+
+/*!
+    \brief Batch tone mapping of interleaved linear pixels
+	\details Runs the statistics pre-pass first when need_tone_stats is true.
+    \param[in] src - linear RGB or XYZ, 3 * count floats
+    \param[out] dst - mapped pixels, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+	\param[in] params - tone mapping parameters
+*/
+void tone_map(const float* src, float* dst, size_t count, const ToneMapParams& params);
+
+/*!
+    \brief Batch tone mapping fused with companding
+	\details Every chunk is mapped and encoded while it is in the cache, which
+		replaces separate tone_map and compand passes over the image.
+    \param[in] src - linear RGB, 3 * count floats
+    \param[out] dst - encoded RGB, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+	\param[in] params - tone mapping parameters
+	\param[in] transfer - transfer function of the output (see TransferEnum)
+	\param[in] gamma - exponent of TransferEnum::Gamma
+*/
+void tone_map(const float* src, float* dst, size_t count, const ToneMapParams& params,
+	TransferEnum transfer, double gamma = 2.2);
+
+}
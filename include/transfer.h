@@ -0,0 +1,71 @@
+/*!
+\file transfer.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include "rgb.h"
+
+namespace colorpp
+{
+
+/*!
+    \brief Batch decoding of integer code values to linear values
+	\details Uses an exact table of all the 2^bit_depth codes built once per transfer,
+		bit depth and gamma, so PQ costs one load per sample instead of two pow calls.
+		Tables of the first 32 custom gammas are kept, further gammas rebuild them per call.
+    \param[in] src - source samples in 0..2^bit_depth-1 (3 per RGB pixel)
+    \param[out] dst - linear samples
+    \param[in] count - number of samples
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] bit_depth - 8..16 bits per sample
+	\param[in] gamma - exponent of TransferEnum::Gamma
+*/
+void inv_compand(const unsigned short* src, float* dst, size_t count,
+	TransferEnum transfer, int bit_depth = 10, double gamma = 2.2);
+
+/*!
+    \brief Batch encoding of linear values to integer code values
+	\details See compand(const float*, float*, ...) for the approximation used.
+    \param[in] src - linear samples, clamped to 0..1.0 (3 per RGB pixel)
+    \param[out] dst - encoded samples in 0..2^bit_depth-1
+    \param[in] count - number of samples
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] bit_depth - 8..16 bits per sample
+	\param[in] gamma - exponent of TransferEnum::Gamma
+*/
+void compand(const float* src, unsigned short* dst, size_t count,
+	TransferEnum transfer, int bit_depth = 10, double gamma = 2.2);
+
+/*!
+    \brief Batch decoding of encoded values to linear values
+	\details Piecewise linear interpolation of a table uniform in the encoded
+		domain; the absolute error is below 1e-6 of the full scale.
+    \param[in] src - encoded samples, clamped to 0..1.0 (3 per RGB pixel)
+    \param[out] dst - linear samples (may alias src)
+    \param[in] count - number of samples
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] gamma - exponent of TransferEnum::Gamma
+*/
+void inv_compand(const float* src, float* dst, size_t count,
+	TransferEnum transfer, double gamma = 2.2);
+
+/*!
+    \brief Batch encoding of linear values to encoded values
+	\details Piecewise linear interpolation of a table indexed by the float exponent
+		and the high mantissa bits, i.e. uniform in the log domain where the curves
+		are smooth; the absolute error is below 1e-5 of the full scale.
+    \param[in] src - linear samples, clamped to 0..1.0 (3 per RGB pixel)
+    \param[out] dst - encoded samples (may alias src)
+    \param[in] count - number of samples
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] gamma - exponent of TransferEnum::Gamma
+*/
+void compand(const float* src, float* dst, size_t count,
+	TransferEnum transfer, double gamma = 2.2);
+
+}
@@ -0,0 +1,148 @@
+/*!
+\file ycbcr.h
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include "rgb.h"
+
+namespace colorpp
+{
+
+/*!
+	\brief YCbCr matrix coefficients enum
+*/
+enum class YCbCrEnum
+{
+	Bt601 = 0,
+	Bt709 = 1,
+	Bt2020 = 2
+};
+
+/*!
+	\brief Quantization range enum for integer YCbCr
+*/
+enum class RangeEnum
+{
+	Full = 0,	// Y, Cb, Cr in 0..2^n-1
+	Limited = 1	// Y in 16..235, Cb and Cr in 16..240 (scaled by 2^(n-8))
+};
+
+/*!
+    \brief Conversion from RGB to YCbCr color model
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] y - luma channel in 0..1.0 range
+  	\param[out] cb - blue-difference channel in 0..1.0 range (0.5 is neutral)
+  	\param[out] cr - red-difference channel in 0..1.0 range (0.5 is neutral)
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+*/
+void rgb_to_ycbcr(double r, double g, double b,
+	double& y, double& cb, double& cr, YCbCrEnum matrix = YCbCrEnum::Bt709);
+
+/*!
+    \brief Conversion from YCbCr to RGB color model
+ 	\param[in] y - luma channel in 0..1.0 range
+  	\param[in] cb - blue-difference channel in 0..1.0 range (0.5 is neutral)
+  	\param[in] cr - red-difference channel in 0..1.0 range (0.5 is neutral)
+    \param[out] r - red channel in 0..1.0 range
+	\param[out] g - green channel in 0..1.0 range
+ 	\param[out] b - blue channel in 0..1.0 range
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+*/
+void ycbcr_to_rgb(double y, double cb, double cr,
+	double& r, double& g, double& b, YCbCrEnum matrix = YCbCrEnum::Bt709);
+
+/*!
+	\brief Create parameters for the RGB color space the YCbCr matrix is defined on
+	\details Bt601 uses SMPTE-C primaries (pass PalSecamRgb params explicitly for 625-line
+		material), Bt709 uses sRGB primaries and Bt2020 uses Rec. 2020 primaries.
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] adaptation - Chromatic adaptation method (see AdaptationEnum)
+	\param[in] illuminant - Illuminant (see IlluminantEnum)
+	\return RGB ColorSpace parameters
+*/
+RgbParams get_ycbcr_rgb_params(YCbCrEnum matrix = YCbCrEnum::Bt709,
+	AdaptationEnum adaptation = AdaptationEnum::amBradford,
+	IlluminantEnum illuminant = IlluminantEnum::D50);
+
+/*!
+    \brief Conversion from YCbCr to XYZ color model
+ 	\param[in] y - luma channel in 0..1.0 range
+  	\param[in] cb - blue-difference channel in 0..1.0 range
+  	\param[in] cr - red-difference channel in 0..1.0 range
+ 	\param[out] x - x channel in 0..1.0 range
+  	\param[out] y_ - y channel in 0..1.0 range
+  	\param[out] z - z channel in 0..1.0 range
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] params - RGB ColorSpace parameters (see get_ycbcr_rgb_params)
+*/
+void ycbcr_to_xyz(double y, double cb, double cr,
+	double& x, double& y_, double& z, YCbCrEnum matrix, const RgbParams& params);
+
+/*!
+    \brief Conversion from XYZ to YCbCr color model
+ 	\param[in] x - x channel in 0..1.0 range
+  	\param[in] y_ - y channel in 0..1.0 range
+  	\param[in] z - z channel in 0..1.0 range
+ 	\param[out] y - luma channel in 0..1.0 range
+  	\param[out] cb - blue-difference channel in 0..1.0 range
+  	\param[out] cr - red-difference channel in 0..1.0 range
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] params - RGB ColorSpace parameters (see get_ycbcr_rgb_params)
+*/
+void xyz_to_ycbcr(double x, double y_, double z,
+	double& y, double& cb, double& cr, YCbCrEnum matrix, const RgbParams& params);
+
+/*!
+    \brief Batch conversion of interleaved 8-bit RGB to interleaved 8-bit YCbCr
+    \param[in] rgb - source pixels, 3 * count bytes
+    \param[out] ycbcr - destination pixels, 3 * count bytes (may alias rgb)
+    \param[in] count - number of pixels
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the destination (see RangeEnum)
+*/
+void rgb_to_ycbcr(const unsigned char* rgb, unsigned char* ycbcr, size_t count,
+	YCbCrEnum matrix = YCbCrEnum::Bt709, RangeEnum range = RangeEnum::Limited);
+
+/*!
+    \brief Batch conversion of interleaved 8-bit YCbCr to interleaved 8-bit RGB
+    \param[in] ycbcr - source pixels, 3 * count bytes
+    \param[out] rgb - destination pixels, 3 * count bytes (may alias ycbcr)
+    \param[in] count - number of pixels
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the source (see RangeEnum)
+*/
+void ycbcr_to_rgb(const unsigned char* ycbcr, unsigned char* rgb, size_t count,
+	YCbCrEnum matrix = YCbCrEnum::Bt709, RangeEnum range = RangeEnum::Limited);
+
+/*!
+    \brief Batch conversion of interleaved high bit depth RGB to YCbCr
+    \param[in] rgb - source pixels, 3 * count words in 0..2^bit_depth-1
+    \param[out] ycbcr - destination pixels, 3 * count words (may alias rgb)
+    \param[in] count - number of pixels
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the destination (see RangeEnum)
+	\param[in] bit_depth - 8..12 bits per sample
+*/
+void rgb_to_ycbcr(const unsigned short* rgb, unsigned short* ycbcr, size_t count,
+	YCbCrEnum matrix = YCbCrEnum::Bt2020, RangeEnum range = RangeEnum::Limited, int bit_depth = 10);
+
+/*!
+    \brief Batch conversion of interleaved high bit depth YCbCr to RGB
+    \param[in] ycbcr - source pixels, 3 * count words
+    \param[out] rgb - destination pixels, 3 * count words in 0..2^bit_depth-1 (may alias ycbcr)
+    \param[in] count - number of pixels
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the source (see RangeEnum)
+	\param[in] bit_depth - 8..12 bits per sample
+*/
+void ycbcr_to_rgb(const unsigned short* ycbcr, unsigned short* rgb, size_t count,
+	YCbCrEnum matrix = YCbCrEnum::Bt2020, RangeEnum range = RangeEnum::Limited, int bit_depth = 10);
+
+}
@@ -1,9 +1,14 @@
+#include <atomic>
+#include <csignal>
 #include <iostream>
 #include <tuple>
 #include <regex>
 
 #include "color.h"
 #include "utils/clparser.h"
+#ifdef __linux__
+#include "utils/convserver.h"
+#endif
 
 std::tuple<int, int, int> extract_from_tristr(std::string s)
 {
@@ -21,6 +26,107 @@ std::tuple<int, int, int> extract_from_tristr(std::string s)
 }
 
 
+#ifdef __linux__
+conv_client* daemon_client = nullptr;
+std::atomic<bool> stop_serving(false);
+
+void on_signal(int)
+{
+	stop_serving = true;
+}
+
+bool serve(const std::string& path)
+{
+	conv_server server;
+	if (!server.open(path))
+	{
+		std::cout << "can't listen on " << path << std::endl;
+		return false;
+	}
+	std::signal(SIGINT, on_signal);
+	std::signal(SIGTERM, on_signal);
+	// the tables are warm before the first client (mapped with COLORPP_LUT_CACHE)
+	colorpp::build_color_lut(colorpp::ColorLutEnum::RgbToHsv);
+	colorpp::build_color_lut(colorpp::ColorLutEnum::RgbToHsl);
+	colorpp::build_color_lut(colorpp::ColorLutEnum::HsvToRgb);
+	colorpp::build_color_lut(colorpp::ColorLutEnum::HslToRgb);
+	std::cout << "serving on " << path << std::endl;
+	server.run(stop_serving);
+	std::cout << server.get_request_count() << " requests in " << server.get_kernel_count()
+		<< " kernel calls" << std::endl;
+	return true;
+}
+
+// converts one color through the daemon, false if it isn't connected or fails
+template<typename S, typename D>
+bool remote_convert(ConvSpaceEnum src_space, const S src[3], ConvSpaceEnum dst_space, D dst[3])
+{
+	if (!daemon_client)
+		return false;
+	const size_t dst_offset = 32;
+	auto buffer = daemon_client->reserve(64);
+	if (!buffer)
+		return false;
+	std::memcpy(buffer, src, 3 * sizeof(S));
+	ConvRequest request;
+	std::memset(&request, 0, sizeof(request));
+	request.Src = {static_cast<uint32_t>(src_space),
+		static_cast<uint32_t>(sizeof(S) == 1 ? ConvFormatEnum::U8 : ConvFormatEnum::U16)};
+	request.Dst = {static_cast<uint32_t>(dst_space),
+		static_cast<uint32_t>(sizeof(D) == 1 ? ConvFormatEnum::U8 : ConvFormatEnum::U16)};
+	request.Count = 1;
+	request.DstOffset = dst_offset;
+	if (daemon_client->convert(request) != ConvStatusEnum::Ok)
+		return false;
+	std::memcpy(dst, buffer + dst_offset, 3 * sizeof(D));
+	return true;
+}
+#endif
+
+colorpp::hsv360_100 to_hsv(const colorpp::rgb256& rgb)
+{
+#ifdef __linux__
+	unsigned char in[3] = {rgb.get_red(), rgb.get_green(), rgb.get_blue()};
+	unsigned short out[3];
+	if (remote_convert(ConvSpaceEnum::Rgb, in, ConvSpaceEnum::Hsv, out))
+		return colorpp::hsv360_100(out[0], static_cast<unsigned char>(out[1]), static_cast<unsigned char>(out[2]));
+#endif
+	return colorpp::hsv360_100(rgb);
+}
+
+colorpp::hsl360_100 to_hsl(const colorpp::rgb256& rgb)
+{
+#ifdef __linux__
+	unsigned char in[3] = {rgb.get_red(), rgb.get_green(), rgb.get_blue()};
+	unsigned short out[3];
+	if (remote_convert(ConvSpaceEnum::Rgb, in, ConvSpaceEnum::Hsl, out))
+		return colorpp::hsl360_100(out[0], static_cast<unsigned char>(out[1]), static_cast<unsigned char>(out[2]));
+#endif
+	return colorpp::hsl360_100(rgb);
+}
+
+colorpp::rgb256 to_rgb(const colorpp::hsv360_100& hsv)
+{
+#ifdef __linux__
+	unsigned short in[3] = {hsv.get_hue(), hsv.get_saturation(), hsv.get_value()};
+	unsigned char out[3];
+	if (remote_convert(ConvSpaceEnum::Hsv, in, ConvSpaceEnum::Rgb, out))
+		return colorpp::rgb256(out[0], out[1], out[2]);
+#endif
+	return colorpp::rgb256(hsv);
+}
+
+colorpp::rgb256 to_rgb(const colorpp::hsl360_100& hsl)
+{
+#ifdef __linux__
+	unsigned short in[3] = {hsl.get_hue(), hsl.get_saturation(), hsl.get_lightness()};
+	unsigned char out[3];
+	if (remote_convert(ConvSpaceEnum::Hsl, in, ConvSpaceEnum::Rgb, out))
+		return colorpp::rgb256(out[0], out[1], out[2]);
+#endif
+	return colorpp::rgb256(hsl);
+}
+
 bool rgb_convert(std::string inp_value, std::string out_mod)
 {
 	if (out_mod != "hsv" && out_mod != "hsl" && out_mod != "all")
@@ -40,12 +146,12 @@ bool rgb_convert(std::string inp_value, std::string out_mod)
 
 	if (out_mod == "hsv" || out_mod == "all")
 	{
-		colorpp::hsv360_100 hsv(rgb);
+		auto hsv = to_hsv(rgb);
 		std::cout << "hsv: " << hsv << std::endl;
 	}
 	if (out_mod == "hsl" || out_mod == "all")
 	{
-		colorpp::hsl360_100 hsl(rgb);
+		auto hsl = to_hsl(rgb);
 		std::cout << "hsl: " << hsl << std::endl;
 	}
 	return true;
@@ -68,12 +174,14 @@ bool hsv_convert(std::string inp_value, std::string out_mod)
 
 	std::cout << "hsv: " << hsv << std::endl;
 
-	colorpp::rgb256 rgb(hsv);
 	if (out_mod == "rgb" || out_mod == "all")
+	{
+		auto rgb = to_rgb(hsv);
 		std::cout << "rgb: " << rgb << std::endl;
+	}
 	if (out_mod == "hsl" || out_mod == "all")
 	{
-		colorpp::hsl360_100 hsl(rgb);
+		colorpp::hsl360_100 hsl(hsv);
 		std::cout << "hsl: " << hsl << std::endl;
 	}
 	return true;
@@ -96,12 +204,14 @@ bool hsl_convert(std::string inp_value, std::string out_mod)
 
 	std::cout << "hsl: " << hsl << std::endl;
 
-	colorpp::rgb256 rgb(hsl);
 	if (out_mod == "rgb" || out_mod == "all")
+	{
+		auto rgb = to_rgb(hsl);
 		std::cout << "rgb: " << rgb << std::endl;
+	}
 	if (out_mod == "hsv" || out_mod == "all")
 	{
-		colorpp::hsv360_100 hsv(rgb);
+		colorpp::hsv360_100 hsv(hsl);
 		std::cout << "hsv: " << hsv << std::endl;
 	}
 	return true;
@@ -116,17 +226,43 @@ int main(int argc, char* argv[])
 	const char* prmHsv = "-hsv";
 	const char* prmHsl = "-hsl";
 	const char* prmOut = "-o";
+	const char* prmServe = "--serve";
+	const char* prmConnect = "--connect";
 	clparser cmdline;
 	cmdline.add_param(prmRgb, splPtrn, valPtrn);
 	cmdline.add_param(prmHsv, splPtrn, valPtrn);
 	cmdline.add_param(prmHsl, splPtrn, valPtrn);
 	cmdline.add_param(prmOut, splPtrn, "\\S+");
+	cmdline.add_param(prmServe, splPtrn, "\\S+");
+	cmdline.add_param(prmConnect, splPtrn, "\\S+");
 	bool is_cl_invalid = true;
+#ifdef __linux__
+	conv_client client;
+#endif
 	while(1)
 	{
 		if (!cmdline.parse(argc, argv))
 			break;
 		auto options_count = cmdline.get_options_count(); 
+#ifdef __linux__
+		if (cmdline.is_exists(prmServe))
+		{
+			is_cl_invalid = options_count != 1;
+			if (!is_cl_invalid && !serve(cmdline.get_value(prmServe)))
+				return 1;
+			break;
+		}
+		if (cmdline.is_exists(prmConnect))
+		{
+			if (!client.connect(cmdline.get_value(prmConnect)))
+			{
+				std::cout << "can't connect to " << cmdline.get_value(prmConnect) << std::endl;
+				return 1;
+			}
+			daemon_client = &client;
+			--options_count;
+		}
+#endif
 		if (options_count < 1 || options_count > 2)
 			break;
 		if (!cmdline.is_exists(prmRgb) && 
@@ -134,13 +270,12 @@ int main(int argc, char* argv[])
 			!cmdline.is_exists(prmHsl))
 			break;
 		std::string out_mod = "all";
-		int out_pos = 1;
 		if (cmdline.is_exists(prmOut))
-		{
-			out_pos = cmdline.get_name(0) == prmOut ? 0 : 1;
 			out_mod = cmdline.get_value(prmOut);
-		}
-		auto inp_name = cmdline.get_name(out_pos == 0 ? 1 : 0);
+		std::string inp_name;
+		for (size_t i = 0; i < cmdline.get_options_count(); ++i)
+			if (cmdline.get_name(i) != prmOut && cmdline.get_name(i) != prmConnect)
+				inp_name = cmdline.get_name(i);
 		if (inp_name == prmRgb)
 			is_cl_invalid = !rgb_convert(cmdline.get_value(inp_name), out_mod);
 		else if (inp_name == prmHsv)
@@ -151,10 +286,12 @@ int main(int argc, char* argv[])
 	}
 	if (is_cl_invalid)
 	{
-		std::cout << "Usage: cconv -mod=x,y,z -o=mod\n"
+		std::cout << "Usage: cconv -mod=x,y,z -o=mod [--connect socket]\n"
+		"       cconv --serve socket\n"
 		"\twhere\n"
 		"\t\tmod is rgb, hsv or hsl\n"
-		"\t\tx,y,z are values from 0 to 255" << std::endl;
+		"\t\tx,y,z are values from 0 to 255\n"
+		"\t\tsocket is the Unix socket of the conversion daemon" << std::endl;
 	}
 
 	return 0;
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "dither.h"
+#include "parallel.h"
+#include "tonemap.h"
+#include "transfer.h"
+#include "utils/clparser.h"
+#include "utils/imageio.h"
+
+// rows converted at once: large enough for the batch kernels, small enough for the cache
+const size_t StripRows = 32;
+
+bool ends_with(const std::string& s, const std::string& suffix)
+{
+	return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// streaming statistics pre-pass, strips are merged as the whole image would be
+colorpp::ToneStats get_stats(const image_reader& reader, std::vector<float>& strip, const double luma[3])
+{
+	colorpp::ToneStats total{0., 0.};
+	double log_sum = 0.;
+	for (size_t y = 0; y < reader.height(); y += StripRows)
+	{
+		auto rows = std::min(StripRows, reader.height() - y);
+		auto count = rows * reader.width();
+		reader.read_rows(y, rows, strip.data());
+		colorpp::ToneStats stats;
+		colorpp::get_tone_stats(strip.data(), count, luma, stats);
+		total.MaxLuminance = std::max(total.MaxLuminance, stats.MaxLuminance);
+		log_sum += std::log(stats.LogAverage) * count;
+	}
+	total.LogAverage = std::exp(log_sum / (reader.width() * reader.height()));
+	return total;
+}
+
+bool convert(const std::string& input, const std::string& output, const std::string& op,
+	colorpp::DitherEnum dither, bool is_16bit)
+{
+	image_reader reader;
+	if (!reader.open(input))
+	{
+		std::cout << "can't read " << input << std::endl;
+		return false;
+	}
+	auto format = ends_with(output, ".pfm") ? ImageEnum::Pfm : (is_16bit ? ImageEnum::Ppm16 : ImageEnum::Ppm8);
+	image_writer writer;
+	if (!writer.open(output, format, reader.width(), reader.height()))
+	{
+		std::cout << "can't write " << output << std::endl;
+		return false;
+	}
+
+	auto width = reader.width();
+	std::vector<float> strip(StripRows * width * 3);
+	std::vector<unsigned short> words(format == ImageEnum::Ppm16 ? strip.size() : 0);
+	auto params = colorpp::get_tone_map_params(colorpp::ToneMapEnum::Aces);
+	auto start = std::chrono::steady_clock::now();
+	if (op == "tonemap" && colorpp::need_tone_stats(params))
+		colorpp::set_tone_stats(params, get_stats(reader, strip, params.Luma));
+
+	for (size_t y = 0; y < reader.height(); y += StripRows)
+	{
+		auto rows = std::min(StripRows, reader.height() - y);
+		auto count = rows * width;
+		// decoding is spread over the library threads like the kernels
+		colorpp::parallel_for(rows, 1, [&](size_t begin, size_t end) {
+			reader.read_rows(y + begin, end - begin, strip.data() + begin * width * 3);
+		});
+		if (op == "linear")
+			colorpp::inv_compand(strip.data(), strip.data(), count * 3, colorpp::TransferEnum::sRGB);
+		else if (op == "srgb")
+			colorpp::compand(strip.data(), strip.data(), count * 3, colorpp::TransferEnum::sRGB);
+		else if (op == "tonemap")
+			colorpp::tone_map(strip.data(), strip.data(), count, params, colorpp::TransferEnum::sRGB);
+
+		if (format == ImageEnum::Pfm)
+			writer.write_rows(y, rows, strip.data());
+		else if (format == ImageEnum::Ppm8)
+			// PPM rows are stored top-down, so bytes are quantized in place
+			colorpp::quantize(strip.data(), width * 3 * sizeof(float), writer.row(y), writer.row_size(),
+				width, rows, 3, dither);
+		else
+		{
+			colorpp::quantize(strip.data(), width * 3 * sizeof(float), words.data(), width * 3 * sizeof(unsigned short),
+				width, rows, 3, dither);
+			writer.write_rows(y, rows, words.data());
+		}
+	}
+	writer.close();
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	auto pixels = static_cast<double>(width * reader.height());
+	std::cout << input << " -> " << output << " (" << op << "): " << width << "x" << reader.height()
+		<< " in " << elapsed.count() << " ms (" << pixels / elapsed.count() / 1000. << " Mpix/s, "
+		<< reader.row_size() * reader.height() / elapsed.count() / 1000. << " MB/s read)" << std::endl;
+	return true;
+}
+
+// Converts PPM/PFM images streaming rows through the batch kernels
+int main(int argc, char* argv[])
+{
+	const char* splPtrn = " :=";
+	const char* prmInp = "-i";
+	const char* prmOut = "-o";
+	const char* prmOp = "-op";
+	const char* prmDither = "-dither";
+	const char* prmBits = "-bits";
+	const char* prmThreads = "-threads";
+	clparser cmdline;
+	cmdline.add_param(prmInp, splPtrn, "\\S+");
+	cmdline.add_param(prmOut, splPtrn, "\\S+");
+	cmdline.add_param(prmOp, splPtrn, "(copy|linear|srgb|tonemap)");
+	cmdline.add_param(prmDither, splPtrn, "(none|bayer|bluenoise|fs)");
+	cmdline.add_param(prmBits, splPtrn, "(8|16)");
+	cmdline.add_param(prmThreads, splPtrn, "\\d+");
+	bool is_cl_invalid = true;
+	while (1)
+	{
+		if (!cmdline.parse(argc, argv))
+			break;
+		if (!cmdline.is_exists(prmInp) || !cmdline.is_exists(prmOut))
+			break;
+		auto op = cmdline.is_exists(prmOp) ? cmdline.get_value(prmOp) : std::string("copy");
+		auto dither_name = cmdline.get_value(prmDither);
+		auto dither = colorpp::DitherEnum::None;
+		if (dither_name == "bayer")
+			dither = colorpp::DitherEnum::Bayer;
+		else if (dither_name == "bluenoise")
+			dither = colorpp::DitherEnum::BlueNoise;
+		else if (dither_name == "fs")
+			dither = colorpp::DitherEnum::FloydSteinberg;
+		if (cmdline.is_exists(prmThreads))
+			colorpp::set_thread_count(static_cast<unsigned>(std::atoi(cmdline.get_value(prmThreads).c_str())));
+		is_cl_invalid = false;
+		if (!convert(cmdline.get_value(prmInp), cmdline.get_value(prmOut), op, dither,
+			cmdline.get_value(prmBits) == "16"))
+			return 1;
+		break;
+	}
+	if (is_cl_invalid)
+	{
+		std::cout << "Usage: imgconv -i=input -o=output [-op=op] [-dither=method] [-bits=n] [-threads=n]\n"
+		"\twhere\n"
+		"\t\tinput is a P6 PPM (8/16-bit) or PF PFM image\n"
+		"\t\toutput is a .pfm or .ppm image\n"
+		"\t\top is copy, linear (sRGB to linear), srgb (linear to sRGB) or tonemap (ACES to sRGB)\n"
+		"\t\tmethod is none, bayer, bluenoise or fs (Floyd-Steinberg) for PPM output\n"
+		"\t\tn is 8 or 16 bits per PPM sample" << std::endl;
+	}
+
+	return 0;
+}
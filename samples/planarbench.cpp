@@ -0,0 +1,59 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "planar.h"
+#include "parallel.h"
+
+// Measures planar YCbCr <-> RGB throughput on 4K frames
+int main(int argc, char* argv[])
+{
+	const size_t width = 3840;
+	const size_t height = 2160;
+	const int frames = 60;
+	if (argc > 1)
+		colorpp::set_thread_count(static_cast<unsigned>(std::atoi(argv[1])));
+	std::cout << "threads: " << colorpp::get_thread_count() << std::endl;
+
+	const colorpp::PlanarEnum formats[] = {colorpp::PlanarEnum::I420, colorpp::PlanarEnum::NV12,
+		colorpp::PlanarEnum::P010, colorpp::PlanarEnum::I422};
+	const char* names[] = {"I420", "NV12", "P010", "I422"};
+
+	std::vector<unsigned char> rgb8(width * height * 3);
+	std::vector<unsigned short> rgb16(width * height * 3);
+	for (size_t i = 0; i < rgb8.size(); ++i)
+	{
+		rgb8[i] = static_cast<unsigned char>((i * 7) >> 4);
+		rgb16[i] = static_cast<unsigned short>(((i * 7) >> 2) & 1023);
+	}
+
+	for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+	{
+		std::vector<unsigned char> data(colorpp::get_planar_size(formats[f], width, height));
+		auto frame = colorpp::get_planar_frame(formats[f], width, height, data.data());
+		bool is_p010 = formats[f] == colorpp::PlanarEnum::P010;
+
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < frames; ++i)
+			if (is_p010)
+				colorpp::rgb_to_planar(rgb16.data(), width * 6, frame);
+			else
+				colorpp::rgb_to_planar(rgb8.data(), width * 3, frame);
+		std::chrono::duration<double, std::milli> to_planar = std::chrono::steady_clock::now() - start;
+
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < frames; ++i)
+			if (is_p010)
+				colorpp::planar_to_rgb(frame, rgb16.data(), width * 6);
+			else
+				colorpp::planar_to_rgb(frame, rgb8.data(), width * 3);
+		std::chrono::duration<double, std::milli> to_rgb = std::chrono::steady_clock::now() - start;
+
+		std::cout << names[f] << "\trgb->planar: " << to_planar.count() / frames << " ms/frame (" 
+			<< frames * 1000. / to_planar.count() << " fps)"
+			<< "\tplanar->rgb: " << to_rgb.count() / frames << " ms/frame ("
+			<< frames * 1000. / to_rgb.count() << " fps)" << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,721 @@
+/*!
+\file convserver.h
+\brief This file contains the source code of the conversion daemon and its client
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2022 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "color_lut.h"
+#include "parallel.h"
+#include "transfer.h"
+
+/*!
+	\brief Color spaces of the conversion requests enum
+*/
+enum class ConvSpaceEnum : uint32_t
+{
+	Rgb = 0,	// encoded RGB of the request transfer function
+	LinearRgb = 1,	// linear RGB
+	Hsv = 2,	// hue 0..360, saturation and value 0..100
+	Hsl = 3	// hue 0..360, saturation and lightness 0..100
+};
+
+/*!
+	\brief Sample formats of the conversion requests enum
+*/
+enum class ConvFormatEnum : uint32_t
+{
+	U8 = 0,
+	U16 = 1,	// native byte order
+	F32 = 2
+};
+
+/*!
+	\brief Results of the conversion requests enum
+*/
+enum class ConvStatusEnum : int32_t
+{
+	Ok = 0,
+	BadRequest = 1,	// malformed message
+	Unsupported = 2,	// no kernel for the descriptors
+	BadBuffer = 3,	// regions out of the shared buffer, misaligned or overlapping, or the buffer may shrink
+	NoServer = 4	// the daemon can't be reached
+};
+
+/*!
+	\brief Space and sample format of a pixel buffer, 3 samples per pixel
+*/
+typedef struct _ConvDesc
+{
+	uint32_t Space;	// ConvSpaceEnum
+	uint32_t Format;	// ConvFormatEnum
+} ConvDesc;
+
+/*!
+	\brief Conversion request, the shared buffer is passed along as a file descriptor
+*/
+typedef struct _ConvRequest
+{
+	uint32_t Magic;
+	uint32_t Version;
+	ConvDesc Src;
+	ConvDesc Dst;
+	uint32_t Transfer;	// colorpp::TransferEnum of Rgb
+	uint32_t BitDepth;	// 8..16 bits of U16 Rgb codes
+	double Gamma;	// exponent of TransferEnum::Gamma in MinGamma..MaxGamma, finite otherwise
+	uint64_t Count;	// number of pixels
+	uint64_t SrcOffset;	// source pixels in the shared buffer
+	uint64_t DstOffset;	// converted pixels in the shared buffer
+} ConvRequest;
+
+/*!
+	\brief Reply to a conversion request
+*/
+typedef struct _ConvReply
+{
+	uint32_t Magic;
+	int32_t Status;	// ConvStatusEnum
+} ConvReply;
+
+namespace convserver_detail
+{
+	const uint32_t Magic = 0x56434343;	// "CCCV"
+	// accepted exponents of TransferEnum::Gamma
+	const double MinGamma = 0.1;
+	const double MaxGamma = 10.;
+	const uint32_t Version = 1;
+	const size_t Grain = 16384;
+
+	inline size_t get_sample_size(uint32_t format)
+	{
+		switch (static_cast<ConvFormatEnum>(format))
+		{
+		case ConvFormatEnum::U8:
+			return 1;
+		case ConvFormatEnum::U16:
+			return 2;
+		case ConvFormatEnum::F32:
+			return 4;
+		}
+		return 0;
+	}
+
+	inline bool is_desc(const ConvDesc& desc, ConvSpaceEnum space, ConvFormatEnum format)
+	{
+		return desc.Space == static_cast<uint32_t>(space) && desc.Format == static_cast<uint32_t>(format);
+	}
+
+	// converts count pixels of a request
+	typedef void (*Kernel)(const void* src, void* dst, size_t count, const ConvRequest& request);
+
+	inline void rgb_to_hsv(const void* src, void* dst, size_t count, const ConvRequest&)
+	{
+		auto in = static_cast<const unsigned char*>(src);
+		auto out = static_cast<unsigned short*>(dst);
+		colorpp::parallel_for(count, Grain, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				auto hsv = colorpp::lut_rgb_to_hsv(colorpp::rgb256(in[3 * i], in[3 * i + 1], in[3 * i + 2]));
+				out[3 * i] = hsv.get_hue();
+				out[3 * i + 1] = hsv.get_saturation();
+				out[3 * i + 2] = hsv.get_value();
+			}
+		});
+	}
+
+	inline void rgb_to_hsl(const void* src, void* dst, size_t count, const ConvRequest&)
+	{
+		auto in = static_cast<const unsigned char*>(src);
+		auto out = static_cast<unsigned short*>(dst);
+		colorpp::parallel_for(count, Grain, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				auto hsl = colorpp::lut_rgb_to_hsl(colorpp::rgb256(in[3 * i], in[3 * i + 1], in[3 * i + 2]));
+				out[3 * i] = hsl.get_hue();
+				out[3 * i + 1] = hsl.get_saturation();
+				out[3 * i + 2] = hsl.get_lightness();
+			}
+		});
+	}
+
+	inline void hsv_to_rgb(const void* src, void* dst, size_t count, const ConvRequest&)
+	{
+		auto in = static_cast<const unsigned short*>(src);
+		auto out = static_cast<unsigned char*>(dst);
+		colorpp::parallel_for(count, Grain, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				auto rgb = colorpp::lut_hsv_to_rgb(colorpp::hsv360_100(in[3 * i],
+					static_cast<unsigned char>(std::min<unsigned short>(in[3 * i + 1], 255)),
+					static_cast<unsigned char>(std::min<unsigned short>(in[3 * i + 2], 255))));
+				out[3 * i] = rgb.get_red();
+				out[3 * i + 1] = rgb.get_green();
+				out[3 * i + 2] = rgb.get_blue();
+			}
+		});
+	}
+
+	inline void hsl_to_rgb(const void* src, void* dst, size_t count, const ConvRequest&)
+	{
+		auto in = static_cast<const unsigned short*>(src);
+		auto out = static_cast<unsigned char*>(dst);
+		colorpp::parallel_for(count, Grain, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				auto rgb = colorpp::lut_hsl_to_rgb(colorpp::hsl360_100(in[3 * i],
+					static_cast<unsigned char>(std::min<unsigned short>(in[3 * i + 1], 255)),
+					static_cast<unsigned char>(std::min<unsigned short>(in[3 * i + 2], 255))));
+				out[3 * i] = rgb.get_red();
+				out[3 * i + 1] = rgb.get_green();
+				out[3 * i + 2] = rgb.get_blue();
+			}
+		});
+	}
+
+	inline void decode_codes(const void* src, void* dst, size_t count, const ConvRequest& request)
+	{
+		colorpp::inv_compand(static_cast<const unsigned short*>(src), static_cast<float*>(dst), 3 * count,
+			static_cast<colorpp::TransferEnum>(request.Transfer), static_cast<int>(request.BitDepth), request.Gamma);
+	}
+
+	inline void encode_codes(const void* src, void* dst, size_t count, const ConvRequest& request)
+	{
+		colorpp::compand(static_cast<const float*>(src), static_cast<unsigned short*>(dst), 3 * count,
+			static_cast<colorpp::TransferEnum>(request.Transfer), static_cast<int>(request.BitDepth), request.Gamma);
+	}
+
+	inline void decode(const void* src, void* dst, size_t count, const ConvRequest& request)
+	{
+		colorpp::inv_compand(static_cast<const float*>(src), static_cast<float*>(dst), 3 * count,
+			static_cast<colorpp::TransferEnum>(request.Transfer), request.Gamma);
+	}
+
+	inline void encode(const void* src, void* dst, size_t count, const ConvRequest& request)
+	{
+		colorpp::compand(static_cast<const float*>(src), static_cast<float*>(dst), 3 * count,
+			static_cast<colorpp::TransferEnum>(request.Transfer), request.Gamma);
+	}
+
+	inline Kernel get_kernel(const ConvRequest& request)
+	{
+		const auto& s = request.Src;
+		const auto& d = request.Dst;
+		if (is_desc(s, ConvSpaceEnum::Rgb, ConvFormatEnum::U8) && is_desc(d, ConvSpaceEnum::Hsv, ConvFormatEnum::U16))
+			return rgb_to_hsv;
+		if (is_desc(s, ConvSpaceEnum::Rgb, ConvFormatEnum::U8) && is_desc(d, ConvSpaceEnum::Hsl, ConvFormatEnum::U16))
+			return rgb_to_hsl;
+		if (is_desc(s, ConvSpaceEnum::Hsv, ConvFormatEnum::U16) && is_desc(d, ConvSpaceEnum::Rgb, ConvFormatEnum::U8))
+			return hsv_to_rgb;
+		if (is_desc(s, ConvSpaceEnum::Hsl, ConvFormatEnum::U16) && is_desc(d, ConvSpaceEnum::Rgb, ConvFormatEnum::U8))
+			return hsl_to_rgb;
+		if (request.Transfer > static_cast<uint32_t>(colorpp::TransferEnum::HLG))
+			return nullptr;
+		if (is_desc(s, ConvSpaceEnum::Rgb, ConvFormatEnum::U16) && is_desc(d, ConvSpaceEnum::LinearRgb, ConvFormatEnum::F32))
+			return decode_codes;
+		if (is_desc(s, ConvSpaceEnum::LinearRgb, ConvFormatEnum::F32) && is_desc(d, ConvSpaceEnum::Rgb, ConvFormatEnum::U16))
+			return encode_codes;
+		if (is_desc(s, ConvSpaceEnum::Rgb, ConvFormatEnum::F32) && is_desc(d, ConvSpaceEnum::LinearRgb, ConvFormatEnum::F32))
+			return decode;
+		if (is_desc(s, ConvSpaceEnum::LinearRgb, ConvFormatEnum::F32) && is_desc(d, ConvSpaceEnum::Rgb, ConvFormatEnum::F32))
+			return encode;
+		return nullptr;
+	}
+
+	// requests converted by the same kernel with the same parameters may be merged
+	inline std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double> get_batch_key(
+		const ConvRequest& request)
+	{
+		return std::make_tuple(request.Src.Space, request.Src.Format, request.Dst.Space, request.Dst.Format,
+			request.Transfer, request.BitDepth, request.Gamma);
+	}
+}
+
+#ifdef __linux__
+
+/*!
+	\brief Conversion daemon over a Unix domain socket
+	\details Each client message is one request plus the file descriptor of a memfd
+		buffer holding the pixels, so pixels are never copied through the socket. The
+		library tables are built once and shared by all the clients. Small requests of
+		the same kind that arrive together are converted by a single kernel call.
+*/
+class conv_server
+{
+	// requests up to this size are merged, larger ones are converted in place
+	static const size_t SmallPixels = 1 << 16;
+	// time to wait for requests of the other clients while the batch is small
+	static const long BatchWindowNs = 200000;
+
+	struct pending
+	{
+		int client;
+		ConvRequest request;
+		ConvStatusEnum status;
+		convserver_detail::Kernel kernel;
+		std::shared_ptr<unsigned char> buffer;	// mapped memfd
+	};
+
+public:
+	~conv_server()
+	{
+		close();
+	}
+
+	bool open(const std::string& path)
+	{
+		close();
+		sockaddr_un addr;
+		if (path.size() >= sizeof(addr.sun_path))
+			return false;
+		listen_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+		if (listen_ < 0)
+			return false;
+		std::memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		std::memcpy(addr.sun_path, path.c_str(), path.size());
+		// only a stale socket is replaced, never another kind of file
+		struct stat st;
+		if (::lstat(path.c_str(), &st) == 0)
+		{
+			if (!S_ISSOCK(st.st_mode))
+			{
+				close();
+				return false;
+			}
+			::unlink(path.c_str());
+		}
+		if (::bind(listen_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listen_, 64) != 0)
+		{
+			close();
+			return false;
+		}
+		path_ = path;
+		return true;
+	}
+
+	/*!
+		\brief Serve a connected SOCK_SEQPACKET socket (e.g. one end of a socketpair)
+		\param[in] client - socket, owned by the server from now on
+	*/
+	void add_client(int client)
+	{
+		clients_.push_back(client);
+	}
+
+	void close()
+	{
+		for (auto client : clients_)
+			::close(client);
+		clients_.clear();
+		if (listen_ >= 0)
+		{
+			::close(listen_);
+			::unlink(path_.c_str());
+		}
+		listen_ = -1;
+		path_.clear();
+	}
+
+	// serves until stop is set, checked at least every 200 ms
+	void run(const std::atomic<bool>& stop)
+	{
+		std::vector<pending> batch;
+		while (!stop)
+		{
+			// a negative descriptor (no listening socket) is ignored by poll
+			std::vector<pollfd> fds;
+			fds.push_back({listen_, POLLIN, 0});
+			for (auto client : clients_)
+				fds.push_back({client, POLLIN, 0});
+			if (::poll(fds.data(), fds.size(), 200) <= 0)
+				continue;
+			if (fds[0].revents & POLLIN)
+			{
+				int client = ::accept4(listen_, nullptr, nullptr, SOCK_CLOEXEC);
+				if (client >= 0)
+					clients_.push_back(client);
+			}
+			fds.erase(fds.begin());
+			receive(fds, batch);
+			// the other clients get a moment to join a small batch
+			while (!batch.empty() && clients_.size() > batch.size() && is_small(batch))
+			{
+				fds.clear();
+				for (auto client : clients_)
+					fds.push_back({client, POLLIN, 0});
+				timespec window = {0, BatchWindowNs};
+				if (::ppoll(fds.data(), fds.size(), &window, nullptr) <= 0)
+					break;
+				receive(fds, batch);
+			}
+			execute(batch);
+			for (const auto& p : batch)
+			{
+				ConvReply reply{convserver_detail::Magic, static_cast<int32_t>(p.status)};
+				// a client that doesn't read its replies must not stall the others
+				::send(p.client, &reply, sizeof(reply), MSG_NOSIGNAL | MSG_DONTWAIT);
+			}
+			batch.clear();
+		}
+	}
+
+	uint64_t get_request_count() const
+	{
+		return requests_;
+	}
+
+	uint64_t get_kernel_count() const
+	{
+		return kernels_;
+	}
+
+private:
+	static bool is_small(const std::vector<pending>& batch)
+	{
+		for (const auto& p : batch)
+			if (p.status == ConvStatusEnum::Ok && p.request.Count > SmallPixels)
+				return false;
+		return true;
+	}
+
+	// reads one message from every ready client, hung up clients are dropped
+	void receive(const std::vector<pollfd>& fds, std::vector<pending>& batch)
+	{
+		for (const auto& fd : fds)
+		{
+			if (!fd.revents)
+				continue;
+			pending p{fd.fd, ConvRequest(), ConvStatusEnum::BadRequest, nullptr, nullptr};
+			int memfd = -1;
+			if (!(fd.revents & POLLIN) || !read_request(fd.fd, p.request, memfd))
+			{
+				drop(fd.fd);
+				continue;
+			}
+			++requests_;
+			p.status = validate(p, memfd);
+			if (memfd >= 0)
+				::close(memfd);
+			batch.push_back(std::move(p));
+		}
+	}
+
+	void drop(int client)
+	{
+		for (size_t i = 0; i < clients_.size(); ++i)
+			if (clients_[i] == client)
+			{
+				::close(client);
+				clients_.erase(clients_.begin() + i);
+				return;
+			}
+	}
+
+	static bool read_request(int client, ConvRequest& request, int& memfd)
+	{
+		iovec iov = {&request, sizeof(request)};
+		union
+		{
+			cmsghdr header;
+			char data[CMSG_SPACE(sizeof(int))];
+		} control;
+		msghdr msg;
+		std::memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control.data;
+		msg.msg_controllen = sizeof(control.data);
+		auto size = ::recvmsg(client, &msg, MSG_CMSG_CLOEXEC);
+		if (size <= 0)
+			return false;
+		auto cmsg = CMSG_FIRSTHDR(&msg);
+		if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+			cmsg->cmsg_len == CMSG_LEN(sizeof(int)))
+			std::memcpy(&memfd, CMSG_DATA(cmsg), sizeof(int));
+		if (static_cast<size_t>(size) != sizeof(request) || (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)))
+			request.Magic = 0;
+		return true;
+	}
+
+	/*
+		Checks the request against the buffer and maps the buffer. The buffer must be
+		sealed against shrinking: a client truncating it after the size check would
+		make the kernels fault on the mapping (SIGBUS) and stop the daemon.
+	*/
+	static ConvStatusEnum validate(pending& p, int memfd)
+	{
+		const auto& r = p.request;
+		if (r.Magic != convserver_detail::Magic || r.Version != convserver_detail::Version || memfd < 0)
+			return ConvStatusEnum::BadRequest;
+		// the gamma keys the batches and the transfer tables of the library
+		bool is_gamma = r.Transfer == static_cast<uint32_t>(colorpp::TransferEnum::Gamma);
+		if (!std::isfinite(r.Gamma) || (is_gamma && !(r.Gamma >= convserver_detail::MinGamma &&
+			r.Gamma <= convserver_detail::MaxGamma)))
+			return ConvStatusEnum::BadRequest;
+		p.kernel = convserver_detail::get_kernel(r);
+		if (!p.kernel)
+			return ConvStatusEnum::Unsupported;
+		auto seals = ::fcntl(memfd, F_GET_SEALS);
+		if (seals < 0 || !(seals & F_SEAL_SHRINK))
+			return ConvStatusEnum::BadBuffer;
+		struct stat st;
+		if (::fstat(memfd, &st) != 0 || st.st_size <= 0)
+			return ConvStatusEnum::BadBuffer;
+		auto size = static_cast<uint64_t>(st.st_size);
+		auto src_sample = convserver_detail::get_sample_size(r.Src.Format);
+		auto dst_sample = convserver_detail::get_sample_size(r.Dst.Format);
+		if (r.Count > size / 3 || r.SrcOffset > size || r.DstOffset > size ||
+			r.Count * 3 * src_sample > size - r.SrcOffset || r.Count * 3 * dst_sample > size - r.DstOffset ||
+			r.SrcOffset % src_sample || r.DstOffset % dst_sample)
+			return ConvStatusEnum::BadBuffer;
+		// only the kernels of equal formats convert in place
+		auto src_end = r.SrcOffset + r.Count * 3 * src_sample;
+		auto dst_end = r.DstOffset + r.Count * 3 * dst_sample;
+		bool overlap = r.Count && r.SrcOffset < dst_end && r.DstOffset < src_end;
+		if (overlap && (r.SrcOffset != r.DstOffset || src_sample != dst_sample))
+			return ConvStatusEnum::BadBuffer;
+		auto addr = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+		if (addr == MAP_FAILED)
+			return ConvStatusEnum::BadBuffer;
+		auto length = static_cast<size_t>(size);
+		p.buffer.reset(static_cast<unsigned char*>(addr), [length](unsigned char* q) {
+			::munmap(q, length);
+		});
+		return ConvStatusEnum::Ok;
+	}
+
+	// one kernel call per group of small requests with the same batch key
+	void execute(std::vector<pending>& batch)
+	{
+		std::map<decltype(convserver_detail::get_batch_key(ConvRequest())), std::vector<pending*>> groups;
+		for (auto& p : batch)
+		{
+			if (p.status != ConvStatusEnum::Ok)
+				continue;
+			if (p.request.Count > SmallPixels)
+			{
+				p.kernel(p.buffer.get() + p.request.SrcOffset, p.buffer.get() + p.request.DstOffset,
+					static_cast<size_t>(p.request.Count), p.request);
+				++kernels_;
+			}
+			else
+				groups[convserver_detail::get_batch_key(p.request)].push_back(&p);
+		}
+		for (const auto& group : groups)
+		{
+			const auto& first = group.second.front()->request;
+			auto src_pixel = 3 * convserver_detail::get_sample_size(first.Src.Format);
+			auto dst_pixel = 3 * convserver_detail::get_sample_size(first.Dst.Format);
+			if (group.second.size() == 1)
+			{
+				auto p = group.second.front();
+				p->kernel(p->buffer.get() + first.SrcOffset, p->buffer.get() + first.DstOffset,
+					static_cast<size_t>(first.Count), first);
+				++kernels_;
+				continue;
+			}
+			size_t total = 0;
+			for (auto p : group.second)
+				total += static_cast<size_t>(p->request.Count);
+			src_.resize((total * src_pixel + 3) / 4);
+			dst_.resize((total * dst_pixel + 3) / 4);
+			auto src = reinterpret_cast<unsigned char*>(src_.data());
+			auto dst = reinterpret_cast<unsigned char*>(dst_.data());
+			size_t offset = 0;
+			for (auto p : group.second)
+			{
+				std::memcpy(src + offset * src_pixel, p->buffer.get() + p->request.SrcOffset,
+					static_cast<size_t>(p->request.Count) * src_pixel);
+				offset += static_cast<size_t>(p->request.Count);
+			}
+			group.second.front()->kernel(src, dst, total, first);
+			++kernels_;
+			offset = 0;
+			for (auto p : group.second)
+			{
+				std::memcpy(p->buffer.get() + p->request.DstOffset, dst + offset * dst_pixel,
+					static_cast<size_t>(p->request.Count) * dst_pixel);
+				offset += static_cast<size_t>(p->request.Count);
+			}
+		}
+	}
+
+	int listen_ = -1;
+	std::string path_;
+	std::vector<int> clients_;
+	// staging buffers of the merged requests, float aligned
+	std::vector<float> src_;
+	std::vector<float> dst_;
+	uint64_t requests_ = 0;
+	uint64_t kernels_ = 0;
+};
+
+/*!
+	\brief Client of the conversion daemon
+	\details Pixels are written to and read from the shared buffer, which is passed
+		to the daemon with every request.
+*/
+class conv_client
+{
+public:
+	~conv_client()
+	{
+		close();
+	}
+
+	bool connect(const std::string& path)
+	{
+		close();
+		sockaddr_un addr;
+		if (path.size() >= sizeof(addr.sun_path))
+			return false;
+		socket_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+		if (socket_ < 0)
+			return false;
+		std::memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		std::memcpy(addr.sun_path, path.c_str(), path.size());
+		if (::connect(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void close()
+	{
+		if (socket_ >= 0)
+			::close(socket_);
+		socket_ = -1;
+		if (buffer_)
+			::munmap(buffer_, size_);
+		buffer_ = nullptr;
+		size_ = 0;
+		if (memfd_ >= 0)
+			::close(memfd_);
+		memfd_ = -1;
+	}
+
+	// shared buffer of at least size bytes, the contents are kept when it grows
+	unsigned char* reserve(size_t size)
+	{
+		if (size <= size_)
+			return buffer_;
+		// the daemon only maps buffers that can't shrink, growing is still allowed
+		if (memfd_ < 0)
+		{
+			memfd_ = ::memfd_create("cconv", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+			if (memfd_ >= 0 && ::fcntl(memfd_, F_ADD_SEALS, F_SEAL_SHRINK) != 0)
+			{
+				::close(memfd_);
+				memfd_ = -1;
+			}
+		}
+		if (memfd_ < 0 || ::ftruncate(memfd_, static_cast<off_t>(size)) != 0)
+			return nullptr;
+		auto addr = buffer_ ? ::mremap(buffer_, size_, size, MREMAP_MAYMOVE) :
+			::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd_, 0);
+		if (addr == MAP_FAILED)
+			return nullptr;
+		buffer_ = static_cast<unsigned char*>(addr);
+		size_ = size;
+		return buffer_;
+	}
+
+	unsigned char* buffer() const
+	{
+		return buffer_;
+	}
+
+	// converts pixels of the shared buffer, waiting for the daemon
+	ConvStatusEnum convert(ConvRequest request)
+	{
+		if (socket_ < 0 || memfd_ < 0)
+			return ConvStatusEnum::NoServer;
+		request.Magic = convserver_detail::Magic;
+		request.Version = convserver_detail::Version;
+		iovec iov = {&request, sizeof(request)};
+		union
+		{
+			cmsghdr header;
+			char data[CMSG_SPACE(sizeof(int))];
+		} control;
+		std::memset(&control, 0, sizeof(control));
+		msghdr msg;
+		std::memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control.data;
+		msg.msg_controllen = sizeof(control.data);
+		auto cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+		std::memcpy(CMSG_DATA(cmsg), &memfd_, sizeof(int));
+		if (::sendmsg(socket_, &msg, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(request)))
+			return ConvStatusEnum::NoServer;
+		ConvReply reply;
+		if (::recv(socket_, &reply, sizeof(reply), 0) != static_cast<ssize_t>(sizeof(reply)) ||
+			reply.Magic != convserver_detail::Magic)
+			return ConvStatusEnum::NoServer;
+		return static_cast<ConvStatusEnum>(reply.Status);
+	}
+
+private:
+	int socket_ = -1;
+	int memfd_ = -1;
+	unsigned char* buffer_ = nullptr;
+	size_t size_ = 0;
+};
+
+#endif
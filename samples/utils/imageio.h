@@ -0,0 +1,413 @@
+/*!
+\file imageio.h
+\brief This file contains the source code of streaming PPM/PFM reader and writer
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2022 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*!
+	\brief Image file formats enum
+*/
+enum class ImageEnum
+{
+	Ppm8 = 0,	// binary PPM (P6), maxval < 256
+	Ppm16 = 1,	// binary PPM (P6), big-endian samples
+	Pfm = 2	// color PFM (PF), rows are stored bottom-up
+};
+
+namespace imageio_detail
+{
+	inline bool is_little_endian()
+	{
+		const uint16_t probe = 1;
+		unsigned char first;
+		std::memcpy(&first, &probe, 1);
+		return first == 1;
+	}
+
+	/*
+		Whole file mapping: mmap on POSIX systems, a plain buffer elsewhere.
+		Writable mappings are created with the final size and flushed on close.
+	*/
+	class file_map
+	{
+	public:
+		file_map() = default;
+		file_map(const file_map&) = delete;
+		file_map& operator=(const file_map&) = delete;
+		~file_map()
+		{
+			close();
+		}
+
+		bool open_read(const std::string& path)
+		{
+			close();
+#ifndef _WIN32
+			fd_ = ::open(path.c_str(), O_RDONLY);
+			if (fd_ < 0)
+				return false;
+			struct stat st;
+			if (fstat(fd_, &st) != 0 || st.st_size <= 0)
+				return close(), false;
+			size_ = static_cast<size_t>(st.st_size);
+			auto data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+			if (data == MAP_FAILED)
+				return close(), false;
+			// rows are read once front to back
+			madvise(data, size_, MADV_SEQUENTIAL);
+			data_ = static_cast<unsigned char*>(data);
+			return true;
+#else
+			auto file = std::fopen(path.c_str(), "rb");
+			if (!file)
+				return false;
+			std::fseek(file, 0, SEEK_END);
+			buffer_.resize(static_cast<size_t>(std::ftell(file)));
+			std::fseek(file, 0, SEEK_SET);
+			auto read = std::fread(buffer_.data(), 1, buffer_.size(), file);
+			std::fclose(file);
+			data_ = buffer_.data();
+			size_ = read;
+			return read == buffer_.size();
+#endif
+		}
+
+		bool open_write(const std::string& path, size_t size)
+		{
+			close();
+			path_ = path;
+			size_ = size;
+#ifndef _WIN32
+			fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+			if (fd_ < 0 || ftruncate(fd_, static_cast<off_t>(size)) != 0)
+				return close(), false;
+			auto data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+			if (data == MAP_FAILED)
+				return close(), false;
+			data_ = static_cast<unsigned char*>(data);
+#else
+			buffer_.assign(size, 0);
+			data_ = buffer_.data();
+			writable_ = true;
+#endif
+			return true;
+		}
+
+		void close()
+		{
+#ifndef _WIN32
+			if (data_)
+				munmap(data_, size_);
+			if (fd_ >= 0)
+				::close(fd_);
+			fd_ = -1;
+#else
+			if (writable_ && data_)
+			{
+				auto file = std::fopen(path_.c_str(), "wb");
+				if (file)
+				{
+					std::fwrite(data_, 1, size_, file);
+					std::fclose(file);
+				}
+			}
+			buffer_.clear();
+			writable_ = false;
+#endif
+			data_ = nullptr;
+			size_ = 0;
+		}
+
+		unsigned char* data() const
+		{
+			return data_;
+		}
+
+		size_t size() const
+		{
+			return size_;
+		}
+
+	private:
+		unsigned char* data_{nullptr};
+		size_t size_{0};
+		std::string path_;
+#ifndef _WIN32
+		int fd_{-1};
+#else
+		std::vector<unsigned char> buffer_;
+		bool writable_{false};
+#endif
+	};
+
+	inline size_t sample_size(ImageEnum format)
+	{
+		return format == ImageEnum::Ppm8 ? 1 : (format == ImageEnum::Ppm16 ? 2 : 4);
+	}
+
+	// decimal header number, false for anything but digits or values out of range
+	inline bool parse_size(const std::string& text, size_t& value)
+	{
+		if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos)
+			return false;
+		errno = 0;
+		auto v = std::strtoull(text.c_str(), nullptr, 10);
+		if (errno == ERANGE || v > static_cast<unsigned long long>(SIZE_MAX))
+			return false;
+		value = static_cast<size_t>(v);
+		return true;
+	}
+}
+
+/*!
+	\brief Streaming PPM/PFM reader, rows are decoded from the mapped file on demand
+*/
+class image_reader
+{
+	// header token, skipping whitespace and comments
+	bool token(size_t& pos, std::string& value) const
+	{
+		auto data = map_.data();
+		auto size = map_.size();
+		for (;;)
+		{
+			while (pos < size && std::strchr(" \t\r\n", data[pos]))
+				++pos;
+			if (pos < size && data[pos] == '#')
+			{
+				while (pos < size && data[pos] != '\n')
+					++pos;
+				continue;
+			}
+			break;
+		}
+		value.clear();
+		while (pos < size && !std::strchr(" \t\r\n", data[pos]))
+			value += static_cast<char>(data[pos++]);
+		return !value.empty();
+	}
+
+public:
+	bool open(const std::string& path)
+	{
+		if (!map_.open_read(path))
+			return false;
+		size_t pos = 0;
+		std::string magic, width, height, scale;
+		if (!token(pos, magic) || !token(pos, width) || !token(pos, height) || !token(pos, scale))
+			return close(), false;
+		if (!imageio_detail::parse_size(width, width_) || !imageio_detail::parse_size(height, height_))
+			return close(), false;
+		if (magic == "P6")
+		{
+			size_t max_value = 0;
+			if (!imageio_detail::parse_size(scale, max_value) || max_value == 0 || max_value > 65535)
+				return close(), false;
+			max_value_ = static_cast<unsigned long>(max_value);
+			format_ = max_value_ < 256 ? ImageEnum::Ppm8 : ImageEnum::Ppm16;
+		}
+		else if (magic == "PF")
+		{
+			format_ = ImageEnum::Pfm;
+			swap_ = (std::strtod(scale.c_str(), nullptr) < 0.) != imageio_detail::is_little_endian();
+		}
+		else
+			return close(), false;
+		// a single whitespace character ends the header
+		offset_ = pos + 1;
+		// the pixels must fit the file, checked without overflowing for huge dimensions
+		if (width_ == 0 || height_ == 0 || offset_ >= map_.size() ||
+			width_ > (map_.size() - offset_) / height_ / (3 * imageio_detail::sample_size(format_)))
+			return close(), false;
+		return true;
+	}
+
+	void close()
+	{
+		map_.close();
+		width_ = height_ = 0;
+	}
+
+	size_t width() const
+	{
+		return width_;
+	}
+
+	size_t height() const
+	{
+		return height_;
+	}
+
+	ImageEnum format() const
+	{
+		return format_;
+	}
+
+	// bytes of a stored row
+	size_t row_size() const
+	{
+		return width_ * 3 * imageio_detail::sample_size(format_);
+	}
+
+	// stored row y counted from the top, zero copy
+	const unsigned char* row(size_t y) const
+	{
+		auto stored = format_ == ImageEnum::Pfm ? height_ - 1 - y : y;
+		return map_.data() + offset_ + stored * row_size();
+	}
+
+	/*
+		Decode rows [y, y + count) to RGB floats, 3 * width per row. Integer samples
+		are the centers of the from_dbl bins, (v + 0.5) / (maxval + 1), so quantize
+		restores them after any conversion that is exact to half a code.
+	*/
+	void read_rows(size_t y, size_t count, float* dst) const
+	{
+		const float scale = 1.f / (max_value_ + 1);
+		const float bias = .5f * scale;
+		for (size_t r = 0; r < count; ++r, dst += 3 * width_)
+		{
+			auto src = row(y + r);
+			auto samples = 3 * width_;
+			if (format_ == ImageEnum::Ppm8)
+				for (size_t i = 0; i < samples; ++i)
+					dst[i] = src[i] * scale + bias;
+			else if (format_ == ImageEnum::Ppm16)
+				for (size_t i = 0; i < samples; ++i)
+					dst[i] = ((src[2 * i] << 8) | src[2 * i + 1]) * scale + bias;
+			else
+			{
+				std::memcpy(dst, src, samples * sizeof(float));
+				if (swap_)
+					for (size_t i = 0; i < samples; ++i)
+					{
+						uint32_t v;
+						std::memcpy(&v, dst + i, 4);
+						v = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+						std::memcpy(dst + i, &v, 4);
+					}
+			}
+		}
+	}
+
+private:
+	imageio_detail::file_map map_;
+	ImageEnum format_{ImageEnum::Ppm8};
+	size_t width_{0};
+	size_t height_{0};
+	size_t offset_{0};
+	unsigned long max_value_{255};
+	bool swap_{false};
+};
+
+/*!
+	\brief Streaming PPM/PFM writer into a file mapped with its final size
+*/
+class image_writer
+{
+public:
+	bool open(const std::string& path, ImageEnum format, size_t width, size_t height)
+	{
+		std::string header = format == ImageEnum::Pfm ? "PF\n" : "P6\n";
+		header += std::to_string(width) + " " + std::to_string(height) + "\n";
+		if (format == ImageEnum::Pfm)
+			header += imageio_detail::is_little_endian() ? "-1.0\n" : "1.0\n";
+		else
+			header += format == ImageEnum::Ppm8 ? "255\n" : "65535\n";
+		format_ = format;
+		width_ = width;
+		height_ = height;
+		offset_ = header.size();
+		if (!map_.open_write(path, offset_ + row_size() * height))
+			return false;
+		std::memcpy(map_.data(), header.data(), header.size());
+		return true;
+	}
+
+	void close()
+	{
+		map_.close();
+	}
+
+	size_t row_size() const
+	{
+		return width_ * 3 * imageio_detail::sample_size(format_);
+	}
+
+	// stored row y counted from the top to be filled in place
+	unsigned char* row(size_t y) const
+	{
+		auto stored = format_ == ImageEnum::Pfm ? height_ - 1 - y : y;
+		return map_.data() + offset_ + stored * row_size();
+	}
+
+	// rows [y, y + count) of native samples: bytes, words or floats depending on the format
+	void write_rows(size_t y, size_t count, const void* src) const
+	{
+		auto bytes = static_cast<const unsigned char*>(src);
+		for (size_t r = 0; r < count; ++r, bytes += row_size())
+		{
+			auto dst = row(y + r);
+			if (format_ == ImageEnum::Ppm16)
+				for (size_t i = 0; i < 3 * width_; ++i)
+				{
+					uint16_t v;
+					std::memcpy(&v, bytes + 2 * i, 2);
+					dst[2 * i] = static_cast<unsigned char>(v >> 8);
+					dst[2 * i + 1] = static_cast<unsigned char>(v & 0xff);
+				}
+			else
+				std::memcpy(dst, bytes, row_size());
+		}
+	}
+
+private:
+	imageio_detail::file_map map_;
+	ImageEnum format_{ImageEnum::Ppm8};
+	size_t width_{0};
+	size_t height_{0};
+	size_t offset_{0};
+};
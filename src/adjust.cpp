@@ -0,0 +1,264 @@
+/*!
+\file adjust.cpp
+\brief This file contains the source code of the fused image adjustments
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "adjust.h"
+#include "hexcone.h"
+#include "parallel.h"
+#include "stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t AdjustGrain = 4096;
+	const size_t ByteChunk = 256;	// 8-bit pixels decoded on the stack at once
+	const double Pi = 3.14159265358979323846;
+
+	void affine_kernel(const float* src, float* dst, size_t count, const float m[4][3])
+	{
+		const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+		const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+		const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+		const float o0 = m[3][0], o1 = m[3][1], o2 = m[3][2];
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto r = src[3 * i];
+			auto g = src[3 * i + 1];
+			auto b = src[3 * i + 2];
+			dst[3 * i] = std::min(std::max(r * m00 + g * m10 + b * m20 + o0, 0.f), 1.f);
+			dst[3 * i + 1] = std::min(std::max(r * m01 + g * m11 + b * m21 + o1, 0.f), 1.f);
+			dst[3 * i + 2] = std::min(std::max(r * m02 + g * m12 + b * m22 + o2, 0.f), 1.f);
+		}
+	}
+
+	/*
+		Hue rotation keeps the channel maximum and minimum in both HSV and HSL, so the
+		hue in sextants is rotated and the channels are rebuilt by the hexcone formula.
+		Saturation and brightness then scale the chroma around V or L with the limits
+		of the models, so the result equals the clamped HSV/HSL round trip.
+	*/
+	template<bool Hsl>
+	void hexcone_kernel(const float* src, float* dst, size_t count, float shift,
+		float saturation, float brightness, float contrast)
+	{
+		const float pivot = 0.5f * (1.f - contrast);
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto r = src[3 * i];
+			auto g = src[3 * i + 1];
+			auto b = src[3 * i + 2];
+			auto mx = std::max(r, std::max(g, b));
+			auto mn = std::min(r, std::min(g, b));
+			auto d = mx - mn;
+			// grays get a huge inverse chroma multiplied by zero differences
+			auto inv = 1.f / (d + 1e-30f);
+			auto hr = (g - b) * inv;
+			auto hg = 2.f + (b - r) * inv;
+			auto hb = 4.f + (r - g) * inv;
+			auto h = mx == g ? hg : hb;
+			h = mx == r ? hr : h;
+			h += shift + 6.f;
+			r = detail::hexcone(mx, d, detail::wrap6(h + 5.f));
+			g = detail::hexcone(mx, d, detail::wrap6(h + 3.f));
+			b = detail::hexcone(mx, d, detail::wrap6(h + 1.f));
+			if (Hsl)
+			{
+				auto l = 0.5f * (mx + mn);
+				auto ks = std::min(saturation, 2.f * std::min(l, 1.f - l) * inv);
+				auto l2 = std::min(l * brightness, 1.f);
+				auto range = 1.f - std::abs(2.f * l - 1.f);
+				auto ratio = ks * (1.f - std::abs(2.f * l2 - 1.f)) / (range + 1e-30f);
+				r = l2 + (r - l) * ratio;
+				g = l2 + (g - l) * ratio;
+				b = l2 + (b - l) * ratio;
+			}
+			else
+			{
+				auto ks = std::min(saturation, mx * inv);
+				auto kv = std::min(brightness, 1.f / (mx + 1e-30f));
+				r = (mx - (mx - r) * ks) * kv;
+				g = (mx - (mx - g) * ks) * kv;
+				b = (mx - (mx - b) * ks) * kv;
+			}
+			dst[3 * i] = std::min(std::max(r * contrast + pivot, 0.f), 1.f);
+			dst[3 * i + 1] = std::min(std::max(g * contrast + pivot, 0.f), 1.f);
+			dst[3 * i + 2] = std::min(std::max(b * contrast + pivot, 0.f), 1.f);
+		}
+	}
+
+	/*
+		Parameters resolved once per call; the kernels are chosen by the model
+		outside of the pixel loops.
+	*/
+	class Adjuster
+	{
+	public:
+		explicit Adjuster(const AdjustParams& params) : mode_(params.Mode)
+		{
+			double m[4][3];
+			get_adjust_matrix(params, m);
+			for (int i = 0; i < 4; ++i)
+				for (int j = 0; j < 3; ++j)
+					matrix_[i][j] = static_cast<float>(m[i][j]);
+			auto shift = std::fmod(params.Hue / 60., 6.);
+			shift_ = static_cast<float>(shift < 0. ? shift + 6. : shift);
+			saturation_ = static_cast<float>(std::max(params.Saturation, 0.));
+			brightness_ = static_cast<float>(std::max(params.Brightness, 0.));
+			contrast_ = static_cast<float>(params.Contrast);
+		}
+
+		void operator()(const float* src, float* dst, size_t count) const
+		{
+			if (mode_ == AdjustEnum::Hsv)
+				hexcone_kernel<false>(src, dst, count, shift_, saturation_, brightness_, contrast_);
+			else if (mode_ == AdjustEnum::Hsl)
+				hexcone_kernel<true>(src, dst, count, shift_, saturation_, brightness_, contrast_);
+			else
+				affine_kernel(src, dst, count, matrix_);
+		}
+
+	private:
+		AdjustEnum mode_;
+		float matrix_[4][3];
+		float shift_;
+		float saturation_;
+		float brightness_;
+		float contrast_;
+	};
+}
+
+/*!
+	\brief Create adjustment parameters without any change
+	\param[in] mode - adjustment model (see AdjustEnum)
+	\return adjustment parameters
+*/
+AdjustParams get_adjust_params(AdjustEnum mode)
+{
+	AdjustParams result;
+	result.Mode = mode;
+	result.Hue = 0.0;
+	result.Saturation = 1.0;
+	result.Brightness = 1.0;
+	result.Contrast = 1.0;
+	result.Luma[0] = 0.2126;
+	result.Luma[1] = 0.7152;
+	result.Luma[2] = 0.0722;
+	return result;
+}
+
+/*!
+	\brief Get the fused matrix of the Luminance model
+	\param[in] params - adjustment parameters
+	\param[out] m - affine matrix
+*/
+void get_adjust_matrix(const AdjustParams& params, double m[4][3])
+{
+	// YCbCr with the luma weights: hue rotates and saturation scales the chroma plane
+	const double lr = params.Luma[0], lg = params.Luma[1], lb = params.Luma[2];
+	const double kb = 2. * (1. - lb), kr = 2. * (1. - lr);
+	const double to_ycc[3][3] = {
+		{lr, lg, lb},
+		{-lr / kb, -lg / kb, (1. - lb) / kb},
+		{(1. - lr) / kr, -lg / kr, -lb / kr}};
+	const double from_ycc[3][3] = {
+		{1., 0., kr},
+		{(1. - lr - lb) / lg, -lb * kb / lg, -lr * kr / lg},
+		{1., kb, 0.}};
+	auto angle = params.Hue * Pi / 180.;
+	auto s = std::max(params.Saturation, 0.);
+	const double chroma[3][3] = {
+		{1., 0., 0.},
+		{0., s * std::cos(angle), -s * std::sin(angle)},
+		{0., s * std::sin(angle), s * std::cos(angle)}};
+	double t[3][3];
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 3; ++j)
+			t[i][j] = chroma[i][0] * to_ycc[0][j] + chroma[i][1] * to_ycc[1][j] + chroma[i][2] * to_ycc[2][j];
+	auto scale = std::max(params.Brightness, 0.) * params.Contrast;
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 3; ++j)
+			// transposed to the library convention
+			m[j][i] = scale * (from_ycc[i][0] * t[0][j] + from_ycc[i][1] * t[1][j] + from_ycc[i][2] * t[2][j]);
+	for (int j = 0; j < 3; ++j)
+		m[3][j] = 0.5 * (1. - params.Contrast);
+}
+
+/*!
+    \brief Batch adjustment of interleaved RGB in a single pass
+    \param[in] src - RGB in 0..1.0 range, 3 * count floats
+    \param[out] dst - adjusted RGB clamped to 0..1.0, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+	\param[in] params - adjustment parameters
+*/
+void adjust(const float* src, float* dst, size_t count, const AdjustParams& params)
+{
+	COLORPP_STATS_SCOPE("adjust/float", count);
+	const Adjuster adjuster(params);
+	parallel_for(count, AdjustGrain, [&](size_t begin, size_t end) {
+		adjuster(src + 3 * begin, dst + 3 * begin, end - begin);
+	});
+}
+
+/*!
+    \brief Batch adjustment of interleaved 8-bit RGB in a single pass
+    \param[in] src - source pixels, 3 * count bytes
+    \param[out] dst - adjusted pixels, 3 * count bytes (may alias src)
+    \param[in] count - number of pixels
+	\param[in] params - adjustment parameters
+*/
+void adjust(const unsigned char* src, unsigned char* dst, size_t count, const AdjustParams& params)
+{
+	COLORPP_STATS_SCOPE("adjust/8", count);
+	const Adjuster adjuster(params);
+	parallel_for(count, AdjustGrain, [&](size_t begin, size_t end) {
+		float buffer[3 * ByteChunk];
+		for (size_t i = begin; i < end; i += ByteChunk)
+		{
+			auto n = 3 * std::min(ByteChunk, end - i);
+			auto s = src + 3 * i;
+			auto d = dst + 3 * i;
+			for (size_t k = 0; k < n; ++k)
+				buffer[k] = (s[k] + 0.5f) * (1.f / 256.f);
+			adjuster(buffer, buffer, n / 3);
+			for (size_t k = 0; k < n; ++k)
+				d[k] = static_cast<unsigned char>(std::min(buffer[k] * 256.f, 255.f));
+		}
+	});
+}
+
+}
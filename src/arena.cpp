@@ -0,0 +1,355 @@
+/*!
+\file arena.cpp
+\brief Thread arenas of scratch buffers
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "arena.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t Alignment = 64;
+	// the smallest block is a page
+	const int MinShift = 12;
+	const int ClassCount = 40;
+	// cached blocks of a size per thread
+	const size_t MaxCached = 4;
+	const size_t DefaultHugePage = 2 << 20;
+
+	enum BlockKind
+	{
+		EmptyBlock = 0,
+		HeapBlock = 1,
+		MappedBlock = 2,
+		HugeBlock = 3
+	};
+
+	std::atomic<int> huge_mode(static_cast<int>(HugePageEnum::None));
+	std::atomic<size_t> huge_threshold(2 << 20);
+	std::atomic<size_t> cache_limit(64 << 20);
+
+	struct Counters
+	{
+		std::atomic<uint64_t> in_use{0};
+		std::atomic<uint64_t> peak{0};
+		std::atomic<uint64_t> reserved{0};
+		std::atomic<uint64_t> huge{0};
+		std::atomic<uint64_t> allocations{0};
+		std::atomic<uint64_t> misses{0};
+	};
+
+	Counters& get_counters()
+	{
+		static Counters counters;
+		return counters;
+	}
+
+	int get_class(size_t size)
+	{
+		int result = 0;
+		while (result + 1 < ClassCount && (static_cast<size_t>(1) << (result + MinShift)) < size)
+			++result;
+		return result;
+	}
+
+#ifdef __linux__
+	// default size of explicit huge pages
+	size_t get_huge_page_size()
+	{
+		static const size_t size = [] {
+			size_t kb = 0;
+			if (auto file = std::fopen("/proc/meminfo", "r"))
+			{
+				char line[128];
+				while (std::fgets(line, sizeof(line), file))
+					if (std::sscanf(line, "Hugepagesize: %zu kB", &kb) == 1)
+						break;
+				std::fclose(file);
+			}
+			return kb ? kb << 10 : DefaultHugePage;
+		}();
+		return size;
+	}
+#endif
+
+	detail::ArenaBlock new_block(size_t size)
+	{
+		detail::ArenaBlock block{nullptr, size, HeapBlock};
+#ifdef __linux__
+		auto mode = static_cast<HugePageEnum>(huge_mode.load(std::memory_order_relaxed));
+		if (mode != HugePageEnum::None && size >= huge_threshold.load(std::memory_order_relaxed))
+		{
+			void* addr = MAP_FAILED;
+			if (mode == HugePageEnum::Explicit)
+			{
+				// the mapping takes whole huge pages and munmap fails with a shorter length
+				auto page = get_huge_page_size();
+				auto huge_size = (size + page - 1) / page * page;
+				addr = ::mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+				if (addr != MAP_FAILED)
+					block.size = huge_size;
+			}
+			if (addr != MAP_FAILED)
+				block.kind = HugeBlock;
+			else
+			{
+				// the huge page pool is empty or not configured
+				addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				block.kind = MappedBlock;
+				if (addr != MAP_FAILED && mode == HugePageEnum::Transparent && ::madvise(addr, size, MADV_HUGEPAGE) == 0)
+					block.kind = HugeBlock;
+			}
+			if (addr != MAP_FAILED)
+			{
+				block.data = addr;
+				return block;
+			}
+			block.kind = HeapBlock;
+		}
+#endif
+#ifdef _WIN32
+		block.data = _aligned_malloc(size, Alignment);
+#else
+		if (posix_memalign(&block.data, Alignment, size) != 0)
+			block.data = nullptr;
+#endif
+		return block;
+	}
+
+	void free_block(const detail::ArenaBlock& block)
+	{
+		auto& counters = get_counters();
+		counters.reserved -= block.size;
+		if (block.kind == HugeBlock)
+			counters.huge -= block.size;
+#ifndef _WIN32
+		if (block.kind == MappedBlock || block.kind == HugeBlock)
+		{
+			::munmap(block.data, block.size);
+			return;
+		}
+#endif
+#ifdef _WIN32
+		_aligned_free(block.data);
+#else
+		std::free(block.data);
+#endif
+	}
+
+	struct ThreadArena;
+
+	// arenas of the live threads, so any thread can trim all the caches
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<ThreadArena*> arenas;
+	};
+
+	Registry& get_registry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	struct ThreadArena
+	{
+		// the owner thread takes it too, only trimming contends for it
+		std::mutex mutex;
+		std::vector<detail::ArenaBlock> cached[ClassCount];
+		size_t cached_bytes = 0;
+
+		ThreadArena()
+		{
+			auto& registry = get_registry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.arenas.push_back(this);
+		}
+
+		~ThreadArena()
+		{
+			{
+				auto& registry = get_registry();
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				registry.arenas.erase(std::find(registry.arenas.begin(), registry.arenas.end(), this));
+			}
+			release();
+		}
+
+		void release()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (auto& blocks : cached)
+			{
+				for (const auto& block : blocks)
+					free_block(block);
+				blocks.clear();
+			}
+			cached_bytes = 0;
+		}
+	};
+
+	ThreadArena& get_thread_arena()
+	{
+		static thread_local ThreadArena arena;
+		return arena;
+	}
+}
+
+/*!
+	\brief Set the huge page mode of large scratch blocks
+	\param[in] mode - huge page mode (see HugePageEnum)
+	\param[in] threshold - smallest block on huge pages in bytes
+*/
+void set_arena_huge_pages(HugePageEnum mode, size_t threshold)
+{
+	huge_threshold = threshold;
+	huge_mode = static_cast<int>(mode);
+}
+
+/*!
+	\brief Set the maximum of the cached scratch memory per thread
+	\param[in] bytes - cached bytes of a thread, larger blocks are freed on release
+*/
+void set_arena_cache_limit(size_t bytes)
+{
+	cache_limit = bytes;
+}
+
+/*!
+	\brief Get the scratch memory counters
+	\return counters
+*/
+ArenaStats get_arena_stats()
+{
+	auto& counters = get_counters();
+	return ArenaStats{counters.in_use, counters.peak, counters.reserved, counters.huge,
+		counters.allocations, counters.misses};
+}
+
+/*!
+	\brief Reset the peak of the scratch memory to the memory in use
+*/
+void reset_arena_peak()
+{
+	auto& counters = get_counters();
+	counters.peak = counters.in_use.load();
+}
+
+/*!
+	\brief Free the cached scratch blocks of all the threads
+*/
+void release_arena_memory()
+{
+	auto& registry = get_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (auto arena : registry.arenas)
+		arena->release();
+}
+
+namespace detail
+{
+
+ArenaBlock arena_allocate(size_t size)
+{
+	if (size == 0)
+		return ArenaBlock{nullptr, 0, EmptyBlock};
+	auto& counters = get_counters();
+	auto cls = get_class(size);
+	auto& arena = get_thread_arena();
+	ArenaBlock block{nullptr, 0, EmptyBlock};
+	{
+		std::lock_guard<std::mutex> lock(arena.mutex);
+		auto& cached = arena.cached[cls];
+		if (!cached.empty() && cached.back().size >= size)
+		{
+			block = cached.back();
+			cached.pop_back();
+			arena.cached_bytes -= block.size;
+		}
+	}
+	if (!block.data)
+	{
+		block = new_block(std::max(static_cast<size_t>(1) << (cls + MinShift), size));
+		// same failure as the vectors the buffers replace
+		if (!block.data)
+			throw std::bad_alloc();
+		counters.reserved += block.size;
+		if (block.kind == HugeBlock)
+			counters.huge += block.size;
+		++counters.misses;
+	}
+	++counters.allocations;
+	auto in_use = counters.in_use += block.size;
+	auto peak = counters.peak.load(std::memory_order_relaxed);
+	while (in_use > peak && !counters.peak.compare_exchange_weak(peak, in_use))
+	{
+	}
+	return block;
+}
+
+void arena_release(const ArenaBlock& block)
+{
+	if (block.kind == EmptyBlock)
+		return;
+	get_counters().in_use -= block.size;
+	auto& arena = get_thread_arena();
+	{
+		std::lock_guard<std::mutex> lock(arena.mutex);
+		auto& cached = arena.cached[get_class(block.size)];
+		if (cached.size() < MaxCached && arena.cached_bytes + block.size <= cache_limit.load(std::memory_order_relaxed))
+		{
+			cached.push_back(block);
+			arena.cached_bytes += block.size;
+			return;
+		}
+	}
+	free_block(block);
+}
+
+}
+
+}
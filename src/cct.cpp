@@ -0,0 +1,237 @@
+/*!
+\file cct.cpp
+\brief This file contains the source code of correlated color temperature
+	calculations as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "cct.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace colorpp
+{
+
+namespace
+{
+	// loci are tabulated in reciprocal megakelvin (mired) where they are smooth
+	const double MiredStep = 0.5;
+	// largest distance from the Planckian locus in CIE 1960 uv with a meaningful CCT (CIE 15:2004)
+	const double MaxDuv = 0.05;
+
+	// CIE daylight locus (CIE 15:2004)
+	void daylight_xy(double t, double& x, double& y)
+	{
+		double t2 = t * t;
+		double t3 = t2 * t;
+		if (t <= 7000.)
+			x = -4.6070e9 / t3 + 2.9678e6 / t2 + 0.09911e3 / t + 0.244063;
+		else
+			x = -2.0064e9 / t3 + 1.9018e6 / t2 + 0.24748e3 / t + 0.237040;
+		y = -3.000 * x * x + 2.870 * x - 0.275;
+	}
+
+	// Planckian locus, cubic spline approximation (Kim et al., 2002)
+	void planckian_xy(double t, double& x, double& y)
+	{
+		double t2 = t * t;
+		double t3 = t2 * t;
+		if (t <= 4000.)
+			x = -0.2661239e9 / t3 - 0.2343589e6 / t2 + 0.8776956e3 / t + 0.179910;
+		else
+			x = -3.0258469e9 / t3 + 2.1070379e6 / t2 + 0.2226347e3 / t + 0.240390;
+		double x2 = x * x;
+		double x3 = x2 * x;
+		if (t <= 2222.)
+			y = -1.1063814 * x3 - 1.34811020 * x2 + 2.18555832 * x - 0.20219683;
+		else if (t <= 4000.)
+			y = -0.9549476 * x3 - 1.37418593 * x2 + 2.09137015 * x - 0.16748867;
+		else
+			y = 3.0817580 * x3 - 5.87338670 * x2 + 3.75112997 * x - 0.37001483;
+	}
+
+	struct LocusTable
+	{
+		double min_mired;
+		double max_mired;
+		std::vector<double> xy;
+
+		LocusTable(double min_cct, double max_cct, void (*locus)(double, double&, double&))
+			: min_mired(1e6 / max_cct), max_mired(1e6 / min_cct)
+		{
+			auto count = static_cast<size_t>(std::ceil((max_mired - min_mired) / MiredStep)) + 1;
+			xy.resize(2 * count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto mired = std::min(min_mired + i * MiredStep, max_mired);
+				locus(1e6 / mired, xy[2 * i], xy[2 * i + 1]);
+			}
+		}
+
+		bool lookup(double cct, double& x, double& y) const
+		{
+			auto mired = 1e6 / cct;
+			bool in_range = mired >= min_mired && mired <= max_mired;
+			mired = std::min(std::max(mired, min_mired), max_mired);
+			auto pos = (mired - min_mired) / MiredStep;
+			auto i = std::min(static_cast<size_t>(pos), xy.size() / 2 - 2);
+			auto t = pos - i;
+			x = xy[2 * i] + t * (xy[2 * i + 2] - xy[2 * i]);
+			y = xy[2 * i + 1] + t * (xy[2 * i + 3] - xy[2 * i + 1]);
+			return in_range;
+		}
+	};
+
+	const LocusTable& get_locus_table(LocusEnum locus)
+	{
+		static const LocusTable daylight(4000., 25000., daylight_xy);
+		static const LocusTable planckian(1667., 25000., planckian_xy);
+		return locus == LocusEnum::Planckian ? planckian : daylight;
+	}
+
+	// brucelindblum.com XYZ to CCT (Robertson's method) C++ porting
+
+	// reciprocal temperature (K)
+	const double Rt[31] = {
+		1e-300, 10.0e-6, 20.0e-6, 30.0e-6, 40.0e-6, 50.0e-6,
+		60.0e-6, 70.0e-6, 80.0e-6, 90.0e-6, 100.0e-6, 125.0e-6,
+		150.0e-6, 175.0e-6, 200.0e-6, 225.0e-6, 250.0e-6, 275.0e-6,
+		300.0e-6, 325.0e-6, 350.0e-6, 375.0e-6, 400.0e-6, 425.0e-6,
+		450.0e-6, 475.0e-6, 500.0e-6, 525.0e-6, 550.0e-6, 575.0e-6,
+		600.0e-6
+	};
+
+	// u, v, slope of the isotemperature lines
+	const double Uvt[31][3] = {
+		{0.18006, 0.26352, -0.24341},
+		{0.18066, 0.26589, -0.25479},
+		{0.18133, 0.26846, -0.26876},
+		{0.18208, 0.27119, -0.28539},
+		{0.18293, 0.27407, -0.30470},
+		{0.18388, 0.27709, -0.32675},
+		{0.18494, 0.28021, -0.35156},
+		{0.18611, 0.28342, -0.37915},
+		{0.18740, 0.28668, -0.40955},
+		{0.18880, 0.28997, -0.44278},
+		{0.19032, 0.29326, -0.47888},
+		{0.19462, 0.30141, -0.58204},
+		{0.19962, 0.30921, -0.70471},
+		{0.20525, 0.31647, -0.84901},
+		{0.21142, 0.32312, -1.0182},
+		{0.21807, 0.32909, -1.2168},
+		{0.22511, 0.33439, -1.4512},
+		{0.23247, 0.33904, -1.7298},
+		{0.24010, 0.34308, -2.0637},
+		{0.24792, 0.34655, -2.4681},	// 0.24792 corrects 0.24702 misprinted in W&S
+		{0.25591, 0.34951, -2.9641},
+		{0.26400, 0.35200, -3.5814},
+		{0.27218, 0.35407, -4.3633},
+		{0.28039, 0.35577, -5.3762},
+		{0.28863, 0.35714, -6.7262},
+		{0.29685, 0.35823, -8.5955},
+		{0.30505, 0.35907, -11.324},
+		{0.31320, 0.35968, -15.628},
+		{0.32129, 0.36011, -23.325},
+		{0.32931, 0.36038, -40.770},
+		{0.33724, 0.36051, -116.45}
+	};
+}
+
+/*!
+    \brief Chromaticity of a correlated color temperature
+	\param[in] cct - correlated color temperature in Kelvin
+	\param[out] x - x chromaticity
+	\param[out] y - y chromaticity
+	\param[in] locus - daylight or Planckian locus (see LocusEnum)
+	\return false if cct is out of the locus range (the nearest end is used)
+*/
+bool cct_to_xy(double cct, double& x, double& y, LocusEnum locus)
+{
+	if (!(cct > 0.))
+		cct = 1.;
+	return get_locus_table(locus).lookup(cct, x, y);
+}
+
+/*!
+    \brief Reference white of a correlated color temperature
+	\param[in] cct - correlated color temperature in Kelvin
+	\param[out] white - XYZ of the white with Y = 1
+	\param[in] locus - daylight or Planckian locus (see LocusEnum)
+	\return false if cct is out of the locus range (the nearest end is used)
+*/
+bool cct_to_white(double cct, XYZ white, LocusEnum locus)
+{
+	double x, y;
+	auto result = cct_to_xy(cct, x, y, locus);
+	white[0] = x / y;
+	white[1] = 1.0;
+	white[2] = (1.0 - x - y) / y;
+	return result;
+}
+
+/*!
+    \brief Correlated color temperature of a color (Robertson's method)
+	\param[in] x - x channel
+  	\param[in] y - y channel
+  	\param[in] z - z channel
+	\return temperature in Kelvin or -1 if the color is farther than Duv 0.05 from the
+		Planckian locus or below 1666.7 K
+*/
+double xyz_to_cct(double x, double y, double z)
+{
+	auto denominator = x + 15.0 * y + 3.0 * z;
+	if ((x < 1.0e-20 && y < 1.0e-20 && z < 1.0e-20) || denominator == 0.0)
+		return -1.0;
+	auto us = (4.0 * x) / denominator;
+	auto vs = (6.0 * y) / denominator;
+	double dm = 0.0;
+	double di = 0.0;
+	int i;
+	for (i = 0; i < 31; ++i)
+	{
+		di = (vs - Uvt[i][1]) - Uvt[i][2] * (us - Uvt[i][0]);
+		// found lines bounding (us, vs): i-1 and i
+		if (i > 0 && ((di < 0.0 && dm >= 0.0) || (di >= 0.0 && dm < 0.0)))
+			break;
+		dm = di;
+	}
+	if (i == 31)
+		return -1.0;
+	di = di / std::sqrt(1.0 + Uvt[i][2] * Uvt[i][2]);
+	dm = dm / std::sqrt(1.0 + Uvt[i - 1][2] * Uvt[i - 1][2]);
+	auto p = dm / (dm - di);	// interpolation parameter, 0.0: i-1, 1.0: i
+	auto du = us - (Uvt[i - 1][0] + p * (Uvt[i][0] - Uvt[i - 1][0]));
+	auto dv = vs - (Uvt[i - 1][1] + p * (Uvt[i][1] - Uvt[i - 1][1]));
+	if (du * du + dv * dv > MaxDuv * MaxDuv)
+		return -1.0;
+	return 1.0 / (Rt[i - 1] + p * (Rt[i] - Rt[i - 1]));
+}
+
+}
@@ -0,0 +1,152 @@
+/*!
+\file cmyk.cpp
+\brief This file contains the source code of CMYK conversion
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "cmyk.h"
+#include "parallel.h"
+#include "stats.h"
+
+#include <algorithm>
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t BatchGrain = 16384;
+
+	// black divides zero differences (see hexcone.h)
+	void rgb_to_cmyk_kernel(const float* src, float* dst, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto r = src[3 * i];
+			auto g = src[3 * i + 1];
+			auto b = src[3 * i + 2];
+			auto mx = std::max(r, std::max(g, b));
+			auto inv = 1.f / (mx + 1e-30f);
+			dst[4 * i] = (mx - r) * inv;
+			dst[4 * i + 1] = (mx - g) * inv;
+			dst[4 * i + 2] = (mx - b) * inv;
+			dst[4 * i + 3] = 1.f - mx;
+		}
+	}
+
+	void cmyk_to_rgb_kernel(const float* src, float* dst, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto w = 1.f - src[4 * i + 3];
+			dst[3 * i] = (1.f - src[4 * i]) * w;
+			dst[3 * i + 1] = (1.f - src[4 * i + 1]) * w;
+			dst[3 * i + 2] = (1.f - src[4 * i + 2]) * w;
+		}
+	}
+}
+
+/*!
+    \brief Conversion from RGB to CMYK color model
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] c - cyan channel in 0..1.0 range
+  	\param[out] m - magenta channel in 0..1.0 range
+  	\param[out] y - yellow channel in 0..1.0 range
+  	\param[out] k - black channel in 0..1.0 range
+*/
+void rgb_to_cmyk(double r, double g, double b,
+	double& c, double& m, double& y, double& k)
+{
+	auto mx = std::max(r, std::max(g, b));
+	k = 1. - mx;
+	if (mx > 0.)
+	{
+		c = (mx - r) / mx;
+		m = (mx - g) / mx;
+		y = (mx - b) / mx;
+	}
+	else
+	{
+		c = 0.;
+		m = 0.;
+		y = 0.;
+	}
+}
+
+/*!
+    \brief Conversion from CMYK to RGB color model
+ 	\param[in] c - cyan channel in 0..1.0 range
+  	\param[in] m - magenta channel in 0..1.0 range
+  	\param[in] y - yellow channel in 0..1.0 range
+  	\param[in] k - black channel in 0..1.0 range
+    \param[out] r - red channel in 0..1.0 range
+	\param[out] g - green channel in 0..1.0 range
+ 	\param[out] b - blue channel in 0..1.0 range
+*/
+void cmyk_to_rgb(double c, double m, double y, double k,
+	double& r, double& g, double& b)
+{
+	r = (1. - c) * (1. - k);
+	g = (1. - m) * (1. - k);
+	b = (1. - y) * (1. - k);
+}
+
+/*!
+    \brief Batch conversion from RGB to CMYK color model
+    \param[in] src - RGB in 0..1.0 range, 3 * count floats
+    \param[out] dst - CMYK in 0..1.0 range, 4 * count floats
+    \param[in] count - number of pixels
+*/
+void rgb_to_cmyk(const float* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("rgb_to_cmyk/float", count);
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		rgb_to_cmyk_kernel(src + 3 * begin, dst + 4 * begin, end - begin);
+	});
+}
+
+/*!
+    \brief Batch conversion from CMYK to RGB color model
+    \param[in] src - CMYK in 0..1.0 range, 4 * count floats
+    \param[out] dst - RGB in 0..1.0 range, 3 * count floats
+    \param[in] count - number of pixels
+*/
+void cmyk_to_rgb(const float* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("cmyk_to_rgb/float", count);
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		cmyk_to_rgb_kernel(src + 4 * begin, dst + 3 * begin, end - begin);
+	});
+}
+
+}
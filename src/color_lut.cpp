@@ -0,0 +1,294 @@
+/*!
+\file color_lut.cpp
+\brief This file contains the source code of the exhaustive 8-bit conversion tables
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "color_lut.h"
+#include "lut_cache.h"
+#include "parallel.h"
+#include "stats.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t RgbEntries = 1 << 24;
+	const size_t HueCount = 361;
+	const size_t PercentCount = 101;
+	const size_t ModelEntries = HueCount * PercentCount * PercentCount;
+	const size_t BatchGrain = 16384;
+
+	struct Table
+	{
+		std::once_flag once;
+		CachedTable data;	// mapped from the table cache or built in memory
+		std::atomic<size_t> memory{0};
+	};
+
+	// third channel of the models
+	unsigned char get_third(const hsv360_100& hsv)
+	{
+		return hsv.get_value();
+	}
+	unsigned char get_third(const hsl360_100& hsl)
+	{
+		return hsl.get_lightness();
+	}
+
+	/*
+		Forward entries are packed as hue (9 bits), saturation (7 bits) and
+		value/lightness (7 bits) in 3 little-endian bytes: 48 MB instead of 64.
+	*/
+	template<typename C>
+	void build_forward(unsigned char* out)
+	{
+		parallel_for(1 << 16, 16, [&](size_t begin, size_t end) {
+			for (size_t rg = begin; rg < end; ++rg)
+				for (unsigned b = 0; b < 256; ++b)
+				{
+					C c(rgb256(static_cast<unsigned char>(rg >> 8), static_cast<unsigned char>(rg & 255),
+						static_cast<unsigned char>(b)));
+					uint32_t packed = c.get_hue() | (c.get_saturation() << 9) | (get_third(c) << 16);
+					auto entry = out + 3 * ((rg << 8) | b);
+					entry[0] = static_cast<unsigned char>(packed);
+					entry[1] = static_cast<unsigned char>(packed >> 8);
+					entry[2] = static_cast<unsigned char>(packed >> 16);
+				}
+		});
+	}
+
+	template<typename C>
+	void build_inverse(unsigned char* out)
+	{
+		parallel_for(HueCount * PercentCount, 64, [&](size_t begin, size_t end) {
+			for (size_t hs = begin; hs < end; ++hs)
+				for (unsigned x = 0; x < PercentCount; ++x)
+				{
+					rgb256 rgb(C(static_cast<unsigned short>(hs / PercentCount),
+						static_cast<unsigned char>(hs % PercentCount), static_cast<unsigned char>(x)));
+					auto entry = out + 3 * (hs * PercentCount + x);
+					entry[0] = rgb.get_red();
+					entry[1] = rgb.get_green();
+					entry[2] = rgb.get_blue();
+				}
+		});
+	}
+
+	Table& get_table(ColorLutEnum lut)
+	{
+		static Table tables[4];
+		return tables[static_cast<size_t>(lut)];
+	}
+
+	const unsigned char* get_data(ColorLutEnum lut)
+	{
+		// the version part of the keys changes with the entry layout
+		static const char* const keys[] = {"color_lut/1/RgbToHsv", "color_lut/1/RgbToHsl",
+			"color_lut/1/HsvToRgb", "color_lut/1/HslToRgb"};
+		auto& table = get_table(lut);
+		std::call_once(table.once, [&] {
+			auto index = static_cast<size_t>(lut);
+			auto size = 3 * (index < 2 ? RgbEntries : ModelEntries);
+			table.data = get_cached_table(keys[index], size, [lut](unsigned char* out) {
+				switch (lut)
+				{
+				case ColorLutEnum::RgbToHsv:
+					build_forward<hsv360_100>(out);
+					break;
+				case ColorLutEnum::RgbToHsl:
+					build_forward<hsl360_100>(out);
+					break;
+				case ColorLutEnum::HsvToRgb:
+					build_inverse<hsv360_100>(out);
+					break;
+				case ColorLutEnum::HslToRgb:
+					build_inverse<hsl360_100>(out);
+					break;
+				}
+			});
+			table.memory = table.data.Size;
+		});
+		return table.data.Data;
+	}
+
+	template<typename C>
+	C forward(const unsigned char* data, const rgb256& rgb)
+	{
+		auto entry = data + 3 * ((static_cast<size_t>(rgb.get_red()) << 16) |
+			(static_cast<size_t>(rgb.get_green()) << 8) | rgb.get_blue());
+		uint32_t packed = entry[0] | (entry[1] << 8) | (entry[2] << 16);
+		return C(static_cast<unsigned short>(packed & 511), static_cast<unsigned char>((packed >> 9) & 127),
+			static_cast<unsigned char>(packed >> 16));
+	}
+
+	template<typename C>
+	rgb256 inverse(const unsigned char* data, const C& c)
+	{
+		unsigned short h = c.get_hue();
+		unsigned char s = c.get_saturation();
+		unsigned char x = get_third(c);
+		if (h >= HueCount || s >= PercentCount || x >= PercentCount)
+			return rgb256(c);
+		auto entry = data + 3 * ((h * PercentCount + s) * PercentCount + x);
+		return rgb256(entry[0], entry[1], entry[2]);
+	}
+}
+
+/*!
+	\brief Build a conversion table now instead of on the first use
+	\param[in] lut - conversion table (see ColorLutEnum)
+*/
+void build_color_lut(ColorLutEnum lut)
+{
+	get_data(lut);
+}
+
+/*!
+	\brief Get the memory held by a conversion table
+	\param[in] lut - conversion table (see ColorLutEnum)
+	\return size in bytes, 0 before the table is built
+*/
+size_t get_color_lut_memory(ColorLutEnum lut)
+{
+	return get_table(lut).memory;
+}
+
+/*!
+	\brief Table-driven conversion from rgb256 to hsv360_100
+	\param[in] rgb - source color
+	\return converted color
+*/
+hsv360_100 lut_rgb_to_hsv(const rgb256& rgb)
+{
+	return forward<hsv360_100>(get_data(ColorLutEnum::RgbToHsv), rgb);
+}
+
+/*!
+	\brief Table-driven conversion from rgb256 to hsl360_100
+	\param[in] rgb - source color
+	\return converted color
+*/
+hsl360_100 lut_rgb_to_hsl(const rgb256& rgb)
+{
+	return forward<hsl360_100>(get_data(ColorLutEnum::RgbToHsl), rgb);
+}
+
+/*!
+	\brief Table-driven conversion from hsv360_100 to rgb256
+	\param[in] hsv - source color
+	\return converted color
+*/
+rgb256 lut_hsv_to_rgb(const hsv360_100& hsv)
+{
+	return inverse(get_data(ColorLutEnum::HsvToRgb), hsv);
+}
+
+/*!
+	\brief Table-driven conversion from hsl360_100 to rgb256
+	\param[in] hsl - source color
+	\return converted color
+*/
+rgb256 lut_hsl_to_rgb(const hsl360_100& hsl)
+{
+	return inverse(get_data(ColorLutEnum::HslToRgb), hsl);
+}
+
+/*!
+    \brief Batch table-driven conversion from rgb256 to hsv360_100
+    \param[in] src - source colors
+    \param[out] dst - converted colors
+    \param[in] count - number of colors
+*/
+void lut_rgb_to_hsv(const rgb256* src, hsv360_100* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("lut_rgb_to_hsv", count);
+	auto data = get_data(ColorLutEnum::RgbToHsv);
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			dst[i] = forward<hsv360_100>(data, src[i]);
+	});
+}
+
+/*!
+    \brief Batch table-driven conversion from rgb256 to hsl360_100
+    \param[in] src - source colors
+    \param[out] dst - converted colors
+    \param[in] count - number of colors
+*/
+void lut_rgb_to_hsl(const rgb256* src, hsl360_100* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("lut_rgb_to_hsl", count);
+	auto data = get_data(ColorLutEnum::RgbToHsl);
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			dst[i] = forward<hsl360_100>(data, src[i]);
+	});
+}
+
+/*!
+    \brief Batch table-driven conversion from hsv360_100 to rgb256
+    \param[in] src - source colors
+    \param[out] dst - converted colors
+    \param[in] count - number of colors
+*/
+void lut_hsv_to_rgb(const hsv360_100* src, rgb256* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("lut_hsv_to_rgb", count);
+	auto data = get_data(ColorLutEnum::HsvToRgb);
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			dst[i] = inverse(data, src[i]);
+	});
+}
+
+/*!
+    \brief Batch table-driven conversion from hsl360_100 to rgb256
+    \param[in] src - source colors
+    \param[out] dst - converted colors
+    \param[in] count - number of colors
+*/
+void lut_hsl_to_rgb(const hsl360_100* src, rgb256* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("lut_hsl_to_rgb", count);
+	auto data = get_data(ColorLutEnum::HslToRgb);
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			dst[i] = inverse(data, src[i]);
+	});
+}
+
+}
@@ -0,0 +1,386 @@
+/*!
+\file dither.cpp
+\brief This file contains the source code of dithered quantization
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "dither.h"
+#include "arena.h"
+#include "parallel.h"
+#include "stats.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t BayerSize = 16;
+	const size_t BlueNoiseSize = 64;
+	const double BlueNoiseSigma = 1.5;
+	const size_t WavefrontBlock = 64;	// pixels a row publishes at once to the next one
+
+	// thresholds in 0..1 of a square tile, size * size values
+	struct ThresholdTile
+	{
+		size_t size;
+		std::vector<float> values;
+
+		void set_ranks(const std::vector<size_t>& ranks)
+		{
+			values.resize(ranks.size());
+			for (size_t i = 0; i < ranks.size(); ++i)
+				values[i] = static_cast<float>((ranks[i] + 0.5) / ranks.size());
+		}
+	};
+
+	ThresholdTile make_bayer()
+	{
+		ThresholdTile tile;
+		tile.size = BayerSize;
+		std::vector<size_t> ranks(BayerSize * BayerSize);
+		for (size_t y = 0; y < BayerSize; ++y)
+			for (size_t x = 0; x < BayerSize; ++x)
+			{
+				// interleave the bits of x ^ y and y, the finest level is the most significant
+				size_t rank = 0;
+				for (size_t bit = 1; bit < BayerSize; bit <<= 1)
+					rank = (rank << 2) | (((x ^ y) & bit) ? 2 : 0) | ((y & bit) ? 1 : 0);
+				ranks[y * BayerSize + x] = rank;
+			}
+		tile.set_ranks(ranks);
+		return tile;
+	}
+
+	/*
+		Void-and-cluster (Ulichney, 1993) on a torus: the energy of a cell is the sum
+		of Gaussian weights of the set pixels, updated incrementally per placement.
+	*/
+	class VoidAndCluster
+	{
+	public:
+		VoidAndCluster() : n_(BlueNoiseSize * BlueNoiseSize), kernel_(n_), energy_(n_, 0.), set_(n_, false)
+		{
+			for (size_t y = 0; y < BlueNoiseSize; ++y)
+				for (size_t x = 0; x < BlueNoiseSize; ++x)
+				{
+					auto dx = static_cast<double>(std::min(x, BlueNoiseSize - x));
+					auto dy = static_cast<double>(std::min(y, BlueNoiseSize - y));
+					kernel_[y * BlueNoiseSize + x] = std::exp(-(dx * dx + dy * dy) / (2. * BlueNoiseSigma * BlueNoiseSigma));
+				}
+		}
+
+		std::vector<size_t> ranks()
+		{
+			// random initial pattern with a tenth of the pixels set, fixed seed
+			uint32_t seed = 12345;
+			size_t ones = 0;
+			while (ones < n_ / 10)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				auto i = (seed >> 8) % n_;
+				if (!set_[i])
+				{
+					toggle(i);
+					++ones;
+				}
+			}
+			// move the tightest clusters into the largest voids until stable
+			for (;;)
+			{
+				auto cluster = find(true);
+				toggle(cluster);
+				auto hole = find(false);
+				if (hole == cluster)
+				{
+					toggle(cluster);
+					break;
+				}
+				toggle(hole);
+			}
+			auto initial = set_;
+			auto initial_energy = energy_;
+			std::vector<size_t> result(n_);
+			for (size_t rank = ones; rank-- > 0;)
+			{
+				auto cluster = find(true);
+				toggle(cluster);
+				result[cluster] = rank;
+			}
+			set_ = initial;
+			energy_ = initial_energy;
+			for (size_t rank = ones; rank < n_; ++rank)
+			{
+				auto hole = find(false);
+				toggle(hole);
+				result[hole] = rank;
+			}
+			return result;
+		}
+
+	private:
+		void toggle(size_t i)
+		{
+			double sign = set_[i] ? -1. : 1.;
+			set_[i] = !set_[i];
+			size_t x0 = i % BlueNoiseSize;
+			size_t y0 = i / BlueNoiseSize;
+			for (size_t y = 0; y < BlueNoiseSize; ++y)
+			{
+				auto row = &kernel_[((y + BlueNoiseSize - y0) % BlueNoiseSize) * BlueNoiseSize];
+				auto energy = &energy_[y * BlueNoiseSize];
+				for (size_t x = 0; x < BlueNoiseSize; ++x)
+					energy[x] += sign * row[(x + BlueNoiseSize - x0) % BlueNoiseSize];
+			}
+		}
+
+		// the set pixel of the highest energy or the empty one of the lowest
+		size_t find(bool cluster) const
+		{
+			size_t best = n_;
+			for (size_t i = 0; i < n_; ++i)
+				if (set_[i] == cluster && (best == n_ || (cluster ? energy_[i] > energy_[best] : energy_[i] < energy_[best])))
+					best = i;
+			return best;
+		}
+
+		size_t n_;
+		std::vector<double> kernel_;
+		std::vector<double> energy_;
+		std::vector<bool> set_;
+	};
+
+	ThresholdTile make_blue_noise()
+	{
+		ThresholdTile tile;
+		tile.size = BlueNoiseSize;
+		tile.set_ranks(VoidAndCluster().ranks());
+		return tile;
+	}
+
+	const ThresholdTile& get_tile(DitherEnum dither)
+	{
+		static const ThresholdTile bayer = make_bayer();
+		if (dither == DitherEnum::Bayer)
+			return bayer;
+		static const ThresholdTile blue_noise = make_blue_noise();
+		return blue_noise;
+	}
+
+	template<typename T>
+	const T* row_at(const T* base, size_t stride, size_t y)
+	{
+		return reinterpret_cast<const T*>(reinterpret_cast<const unsigned char*>(base) + y * stride);
+	}
+
+	template<typename T>
+	T* row_at(T* base, size_t stride, size_t y)
+	{
+		return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(base) + y * stride);
+	}
+
+	/*
+		Branch-free thresholding: the row is walked in tile periods, so the inner
+		loop reads the thresholds linearly and the compiler can vectorize it.
+	*/
+	template<typename T>
+	void threshold_row(const float* src, T* dst, size_t samples, const float* thresholds, size_t period,
+		float scale, float max_value)
+	{
+		for (size_t begin = 0; begin < samples; begin += period)
+		{
+			auto n = std::min(period, samples - begin);
+			auto s = src + begin;
+			auto d = dst + begin;
+			for (size_t i = 0; i < n; ++i)
+			{
+				// written so NaN fails the test and gives 0 rather than an undefined cast
+				auto v = s[i] * scale + thresholds[i];
+				v = v > 0.f ? std::min(v, max_value) : 0.f;
+				d[i] = static_cast<T>(static_cast<int32_t>(v));
+			}
+		}
+	}
+
+	template<typename T>
+	void quantize_ordered(const float* src, size_t src_stride, T* dst, size_t dst_stride,
+		size_t width, size_t height, size_t channels, DitherEnum dither, float scale, float max_value)
+	{
+		// one tile period of thresholds per tile row, repeated for the channels;
+		// truncation is a single long row of zeros
+		size_t size = 1;
+		size_t period = 256 * channels;
+		if (dither != DitherEnum::None)
+		{
+			size = get_tile(dither).size;
+			period = size * channels;
+		}
+		ArenaBuffer<float> thresholds(size * period);
+		std::fill(thresholds.data(), thresholds.data() + thresholds.size(), 0.f);
+		if (dither != DitherEnum::None)
+		{
+			auto& tile = get_tile(dither);
+			for (size_t i = 0; i < size * size; ++i)
+				for (size_t c = 0; c < channels; ++c)
+					thresholds[i * channels + c] = tile.values[i];
+		}
+		parallel_for(height, 16, [&](size_t begin, size_t end) {
+			for (size_t y = begin; y < end; ++y)
+				threshold_row(row_at(src, src_stride, y), row_at(dst, dst_stride, y), width * channels,
+					&thresholds[(y % size) * period], period, scale, max_value);
+		});
+	}
+
+	/*
+		Floyd-Steinberg: a row may process pixel x once the previous row has done x + 1.
+		Every pool thread takes the next row from a shared counter (parallel_for chunks
+		are contiguous ranges, which would start rows far ahead) and publishes its
+		progress per block, so the rows run as a pipeline. Error rows live in a ring
+		that is larger than the number of rows which can be in flight.
+	*/
+	template<typename T>
+	void quantize_diffusion(const float* src, size_t src_stride, T* dst, size_t dst_stride,
+		size_t width, size_t height, size_t channels, float scale, float max_value)
+	{
+		const size_t ring = get_thread_count() + 2;
+		const size_t row_size = (width + 2) * channels;
+		ArenaBuffer<float> errors(ring * row_size);
+		std::fill(errors.data(), errors.data() + errors.size(), 0.f);
+		std::unique_ptr<std::atomic<size_t>[]> progress(new std::atomic<size_t>[height]);
+		for (size_t y = 0; y < height; ++y)
+			progress[y].store(0, std::memory_order_relaxed);
+
+		std::atomic<size_t> next_row(0);
+		parallel_for(get_thread_count(), 1, [&](size_t, size_t) {
+			for (size_t y = next_row.fetch_add(1); y < height; y = next_row.fetch_add(1))
+			{
+				auto s = row_at(src, src_stride, y);
+				auto d = row_at(dst, dst_stride, y);
+				auto in = &errors[(y % ring) * row_size];
+				auto out = &errors[((y + 1) % ring) * row_size];
+				std::fill(out, out + row_size, 0.f);
+				float carry[4] = {0.f, 0.f, 0.f, 0.f};
+				for (size_t block = 0; block < width; block += WavefrontBlock)
+				{
+					auto block_end = std::min(block + WavefrontBlock, width);
+					if (y > 0)
+					{
+						auto need = std::min(block_end + 1, width);
+						while (progress[y - 1].load(std::memory_order_acquire) < need)
+							std::this_thread::yield();
+					}
+					for (size_t x = block; x < block_end; ++x)
+						for (size_t c = 0; c < channels; ++c)
+						{
+							auto i = x * channels + c;
+							// the average code matches the value like E[floor(x + t)] of the ordered path
+							auto u = s[i] * scale + in[i + channels] + carry[c];
+							// NaN gives 0 like the ordered path and doesn't spread to the errors
+							u = u > -0.5f ? std::min(u, max_value + 0.5f) : -0.5f;
+							auto q = std::min(std::max(std::floor(u + 0.5f), 0.f), max_value);
+							auto e = u - q;
+							d[i] = static_cast<T>(static_cast<int32_t>(q));
+							carry[c] = e * (7.f / 16.f);
+							out[i] += e * (3.f / 16.f);
+							out[i + channels] += e * (5.f / 16.f);
+							out[i + 2 * channels] += e * (1.f / 16.f);
+						}
+					progress[y].store(block_end, std::memory_order_release);
+				}
+			}
+		});
+	}
+
+	template<typename T>
+	bool quantize_impl(const float* src, size_t src_stride, T* dst, size_t dst_stride,
+		size_t width, size_t height, size_t channels, DitherEnum dither, int bit_depth)
+	{
+		if (!src || !dst || channels == 0 || channels > 4 || bit_depth < 8 || bit_depth > 16 ||
+			src_stride < width * channels * sizeof(float) || dst_stride < width * channels * sizeof(T))
+			return false;
+		// bins convention of from_dbl: 1.0 is 2^bit_depth
+		auto scale = static_cast<float>(1u << bit_depth);
+		auto max_value = static_cast<float>((1u << bit_depth) - 1);
+		if (dither == DitherEnum::FloydSteinberg)
+			quantize_diffusion(src, src_stride, dst, dst_stride, width, height, channels, scale, max_value);
+		else
+			quantize_ordered(src, src_stride, dst, dst_stride, width, height, channels, dither, scale, max_value);
+		return true;
+	}
+}
+
+/*!
+    \brief Batch quantization of 0..1.0 samples to 8-bit with dithering
+    \param[in] src - interleaved source rows
+    \param[in] src_stride - source row size in bytes
+    \param[out] dst - interleaved destination rows
+    \param[in] dst_stride - destination row size in bytes
+    \param[in] width - number of pixels in a row
+    \param[in] height - number of rows
+    \param[in] channels - 1..4 samples per pixel
+	\param[in] dither - dithering method (see DitherEnum)
+	\return false if the arguments are invalid
+*/
+bool quantize(const float* src, size_t src_stride, unsigned char* dst, size_t dst_stride,
+	size_t width, size_t height, size_t channels, DitherEnum dither)
+{
+	COLORPP_STATS_SCOPE("quantize/8", width * height);
+	COLORPP_STATS_CLIPPED(detail::count_outside(src, src_stride, width * channels, height, 0.f, 1.f));
+	return quantize_impl(src, src_stride, dst, dst_stride, width, height, channels, dither, 8);
+}
+
+/*!
+    \brief Batch quantization of 0..1.0 samples to high bit depth with dithering
+    \param[in] src - interleaved source rows
+    \param[in] src_stride - source row size in bytes
+    \param[out] dst - interleaved destination rows
+    \param[in] dst_stride - destination row size in bytes
+    \param[in] width - number of pixels in a row
+    \param[in] height - number of rows
+    \param[in] channels - 1..4 samples per pixel
+	\param[in] dither - dithering method (see DitherEnum)
+	\param[in] bit_depth - 8..16 bits per sample
+	\return false if the arguments are invalid
+*/
+bool quantize(const float* src, size_t src_stride, unsigned short* dst, size_t dst_stride,
+	size_t width, size_t height, size_t channels, DitherEnum dither, int bit_depth)
+{
+	COLORPP_STATS_SCOPE("quantize/16", width * height);
+	COLORPP_STATS_CLIPPED(detail::count_outside(src, src_stride, width * channels, height, 0.f, 1.f));
+	return quantize_impl(src, src_stride, dst, dst_stride, width, height, channels, dither, bit_depth);
+}
+
+}
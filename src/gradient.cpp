@@ -0,0 +1,315 @@
+/*!
+\file gradient.cpp
+\brief This file contains the source code of gradients and colormap lookup tables
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "gradient.h"
+#include "arena.h"
+#include "color.h"
+#include "parallel.h"
+#include "stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t MapGrain = 16384;
+
+	// stop colors in the interpolation space
+	void to_space(const Gradient& gradient, const double rgb[3], double c[3])
+	{
+		switch (gradient.Space)
+		{
+		case GradientEnum::Hsv:
+			rgb_to_hsv(rgb[0], rgb[1], rgb[2], c[0], c[1], c[2]);
+			break;
+		case GradientEnum::Hsl:
+			rgb_to_hsl(rgb[0], rgb[1], rgb[2], c[0], c[1], c[2]);
+			break;
+		case GradientEnum::Lab:
+		{
+			double xyz[3];
+			rgb_to_xyz(rgb[0], rgb[1], rgb[2], xyz[0], xyz[1], xyz[2], gradient.Params);
+			xyz_to_lab(xyz[0], xyz[1], xyz[2], c[0], c[1], c[2], gradient.Params.RefWhite);
+			break;
+		}
+		default:
+			c[0] = rgb[0];
+			c[1] = rgb[1];
+			c[2] = rgb[2];
+		}
+	}
+
+	void from_space(const Gradient& gradient, const double c[3], double rgb[3])
+	{
+		switch (gradient.Space)
+		{
+		case GradientEnum::Hsv:
+			hsv_to_rgb(c[0], c[1], c[2], rgb[0], rgb[1], rgb[2]);
+			break;
+		case GradientEnum::Hsl:
+			hsl_to_rgb(c[0], c[1], c[2], rgb[0], rgb[1], rgb[2]);
+			break;
+		case GradientEnum::Lab:
+		{
+			double xyz[3];
+			lab_to_xyz(c[0], c[1], c[2], xyz[0], xyz[1], xyz[2], gradient.Params.RefWhite);
+			xyz_to_rgb(xyz[0], xyz[1], xyz[2], rgb[0], rgb[1], rgb[2], gradient.Params);
+			break;
+		}
+		default:
+			rgb[0] = c[0];
+			rgb[1] = c[1];
+			rgb[2] = c[2];
+		}
+		for (int i = 0; i < 3; ++i)
+			rgb[i] = std::min(std::max(rgb[i], 0.0), 1.0);
+	}
+
+	void interpolate(const Gradient& gradient, const GradientStop& a, const GradientStop& b, double t, double rgb[3])
+	{
+		double ca[3], cb[3], c[3];
+		to_space(gradient, a.Rgb, ca);
+		to_space(gradient, b.Rgb, cb);
+		bool is_hue = gradient.Space == GradientEnum::Hsv || gradient.Space == GradientEnum::Hsl;
+		if (is_hue)
+		{
+			// grays have no hue, they take the hue of the other stop
+			if (ca[1] == 0.0)
+				ca[0] = cb[0];
+			if (cb[1] == 0.0)
+				cb[0] = ca[0];
+			auto dh = cb[0] - ca[0];
+			if (dh > 0.5)
+				cb[0] -= 1.0;
+			else if (dh < -0.5)
+				cb[0] += 1.0;
+		}
+		for (int i = 0; i < 3; ++i)
+			c[i] = ca[i] + (cb[i] - ca[i]) * t;
+		if (is_hue)
+			c[0] -= std::floor(c[0]);
+		from_space(gradient, c, rgb);
+	}
+
+	// nearest entry of a float sample, NaN goes to the first one
+	class FloatIndex
+	{
+	public:
+		explicit FloatIndex(const GradientLut& lut) :
+			scale_(static_cast<float>((lut.Size - 1) / (lut.High - lut.Low))),
+			offset_(static_cast<float>(-lut.Low * (lut.Size - 1) / (lut.High - lut.Low) + 0.5)),
+			max_(static_cast<float>(lut.Size - 1))
+		{
+		}
+		size_t operator()(float v) const
+		{
+			auto x = v * scale_ + offset_;
+			x = x > 0.f ? x : 0.f;
+			return static_cast<size_t>(std::min(x, max_));
+		}
+
+	private:
+		float scale_;
+		float offset_;
+		float max_;
+	};
+}
+
+/*!
+	\brief Create a gradient
+	\param[in] space - interpolation space (see GradientEnum)
+	\param[in] stops - color stops in any order
+	\param[in] count - number of stops
+	\param[in] params - RGB ColorSpace parameters of the stops
+	\return gradient, without stops if count is 0
+*/
+Gradient get_gradient(GradientEnum space, const GradientStop* stops, size_t count, const RgbParams& params)
+{
+	Gradient result;
+	result.Space = space;
+	result.Params = params;
+	if (stops)
+		result.Stops.assign(stops, stops + count);
+	std::stable_sort(result.Stops.begin(), result.Stops.end(),
+		[](const GradientStop& a, const GradientStop& b) { return a.Position < b.Position; });
+	return result;
+}
+
+/*!
+	\brief Color of a gradient
+	\param[in] gradient - gradient
+	\param[in] position - position in 0..1.0 range
+	\param[out] rgb - color in 0..1.0 range
+*/
+void get_gradient_color(const Gradient& gradient, double position, double rgb[3])
+{
+	auto& stops = gradient.Stops;
+	if (stops.empty())
+	{
+		rgb[0] = rgb[1] = rgb[2] = 0.0;
+		return;
+	}
+	auto next = std::upper_bound(stops.begin(), stops.end(), position,
+		[](double p, const GradientStop& stop) { return p < stop.Position; });
+	if (next == stops.begin() || next == stops.end())
+	{
+		auto& stop = next == stops.begin() ? stops.front() : stops.back();
+		for (int i = 0; i < 3; ++i)
+			rgb[i] = stop.Rgb[i];
+		return;
+	}
+	auto& a = *(next - 1);
+	auto& b = *next;
+	interpolate(gradient, a, b, (position - a.Position) / (b.Position - a.Position), rgb);
+}
+
+/*!
+	\brief Bake a gradient into a lookup table
+	\param[in] gradient - gradient
+	\param[in] size - number of entries, usually 256 or 4096
+	\param[in] low - sample value mapped to position 0
+	\param[in] high - sample value mapped to position 1.0
+	\return lookup table, empty if size < 2 or the gradient has no stops
+*/
+GradientLut bake_gradient(const Gradient& gradient, size_t size, double low, double high)
+{
+	GradientLut result;
+	result.Size = 0;
+	result.Low = low;
+	result.High = high;
+	if (size < 2 || size > 65536 || gradient.Stops.empty() || low == high)
+		return result;
+	result.Size = size;
+	result.Rgb.resize(3 * size);
+	result.Rgb256.resize(3 * size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		double rgb[3];
+		get_gradient_color(gradient, static_cast<double>(i) / (size - 1), rgb);
+		for (int c = 0; c < 3; ++c)
+		{
+			result.Rgb[3 * i + c] = static_cast<float>(rgb[c]);
+			result.Rgb256[3 * i + c] = from_dbl<byte>(rgb[c]);
+		}
+	}
+	return result;
+}
+
+/*!
+    \brief Batch mapping of float samples to 8-bit RGB through a baked gradient
+    \param[in] src - samples
+    \param[out] dst - interleaved RGB, 3 * count bytes
+    \param[in] count - number of samples
+	\param[in] lut - baked gradient
+*/
+void map_gradient(const float* src, unsigned char* dst, size_t count, const GradientLut& lut)
+{
+	COLORPP_STATS_SCOPE("map_gradient/float", count);
+	if (lut.Size == 0)
+		return;
+	const FloatIndex index(lut);
+	parallel_for(count, MapGrain, [&](size_t begin, size_t end) {
+		auto table = lut.Rgb256.data();
+		for (size_t i = begin; i < end; ++i)
+		{
+			auto entry = table + 3 * index(src[i]);
+			dst[3 * i] = entry[0];
+			dst[3 * i + 1] = entry[1];
+			dst[3 * i + 2] = entry[2];
+		}
+	});
+}
+
+/*!
+    \brief Batch mapping of float samples to float RGB through a baked gradient
+    \param[in] src - samples
+    \param[out] dst - interleaved RGB, 3 * count floats
+    \param[in] count - number of samples
+	\param[in] lut - baked gradient
+*/
+void map_gradient(const float* src, float* dst, size_t count, const GradientLut& lut)
+{
+	COLORPP_STATS_SCOPE("map_gradient/float", count);
+	if (lut.Size == 0)
+		return;
+	const FloatIndex index(lut);
+	parallel_for(count, MapGrain, [&](size_t begin, size_t end) {
+		auto table = lut.Rgb.data();
+		for (size_t i = begin; i < end; ++i)
+		{
+			auto entry = table + 3 * index(src[i]);
+			dst[3 * i] = entry[0];
+			dst[3 * i + 1] = entry[1];
+			dst[3 * i + 2] = entry[2];
+		}
+	});
+}
+
+/*!
+    \brief Batch mapping of integer samples to 8-bit RGB through a baked gradient
+    \param[in] src - samples in 0..2^bit_depth-1
+    \param[out] dst - interleaved RGB, 3 * count bytes
+    \param[in] count - number of samples
+	\param[in] lut - baked gradient
+	\param[in] bit_depth - 8..16 bits per sample
+*/
+void map_gradient(const unsigned short* src, unsigned char* dst, size_t count, const GradientLut& lut,
+	int bit_depth)
+{
+	COLORPP_STATS_SCOPE("map_gradient/16", count);
+	if (lut.Size == 0)
+		return;
+	bit_depth = std::min(std::max(bit_depth, 8), 16);
+	// every code gets its entry once, codes above the depth take the last one
+	const unsigned max_code = (1u << bit_depth) - 1;
+	const FloatIndex float_index(lut);
+	ArenaBuffer<uint16_t> index(65536);
+	for (unsigned code = 0; code < index.size(); ++code)
+		index[code] = static_cast<uint16_t>(float_index(static_cast<float>(static_cast<double>(std::min(code, max_code)) / max_code)));
+	parallel_for(count, MapGrain, [&](size_t begin, size_t end) {
+		auto table = lut.Rgb256.data();
+		for (size_t i = begin; i < end; ++i)
+		{
+			auto entry = table + 3 * static_cast<size_t>(index[src[i]]);
+			dst[3 * i] = entry[0];
+			dst[3 * i + 1] = entry[1];
+			dst[3 * i + 2] = entry[2];
+		}
+	});
+}
+
+}
@@ -0,0 +1,40 @@
+/*!
+\file hexcone.h
+\brief Hexcone helpers shared by the float kernels of the hue models
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace colorpp
+{
+
+namespace detail
+{
+
+/*
+	The batch kernels of the hue models (HSV, HSL, HWB, CMYK and the adjustments) are
+	branchless so their loops vectorize: the hue sextant is picked with selects, and the
+	divisions that are 0 / 0 for grays or black add 1e-30f to the divisor, so the zero
+	numerator keeps the result 0 without a test.
+*/
+
+// positive x wrapped to [0, 6) by truncation, floor needs SSE4.1 to vectorize
+inline float wrap6(float x)
+{
+	return x - 6.f * static_cast<float>(static_cast<int32_t>(x * (1.f / 6.f)));
+}
+
+// channel of the hexcone with the maximum mx and the chroma d at the hue position k
+inline float hexcone(float mx, float d, float k)
+{
+	return mx - d * std::min(std::max(std::min(k, 4.f - k), 0.f), 1.f);
+}
+
+}
+
+}
@@ -0,0 +1,318 @@
+/*!
+\file histogram.cpp
+\brief Color histograms and statistics
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#include "histogram.h"
+#include "color.h"
+#include "arena.h"
+#include "parallel.h"
+#include "stats.h"
+#include "transfer.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t HistogramGrain = 1 << 16;
+	// statistics blocks, fixed so the sums don't depend on the threads
+	const size_t StatsBlocks = 64;
+	const double Pi = 3.14159265358979323846;
+
+	// linear values of the 8-bit codes
+	struct Linearizer
+	{
+		float lut[256];
+
+		explicit Linearizer(const RgbParams& params)
+		{
+			unsigned short codes[256];
+			for (int i = 0; i < 256; ++i)
+				codes[i] = static_cast<unsigned short>(i);
+			inv_compand(codes, lut, 256, get_transfer(params), 8, params.GammaRGB);
+		}
+	};
+
+	// channels of a pixel in 0..1.0 range
+	class Channels
+	{
+	public:
+		Channels(HistogramEnum space, const RgbParams& params) : space_(space), linear_(params)
+		{
+			Mtx3x3 adaptation;
+			get_adaptation_matrix(params, adaptation);
+			for (int i = 0; i < 3; ++i)
+				for (int j = 0; j < 3; ++j)
+				{
+					m_[i][j] = 0.;
+					for (int k = 0; k < 3; ++k)
+						m_[i][j] += params.MtxRGB2XYZ[i][k] * adaptation[k][j];
+					m_[i][j] /= params.RefWhite[j];
+				}
+		}
+
+		void operator()(const unsigned char* p, double v[3]) const
+		{
+			switch (space_)
+			{
+			case HistogramEnum::Rgb:
+				for (int c = 0; c < 3; ++c)
+					v[c] = get_dbl<byte>(p[c]);
+				break;
+			case HistogramEnum::Hsv:
+				rgb_to_hsv(get_dbl<byte>(p[0]), get_dbl<byte>(p[1]), get_dbl<byte>(p[2]), v[0], v[1], v[2]);
+				break;
+			case HistogramEnum::Hsl:
+				rgb_to_hsl(get_dbl<byte>(p[0]), get_dbl<byte>(p[1]), get_dbl<byte>(p[2]), v[0], v[1], v[2]);
+				break;
+			case HistogramEnum::Lab:
+			{
+				// the matrix is divided by the white already
+				static const XYZ unit = {1., 1., 1.};
+				double xyz[3];
+				for (int j = 0; j < 3; ++j)
+					xyz[j] = linear_.lut[p[0]] * m_[0][j] + linear_.lut[p[1]] * m_[1][j] + linear_.lut[p[2]] * m_[2][j];
+				xyz_to_lab(xyz[0], xyz[1], xyz[2], v[0], v[1], v[2], unit);
+				v[0] /= 100.0;
+				v[1] = (v[1] + 128.0) / 256.0;
+				v[2] = (v[2] + 128.0) / 256.0;
+				break;
+			}
+			}
+		}
+
+	private:
+		HistogramEnum space_;
+		Linearizer linear_;
+		double m_[3][3];	// linear RGB to XYZ relative to the white
+	};
+
+	// bin of a channel value, out of range values go to the end bins
+	size_t get_bin(double v, size_t bins)
+	{
+		return v > 0. ? std::min(static_cast<size_t>(v * bins), bins - 1) : 0;
+	}
+
+	// private bins of every thread slice, summed into hist
+	template<typename Fn>
+	void count_bins(const unsigned char* src, size_t count, uint64_t* hist, size_t size, const Fn& add)
+	{
+		const size_t slices = std::max<size_t>(1, std::min<size_t>(get_thread_count(),
+			(count + HistogramGrain - 1) / HistogramGrain));
+		ArenaBuffer<uint64_t> bins(slices * size);
+		parallel_for(slices, 1, [&](size_t begin, size_t end) {
+			for (size_t slice = begin; slice < end; ++slice)
+			{
+				uint64_t* h = &bins[slice * size];
+				std::fill(h, h + size, uint64_t(0));
+				const size_t first = count * slice / slices;
+				const size_t last = count * (slice + 1) / slices;
+				for (const unsigned char* p = src + 3 * first; p != src + 3 * last; p += 3)
+					add(p, h);
+			}
+		});
+		parallel_for(size, 4096, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				uint64_t sum = 0;
+				for (size_t slice = 0; slice < slices; ++slice)
+					sum += bins[slice * size + i];
+				hist[i] = sum;
+			}
+		});
+	}
+
+	struct Moments
+	{
+		double linear[3];
+		double squares[3];
+		double luminance;
+		double hue[2];	// sum of the hues and their squares or of the hue vectors
+		double saturation;
+		size_t chromatic;
+	};
+}
+
+/*!
+	\brief Batch histograms of the channels
+	\param[in] src - RGB pixels, 3 * count bytes
+	\param[in] count - number of pixels
+	\param[out] hist - 3 * bins counts, bins of the first channel first
+	\param[in] bins - number of bins per channel
+	\param[in] space - channel space (see HistogramEnum)
+	\param[in] params - RGB ColorSpace parameters (Lab)
+*/
+void get_channel_histograms(const unsigned char* src, size_t count, uint64_t* hist, size_t bins,
+	HistogramEnum space, const RgbParams& params)
+{
+	COLORPP_STATS_SCOPE("get_channel_histograms", count);
+	if (bins == 0)
+		return;
+	const Channels channels(space, params);
+	count_bins(src, count, hist, 3 * bins, [&](const unsigned char* p, uint64_t* h) {
+		double v[3];
+		channels(p, v);
+		++h[get_bin(v[0], bins)];
+		++h[bins + get_bin(v[1], bins)];
+		++h[2 * bins + get_bin(v[2], bins)];
+	});
+}
+
+/*!
+	\brief Batch 3D histogram of quantized colors
+	\param[in] src - RGB pixels, 3 * count bytes
+	\param[in] count - number of pixels
+	\param[out] hist - 2^(3 * bits) counts
+	\param[in] bits - bits per channel, 1..6
+	\param[in] space - channel space (see HistogramEnum)
+	\param[in] params - RGB ColorSpace parameters (Lab)
+*/
+void get_histogram_3d(const unsigned char* src, size_t count, uint64_t* hist, int bits,
+	HistogramEnum space, const RgbParams& params)
+{
+	COLORPP_STATS_SCOPE("get_histogram_3d", count);
+	bits = std::min(std::max(bits, 1), 6);
+	const size_t bins = size_t(1) << bits;
+	if (space == HistogramEnum::Rgb)
+	{
+		// bins of the codes are their high bits
+		const int shift = 8 - bits;
+		count_bins(src, count, hist, bins * bins * bins, [&](const unsigned char* p, uint64_t* h) {
+			++h[((p[0] >> shift) << (2 * bits)) | ((p[1] >> shift) << bits) | (p[2] >> shift)];
+		});
+		return;
+	}
+	const Channels channels(space, params);
+	count_bins(src, count, hist, bins * bins * bins, [&](const unsigned char* p, uint64_t* h) {
+		double v[3];
+		channels(p, v);
+		++h[(get_bin(v[0], bins) << (2 * bits)) | (get_bin(v[1], bins) << bits) | get_bin(v[2], bins)];
+	});
+}
+
+/*!
+	\brief Moment statistics of an image
+	\param[in] src - RGB pixels, 3 * count bytes
+	\param[in] count - number of pixels
+	\param[in] hue_mean - hue averaging method (see HueMeanEnum)
+	\param[in] params - RGB ColorSpace parameters
+	\return statistics, zeros if count is 0
+*/
+ColorStats get_color_stats(const unsigned char* src, size_t count, HueMeanEnum hue_mean, const RgbParams& params)
+{
+	COLORPP_STATS_SCOPE("get_color_stats", count);
+	ColorStats stats = {};
+	if (count == 0)
+		return stats;
+	const Linearizer linear(params);
+	const bool circular = hue_mean == HueMeanEnum::Circular;
+	const size_t blocks = std::min(StatsBlocks, count);
+	std::vector<Moments> moments(blocks);
+	parallel_for(blocks, 1, [&](size_t begin, size_t end) {
+		for (size_t block = begin; block < end; ++block)
+		{
+			Moments m = {};
+			for (size_t i = count * block / blocks; i < count * (block + 1) / blocks; ++i)
+			{
+				const unsigned char* p = src + 3 * i;
+				double rgb[3];
+				for (int c = 0; c < 3; ++c)
+				{
+					rgb[c] = linear.lut[p[c]];
+					m.linear[c] += rgb[c];
+					m.squares[c] += rgb[c] * rgb[c];
+				}
+				m.luminance += rgb[0] * params.MtxRGB2XYZ[0][1] + rgb[1] * params.MtxRGB2XYZ[1][1] +
+					rgb[2] * params.MtxRGB2XYZ[2][1];
+				double h, s, v;
+				rgb_to_hsv(get_dbl<byte>(p[0]), get_dbl<byte>(p[1]), get_dbl<byte>(p[2]), h, s, v);
+				m.saturation += s;
+				if (s > 0.)
+				{
+					++m.chromatic;
+					m.hue[0] += circular ? std::cos(2. * Pi * h) : h;
+					m.hue[1] += circular ? std::sin(2. * Pi * h) : h * h;
+				}
+			}
+			moments[block] = m;
+		}
+	});
+
+	Moments total = {};
+	for (const Moments& m : moments)
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			total.linear[c] += m.linear[c];
+			total.squares[c] += m.squares[c];
+		}
+		total.luminance += m.luminance;
+		total.hue[0] += m.hue[0];
+		total.hue[1] += m.hue[1];
+		total.saturation += m.saturation;
+		total.chromatic += m.chromatic;
+	}
+	for (int c = 0; c < 3; ++c)
+	{
+		stats.LinearMean[c] = total.linear[c] / count;
+		stats.LinearStdDev[c] = std::sqrt(std::max(total.squares[c] / count - stats.LinearMean[c] * stats.LinearMean[c], 0.));
+		stats.Mean[c] = compand(stats.LinearMean[c], get_transfer(params), params.GammaRGB);
+	}
+	stats.Luminance = total.luminance / count;
+	stats.Saturation = total.saturation / count;
+	stats.Chromatic = total.chromatic;
+	if (total.chromatic > 0)
+	{
+		const double x = total.hue[0] / total.chromatic;
+		const double y = total.hue[1] / total.chromatic;
+		if (circular)
+		{
+			stats.Hue = std::atan2(y, x) / (2. * Pi);
+			if (stats.Hue < 0.)
+				stats.Hue += 1.;
+			stats.HueSpread = 1. - std::min(std::sqrt(x * x + y * y), 1.);
+		}
+		else
+		{
+			stats.Hue = x;
+			stats.HueSpread = std::sqrt(std::max(y - x * x, 0.));
+		}
+	}
+	return stats;
+}
+
+}
@@ -0,0 +1,235 @@
+/*!
+\file hsi.cpp
+\brief This file contains the source code of HSI conversion
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "hsi.h"
+#include "parallel.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t BatchGrain = 16384;
+	const double Pi = 3.14159265358979323846;
+	const float Sqrt3 = 1.7320508f;
+
+	/*
+		atan(z) / z for z in 0..1.0 as a polynomial of z^2 (Abramowitz & Stegun 4.4.49,
+		error below 2e-8 rad), octants by selects instead of branches
+	*/
+	inline float atan2_turns(float y, float x)
+	{
+		const float ax = std::abs(x);
+		const float ay = std::abs(y);
+		const float z = std::min(ax, ay) / (std::max(ax, ay) + 1e-30f);
+		const float z2 = z * z;
+		float p = 0.0028662257f;
+		p = p * z2 - 0.0161657367f;
+		p = p * z2 + 0.0429096138f;
+		p = p * z2 - 0.0752896400f;
+		p = p * z2 + 0.1065626393f;
+		p = p * z2 - 0.1420889944f;
+		p = p * z2 + 0.1999355085f;
+		p = p * z2 - 0.3333314528f;
+		float a = (p * z2 + 1.f) * z * static_cast<float>(0.5 / Pi);
+		a = ay > ax ? 0.25f - a : a;
+		a = x < 0.f ? 0.5f - a : a;
+		a = y < 0.f ? 1.f - a : a;
+		return a >= 1.f ? 0.f : a;
+	}
+
+	/*
+		Cosine and sine of the angle h in turns: the half angle is reduced to
+		-pi/2..pi/2 and its Taylor polynomials (error below 6e-8) are doubled.
+	*/
+	inline void cos_sin_turns(float h, float& c, float& s)
+	{
+		auto x = h + 1.f;
+		x -= static_cast<float>(static_cast<int32_t>(x));
+		const float a = static_cast<float>(Pi) * (x - 0.5f);
+		const float a2 = a * a;
+		float sa = -1.f / 39916800.f;
+		sa = sa * a2 + 1.f / 362880.f;
+		sa = sa * a2 - 1.f / 5040.f;
+		sa = sa * a2 + 1.f / 120.f;
+		sa = sa * a2 - 1.f / 6.f;
+		sa = (sa * a2 + 1.f) * a;
+		float ca = 1.f / 479001600.f;
+		ca = ca * a2 - 1.f / 3628800.f;
+		ca = ca * a2 + 1.f / 40320.f;
+		ca = ca * a2 - 1.f / 720.f;
+		ca = ca * a2 + 1.f / 24.f;
+		ca = ca * a2 - 0.5f;
+		ca = ca * a2 + 1.f;
+		// the angle is pi + 2a
+		c = 2.f * sa * sa - 1.f;
+		s = -2.f * sa * ca;
+	}
+
+	void rgb_to_hsi_kernel(const float* src, float* dst, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto r = src[3 * i];
+			auto g = src[3 * i + 1];
+			auto b = src[3 * i + 2];
+			auto intensity = (r + g + b) * (1.f / 3.f);
+			auto mn = std::min(r, std::min(g, b));
+			dst[3 * i] = atan2_turns(Sqrt3 * (g - b), 2.f * r - g - b);
+			dst[3 * i + 1] = (intensity - mn) / (intensity + 1e-30f);
+			dst[3 * i + 2] = intensity;
+		}
+	}
+
+	/*
+		The hue direction in the chromaticity plane is scaled so that the minimum
+		channel is I * (1 - S), the direction sums to zero so its minimum is negative.
+	*/
+	void hsi_to_rgb_kernel(const float* src, float* dst, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			float c, s;
+			cos_sin_turns(src[3 * i], c, s);
+			auto intensity = src[3 * i + 2];
+			auto ur = 2.f * c;
+			auto ug = Sqrt3 * s - c;
+			auto ub = -Sqrt3 * s - c;
+			auto k = -intensity * src[3 * i + 1] / std::min(ur, std::min(ug, ub));
+			dst[3 * i] = std::min(std::max(intensity + k * ur, 0.f), 1.f);
+			dst[3 * i + 1] = std::min(std::max(intensity + k * ug, 0.f), 1.f);
+			dst[3 * i + 2] = std::min(std::max(intensity + k * ub, 0.f), 1.f);
+		}
+	}
+}
+
+/*!
+    \brief Conversion from RGB to HSI color model
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] h - hue channel in 0..1.0 range, 0 for grays
+  	\param[out] s - saturation channel in 0..1.0 range
+  	\param[out] i - intensity channel in 0..1.0 range
+*/
+void rgb_to_hsi(double r, double g, double b,
+	double& h, double& s, double& i)
+{
+	i = (r + g + b) / 3.;
+	s = i > 0. ? 1. - std::min(r, std::min(g, b)) / i : 0.;
+	// the arc cosine formula of Gonzalez & Woods with the quadrant resolved
+	if (r == g && g == b)
+		h = 0.;
+	else
+	{
+		h = std::atan2(std::sqrt(3.) * (g - b), 2. * r - g - b) / (2. * Pi);
+		if (h < 0.)
+			h += 1.;
+	}
+}
+
+/*!
+    \brief Conversion from HSI to RGB color model
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] s - saturation channel in 0..1.0 range
+  	\param[in] i - intensity channel in 0..1.0 range
+    \param[out] r - red channel, out of gamut colors are out of 0..1.0 range
+	\param[out] g - green channel, out of gamut colors are out of 0..1.0 range
+ 	\param[out] b - blue channel, out of gamut colors are out of 0..1.0 range
+*/
+void hsi_to_rgb(double h, double s, double i,
+	double& r, double& g, double& b)
+{
+	// sectors of 120 degrees, the channel after the sector is the minimum
+	auto degrees = 360. * (h - std::floor(h));
+	auto sector = std::min(static_cast<int>(degrees / 120.), 2);
+	degrees -= 120. * sector;
+	auto angle = degrees * Pi / 180.;
+	auto x = i * (1. - s);
+	auto y = i * (1. + s * std::cos(angle) / std::cos(Pi / 3. - angle));
+	auto z = 3. * i - (x + y);
+	if (sector == 0)
+	{
+		r = y;
+		g = z;
+		b = x;
+	}
+	else if (sector == 1)
+	{
+		r = x;
+		g = y;
+		b = z;
+	}
+	else
+	{
+		r = z;
+		g = x;
+		b = y;
+	}
+}
+
+/*!
+    \brief Batch conversion from RGB to HSI color model
+    \param[in] src - RGB in 0..1.0 range, 3 * count floats
+    \param[out] dst - HSI in 0..1.0 range, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void rgb_to_hsi(const float* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("rgb_to_hsi/float", count);
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		rgb_to_hsi_kernel(src + 3 * begin, dst + 3 * begin, end - begin);
+	});
+}
+
+/*!
+    \brief Batch conversion from HSI to RGB color model
+    \param[in] src - HSI in 0..1.0 range, 3 * count floats
+    \param[out] dst - RGB clamped to 0..1.0, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void hsi_to_rgb(const float* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("hsi_to_rgb/float", count);
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		hsi_to_rgb_kernel(src + 3 * begin, dst + 3 * begin, end - begin);
+	});
+}
+
+}
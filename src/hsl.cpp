@@ -31,6 +31,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 
+#include "hsl.h"
+#include "parallel.h"
+#include "stats.h"
 #include <algorithm>
 //#include <cmath>
 
@@ -81,12 +84,29 @@ void rgb_to_hsl(double r, double g, double b,
 
 namespace
 {
+    const size_t BatchGrain = 16384;
+
     double mod2(double v)
     {
         while (v > 2.)
             v -= 2.;
         return v;
     }
+
+    // grays have zero differences, s and l are 0 or l is 1 (see hexcone.h)
+    void hsv_to_hsl_kernel(const float* src, float* dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto h = src[3 * i];
+            auto s = src[3 * i + 1];
+            auto v = src[3 * i + 2];
+            auto l = v * (1.f - 0.5f * s);
+            dst[3 * i] = h;
+            dst[3 * i + 1] = (v - l) / (std::min(l, 1.f - l) + 1e-30f);
+            dst[3 * i + 2] = l;
+        }
+    }
 }
 
 /*!
@@ -154,5 +174,38 @@ void hsl_to_rgb(double h, double s, double l,
 
 }
 
+/*!
+    \brief Conversion from HSV to HSL color model
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] s - saturation channel in 0..1.0 range
+  	\param[in] v - value channel in 0..1.0 range
+ 	\param[out] hl - hue channel in 0..1.0 range
+  	\param[out] sl - saturation channel in 0..1.0 range
+  	\param[out] l - lightness channel in 0..1.0 range
+*/
+void hsv_to_hsl(double h, double s, double v,
+	double& hl, double& sl, double& l)
+{
+    // l = v (1 - s / 2), the chroma s * v is 2 * min(l, 1 - l) * sl
+    auto lightness = v * (1. - s / 2.);
+    auto range = std::min(lightness, 1. - lightness);
+    sl = range > 0. ? (v - lightness) / range : 0.;
+    hl = h;
+    l = lightness;
+}
+
+/*!
+    \brief Batch conversion from HSV to HSL color model
+    \param[in] src - HSV in 0..1.0 range, 3 * count floats
+    \param[out] dst - HSL in 0..1.0 range, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void hsv_to_hsl(const float* src, float* dst, size_t count)
+{
+    COLORPP_STATS_SCOPE("hsv_to_hsl/float", count);
+    parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+        hsv_to_hsl_kernel(src + 3 * begin, dst + 3 * begin, end - begin);
+    });
 }
 
+}
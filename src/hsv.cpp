@@ -31,6 +31,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 
+#include "hsv.h"
+#include "parallel.h"
+#include "stats.h"
 #include <algorithm>
 //#include <cmath>
 
@@ -80,12 +83,29 @@ void rgb_to_hsv(double r, double g, double b,
 
 namespace
 {
+    const size_t BatchGrain = 16384;
+
     double mod2(double v)
     {
         while (v > 2.)
             v -= 2.;
         return v;
     }
+
+    // v is 0 only for zero differences (see hexcone.h)
+    void hsl_to_hsv_kernel(const float* src, float* dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto h = src[3 * i];
+            auto s = src[3 * i + 1];
+            auto l = src[3 * i + 2];
+            auto v = l + s * std::min(l, 1.f - l);
+            dst[3 * i] = h;
+            dst[3 * i + 1] = 2.f * (v - l) / (v + 1e-30f);
+            dst[3 * i + 2] = v;
+        }
+    }
 }
 
 /*!
@@ -152,5 +172,37 @@ void hsv_to_rgb(double h, double s, double v,
     }
 }
 
+/*!
+    \brief Conversion from HSL to HSV color model
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] s - saturation channel in 0..1.0 range
+  	\param[in] l - lightness channel in 0..1.0 range
+ 	\param[out] hv - hue channel in 0..1.0 range
+  	\param[out] sv - saturation channel in 0..1.0 range
+  	\param[out] v - value channel in 0..1.0 range
+*/
+void hsl_to_hsv(double h, double s, double l,
+	double& hv, double& sv, double& v)
+{
+    // v = l + s * min(l, 1 - l), the chroma is the same in both models
+    auto value = l + s * std::min(l, 1. - l);
+    sv = value > 0. ? 2. * (1. - l / value) : 0.;
+    hv = h;
+    v = value;
+}
+
+/*!
+    \brief Batch conversion from HSL to HSV color model
+    \param[in] src - HSL in 0..1.0 range, 3 * count floats
+    \param[out] dst - HSV in 0..1.0 range, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void hsl_to_hsv(const float* src, float* dst, size_t count)
+{
+    COLORPP_STATS_SCOPE("hsl_to_hsv/float", count);
+    parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+        hsl_to_hsv_kernel(src + 3 * begin, dst + 3 * begin, end - begin);
+    });
 }
 
+}
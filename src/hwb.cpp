@@ -0,0 +1,199 @@
+/*!
+\file hwb.cpp
+\brief This file contains the source code of HWB conversion
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "hwb.h"
+#include "hexcone.h"
+#include "hsv.h"
+#include "parallel.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t BatchGrain = 16384;
+
+	// grays get a huge inverse chroma multiplied by zero differences (see hexcone.h)
+	void rgb_to_hwb_kernel(const float* src, float* dst, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto r = src[3 * i];
+			auto g = src[3 * i + 1];
+			auto b = src[3 * i + 2];
+			auto mx = std::max(r, std::max(g, b));
+			auto mn = std::min(r, std::min(g, b));
+			auto inv = 1.f / (mx - mn + 1e-30f);
+			auto hr = (g - b) * inv;
+			auto hg = 2.f + (b - r) * inv;
+			auto hb = 4.f + (r - g) * inv;
+			auto h = mx == g ? hg : hb;
+			h = mx == r ? hr : h;
+			h = h < 0.f ? h + 6.f : h;
+			dst[3 * i] = h * (1.f / 6.f);
+			dst[3 * i + 1] = mn;
+			dst[3 * i + 2] = 1.f - mx;
+		}
+	}
+
+	void hwb_to_rgb_kernel(const float* src, float* dst, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto h = 6.f * src[3 * i] + 6.f;
+			auto w = src[3 * i + 1];
+			auto b = src[3 * i + 2];
+			// w + b above 1 is scaled down to a gray
+			auto scale = 1.f / std::max(w + b, 1.f);
+			auto mn = w * scale;
+			auto mx = 1.f - b * scale;
+			auto d = mx - mn;
+			dst[3 * i] = detail::hexcone(mx, d, detail::wrap6(h + 5.f));
+			dst[3 * i + 1] = detail::hexcone(mx, d, detail::wrap6(h + 3.f));
+			dst[3 * i + 2] = detail::hexcone(mx, d, detail::wrap6(h + 1.f));
+		}
+	}
+}
+
+/*!
+    \brief Conversion from RGB to HWB color model (CSS Color 4)
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] h - hue channel in 0..1.0 range, the HSV hue
+  	\param[out] w - whiteness channel in 0..1.0 range
+  	\param[out] b_ - blackness channel in 0..1.0 range
+*/
+void rgb_to_hwb(double r, double g, double b,
+	double& h, double& w, double& b_)
+{
+	double s = 0;
+	double v = 0;
+	rgb_to_hsv(r, g, b, h, s, v);
+	w = std::min(r, std::min(g, b));
+	b_ = 1. - v;
+}
+
+/*!
+    \brief Conversion from HWB to RGB color model (CSS Color 4)
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] w - whiteness channel in 0..1.0 range
+  	\param[in] b_ - blackness channel in 0..1.0 range
+    \param[out] r - red channel in 0..1.0 range
+	\param[out] g - green channel in 0..1.0 range
+ 	\param[out] b - blue channel in 0..1.0 range
+*/
+void hwb_to_rgb(double h, double w, double b_,
+	double& r, double& g, double& b)
+{
+	double hv = 0;
+	double s = 0;
+	double v = 0;
+	hwb_to_hsv(h, w, b_, hv, s, v);
+	hsv_to_rgb(hv, s, v, r, g, b);
+}
+
+/*!
+    \brief Conversion from HSV to HWB color model
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] s - saturation channel in 0..1.0 range
+  	\param[in] v - value channel in 0..1.0 range
+ 	\param[out] hw - hue channel in 0..1.0 range
+  	\param[out] w - whiteness channel in 0..1.0 range
+  	\param[out] b - blackness channel in 0..1.0 range
+*/
+void hsv_to_hwb(double h, double s, double v,
+	double& hw, double& w, double& b)
+{
+	hw = h;
+	w = (1. - s) * v;
+	b = 1. - v;
+}
+
+/*!
+    \brief Conversion from HWB to HSV color model
+	\param[in] h - hue channel in 0..1.0 range
+  	\param[in] w - whiteness channel in 0..1.0 range
+  	\param[in] b - blackness channel in 0..1.0 range
+ 	\param[out] hv - hue channel in 0..1.0 range
+  	\param[out] s - saturation channel in 0..1.0 range
+  	\param[out] v - value channel in 0..1.0 range
+*/
+void hwb_to_hsv(double h, double w, double b,
+	double& hv, double& s, double& v)
+{
+	auto sum = w + b;
+	if (sum > 1.)
+	{
+		w /= sum;
+		b /= sum;
+	}
+	hv = h;
+	v = 1. - b;
+	s = v > 0. ? 1. - w / v : 0.;
+}
+
+/*!
+    \brief Batch conversion from RGB to HWB color model
+    \param[in] src - RGB in 0..1.0 range, 3 * count floats
+    \param[out] dst - HWB in 0..1.0 range, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void rgb_to_hwb(const float* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("rgb_to_hwb/float", count);
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		rgb_to_hwb_kernel(src + 3 * begin, dst + 3 * begin, end - begin);
+	});
+}
+
+/*!
+    \brief Batch conversion from HWB to RGB color model
+    \param[in] src - HWB in 0..1.0 range, 3 * count floats
+    \param[out] dst - RGB in 0..1.0 range, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void hwb_to_rgb(const float* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("hwb_to_rgb/float", count);
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		hwb_to_rgb_kernel(src + 3 * begin, dst + 3 * begin, end - begin);
+	});
+}
+
+}
@@ -0,0 +1,481 @@
+/*!
+\file icc.cpp
+\brief This file contains the source code of ICC matrix/TRC profile loader
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "icc.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+
+namespace colorpp
+{
+
+namespace
+{
+	// ICC.1:2010 (v4) and ICC.1:2001-04 (v2) structures, all numbers are big-endian
+	const size_t HeaderSize = 128;
+
+	uint32_t sig(const char* s)
+	{
+		return (static_cast<uint32_t>(s[0]) << 24) | (static_cast<uint32_t>(s[1]) << 16) |
+			(static_cast<uint32_t>(s[2]) << 8) | static_cast<uint32_t>(s[3]);
+	}
+
+	uint32_t read_u32(const unsigned char* p)
+	{
+		return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+			(static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+	}
+
+	uint16_t read_u16(const unsigned char* p)
+	{
+		return static_cast<uint16_t>((p[0] << 8) | p[1]);
+	}
+
+	double read_s15f16(const unsigned char* p)
+	{
+		return static_cast<int32_t>(read_u32(p)) / 65536.0;
+	}
+
+	/*
+		Any ICC TRC as a parametricCurveType function 4:
+		Y = (a * X + b)^g + e for X >= d, Y = c * X + f otherwise,
+		or as a sampled curveType table.
+	*/
+	struct Curve
+	{
+		double g{1.}, a{1.}, b{0.}, c{0.}, d{0.}, e{0.}, f{0.};
+		std::vector<double> table;
+
+		double eval(double x) const
+		{
+			x = std::min(std::max(x, 0.), 1.);
+			if (!table.empty())
+			{
+				auto pos = x * (table.size() - 1);
+				auto i = std::min(static_cast<size_t>(pos), table.size() - 2);
+				auto t = pos - i;
+				return table[i] + t * (table[i + 1] - table[i]);
+			}
+			if (x >= d)
+			{
+				auto v = a * x + b;
+				return (v > 0. ? std::pow(v, g) : 0.) + e;
+			}
+			return c * x + f;
+		}
+
+		bool is_gamma() const
+		{
+			return table.empty() && a == 1. && b == 0. && d == 0. && e == 0.;
+		}
+
+		bool is_srgb() const
+		{
+			const double eps = 1e-3;
+			return table.empty() && std::abs(g - 2.4) < eps && std::abs(a - 1. / 1.055) < eps &&
+				std::abs(b - 0.055 / 1.055) < eps && std::abs(c - 1. / 12.92) < eps &&
+				std::abs(d - 0.04045) < eps && std::abs(e) < eps && std::abs(f) < eps;
+		}
+
+		bool operator==(const Curve& other) const
+		{
+			return g == other.g && a == other.a && b == other.b && c == other.c &&
+				d == other.d && e == other.e && f == other.f && table == other.table;
+		}
+	};
+
+	struct TagTable
+	{
+		const unsigned char* data;
+		size_t size;
+
+		// tag data of at least min_size bytes or nullptr
+		const unsigned char* find(uint32_t signature, size_t min_size) const
+		{
+			auto count = read_u32(data + HeaderSize);
+			if (HeaderSize + 4 + static_cast<size_t>(count) * 12 > size)
+				return nullptr;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				auto entry = data + HeaderSize + 4 + i * 12;
+				if (read_u32(entry) != signature)
+					continue;
+				size_t offset = read_u32(entry + 4);
+				size_t length = read_u32(entry + 8);
+				if (length < min_size || offset > size || length > size - offset)
+					return nullptr;
+				return data + offset;
+			}
+			return nullptr;
+		}
+	};
+
+	bool read_xyz(const TagTable& tags, const char* name, XYZ xyz)
+	{
+		auto tag = tags.find(sig(name), 20);
+		if (!tag || read_u32(tag) != sig("XYZ "))
+			return false;
+		for (int i = 0; i < 3; ++i)
+			xyz[i] = read_s15f16(tag + 8 + 4 * i);
+		return true;
+	}
+
+	bool read_curve(const TagTable& tags, const char* name, Curve& curve)
+	{
+		auto tag = tags.find(sig(name), 12);
+		if (!tag)
+			return false;
+		auto type = read_u32(tag);
+		if (type == sig("curv"))
+		{
+			auto count = read_u32(tag + 8);
+			if (tags.size - (tag - tags.data) < 12 + static_cast<size_t>(count) * 2)
+				return false;
+			if (count == 0)
+				curve.g = 1.;	// identity
+			else if (count == 1)
+				curve.g = read_u16(tag + 12) / 256.;	// u8Fixed8Number gamma
+			else
+			{
+				curve.table.resize(count);
+				for (uint32_t i = 0; i < count; ++i)
+					curve.table[i] = read_u16(tag + 12 + 2 * i) / 65535.;
+			}
+			return true;
+		}
+		if (type == sig("para"))
+		{
+			static const size_t ParamCount[5] = {1, 3, 4, 5, 7};
+			auto function = read_u16(tag + 8);
+			if (function > 4 || tags.size - (tag - tags.data) < 12 + ParamCount[function] * 4)
+				return false;
+			double p[7] = {1., 1., 0., 0., 0., 0., 0.};
+			for (size_t i = 0; i < ParamCount[function]; ++i)
+				p[i] = read_s15f16(tag + 12 + 4 * i);
+			curve.g = p[0];
+			switch (function)
+			{
+			case 0:
+				break;
+			case 1:	// Y = (a * X + b)^g for X >= -b/a, 0 otherwise
+				curve.a = p[1];
+				curve.b = p[2];
+				curve.d = p[1] != 0. ? -p[2] / p[1] : 0.;
+				break;
+			case 2:	// Y = (a * X + b)^g + c for X >= -b/a, c otherwise
+				curve.a = p[1];
+				curve.b = p[2];
+				curve.d = p[1] != 0. ? -p[2] / p[1] : 0.;
+				curve.e = p[3];
+				curve.f = p[3];
+				break;
+			case 3:	// Y = (a * X + b)^g for X >= d, c * X otherwise
+			case 4:	// Y = (a * X + b)^g + e for X >= d, c * X + f otherwise
+				curve.a = p[1];
+				curve.b = p[2];
+				curve.c = p[3];
+				curve.d = p[4];
+				curve.e = p[5];
+				curve.f = p[6];
+				break;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	void sample_curve(const Curve& curve, std::vector<double>& to_linear, std::vector<double>& to_encoded)
+	{
+		to_linear.resize(IccLutSize + 1);
+		to_encoded.resize(IccLutSize + 1);
+		for (size_t i = 0; i <= IccLutSize; ++i)
+			to_linear[i] = curve.eval(static_cast<double>(i) / IccLutSize);
+		// monotonic curve inversion by bisection
+		for (size_t i = 0; i <= IccLutSize; ++i)
+		{
+			double target = static_cast<double>(i) / IccLutSize;
+			double lo = 0.;
+			double hi = 1.;
+			for (int k = 0; k < 32; ++k)
+			{
+				double mid = (lo + hi) / 2.;
+				if (curve.eval(mid) < target)
+					lo = mid;
+				else
+					hi = mid;
+			}
+			to_encoded[i] = (lo + hi) / 2.;
+		}
+	}
+
+	double lookup(const std::vector<double>& lut, double v)
+	{
+		auto pos = std::min(std::max(v, 0.), 1.) * IccLutSize;
+		auto i = std::min(static_cast<size_t>(pos), IccLutSize - 1);
+		auto t = pos - i;
+		return lut[i] + t * (lut[i + 1] - lut[i]);
+	}
+
+	// FNV-1a
+	uint64_t hash_data(const unsigned char* data, size_t size)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= data[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	struct CachedProfile
+	{
+		std::vector<unsigned char> data;
+		std::shared_ptr<const IccTransform> transform;
+	};
+
+	// the hash only finds the candidates, a hit needs the same profile bytes
+	struct IccCache
+	{
+		std::mutex mutex;
+		std::unordered_multimap<uint64_t, CachedProfile> transforms;
+
+		std::shared_ptr<const IccTransform> find(uint64_t hash, const unsigned char* data, size_t size) const
+		{
+			auto range = transforms.equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it)
+				if (it->second.data.size() == size && std::memcmp(it->second.data.data(), data, size) == 0)
+					return it->second.transform;
+			return nullptr;
+		}
+	};
+
+	IccCache& get_cache()
+	{
+		static IccCache cache;
+		return cache;
+	}
+}
+
+/*!
+	\brief Parse an ICC matrix/TRC profile and compile the transform (not cached)
+	\param[in] data - profile data
+	\param[in] size - size of the data in bytes
+	\param[out] transform - compiled transform
+	\return false if the data is not an RGB matrix/TRC profile
+*/
+bool parse_icc_profile(const unsigned char* data, size_t size, IccTransform& transform)
+{
+	if (!data || size < HeaderSize + 4 || read_u32(data) > size)
+		return false;
+	size = read_u32(data);
+	if (read_u32(data + 36) != sig("acsp") || read_u32(data + 16) != sig("RGB ") ||
+		read_u32(data + 20) != sig("XYZ "))
+		return false;
+
+	TagTable tags{data, size};
+	XYZ colorants[3];
+	Curve curves[3];
+	if (!read_xyz(tags, "rXYZ", colorants[0]) || !read_xyz(tags, "gXYZ", colorants[1]) ||
+		!read_xyz(tags, "bXYZ", colorants[2]) ||
+		!read_curve(tags, "rTRC", curves[0]) || !read_curve(tags, "gTRC", curves[1]) ||
+		!read_curve(tags, "bTRC", curves[2]))
+		return false;
+	if (!read_xyz(tags, "wtpt", transform.MediaWhite))
+	{
+		transform.MediaWhite[0] = 0.9642;
+		transform.MediaWhite[1] = 1.0;
+		transform.MediaWhite[2] = 0.8249;
+	}
+
+	auto& params = transform.Params;
+	params = get_rgb_params();
+	// the colorants are already adapted to the PCS illuminant
+	for (int i = 0; i < 3; ++i)
+	{
+		params.RefWhiteRGB[i] = read_s15f16(data + 68 + 4 * i);
+		params.RefWhite[i] = params.RefWhiteRGB[i];
+		for (int j = 0; j < 3; ++j)
+			params.MtxRGB2XYZ[i][j] = colorants[i][j];
+	}
+	invert_matrix(params.MtxRGB2XYZ, params.MtxXYZ2RGB);
+	update_adaptation(params);
+
+	transform.UseGamma = false;
+	if (curves[0] == curves[1] && curves[0] == curves[2])
+	{
+		if (curves[0].is_gamma() && curves[0].g > 0.)
+		{
+			params.GammaRGB = curves[0].g;
+			params.TransferRGB = TransferEnum::Gamma;
+			transform.UseGamma = true;
+		}
+		else if (curves[0].is_srgb())
+		{
+			params.GammaRGB = -2.2;
+			params.TransferRGB = TransferEnum::sRGB;
+			transform.UseGamma = true;
+		}
+	}
+	for (int i = 0; i < 3; ++i)
+	{
+		transform.ToLinear[i].clear();
+		transform.ToEncoded[i].clear();
+	}
+	if (!transform.UseGamma)
+	{
+		params.GammaRGB = 1.0;
+		params.TransferRGB = TransferEnum::Gamma;
+		for (int i = 0; i < 3; ++i)
+			sample_curve(curves[i], transform.ToLinear[i], transform.ToEncoded[i]);
+	}
+	transform.Hash = hash_data(data, size);
+	return true;
+}
+
+/*!
+	\brief Get the compiled transform of an in-memory ICC profile
+	\param[in] data - profile data
+	\param[in] size - size of the data in bytes
+	\return compiled transform or nullptr if the data is not an RGB matrix/TRC profile
+*/
+std::shared_ptr<const IccTransform> get_icc_transform(const unsigned char* data, size_t size)
+{
+	if (!data || size < HeaderSize + 4 || read_u32(data) > size)
+		return nullptr;
+	// bytes after the declared profile size are ignored, as by parse_icc_profile
+	size = read_u32(data);
+	auto hash = hash_data(data, size);
+	auto& cache = get_cache();
+	{
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		auto cached = cache.find(hash, data, size);
+		if (cached)
+			return cached;
+	}
+	// parse outside the lock, a concurrent duplicate is harmless
+	std::shared_ptr<IccTransform> transform(new IccTransform());
+	if (!parse_icc_profile(data, size, *transform))
+		return nullptr;
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	auto cached = cache.find(transform->Hash, data, size);
+	if (cached)
+		return cached;
+	cache.transforms.emplace(transform->Hash, CachedProfile{std::vector<unsigned char>(data, data + size), transform});
+	return transform;
+}
+
+/*!
+	\brief Load an ICC profile file and get its compiled transform (see get_icc_transform)
+	\param[in] path - path of the local profile file
+	\return compiled transform or nullptr if the file can't be read or parsed
+*/
+std::shared_ptr<const IccTransform> load_icc_profile(const char* path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return nullptr;
+	std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return get_icc_transform(data.data(), data.size());
+}
+
+/*!
+	\brief Drop all the cached ICC transforms
+*/
+void clear_icc_cache()
+{
+	auto& cache = get_cache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	cache.transforms.clear();
+}
+
+/*!
+	\brief Get the number of cached ICC transforms
+	\return number of transforms
+*/
+size_t get_icc_cache_size()
+{
+	auto& cache = get_cache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	return cache.transforms.size();
+}
+
+/*!
+    \brief Conversion from profile RGB to XYZ color model
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] x - x channel in 0..1.0 range
+  	\param[out] y - y channel in 0..1.0 range
+  	\param[out] z - z channel in 0..1.0 range
+	\param[in] transform - compiled ICC transform
+*/
+void icc_rgb_to_xyz(double r, double g, double b,
+	double& x, double& y, double& z, const IccTransform& transform)
+{
+	if (!transform.UseGamma)
+	{
+		r = lookup(transform.ToLinear[0], r);
+		g = lookup(transform.ToLinear[1], g);
+		b = lookup(transform.ToLinear[2], b);
+	}
+	rgb_to_xyz(r, g, b, x, y, z, transform.Params);
+}
+
+/*!
+    \brief Conversion from XYZ to profile RGB color model
+	\param[in] x - x channel in 0..1.0 range
+  	\param[in] y - y channel in 0..1.0 range
+  	\param[in] z - z channel in 0..1.0 range
+    \param[out] r - red channel in 0..1.0 range
+	\param[out] g - green channel in 0..1.0 range
+ 	\param[out] b - blue channel in 0..1.0 range
+	\param[in] transform - compiled ICC transform
+*/
+void icc_xyz_to_rgb(double x, double y, double z,
+	double& r, double& g, double& b, const IccTransform& transform)
+{
+	xyz_to_rgb(x, y, z, r, g, b, transform.Params);
+	if (!transform.UseGamma)
+	{
+		r = lookup(transform.ToEncoded[0], r);
+		g = lookup(transform.ToEncoded[1], g);
+		b = lookup(transform.ToEncoded[2], b);
+	}
+}
+
+}
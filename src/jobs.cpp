@@ -0,0 +1,269 @@
+/*!
+\file jobs.cpp
+\brief This file contains the source code of the work stealing job scheduler
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "jobs.h"
+#include "parallel_detail.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace colorpp
+{
+
+namespace
+{
+	typedef std::function<void()> Task;
+
+	// tasks taken from the own queue under one lock
+	const size_t JobBatch = 8;
+
+	thread_local size_t WorkerIndex = static_cast<size_t>(-1);
+
+	/*
+		Every worker owns a queue: it pops batches of the newest tasks from its back
+		and steals the oldest task from the front of the others when it runs dry.
+		Tasks submitted from a worker go to its own queue, the others round-robin.
+	*/
+	class Scheduler
+	{
+	public:
+		Scheduler()
+		{
+			start(0);
+		}
+		~Scheduler()
+		{
+			stop();
+		}
+
+		unsigned size() const
+		{
+			return static_cast<unsigned>(queues_.size());
+		}
+
+		void resize(unsigned count)
+		{
+			stop();
+			start(count);
+		}
+
+		void push(Task task)
+		{
+			auto count = queues_.size();
+			auto index = WorkerIndex < count ? WorkerIndex : next_.fetch_add(1) % count;
+			{
+				std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+				queues_[index]->tasks.push_back(std::move(task));
+			}
+			queued_.fetch_add(1);
+			{
+				std::lock_guard<std::mutex> lock(sleep_mutex_);
+			}
+			cv_.notify_one();
+		}
+
+	private:
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		void start(unsigned count)
+		{
+			if (count == 0)
+				count = std::max(1u, std::thread::hardware_concurrency());
+			stop_ = false;
+			for (unsigned i = 0; i < count; ++i)
+				queues_.emplace_back(new Queue());
+			for (unsigned i = 0; i < count; ++i)
+				workers_.emplace_back([this, i] { loop(i); });
+		}
+
+		// workers leave when the queues are drained
+		void stop()
+		{
+			{
+				std::lock_guard<std::mutex> lock(sleep_mutex_);
+				stop_ = true;
+			}
+			cv_.notify_all();
+			for (auto& worker : workers_)
+				worker.join();
+			workers_.clear();
+			queues_.clear();
+		}
+
+		bool pop(size_t self, std::vector<Task>& batch)
+		{
+			{
+				auto& queue = *queues_[self];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				while (!queue.tasks.empty() && batch.size() < JobBatch)
+				{
+					batch.push_back(std::move(queue.tasks.back()));
+					queue.tasks.pop_back();
+				}
+			}
+			for (size_t i = 1; batch.empty() && i < queues_.size(); ++i)
+			{
+				auto& queue = *queues_[(self + i) % queues_.size()];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (!queue.tasks.empty())
+				{
+					batch.push_back(std::move(queue.tasks.front()));
+					queue.tasks.pop_front();
+				}
+			}
+			queued_.fetch_sub(batch.size());
+			return !batch.empty();
+		}
+
+		void loop(size_t self)
+		{
+			WorkerIndex = self;
+			detail::set_inside_parallel(true);
+			std::vector<Task> batch;
+			batch.reserve(JobBatch);
+			for (;;)
+			{
+				if (pop(self, batch))
+				{
+					for (auto& task : batch)
+						task();
+					batch.clear();
+					continue;
+				}
+				std::unique_lock<std::mutex> lock(sleep_mutex_);
+				if (stop_ && queued_ == 0)
+					break;
+				cv_.wait(lock, [this] { return stop_ || queued_ > 0; });
+			}
+			WorkerIndex = static_cast<size_t>(-1);
+		}
+
+		std::vector<std::unique_ptr<Queue>> queues_;
+		std::vector<std::thread> workers_;
+		std::mutex sleep_mutex_;
+		std::condition_variable cv_;
+		std::atomic<size_t> queued_{0};
+		std::atomic<size_t> next_{0};
+		bool stop_{false};
+	};
+
+	Scheduler& get_scheduler()
+	{
+		static Scheduler scheduler;
+		return scheduler;
+	}
+
+	struct RangeState
+	{
+		std::function<void(size_t, size_t)> fn;
+		std::function<void()> done;
+		std::atomic<size_t> remaining;
+	};
+}
+
+namespace detail
+{
+
+/*!
+	\brief Queue a task on the job scheduler
+	\param[in] task - task function
+*/
+void submit_task(std::function<void()> task)
+{
+	get_scheduler().push(std::move(task));
+}
+
+/*!
+	\brief Queue a range job on the job scheduler
+	\param[in] count - number of items
+	\param[in] grain - minimal number of items in a part
+	\param[in] fn - part function, called as fn(begin, end)
+	\param[in] done - called once after the last part
+*/
+void submit_range(size_t count, size_t grain, std::function<void(size_t, size_t)> fn,
+	std::function<void()> done)
+{
+	if (count == 0)
+	{
+		done();
+		return;
+	}
+	auto& scheduler = get_scheduler();
+	size_t threads = scheduler.size();
+	// a few parts per thread to even out the load, as parallel_for does
+	auto part = std::max(std::max<size_t>(grain, 1), (count + threads * 4 - 1) / (threads * 4));
+	auto parts = (count + part - 1) / part;
+	std::shared_ptr<RangeState> state(new RangeState());
+	state->fn = std::move(fn);
+	state->done = std::move(done);
+	state->remaining = parts;
+	for (size_t begin = 0; begin < count; begin += part)
+	{
+		auto end = std::min(begin + part, count);
+		scheduler.push([state, begin, end] {
+			state->fn(begin, end);
+			if (state->remaining.fetch_sub(1) == 1)
+				state->done();
+		});
+	}
+}
+
+}
+
+/*!
+	\brief Set the number of job scheduler threads
+	\param[in] count - number of threads (0 - hardware concurrency)
+*/
+void set_job_thread_count(unsigned count)
+{
+	get_scheduler().resize(count);
+}
+
+/*!
+	\brief Get the number of job scheduler threads
+	\return number of threads
+*/
+unsigned get_job_thread_count()
+{
+	return get_scheduler().size();
+}
+
+}
@@ -0,0 +1,356 @@
+/*!
+\file lut_cache.cpp
+\brief Versioned on-disk cache of baked tables
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "lut_cache.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef COLORPP_VERSION
+#define COLORPP_VERSION "unknown"
+#endif
+#define COLORPP_STRINGIZE(x) #x
+#define COLORPP_TO_STRING(x) COLORPP_STRINGIZE(x)
+
+namespace colorpp
+{
+
+namespace
+{
+	// bumped on any change of the file layout
+	const uint32_t FormatVersion = 2;
+	const uint32_t ByteOrderMark = 0x01020304;
+	const char Magic[8] = {'C', 'P', 'P', 'L', 'U', 'T', 0, 0};
+	// payloads start on a page boundary of the mapping
+	const uint64_t PayloadAlign = 4096;
+
+	struct FileHeader
+	{
+		char Magic[8];
+		uint32_t Version;
+		uint32_t ByteOrder;
+		uint64_t Build;	// hash of the build id of the writer
+		uint64_t KeySize;	// the key follows the header
+		uint64_t PayloadOffset;
+		uint64_t PayloadSize;
+		uint64_t Checksum;
+	};
+
+	struct CacheDir
+	{
+		std::mutex mutex;
+		std::string dir;
+		CacheDir()
+		{
+			auto env = std::getenv("COLORPP_LUT_CACHE");
+			if (env && *env && is_writable(env))
+				dir = env;
+		}
+		static bool is_writable(const std::string& dir)
+		{
+			auto probe = dir + "/.colorpp_probe." + std::to_string(getpid());
+			auto file = std::fopen(probe.c_str(), "wb");
+			if (!file)
+				return false;
+			std::fclose(file);
+			std::remove(probe.c_str());
+			return true;
+		}
+	};
+
+	CacheDir& get_cache_dir()
+	{
+		static CacheDir cache;
+		return cache;
+	}
+
+	uint64_t hash_key(const std::string& key)
+	{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ULL;
+		for (unsigned char c : key)
+			hash = (hash ^ c) * 1099511628211ULL;
+		return hash;
+	}
+
+	// tables of other library versions, compilers or instruction sets may differ in the last bits
+	const char* const BuildId = "colorpp " COLORPP_VERSION
+#if defined(__VERSION__)
+		" " __VERSION__
+#elif defined(_MSC_FULL_VER)
+		" msvc " COLORPP_TO_STRING(_MSC_FULL_VER)
+#endif
+#ifdef __FMA__
+		" fma"
+#endif
+#ifdef __AVX2__
+		" avx2"
+#endif
+#ifdef __AVX512F__
+		" avx512f"
+#endif
+		"";
+
+	// word-wise multiplicative hash, fast enough to check tables of tens of megabytes on load
+	uint64_t get_checksum(const unsigned char* data, size_t size)
+	{
+		uint64_t hash = 14695981039346656037ULL ^ size;
+		size_t i = 0;
+		for (; i + 8 <= size; i += 8)
+		{
+			uint64_t word;
+			std::memcpy(&word, data + i, 8);
+			hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+			hash ^= hash >> 29;
+		}
+		for (; i < size; ++i)
+			hash = (hash ^ data[i]) * 1099511628211ULL;
+		return hash;
+	}
+
+	bool is_valid(const unsigned char* file, size_t file_size, const std::string& key, size_t size)
+	{
+		if (file_size < sizeof(FileHeader))
+			return false;
+		FileHeader header;
+		std::memcpy(&header, file, sizeof(header));
+		return std::memcmp(header.Magic, Magic, sizeof(Magic)) == 0 &&
+			header.Version == FormatVersion &&
+			header.ByteOrder == ByteOrderMark &&
+			header.Build == hash_key(BuildId) &&
+			header.KeySize == key.size() &&
+			sizeof(FileHeader) + header.KeySize <= file_size &&
+			std::memcmp(file + sizeof(FileHeader), key.data(), key.size()) == 0 &&
+			header.PayloadSize == size &&
+			header.PayloadOffset % PayloadAlign == 0 &&
+			header.PayloadOffset >= sizeof(FileHeader) + header.KeySize &&
+			header.PayloadOffset <= file_size && header.PayloadSize <= file_size - header.PayloadOffset &&
+			header.Checksum == get_checksum(file + header.PayloadOffset, size);
+	}
+
+	// whole file in memory or mapped, empty if it can't be read
+	std::shared_ptr<const void> map_file(const std::string& path, size_t& file_size)
+	{
+#ifdef _WIN32
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			return nullptr;
+		auto data = std::make_shared<std::vector<unsigned char>>(
+			std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		file_size = data->size();
+		return std::shared_ptr<const void>(data, data->data());
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return nullptr;
+		struct stat st;
+		void* addr = MAP_FAILED;
+		if (::fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			file_size = static_cast<size_t>(st.st_size);
+			// shared read-only mapping: all processes use the same page cache pages
+			addr = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+		}
+		::close(fd);
+		if (addr == MAP_FAILED)
+			return nullptr;
+		size_t length = file_size;
+		return std::shared_ptr<const void>(addr, [length](const void* p) {
+			::munmap(const_cast<void*>(p), length);
+		});
+#endif
+	}
+}
+
+/*!
+	\brief Set the directory of the table cache
+	\param[in] dir - existing directory, empty to turn the cache off
+	\return false if the directory isn't writable (the cache is turned off)
+*/
+bool set_lut_cache_dir(const std::string& dir)
+{
+	auto& cache = get_cache_dir();
+	bool result = dir.empty() || CacheDir::is_writable(dir);
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	cache.dir = result ? dir : std::string();
+	return result;
+}
+
+/*!
+	\brief Get the directory of the table cache
+	\return directory, empty if the cache is off
+*/
+std::string get_lut_cache_dir()
+{
+	auto& cache = get_cache_dir();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	return cache.dir;
+}
+
+/*!
+	\brief Get the cache file name of a table
+	\param[in] key - parameters of the table, for example "color_lut/RgbToHsv"
+	\return file name in the cache directory, empty if the cache is off
+*/
+std::string get_lut_cache_path(const std::string& key)
+{
+	auto dir = get_lut_cache_dir();
+	if (dir.empty())
+		return dir;
+	char name[32];
+	std::snprintf(name, sizeof(name), "/%016llx.lut", static_cast<unsigned long long>(hash_key(key)));
+	return dir + name;
+}
+
+/*!
+	\brief Map a table from the cache read-only
+	\param[in] key - parameters of the table
+	\param[in] size - expected size in bytes
+	\return table, without data if the file is missing or invalid
+*/
+CachedTable load_cached_table(const std::string& key, size_t size)
+{
+	CachedTable table{nullptr, 0, false, nullptr};
+	auto path = get_lut_cache_path(key);
+	if (path.empty())
+		return table;
+	size_t file_size = 0;
+	auto file = map_file(path, file_size);
+	auto bytes = static_cast<const unsigned char*>(file.get());
+	if (!bytes || !is_valid(bytes, file_size, key, size))
+		return table;
+	FileHeader header;
+	std::memcpy(&header, bytes, sizeof(header));
+	table.Data = bytes + header.PayloadOffset;
+	table.Size = size;
+#ifndef _WIN32
+	table.IsMapped = true;
+#endif
+	table.Holder = file;
+	return table;
+}
+
+/*!
+	\brief Store a table in the cache
+	\param[in] key - parameters of the table
+	\param[in] data - table
+	\param[in] size - size in bytes
+	\return false if the cache is off or the file can't be written
+*/
+bool store_cached_table(const std::string& key, const void* data, size_t size)
+{
+	auto path = get_lut_cache_path(key);
+	if (path.empty())
+		return false;
+	FileHeader header;
+	std::memcpy(header.Magic, Magic, sizeof(Magic));
+	header.Version = FormatVersion;
+	header.ByteOrder = ByteOrderMark;
+	header.Build = hash_key(BuildId);
+	header.KeySize = key.size();
+	header.PayloadOffset = (sizeof(FileHeader) + key.size() + PayloadAlign - 1) / PayloadAlign * PayloadAlign;
+	header.PayloadSize = size;
+	header.Checksum = get_checksum(static_cast<const unsigned char*>(data), size);
+
+	// unique temporary name per process and call, renamed over the final name at once
+	static std::atomic<unsigned> counter{0};
+	auto temp = path + ".tmp." + std::to_string(getpid()) + "." + std::to_string(counter++);
+	auto file = std::fopen(temp.c_str(), "wb");
+	if (!file)
+		return false;
+	std::vector<char> padding(static_cast<size_t>(header.PayloadOffset) - sizeof(FileHeader) - key.size(), 0);
+	bool result = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+		std::fwrite(key.data(), 1, key.size(), file) == key.size() &&
+		std::fwrite(padding.data(), 1, padding.size(), file) == padding.size() &&
+		std::fwrite(data, 1, size, file) == size;
+	result = std::fclose(file) == 0 && result;
+	if (result)
+	{
+#ifdef _WIN32
+		// rename doesn't replace the file of another process that stored the table first
+		std::remove(path.c_str());
+#endif
+		result = std::rename(temp.c_str(), path.c_str()) == 0;
+	}
+	if (!result)
+		std::remove(temp.c_str());
+	return result;
+}
+
+/*!
+	\brief Get a table from the cache, or build it and store it
+	\param[in] key - parameters of the table
+	\param[in] size - size in bytes
+	\param[in] build - fills size bytes of the table
+	\return table
+*/
+CachedTable get_cached_table(const std::string& key, size_t size,
+	const std::function<void(unsigned char*)>& build)
+{
+	auto table = load_cached_table(key, size);
+	if (table.Data)
+		return table;
+	auto data = std::make_shared<std::vector<unsigned char>>(size);
+	build(data->data());
+	if (store_cached_table(key, data->data(), size))
+	{
+		// the stored file replaces the private copy, so its pages are shared
+		table = load_cached_table(key, size);
+		if (table.Data)
+			return table;
+	}
+	table.Data = data->data();
+	table.Size = size;
+	table.IsMapped = false;
+	table.Holder = std::shared_ptr<const void>(data, data->data());
+	return table;
+}
+
+}
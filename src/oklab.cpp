@@ -0,0 +1,387 @@
+/*!
+\file oklab.cpp
+\brief Oklab and Oklch color models
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#include "oklab.h"
+#include "parallel.h"
+#include "rgb.h"
+#include "stats.h"
+#include "transfer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t BatchGrain = 16384;
+	const size_t CodeBlock = 256;
+	const double Pi = 3.14159265358979323846;
+
+	// channels to Oklab: a = (channel - 0.5) * AbRange, C = channel * ChromaRange
+	const double AbRange = 0.8;
+	const double ChromaRange = 0.4;
+
+	// linear sRGB to LMS and cube rooted LMS to Lab (Bjorn Ottosson)
+	const double M1[3][3] = {
+		{0.4122214708, 0.5363325363, 0.0514459929},
+		{0.2119034982, 0.6806995451, 0.1073969566},
+		{0.0883024619, 0.2817188376, 0.6299787005}
+	};
+	const double M2[3][3] = {
+		{0.2104542553, 0.7936177850, -0.0040720468},
+		{1.9779984951, -2.4285922050, 0.4505937099},
+		{0.0259040371, 0.7827717662, -0.8086757660}
+	};
+	const double InvM2[3][3] = {
+		{1.0, 0.3963377774, 0.2158037573},
+		{1.0, -0.1055613458, -0.0638541728},
+		{1.0, -0.0894841775, -1.2914855480}
+	};
+	const double InvM1[3][3] = {
+		{4.0767416621, -3.3077115913, 0.2309699292},
+		{-1.2684380046, 2.6097574011, -0.3413193965},
+		{-0.0041960863, -0.7034186147, 1.7076147010}
+	};
+
+	template<typename T>
+	void multiply(const double m[3][3], const T in[3], T out[3])
+	{
+		for (int i = 0; i < 3; ++i)
+			out[i] = static_cast<T>(m[i][0] * in[0] + m[i][1] * in[1] + m[i][2] * in[2]);
+	}
+
+	/*
+		Cube root without libm: the exponent divided by 3 through the bits (Kahan's
+		constant, within 4%), then two Halley steps reach the float precision.
+		Straight-line code, so the loops around it vectorize.
+	*/
+	inline float cube_root(float x)
+	{
+		const float ax = std::abs(x) + 1e-30f;
+		int32_t bits;
+		std::memcpy(&bits, &ax, sizeof(bits));
+		bits = static_cast<int32_t>(static_cast<float>(bits) * (1.f / 3.f)) + 709958130;
+		float y;
+		std::memcpy(&y, &bits, sizeof(y));
+		for (int i = 0; i < 2; ++i)
+		{
+			const float y3 = y * y * y;
+			y *= (y3 + 2.f * ax) / (2.f * y3 + ax);
+		}
+		return std::copysign(y, x);
+	}
+
+	// float copies of the matrices, the channel offsets folded into M2 and InvM2
+	struct Kernel
+	{
+		float m1[3][3];
+		float m2[3][3];
+		float o2[3];	// channel offsets
+		float inv_m2[3][3];
+		float inv_o2[3];
+		float inv_m1[3][3];
+
+		Kernel()
+		{
+			const double scale[3] = {1., 1. / AbRange, 1. / AbRange};
+			const double offset[3] = {0., 0.5, 0.5};
+			for (int i = 0; i < 3; ++i)
+			{
+				for (int j = 0; j < 3; ++j)
+				{
+					m1[i][j] = static_cast<float>(M1[i][j]);
+					m2[i][j] = static_cast<float>(M2[i][j] * scale[i]);
+					inv_m2[i][j] = static_cast<float>(InvM2[i][j] / scale[j]);
+					inv_m1[i][j] = static_cast<float>(InvM1[i][j]);
+				}
+				o2[i] = static_cast<float>(offset[i]);
+			}
+			for (int i = 0; i < 3; ++i)
+				inv_o2[i] = -(inv_m2[i][0] * o2[0] + inv_m2[i][1] * o2[1] + inv_m2[i][2] * o2[2]);
+		}
+
+		// linear sRGB to Oklab channels
+		void forward(float r, float g, float b, float* dst) const
+		{
+			const float l = cube_root(m1[0][0] * r + m1[0][1] * g + m1[0][2] * b);
+			const float m = cube_root(m1[1][0] * r + m1[1][1] * g + m1[1][2] * b);
+			const float s = cube_root(m1[2][0] * r + m1[2][1] * g + m1[2][2] * b);
+			dst[0] = m2[0][0] * l + m2[0][1] * m + m2[0][2] * s + o2[0];
+			dst[1] = m2[1][0] * l + m2[1][1] * m + m2[1][2] * s + o2[1];
+			dst[2] = m2[2][0] * l + m2[2][1] * m + m2[2][2] * s + o2[2];
+		}
+
+		// Oklab channels to linear sRGB
+		void inverse(const float* src, float* dst) const
+		{
+			float lms[3];
+			for (int i = 0; i < 3; ++i)
+			{
+				const float c = inv_m2[i][0] * src[0] + inv_m2[i][1] * src[1] + inv_m2[i][2] * src[2] + inv_o2[i];
+				lms[i] = c * c * c;
+			}
+			for (int i = 0; i < 3; ++i)
+				dst[i] = inv_m1[i][0] * lms[0] + inv_m1[i][1] * lms[1] + inv_m1[i][2] * lms[2];
+		}
+	};
+
+	const Kernel& get_kernel()
+	{
+		static const Kernel kernel;
+		return kernel;
+	}
+
+	// linear values of the 8-bit sRGB codes
+	const float* get_codes()
+	{
+		struct Codes
+		{
+			float lut[256];
+			Codes()
+			{
+				unsigned short codes[256];
+				for (int i = 0; i < 256; ++i)
+					codes[i] = static_cast<unsigned short>(i);
+				inv_compand(codes, lut, 256, TransferEnum::sRGB, 8);
+			}
+		};
+		static const Codes codes;
+		return codes.lut;
+	}
+}
+
+/*!
+    \brief Conversion from sRGB to Oklab color model
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] l - lightness channel in 0..1.0 range
+  	\param[out] a - green-red channel in 0..1.0 range (0.5 is neutral)
+  	\param[out] b_ - blue-yellow channel in 0..1.0 range (0.5 is neutral)
+*/
+void rgb_to_oklab(double r, double g, double b,
+	double& l, double& a, double& b_)
+{
+	const double rgb[3] = {inv_compand(r, TransferEnum::sRGB), inv_compand(g, TransferEnum::sRGB),
+		inv_compand(b, TransferEnum::sRGB)};
+	double lms[3];
+	multiply(M1, rgb, lms);
+	for (int i = 0; i < 3; ++i)
+		lms[i] = std::cbrt(lms[i]);
+	double lab[3];
+	multiply(M2, lms, lab);
+	l = lab[0];
+	a = 0.5 + lab[1] / AbRange;
+	b_ = 0.5 + lab[2] / AbRange;
+}
+
+/*!
+    \brief Conversion from Oklab to sRGB color model
+ 	\param[in] l - lightness channel in 0..1.0 range
+  	\param[in] a - green-red channel in 0..1.0 range (0.5 is neutral)
+  	\param[in] b_ - blue-yellow channel in 0..1.0 range (0.5 is neutral)
+    \param[out] r - red channel, out of gamut colors are out of 0..1.0 range
+	\param[out] g - green channel, out of gamut colors are out of 0..1.0 range
+ 	\param[out] b - blue channel, out of gamut colors are out of 0..1.0 range
+*/
+void oklab_to_rgb(double l, double a, double b_,
+	double& r, double& g, double& b)
+{
+	const double lab[3] = {l, (a - 0.5) * AbRange, (b_ - 0.5) * AbRange};
+	double lms[3];
+	multiply(InvM2, lab, lms);
+	for (int i = 0; i < 3; ++i)
+		lms[i] = lms[i] * lms[i] * lms[i];
+	double rgb[3];
+	multiply(InvM1, lms, rgb);
+	r = compand(rgb[0], TransferEnum::sRGB);
+	g = compand(rgb[1], TransferEnum::sRGB);
+	b = compand(rgb[2], TransferEnum::sRGB);
+}
+
+/*!
+    \brief Conversion from Oklab to Oklch color model
+ 	\param[in] l - lightness channel in 0..1.0 range
+  	\param[in] a - green-red channel in 0..1.0 range (0.5 is neutral)
+  	\param[in] b - blue-yellow channel in 0..1.0 range (0.5 is neutral)
+ 	\param[out] l_ - lightness channel in 0..1.0 range
+  	\param[out] c - chroma channel in 0..1.0 range
+  	\param[out] h - hue channel in 0..1.0 range, 0 for neutral colors
+*/
+void oklab_to_oklch(double l, double a, double b,
+	double& l_, double& c, double& h)
+{
+	const double da = (a - 0.5) * AbRange;
+	const double db = (b - 0.5) * AbRange;
+	l_ = l;
+	c = std::sqrt(da * da + db * db) / ChromaRange;
+	h = std::atan2(db, da) / (2. * Pi);
+	if (h < 0.)
+		h += 1.;
+}
+
+/*!
+    \brief Conversion from Oklch to Oklab color model
+ 	\param[in] l - lightness channel in 0..1.0 range
+  	\param[in] c - chroma channel in 0..1.0 range
+  	\param[in] h - hue channel in 0..1.0 range
+ 	\param[out] l_ - lightness channel in 0..1.0 range
+  	\param[out] a - green-red channel in 0..1.0 range (0.5 is neutral)
+  	\param[out] b - blue-yellow channel in 0..1.0 range (0.5 is neutral)
+*/
+void oklch_to_oklab(double l, double c, double h,
+	double& l_, double& a, double& b)
+{
+	l_ = l;
+	a = 0.5 + c * ChromaRange * std::cos(2. * Pi * h) / AbRange;
+	b = 0.5 + c * ChromaRange * std::sin(2. * Pi * h) / AbRange;
+}
+
+/*!
+    \brief Batch conversion from sRGB to Oklab color model
+    \param[in] src - sRGB in 0..1.0 range, 3 * count floats
+    \param[out] dst - Oklab channels, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void rgb_to_oklab(const float* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("rgb_to_oklab/float", count);
+	auto& kernel = get_kernel();
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		// decoded in place, the chunk is still in the cache for the matrices
+		float* d = dst + 3 * begin;
+		inv_compand(src + 3 * begin, d, 3 * (end - begin), TransferEnum::sRGB);
+		for (size_t i = 0; i < end - begin; ++i)
+			kernel.forward(d[3 * i], d[3 * i + 1], d[3 * i + 2], d + 3 * i);
+	});
+}
+
+/*!
+    \brief Batch conversion from 8-bit sRGB to Oklab color model
+    \param[in] src - sRGB codes (value / 255), 3 * count bytes
+    \param[out] dst - Oklab channels, 3 * count floats
+    \param[in] count - number of pixels
+*/
+void rgb_to_oklab(const unsigned char* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("rgb_to_oklab/8", count);
+	auto& kernel = get_kernel();
+	auto lut = get_codes();
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		// table loads are gathers, decoded per block so the matrix loop stays vectorized
+		float linear[3 * CodeBlock];
+		for (size_t block = begin; block < end; block += CodeBlock)
+		{
+			const size_t n = std::min(CodeBlock, end - block);
+			const unsigned char* s = src + 3 * block;
+			float* d = dst + 3 * block;
+			for (size_t i = 0; i < 3 * n; ++i)
+				linear[i] = lut[s[i]];
+			for (size_t i = 0; i < n; ++i)
+				kernel.forward(linear[3 * i], linear[3 * i + 1], linear[3 * i + 2], d + 3 * i);
+		}
+	});
+}
+
+/*!
+    \brief Batch conversion from Oklab to sRGB color model
+    \param[in] src - Oklab channels, 3 * count floats
+    \param[out] dst - sRGB clamped to 0..1.0, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void oklab_to_rgb(const float* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("oklab_to_rgb/float", count);
+	auto& kernel = get_kernel();
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		float* d = dst + 3 * begin;
+		for (size_t i = begin; i < end; ++i)
+			kernel.inverse(src + 3 * i, dst + 3 * i);
+		compand(d, d, 3 * (end - begin), TransferEnum::sRGB);
+	});
+}
+
+/*!
+    \brief Batch conversion from Oklab to Oklch color model
+    \param[in] src - Oklab channels, 3 * count floats
+    \param[out] dst - Oklch channels, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void oklab_to_oklch(const float* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("oklab_to_oklch/float", count);
+	const float ab = static_cast<float>(AbRange);
+	const float chroma = static_cast<float>(AbRange / ChromaRange);
+	const float turn = static_cast<float>(1. / (2. * Pi));
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			const float a = src[3 * i + 1] - 0.5f;
+			const float b = src[3 * i + 2] - 0.5f;
+			const float h = std::atan2(b * ab, a * ab) * turn;
+			dst[3 * i] = src[3 * i];
+			dst[3 * i + 1] = std::sqrt(a * a + b * b) * chroma;
+			dst[3 * i + 2] = h < 0.f ? h + 1.f : h;
+		}
+	});
+}
+
+/*!
+    \brief Batch conversion from Oklch to Oklab color model
+    \param[in] src - Oklch channels, 3 * count floats
+    \param[out] dst - Oklab channels, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+*/
+void oklch_to_oklab(const float* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("oklch_to_oklab/float", count);
+	const float chroma = static_cast<float>(ChromaRange / AbRange);
+	const float angle = static_cast<float>(2. * Pi);
+	parallel_for(count, BatchGrain, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			const float c = src[3 * i + 1] * chroma;
+			const float h = src[3 * i + 2] * angle;
+			dst[3 * i] = src[3 * i];
+			dst[3 * i + 1] = 0.5f + c * std::cos(h);
+			dst[3 * i + 2] = 0.5f + c * std::sin(h);
+		}
+	});
+}
+
+}
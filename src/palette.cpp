@@ -0,0 +1,363 @@
+/*!
+\file palette.cpp
+\brief Palette extraction
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#include "palette.h"
+#include "arena.h"
+#include "parallel.h"
+#include "stats.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t HistogramGrain = 1 << 16;
+	// k-means assignment blocks, fixed so the sums don't depend on the threads
+	const size_t AssignBlocks = 64;
+
+	struct Bin
+	{
+		uint64_t count;
+		uint64_t sum[3];
+	};
+
+	// non-empty histogram bin
+	struct Cell
+	{
+		double count;
+		double rgb[3];	// mean of the pixels in 0..1.0 range
+		double lab[3];
+	};
+
+	void rgb_to_lab(const double rgb[3], double lab[3], const RgbParams& params)
+	{
+		double xyz[3];
+		rgb_to_xyz(rgb[0], rgb[1], rgb[2], xyz[0], xyz[1], xyz[2], params);
+		xyz_to_lab(xyz[0], xyz[1], xyz[2], lab[0], lab[1], lab[2], params.RefWhite);
+	}
+
+	void lab_to_rgb(const double lab[3], double rgb[3], const RgbParams& params)
+	{
+		double xyz[3];
+		lab_to_xyz(lab[0], lab[1], lab[2], xyz[0], xyz[1], xyz[2], params.RefWhite);
+		xyz_to_rgb(xyz[0], xyz[1], xyz[2], rgb[0], rgb[1], rgb[2], params);
+	}
+
+	double distance2(const double a[3], const double b[3])
+	{
+		double d0 = a[0] - b[0];
+		double d1 = a[1] - b[1];
+		double d2 = a[2] - b[2];
+		return d0 * d0 + d1 * d1 + d2 * d2;
+	}
+
+	PaletteColor make_color(const double rgb[3], double population)
+	{
+		// rounded to the nearest byte in the from_dbl convention (v * 256 truncated)
+		rgb256 color(from_dbl<byte>(rgb[0] + 0.5 / 256), from_dbl<byte>(rgb[1] + 0.5 / 256),
+			from_dbl<byte>(rgb[2] + 0.5 / 256));
+		return {color, hsv360_100(color), static_cast<size_t>(population)};
+	}
+
+	// histogram of the pixels, the bins of every thread merged
+	std::vector<Cell> get_cells(const unsigned char* src, size_t count, int bits)
+	{
+		const int shift = 8 - bits;
+		const size_t bins = size_t(1) << (3 * bits);
+		const size_t slices = std::max<size_t>(1, std::min<size_t>(get_thread_count(),
+			(count + HistogramGrain - 1) / HistogramGrain));
+		ArenaBuffer<Bin> histograms(slices * bins);
+		parallel_for(slices, 1, [&](size_t begin, size_t end) {
+			for (size_t slice = begin; slice < end; ++slice)
+			{
+				Bin* h = &histograms[slice * bins];
+				std::fill(h, h + bins, Bin{0, {0, 0, 0}});
+				const size_t first = count * slice / slices;
+				const size_t last = count * (slice + 1) / slices;
+				for (const unsigned char* p = src + 3 * first; p != src + 3 * last; p += 3)
+				{
+					Bin& bin = h[((p[0] >> shift) << (2 * bits)) | ((p[1] >> shift) << bits) | (p[2] >> shift)];
+					++bin.count;
+					bin.sum[0] += p[0];
+					bin.sum[1] += p[1];
+					bin.sum[2] += p[2];
+				}
+			}
+		});
+		parallel_for(bins, 4096, [&](size_t begin, size_t end) {
+			for (size_t slice = 1; slice < slices; ++slice)
+				for (size_t i = begin; i < end; ++i)
+				{
+					const Bin& bin = histograms[slice * bins + i];
+					histograms[i].count += bin.count;
+					for (int c = 0; c < 3; ++c)
+						histograms[i].sum[c] += bin.sum[c];
+				}
+		});
+
+		std::vector<Cell> cells;
+		for (size_t i = 0; i < bins; ++i)
+		{
+			const Bin& bin = histograms[i];
+			if (bin.count == 0)
+				continue;
+			Cell cell;
+			cell.count = static_cast<double>(bin.count);
+			for (int c = 0; c < 3; ++c)
+				cell.rgb[c] = static_cast<double>(bin.sum[c]) / cell.count / 256.0;
+			cells.push_back(cell);
+		}
+		return cells;
+	}
+
+	std::vector<PaletteColor> median_cut(std::vector<Cell>& cells, size_t colors)
+	{
+		struct Box
+		{
+			size_t first;
+			size_t last;
+			double count;
+		};
+		std::vector<Box> boxes{{0, cells.size(), 0.}};
+		for (const Cell& cell : cells)
+			boxes[0].count += cell.count;
+		while (boxes.size() < colors)
+		{
+			// the most populated box with more than one cell
+			Box* box = nullptr;
+			for (Box& b : boxes)
+				if (b.last - b.first > 1 && (!box || b.count > box->count))
+					box = &b;
+			if (!box)
+				break;
+			double low[3] = {1., 1., 1.};
+			double high[3] = {0., 0., 0.};
+			for (size_t i = box->first; i < box->last; ++i)
+				for (int c = 0; c < 3; ++c)
+				{
+					low[c] = std::min(low[c], cells[i].rgb[c]);
+					high[c] = std::max(high[c], cells[i].rgb[c]);
+				}
+			int axis = 0;
+			for (int c = 1; c < 3; ++c)
+				if (high[c] - low[c] > high[axis] - low[axis])
+					axis = c;
+			std::sort(cells.begin() + box->first, cells.begin() + box->last, [axis](const Cell& a, const Cell& b) {
+				return a.rgb[axis] < b.rgb[axis];
+			});
+			// the median pixel, keeping a cell on both sides
+			size_t split = box->first + 1;
+			double below = cells[box->first].count;
+			while (split + 1 < box->last && below + cells[split].count <= box->count / 2)
+				below += cells[split++].count;
+			Box upper{split, box->last, box->count - below};
+			box->last = split;
+			box->count = below;
+			boxes.push_back(upper);
+		}
+
+		std::vector<PaletteColor> palette;
+		for (const Box& box : boxes)
+		{
+			double rgb[3] = {0., 0., 0.};
+			for (size_t i = box.first; i < box.last; ++i)
+				for (int c = 0; c < 3; ++c)
+					rgb[c] += cells[i].rgb[c] * cells[i].count;
+			for (int c = 0; c < 3; ++c)
+				rgb[c] /= box.count;
+			palette.push_back(make_color(rgb, box.count));
+		}
+		return palette;
+	}
+
+	// k-means++: every next center is drawn with probability count * D^2
+	std::vector<std::array<double, 3>> seed_centers(const std::vector<Cell>& cells, size_t colors, unsigned seed)
+	{
+		std::mt19937 engine(seed);
+		std::vector<std::array<double, 3>> centers;
+		std::vector<double> weights(cells.size());
+		for (size_t i = 0; i < cells.size(); ++i)
+			weights[i] = cells[i].count;
+		while (centers.size() < colors)
+		{
+			double total = 0.;
+			for (double w : weights)
+				total += w;
+			if (!(total > 0.))
+				break;	// fewer distinct cells than colors
+			double pick = std::uniform_real_distribution<double>(0., total)(engine);
+			size_t i = 0;
+			while (i + 1 < cells.size() && (pick -= weights[i]) >= 0.)
+				++i;
+			while (!(weights[i] > 0.))
+				--i;
+			centers.push_back({{cells[i].lab[0], cells[i].lab[1], cells[i].lab[2]}});
+			parallel_for(cells.size(), 1024, [&](size_t begin, size_t end) {
+				for (size_t j = begin; j < end; ++j)
+				{
+					double d = distance2(cells[j].lab, centers.back().data()) * cells[j].count;
+					weights[j] = centers.size() == 1 ? d : std::min(weights[j], d);
+				}
+			});
+		}
+		return centers;
+	}
+
+	std::vector<PaletteColor> kmeans(std::vector<Cell>& cells, const PaletteParams& params)
+	{
+		parallel_for(cells.size(), 1024, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				rgb_to_lab(cells[i].rgb, cells[i].lab, params.Params);
+		});
+		auto centers = seed_centers(cells, params.Colors, params.Seed);
+		const size_t k = centers.size();
+		const size_t blocks = std::min(AssignBlocks, cells.size());
+		// per block: weighted Lab sums and count of every center
+		std::vector<double> sums(blocks * k * 4);
+		std::vector<size_t> moved(blocks);
+		std::vector<size_t> labels(cells.size(), k);
+		std::vector<double> totals(k * 4);
+		for (int iteration = 0; ; ++iteration)
+		{
+			parallel_for(blocks, 1, [&](size_t begin, size_t end) {
+				for (size_t block = begin; block < end; ++block)
+				{
+					double* s = &sums[block * k * 4];
+					std::fill(s, s + k * 4, 0.);
+					moved[block] = 0;
+					for (size_t i = cells.size() * block / blocks; i < cells.size() * (block + 1) / blocks; ++i)
+					{
+						size_t best = 0;
+						double best_d = distance2(cells[i].lab, centers[0].data());
+						for (size_t j = 1; j < k; ++j)
+						{
+							double d = distance2(cells[i].lab, centers[j].data());
+							if (d < best_d)
+							{
+								best_d = d;
+								best = j;
+							}
+						}
+						moved[block] += labels[i] != best;
+						labels[i] = best;
+						for (int c = 0; c < 3; ++c)
+							s[best * 4 + c] += cells[i].lab[c] * cells[i].count;
+						s[best * 4 + 3] += cells[i].count;
+					}
+				}
+			});
+			std::fill(totals.begin(), totals.end(), 0.);
+			size_t changes = 0;
+			for (size_t block = 0; block < blocks; ++block)
+			{
+				for (size_t j = 0; j < k * 4; ++j)
+					totals[j] += sums[block * k * 4 + j];
+				changes += moved[block];
+			}
+			// empty clusters keep their centers
+			double shift = 0.;
+			for (size_t j = 0; j < k; ++j)
+				if (totals[j * 4 + 3] > 0.)
+				{
+					std::array<double, 3> center{{totals[j * 4] / totals[j * 4 + 3], totals[j * 4 + 1] / totals[j * 4 + 3],
+						totals[j * 4 + 2] / totals[j * 4 + 3]}};
+					shift = std::max(shift, distance2(center.data(), centers[j].data()));
+					centers[j] = center;
+				}
+			if (changes == 0 || std::sqrt(shift) <= params.Tolerance || iteration + 1 >= params.MaxIterations)
+				break;
+		}
+
+		std::vector<PaletteColor> palette;
+		for (size_t j = 0; j < k; ++j)
+			if (totals[j * 4 + 3] > 0.)
+			{
+				double rgb[3];
+				lab_to_rgb(centers[j].data(), rgb, params.Params);
+				palette.push_back(make_color(rgb, totals[j * 4 + 3]));
+			}
+		return palette;
+	}
+}
+
+/*!
+	\brief Get palette extraction parameters
+	\param[in] method - extraction method (see PaletteEnum)
+	\param[in] colors - maximum number of colors
+	\return parameters
+*/
+PaletteParams get_palette_params(PaletteEnum method, size_t colors)
+{
+	PaletteParams params;
+	params.Method = method;
+	params.Colors = colors;
+	params.HistogramBits = 5;
+	params.MaxIterations = 20;
+	params.Tolerance = 0.1;
+	params.Seed = 1;
+	params.Params = get_rgb_params();
+	return params;
+}
+
+/*!
+	\brief Extract the dominant colors of an image
+	\param[in] src - RGB pixels, 3 * count bytes
+	\param[in] count - number of pixels
+	\param[in] params - extraction parameters
+	\return colors ordered by population
+*/
+std::vector<PaletteColor> get_palette(const unsigned char* src, size_t count, const PaletteParams& params)
+{
+	COLORPP_STATS_SCOPE("get_palette", count);
+	std::vector<PaletteColor> palette;
+	if (count == 0 || params.Colors == 0)
+		return palette;
+	auto cells = get_cells(src, count, std::min(std::max(params.HistogramBits, 1), 6));
+	if (params.Method == PaletteEnum::MedianCut)
+		palette = median_cut(cells, params.Colors);
+	else
+		palette = kmeans(cells, params);
+	std::stable_sort(palette.begin(), palette.end(), [](const PaletteColor& a, const PaletteColor& b) {
+		return a.Population > b.Population;
+	});
+	return palette;
+}
+
+}
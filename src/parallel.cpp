@@ -0,0 +1,277 @@
+/*!
+\file parallel.cpp
+\brief This file contains the source code of the thread pool used by batch
+	kernels as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "parallel.h"
+#include "parallel_detail.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace colorpp
+{
+
+namespace
+{
+	thread_local bool InsideParallel = false;
+
+	// marks the thread as running parallel work until the scope is left, even by an exception
+	class InsideScope
+	{
+	public:
+		InsideScope() : inside_(InsideParallel)
+		{
+			InsideParallel = true;
+		}
+		~InsideScope()
+		{
+			InsideParallel = inside_;
+		}
+		InsideScope(const InsideScope&) = delete;
+		InsideScope& operator=(const InsideScope&) = delete;
+
+	private:
+		bool inside_;
+	};
+
+	/*
+		Persistent pool: workers sleep on a condition variable and wake up for
+		every parallel_for, then pull chunks from a shared atomic counter.
+		The first exception thrown by fn on any thread stops handing out chunks
+		and is rethrown on the caller once every thread has left fn.
+	*/
+	class ThreadPool
+	{
+	public:
+		ThreadPool()
+		{
+			start(std::max(1u, std::thread::hardware_concurrency()));
+		}
+		~ThreadPool()
+		{
+			stop();
+		}
+
+		unsigned size()
+		{
+			std::lock_guard<std::mutex> run_lock(run_mutex_);
+			return static_cast<unsigned>(workers_.size()) + 1;
+		}
+
+		void resize(unsigned count)
+		{
+			if (count == 0)
+				count = std::max(1u, std::thread::hardware_concurrency());
+			std::lock_guard<std::mutex> run_lock(run_mutex_);
+			stop();
+			start(count);
+		}
+
+		void run(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn)
+		{
+			std::lock_guard<std::mutex> run_lock(run_mutex_);
+			auto threads = workers_.size() + 1;
+			// a few chunks per thread to even out the load
+			size_t chunk = std::max(grain, (count + threads * 4 - 1) / (threads * 4));
+			if (threads == 1 || chunk >= count)
+			{
+				run_serial(count, fn);
+				return;
+			}
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				fn_ = &fn;
+				count_ = count;
+				chunk_ = chunk;
+				next_ = 0;
+				active_ = static_cast<unsigned>(workers_.size());
+				++generation_;
+			}
+			cv_.notify_all();
+			{
+				InsideScope inside;
+				work();
+			}
+			std::exception_ptr error;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				done_cv_.wait(lock, [this] { return active_ == 0; });
+				fn_ = nullptr;
+				std::swap(error, error_);
+			}
+			if (error)
+				std::rethrow_exception(error);
+		}
+
+		static void run_serial(size_t count, const std::function<void(size_t, size_t)>& fn)
+		{
+			InsideScope inside;
+			fn(0, count);
+		}
+
+	private:
+		void start(unsigned count)
+		{
+			stop_ = false;
+			for (unsigned i = 1; i < count; ++i)
+				workers_.emplace_back([this] { loop(); });
+		}
+
+		void stop()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				stop_ = true;
+			}
+			cv_.notify_all();
+			for (auto& worker : workers_)
+				worker.join();
+			workers_.clear();
+		}
+
+		void work()
+		{
+			for (;;)
+			{
+				auto begin = next_.fetch_add(chunk_);
+				if (begin >= count_)
+					break;
+				try
+				{
+					(*fn_)(begin, std::min(begin + chunk_, count_));
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					if (!error_)
+						error_ = std::current_exception();
+					next_ = count_;
+					break;
+				}
+			}
+		}
+
+		void loop()
+		{
+			InsideParallel = true;
+			size_t generation = 0;
+			for (;;)
+			{
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					cv_.wait(lock, [&] { return stop_ || generation_ != generation; });
+					if (stop_)
+						return;
+					generation = generation_;
+				}
+				work();
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					--active_;
+				}
+				done_cv_.notify_one();
+			}
+		}
+
+		std::vector<std::thread> workers_;
+		std::mutex run_mutex_;	// one parallel_for at a time
+		std::mutex mutex_;
+		std::condition_variable cv_;
+		std::condition_variable done_cv_;
+		const std::function<void(size_t, size_t)>* fn_{nullptr};
+		std::exception_ptr error_;	// first exception of fn, guarded by mutex_
+		std::atomic<size_t> next_{0};
+		size_t count_{0};
+		size_t chunk_{1};
+		size_t generation_{0};
+		unsigned active_{0};
+		bool stop_{false};
+	};
+
+	ThreadPool& get_pool()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+}
+
+namespace detail
+{
+
+bool set_inside_parallel(bool inside)
+{
+	auto result = InsideParallel;
+	InsideParallel = inside;
+	return result;
+}
+
+}
+
+/*!
+	\brief Set the number of threads used by the batch kernels
+	\param[in] count - number of threads including the calling one (0 - hardware concurrency)
+*/
+void set_thread_count(unsigned count)
+{
+	get_pool().resize(count);
+}
+
+/*!
+	\brief Get the number of threads used by the batch kernels
+	\return number of threads including the calling one
+*/
+unsigned get_thread_count()
+{
+	return get_pool().size();
+}
+
+/*!
+	\brief Run fn over [0, count) split into chunks on the library threads
+	\param[in] count - number of items
+	\param[in] grain - minimal number of items in a chunk
+	\param[in] fn - chunk function, called as fn(begin, end)
+*/
+void parallel_for(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn)
+{
+	if (count == 0)
+		return;
+	if (InsideParallel)
+		ThreadPool::run_serial(count, fn);
+	else
+		get_pool().run(count, grain, fn);
+}
+
+}
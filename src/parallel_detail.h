@@ -0,0 +1,25 @@
+/*!
+\file parallel_detail.h
+\brief Thread pool internals shared with the job scheduler
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+namespace colorpp
+{
+
+namespace detail
+{
+
+/*!
+	\brief Mark the current thread as a worker, so parallel_for runs serially on it
+	\param[in] inside - true for a worker thread
+	\return previous state
+*/
+bool set_inside_parallel(bool inside);
+
+}
+
+}
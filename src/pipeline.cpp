@@ -0,0 +1,235 @@
+/*!
+\file pipeline.cpp
+\brief Cache-blocked multi-stage conversions
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "pipeline.h"
+#include "parallel.h"
+#include "stats.h"
+#include "transfer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace colorpp
+{
+
+namespace
+{
+	// used if the system doesn't report the L2 size
+	const size_t DefaultL2 = 512 << 10;
+	const size_t MinStrip = 1024;
+
+	struct Matrix
+	{
+		float m[3][3];
+	};
+
+	// a * b in the row vector convention of the library
+	Matrix multiply(const Mtx3x3 a, const Mtx3x3 b)
+	{
+		Matrix result;
+		for (int i = 0; i < 3; ++i)
+			for (int j = 0; j < 3; ++j)
+				result.m[i][j] = static_cast<float>(a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j]);
+		return result;
+	}
+
+	void transform(const float* src, float* dst, size_t count, const Matrix& matrix)
+	{
+		auto& m = matrix.m;
+		const float m00 = m[0][0], m01 = m[0][1], m02 = m[0][2];
+		const float m10 = m[1][0], m11 = m[1][1], m12 = m[1][2];
+		const float m20 = m[2][0], m21 = m[2][1], m22 = m[2][2];
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto x = src[3 * i];
+			auto y = src[3 * i + 1];
+			auto z = src[3 * i + 2];
+			dst[3 * i] = x * m00 + y * m10 + z * m20;
+			dst[3 * i + 1] = x * m01 + y * m11 + z * m21;
+			dst[3 * i + 2] = x * m02 + y * m12 + z * m22;
+		}
+	}
+
+	size_t get_l2_size()
+	{
+#ifdef _SC_LEVEL2_CACHE_SIZE
+		auto size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+		if (size > 0)
+			return static_cast<size_t>(size);
+#endif
+		return DefaultL2;
+	}
+}
+
+/*!
+	\brief Get the strip size tuned to the cache
+	\return number of pixels
+*/
+size_t get_strip_pixels()
+{
+	static const size_t pixels = std::max(get_l2_size() / 2 / (3 * sizeof(float)) / 64 * 64, MinStrip);
+	return pixels;
+}
+
+/*!
+	\brief Stage converting encoded RGB to XYZ
+	\param[in] params - RGB ColorSpace parameters
+	\return stage
+*/
+PipelineStage get_rgb_to_xyz_stage(const RgbParams& params)
+{
+	Mtx3x3 adaptation;
+	get_adaptation_matrix(params, adaptation);
+	auto matrix = multiply(params.MtxRGB2XYZ, adaptation);
+	auto transfer = get_transfer(params);
+	auto gamma = params.GammaRGB;
+	return [matrix, transfer, gamma](const float* src, float* dst, size_t count) {
+		inv_compand(src, dst, 3 * count, transfer, gamma);
+		transform(dst, dst, count, matrix);
+	};
+}
+
+/*!
+	\brief Stage converting XYZ to encoded RGB
+	\param[in] params - RGB ColorSpace parameters
+	\return stage
+*/
+PipelineStage get_xyz_to_rgb_stage(const RgbParams& params)
+{
+	Mtx3x3 adaptation;
+	get_inv_adaptation_matrix(params, adaptation);
+	auto matrix = multiply(adaptation, params.MtxXYZ2RGB);
+	auto transfer = get_transfer(params);
+	auto gamma = params.GammaRGB;
+	return [matrix, transfer, gamma](const float* src, float* dst, size_t count) {
+		transform(src, dst, count, matrix);
+		compand(dst, dst, 3 * count, transfer, gamma);
+	};
+}
+
+/*!
+	\brief Stage converting XYZ to CIE L*a*b*
+	\param[in] white - reference white
+	\return stage, L* in 0..100 range
+*/
+PipelineStage get_xyz_to_lab_stage(const XYZ white)
+{
+	std::array<double, 3> w = {{white[0], white[1], white[2]}};
+	return [w](const float* src, float* dst, size_t count) {
+		for (size_t i = 0; i < count; ++i)
+		{
+			double l, a, b;
+			xyz_to_lab(src[3 * i], src[3 * i + 1], src[3 * i + 2], l, a, b, w.data());
+			dst[3 * i] = static_cast<float>(l);
+			dst[3 * i + 1] = static_cast<float>(a);
+			dst[3 * i + 2] = static_cast<float>(b);
+		}
+	};
+}
+
+/*!
+	\brief Stage converting CIE L*a*b* to XYZ
+	\param[in] white - reference white
+	\return stage
+*/
+PipelineStage get_lab_to_xyz_stage(const XYZ white)
+{
+	std::array<double, 3> w = {{white[0], white[1], white[2]}};
+	return [w](const float* src, float* dst, size_t count) {
+		for (size_t i = 0; i < count; ++i)
+		{
+			double x, y, z;
+			lab_to_xyz(src[3 * i], src[3 * i + 1], src[3 * i + 2], x, y, z, w.data());
+			dst[3 * i] = static_cast<float>(x);
+			dst[3 * i + 1] = static_cast<float>(y);
+			dst[3 * i + 2] = static_cast<float>(z);
+		}
+	};
+}
+
+/*!
+	\brief Stage adjusting RGB (see adjust)
+	\param[in] params - adjustment parameters
+	\return stage
+*/
+PipelineStage get_adjust_stage(const AdjustParams& params)
+{
+	return [params](const float* src, float* dst, size_t count) {
+		adjust(src, dst, count, params);
+	};
+}
+
+/*!
+	\brief Run the stages of a pipeline strip by strip
+	\param[in] pipeline - stages and strip size
+	\param[in] src - source pixels, 3 * count floats
+	\param[out] dst - converted pixels, 3 * count floats (may alias src)
+	\param[in] count - number of pixels
+*/
+void run_pipeline(const Pipeline& pipeline, const float* src, float* dst, size_t count)
+{
+	COLORPP_STATS_SCOPE("run_pipeline", count);
+	if (pipeline.Stages.empty())
+	{
+		if (src != dst)
+			std::copy(src, src + 3 * count, dst);
+		return;
+	}
+	auto strip = pipeline.StripPixels ? pipeline.StripPixels : get_strip_pixels();
+	auto run_strip = [&](size_t first, size_t n) {
+		auto in = src + 3 * first;
+		auto out = dst + 3 * first;
+		for (const auto& stage : pipeline.Stages)
+		{
+			stage(in, out, n);
+			in = out;
+		}
+	};
+	// a single strip runs stage by stage, each stage on all the threads
+	if (strip >= count)
+	{
+		run_strip(0, count);
+		return;
+	}
+	parallel_for((count + strip - 1) / strip, 1, [&](size_t begin, size_t end) {
+		for (size_t s = begin; s < end; ++s)
+			run_strip(s * strip, std::min(strip, count - s * strip));
+	});
+}
+
+}
@@ -0,0 +1,403 @@
+/*!
+\file planar.cpp
+\brief This file contains the source code of chroma subsampled planar YCbCr
+	conversion as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "planar.h"
+#include "arena.h"
+#include "parallel.h"
+#include "ycbcr_fix.h"
+#include "stats.h"
+#include <algorithm>
+
+namespace colorpp
+{
+
+namespace
+{
+	using detail::FixCoefs;
+	using detail::FixShift;
+
+	// rows per parallel chunk
+	const size_t RowGrain = 8;
+
+	struct Layout
+	{
+		size_t sub_y;		// vertical chroma subsampling
+		bool interleaved;	// CbCr in one plane
+		size_t sample_size;	// bytes per sample
+		int shift;			// sample bits position in the word
+		int bit_depth;
+	};
+
+	Layout get_layout(PlanarEnum format)
+	{
+		switch (format)
+		{
+		case PlanarEnum::NV12:
+			return {2, true, 1, 0, 8};
+		case PlanarEnum::P010:
+			return {2, true, 2, 6, 10};
+		case PlanarEnum::I422:
+			return {1, false, 1, 0, 8};
+		default:
+		case PlanarEnum::I420:
+			return {2, false, 1, 0, 8};
+		}
+	}
+
+	template<typename T>
+	const T* row_at(const unsigned char* plane, size_t stride, size_t row)
+	{
+		return reinterpret_cast<const T*>(plane + stride * row);
+	}
+
+	template<typename T>
+	T* row_at(unsigned char* plane, size_t stride, size_t row)
+	{
+		return reinterpret_cast<T*>(plane + stride * row);
+	}
+
+	/*
+		Luma row plus 8x scaled full resolution chroma rows into RGB.
+		Straight-line int32 code over contiguous arrays, so it vectorizes.
+	*/
+	template<typename Ts, typename Td>
+	void ycbcr_row_to_rgb(const Ts* y_row, const int32_t* cb, const int32_t* cr,
+		Td* rgb, size_t width, int shift, const FixCoefs& c)
+	{
+		const int32_t m00 = c.m[0][0], m01 = c.m[0][1], m02 = c.m[0][2];
+		const int32_t m10 = c.m[1][0], m11 = c.m[1][1], m12 = c.m[1][2];
+		const int32_t m20 = c.m[2][0], m21 = c.m[2][1], m22 = c.m[2][2];
+		const int32_t a0 = c.add[0] << 3, a1 = c.add[1] << 3, a2 = c.add[2] << 3;
+		const int32_t o0 = c.off[0], o1 = c.off[1] << 3, o2 = c.off[2] << 3;
+		const int32_t max_value = c.max_value;
+		for (size_t x = 0; x < width; ++x)
+		{
+			int32_t s0 = ((static_cast<int32_t>(y_row[x]) >> shift) - o0) << 3;
+			int32_t s1 = cb[x] - o1;
+			int32_t s2 = cr[x] - o2;
+			int32_t d0 = (m00 * s0 + m01 * s1 + m02 * s2 + a0) >> (FixShift + 3);
+			int32_t d1 = (m10 * s0 + m11 * s1 + m12 * s2 + a1) >> (FixShift + 3);
+			int32_t d2 = (m20 * s0 + m21 * s1 + m22 * s2 + a2) >> (FixShift + 3);
+			rgb[3 * x] = static_cast<Td>(std::min(std::max(d0, 0), max_value));
+			rgb[3 * x + 1] = static_cast<Td>(std::min(std::max(d1, 0), max_value));
+			rgb[3 * x + 2] = static_cast<Td>(std::min(std::max(d2, 0), max_value));
+		}
+	}
+
+	template<typename Ts, typename Td>
+	void planar_rows_to_rgb(const PlanarFrame& frame, const Layout& layout, Td* rgb, size_t rgb_stride,
+		const FixCoefs& c, size_t row_begin, size_t row_end)
+	{
+		auto width = frame.Width;
+		if (width == 0)
+			return;
+		auto chroma_width = (width + 1) / 2;
+		auto chroma_height = (frame.Height + layout.sub_y - 1) / layout.sub_y;
+		// 4x scaled vertically filtered chroma with one guard sample
+		ArenaBuffer<int32_t> vcb(chroma_width + 1);
+		ArenaBuffer<int32_t> vcr(chroma_width + 1);
+		// 8x scaled full resolution chroma
+		ArenaBuffer<int32_t> cb(width + 1);
+		ArenaBuffer<int32_t> cr(width + 1);
+		auto shift = layout.shift;
+		for (size_t y = row_begin; y < row_end; ++y)
+		{
+			// vertical: 3/4 nearest + 1/4 next nearest chroma row (just the row for 4:2:2)
+			size_t cy0 = y / layout.sub_y;
+			size_t cy1 = cy0;
+			if (layout.sub_y == 2)
+				cy1 = (y & 1) ? std::min(cy0 + 1, chroma_height - 1) : (cy0 > 0 ? cy0 - 1 : 0);
+			if (layout.interleaved)
+			{
+				auto r0 = row_at<Ts>(frame.Planes[1], frame.Strides[1], cy0);
+				auto r1 = row_at<Ts>(frame.Planes[1], frame.Strides[1], cy1);
+				for (size_t i = 0; i < chroma_width; ++i)
+				{
+					vcb[i] = 3 * (r0[2 * i] >> shift) + (r1[2 * i] >> shift);
+					vcr[i] = 3 * (r0[2 * i + 1] >> shift) + (r1[2 * i + 1] >> shift);
+				}
+			}
+			else
+			{
+				auto b0 = row_at<Ts>(frame.Planes[1], frame.Strides[1], cy0);
+				auto b1 = row_at<Ts>(frame.Planes[1], frame.Strides[1], cy1);
+				auto r0 = row_at<Ts>(frame.Planes[2], frame.Strides[2], cy0);
+				auto r1 = row_at<Ts>(frame.Planes[2], frame.Strides[2], cy1);
+				for (size_t i = 0; i < chroma_width; ++i)
+				{
+					vcb[i] = 3 * (b0[i] >> shift) + (b1[i] >> shift);
+					vcr[i] = 3 * (r0[i] >> shift) + (r1[i] >> shift);
+				}
+			}
+			vcb[chroma_width] = vcb[chroma_width - 1];
+			vcr[chroma_width] = vcr[chroma_width - 1];
+
+			// horizontal: co-sited on even columns, averaged on odd ones
+			for (size_t i = 0; i < chroma_width; ++i)
+			{
+				cb[2 * i] = 2 * vcb[i];
+				cb[2 * i + 1] = vcb[i] + vcb[i + 1];
+				cr[2 * i] = 2 * vcr[i];
+				cr[2 * i + 1] = vcr[i] + vcr[i + 1];
+			}
+
+			ycbcr_row_to_rgb(row_at<Ts>(frame.Planes[0], frame.Strides[0], y), cb.data(), cr.data(),
+				reinterpret_cast<Td*>(reinterpret_cast<unsigned char*>(rgb) + rgb_stride * y),
+				width, shift, c);
+		}
+	}
+
+	template<typename Ts, typename Td>
+	void rgb_row_to_luma(const Ts* src, Td* dst, size_t width, int shift, const FixCoefs& c)
+	{
+		const int32_t m00 = c.m[0][0], m01 = c.m[0][1], m02 = c.m[0][2];
+		const int32_t a0 = c.add[0];
+		const int32_t max_value = c.max_value;
+		for (size_t x = 0; x < width; ++x)
+		{
+			int32_t s0 = src[3 * x];
+			int32_t s1 = src[3 * x + 1];
+			int32_t s2 = src[3 * x + 2];
+			int32_t d0 = (m00 * s0 + m01 * s1 + m02 * s2 + a0) >> FixShift;
+			dst[x] = static_cast<Td>(std::min(std::max(d0, 0), max_value) << shift);
+		}
+	}
+
+	/*
+		Chroma sited like planar_rows_to_rgb expects it (MPEG-2): the two rows are
+		averaged vertically, columns are filtered with [1 2 1] around the even column
+		2i, the edge pixels repeated. Scaled 8x before the matrix.
+	*/
+	template<size_t step, typename Ts, typename Td>
+	void rgb_rows_to_chroma(const Ts* src0, const Ts* src1, Td* cb, Td* cr, size_t width,
+		int shift, const FixCoefs& c)
+	{
+		const int32_t m10 = c.m[1][0], m11 = c.m[1][1], m12 = c.m[1][2];
+		const int32_t m20 = c.m[2][0], m21 = c.m[2][1], m22 = c.m[2][2];
+		const int32_t a1 = c.add[1] << 3, a2 = c.add[2] << 3;
+		const int32_t max_value = c.max_value;
+		auto chroma = [&](size_t i, size_t left, size_t right) {
+			const size_t l = 3 * left, m = 6 * i, r = 3 * right;
+			int32_t s0 = src0[l] + 2 * src0[m] + src0[r] + src1[l] + 2 * src1[m] + src1[r];
+			int32_t s1 = src0[l + 1] + 2 * src0[m + 1] + src0[r + 1] + src1[l + 1] + 2 * src1[m + 1] + src1[r + 1];
+			int32_t s2 = src0[l + 2] + 2 * src0[m + 2] + src0[r + 2] + src1[l + 2] + 2 * src1[m + 2] + src1[r + 2];
+			int32_t d1 = (m10 * s0 + m11 * s1 + m12 * s2 + a1) >> (FixShift + 3);
+			int32_t d2 = (m20 * s0 + m21 * s1 + m22 * s2 + a2) >> (FixShift + 3);
+			cb[step * i] = static_cast<Td>(std::min(std::max(d1, 0), max_value) << shift);
+			cr[step * i] = static_cast<Td>(std::min(std::max(d2, 0), max_value) << shift);
+		};
+		chroma(0, 0, std::min<size_t>(1, width - 1));
+		// inner columns have both neighbours
+		const size_t inner = width / 2;
+		for (size_t i = 1; i < inner; ++i)
+			chroma(i, 2 * i - 1, 2 * i + 1);
+		if ((width & 1) && width > 1)
+			chroma(inner, width - 2, width - 1);
+	}
+
+	template<typename Ts, typename Td>
+	void rgb_rows_to_planar(const Ts* rgb, size_t rgb_stride, const PlanarFrame& frame, const Layout& layout,
+		const FixCoefs& c, size_t chroma_begin, size_t chroma_end)
+	{
+		auto width = frame.Width;
+		if (width == 0)
+			return;
+		auto shift = layout.shift;
+		auto rgb_row = [&](size_t y) {
+			return reinterpret_cast<const Ts*>(reinterpret_cast<const unsigned char*>(rgb) + rgb_stride * y);
+		};
+		for (size_t cy = chroma_begin; cy < chroma_end; ++cy)
+		{
+			size_t y0 = cy * layout.sub_y;
+			size_t y1 = std::min(y0 + layout.sub_y - 1, frame.Height - 1);
+
+			// luma of the one or two rows covered by this chroma row
+			for (size_t y = y0; y <= y1; ++y)
+				rgb_row_to_luma(rgb_row(y), row_at<Td>(frame.Planes[0], frame.Strides[0], y), width, shift, c);
+
+			auto src0 = rgb_row(y0);
+			auto src1 = rgb_row(y1);
+			Td* cb = row_at<Td>(frame.Planes[1], frame.Strides[1], cy);
+			if (layout.interleaved)
+				rgb_rows_to_chroma<2>(src0, src1, cb, cb + 1, width, shift, c);
+			else
+				rgb_rows_to_chroma<1>(src0, src1, cb, row_at<Td>(frame.Planes[2], frame.Strides[2], cy), width, shift, c);
+		}
+	}
+}
+
+/*!
+	\brief Get the size of a tightly packed planar frame
+	\param[in] format - planar format (see PlanarEnum)
+	\param[in] width - frame width in pixels
+	\param[in] height - frame height in pixels
+	\return size in bytes
+*/
+size_t get_planar_size(PlanarEnum format, size_t width, size_t height)
+{
+	auto layout = get_layout(format);
+	auto chroma_width = (width + 1) / 2;
+	auto chroma_height = (height + layout.sub_y - 1) / layout.sub_y;
+	return (width * height + 2 * chroma_width * chroma_height) * layout.sample_size;
+}
+
+/*!
+	\brief Describe a tightly packed planar frame placed in a single buffer
+	\param[in] format - planar format (see PlanarEnum)
+	\param[in] width - frame width in pixels
+	\param[in] height - frame height in pixels
+	\param[in] data - buffer of get_planar_size(format, width, height) bytes
+	\return frame description
+*/
+PlanarFrame get_planar_frame(PlanarEnum format, size_t width, size_t height, unsigned char* data)
+{
+	auto layout = get_layout(format);
+	auto chroma_width = (width + 1) / 2;
+	auto chroma_height = (height + layout.sub_y - 1) / layout.sub_y;
+	PlanarFrame frame;
+	frame.Format = format;
+	frame.Width = width;
+	frame.Height = height;
+	frame.Planes[0] = data;
+	frame.Strides[0] = width * layout.sample_size;
+	frame.Planes[1] = data + frame.Strides[0] * height;
+	if (layout.interleaved)
+	{
+		frame.Strides[1] = 2 * chroma_width * layout.sample_size;
+		frame.Planes[2] = nullptr;
+		frame.Strides[2] = 0;
+	}
+	else
+	{
+		frame.Strides[1] = chroma_width * layout.sample_size;
+		frame.Planes[2] = frame.Planes[1] + frame.Strides[1] * chroma_height;
+		frame.Strides[2] = frame.Strides[1];
+	}
+	return frame;
+}
+
+/*!
+    \brief Conversion from an 8-bit planar frame to interleaved 8-bit RGB
+    \param[in] frame - source frame (I420, NV12 or I422)
+    \param[out] rgb - destination pixels
+    \param[in] rgb_stride - destination row stride in bytes
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the source (see RangeEnum)
+	\return false if the frame format does not match the sample type
+*/
+bool planar_to_rgb(const PlanarFrame& frame, unsigned char* rgb, size_t rgb_stride,
+	YCbCrEnum matrix, RangeEnum range)
+{
+	COLORPP_STATS_SCOPE("planar_to_rgb/8", frame.Width * frame.Height);
+	auto layout = get_layout(frame.Format);
+	if (layout.sample_size != 1)
+		return false;
+	auto& c = detail::get_fix_coefs(true, matrix, range, layout.bit_depth);
+	parallel_for(frame.Height, RowGrain, [&](size_t begin, size_t end) {
+		planar_rows_to_rgb<unsigned char>(frame, layout, rgb, rgb_stride, c, begin, end);
+	});
+	return true;
+}
+
+/*!
+    \brief Conversion from a P010 frame to interleaved 10-bit RGB
+    \param[in] frame - source frame (P010)
+    \param[out] rgb - destination pixels in 0..1023
+    \param[in] rgb_stride - destination row stride in bytes
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the source (see RangeEnum)
+	\return false if the frame format does not match the sample type
+*/
+bool planar_to_rgb(const PlanarFrame& frame, unsigned short* rgb, size_t rgb_stride,
+	YCbCrEnum matrix, RangeEnum range)
+{
+	COLORPP_STATS_SCOPE("planar_to_rgb/16", frame.Width * frame.Height);
+	auto layout = get_layout(frame.Format);
+	if (layout.sample_size != 2)
+		return false;
+	auto& c = detail::get_fix_coefs(true, matrix, range, layout.bit_depth);
+	parallel_for(frame.Height, RowGrain, [&](size_t begin, size_t end) {
+		planar_rows_to_rgb<unsigned short>(frame, layout, rgb, rgb_stride, c, begin, end);
+	});
+	return true;
+}
+
+/*!
+    \brief Conversion from interleaved 8-bit RGB to an 8-bit planar frame
+    \param[in] rgb - source pixels
+    \param[in] rgb_stride - source row stride in bytes
+    \param[out] frame - destination frame (I420, NV12 or I422)
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the destination (see RangeEnum)
+	\return false if the frame format does not match the sample type
+*/
+bool rgb_to_planar(const unsigned char* rgb, size_t rgb_stride, const PlanarFrame& frame,
+	YCbCrEnum matrix, RangeEnum range)
+{
+	COLORPP_STATS_SCOPE("rgb_to_planar/8", frame.Width * frame.Height);
+	auto layout = get_layout(frame.Format);
+	if (layout.sample_size != 1)
+		return false;
+	auto& c = detail::get_fix_coefs(false, matrix, range, layout.bit_depth);
+	auto chroma_height = (frame.Height + layout.sub_y - 1) / layout.sub_y;
+	parallel_for(chroma_height, RowGrain, [&](size_t begin, size_t end) {
+		rgb_rows_to_planar<unsigned char, unsigned char>(rgb, rgb_stride, frame, layout, c, begin, end);
+	});
+	return true;
+}
+
+/*!
+    \brief Conversion from interleaved 10-bit RGB to a P010 frame
+    \param[in] rgb - source pixels in 0..1023
+    \param[in] rgb_stride - source row stride in bytes
+    \param[out] frame - destination frame (P010)
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the destination (see RangeEnum)
+	\return false if the frame format does not match the sample type
+*/
+bool rgb_to_planar(const unsigned short* rgb, size_t rgb_stride, const PlanarFrame& frame,
+	YCbCrEnum matrix, RangeEnum range)
+{
+	COLORPP_STATS_SCOPE("rgb_to_planar/16", frame.Width * frame.Height);
+	auto layout = get_layout(frame.Format);
+	if (layout.sample_size != 2)
+		return false;
+	auto& c = detail::get_fix_coefs(false, matrix, range, layout.bit_depth);
+	auto chroma_height = (frame.Height + layout.sub_y - 1) / layout.sub_y;
+	parallel_for(chroma_height, RowGrain, [&](size_t begin, size_t end) {
+		rgb_rows_to_planar<unsigned short, unsigned short>(rgb, rgb_stride, frame, layout, c, begin, end);
+	});
+	return true;
+}
+
+}
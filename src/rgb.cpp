@@ -32,6 +32,8 @@ THE SOFTWARE.
 */
 
 #include "rgb.h"
+#include "stats.h"
+#include <algorithm>
 #include <cmath>
 
 namespace colorpp 
@@ -39,7 +41,7 @@ namespace colorpp
 
 // brucelindblum.com CIE Color Calculator C++ porting
 
-const Mtx3x3 Adaptations[3][2] = {
+const Mtx3x3 Adaptations[6][2] = {
 		{
 			{{0.8951, -0.7502, 0.0389}, {0.2664, 1.7135, -0.0685}, {-0.1614, 0.0367, 1.0296}},
 			{{0.9869929, 0.4323053, -0.0085287}, {-0.1470543, 0.5183603, 0.0400428}, {0.1599627, 0.0492912, 0.9684867}}
@@ -51,78 +53,34 @@ const Mtx3x3 Adaptations[3][2] = {
 		{
 			{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}},
 			{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}},
-		}
-};
-
-static double Compand(double linear, const double gamma)
-{
-	double companded;
-	if (gamma > 0.0)
-	{
-		companded = (linear >= 0.0) ? std::pow(linear, 1.0 / gamma) : -std::pow(-linear, 1.0 / gamma);
-	}
-	else if (gamma < 0.0)
-	{
-		/* sRGB */
-		double sign = 1.0;
-		if (linear < 0.0)
-		{
-			sign = -1.0;
-			linear = -linear;
-		}
-		companded = (linear <= 0.0031308) ? (linear * 12.92) : (1.055 * std::pow(linear, 1.0 / 2.4) - 0.055);
-		companded *= sign;
-	}
-	else
-	{
-		/* L* */
-		double sign = 1.0;
-		if (linear < 0.0)
+		},
 		{
-			sign = -1.0;
-			linear = -linear;
-		}
-		companded = (linear <= (216.0 / 24389.0)) ? (linear * 24389.0 / 2700.0) : (1.16 * std::pow(linear, 1.0 / 3.0) - 0.16);
-		companded *= sign;
-	}
-	return companded;
-}
-
-static double InvCompand(double companded, const double gamma)
-{
-	double linear;
-	if (gamma > 0.0)
-	{
-		linear = (companded >= 0.0) ? std::pow(companded, gamma) : -std::pow(-companded, gamma);
-	}
-	else if (gamma < 0.0)
-	{
-		/* sRGB */
-		double sign = 1.0;
-		if (companded < 0.0)
+			{{0.7328, -0.7036, 0.0030}, {0.4296, 1.6975, 0.0136}, {-0.1624, 0.0061, 0.9834}},
+			{{1.0961238, 0.4543690, -0.0096276}, {-0.2788690, 0.4735332, -0.0056980}, {0.1827452, 0.0720978, 1.0153256}}
+		},
 		{
-			sign = -1.0;
-			companded = -companded;
-		}
-		linear = (companded <= 0.04045) ? (companded / 12.92) : std::pow((companded + 0.055) / 1.055, 2.4);
-		linear *= sign;
-	}
-	else
-	{
-		/* L* */
-		double sign = 1.0;
-		if (companded < 0.0)
+			{{0.401288, -0.250268, -0.002079}, {0.650173, 1.204414, 0.048952}, {-0.051461, 0.045854, 0.953127}},
+			{{1.8620679, 0.3875265, -0.0158415}, {-1.0112546, 0.6214474, -0.0341229}, {0.1491868, -0.0089740, 1.0499644}}
+		},
 		{
-			sign = -1.0;
-			companded = -companded;
+			{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}},
+			{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}},
 		}
-		linear = (companded <= 0.08) ? (2700.0 * companded / 24389.0) : ((((1000000.0 * companded + 480000.0) * companded + 76800.0) * companded + 4096.0) / 1560896.0);
-		linear *= sign;
-	}
-	return linear;
-}
+};
 
-static double Determinant3x3(Mtx3x3 m)
+// SMPTE ST 2084 constants
+const double PqM1 = 2610.0 / 16384.0;
+const double PqM2 = 2523.0 / 4096.0 * 128.0;
+const double PqC1 = 3424.0 / 4096.0;
+const double PqC2 = 2413.0 / 4096.0 * 32.0;
+const double PqC3 = 2392.0 / 4096.0 * 32.0;
+
+// ARIB STD-B67 constants
+const double HlgA = 0.17883277;
+const double HlgB = 1.0 - 4.0 * HlgA;
+const double HlgC = 0.5 - HlgA * std::log(4.0 * HlgA);
+
+static double Determinant3x3(const Mtx3x3 m)
 {
 	double det = m[0][0] * (m[2][2] * m[1][1] - m[2][1] * m[1][2]) -
 		m[1][0] * (m[2][2] * m[0][1] - m[2][1] * m[0][2]) +
@@ -131,7 +89,12 @@ static double Determinant3x3(Mtx3x3 m)
 	return det;
 }
 
-static void MtxInvert3x3(Mtx3x3 m, Mtx3x3 i)
+/*!
+	\brief Invert a 3x3 matrix
+	\param[in] m - matrix, not singular
+	\param[out] i - inverse matrix
+*/
+void invert_matrix(const Mtx3x3 m, Mtx3x3 i)
 {
 	double scale = 1.0 / Determinant3x3(m);
 
@@ -148,6 +111,21 @@ static void MtxInvert3x3(Mtx3x3 m, Mtx3x3 i)
 	i[2][2] = scale * (m[1][1] * m[0][0] - m[1][0] * m[0][1]);
 }
 
+// CIE constants
+const double LabEpsilon = 216.0 / 24389.0;
+const double LabKappa = 24389.0 / 27.0;
+
+static double LabF(double t)
+{
+	return t > LabEpsilon ? std::cbrt(t) : (LabKappa * t + 16.0) / 116.0;
+}
+
+static double LabFInv(double f)
+{
+	double t = f * f * f;
+	return t > LabEpsilon ? t : (116.0 * f - 16.0) / LabKappa;
+}
+
 static void MtxTranspose3x3(Mtx3x3 m)
 {
 	double v = m[0][1];
@@ -225,6 +203,7 @@ static void GetRefWhite(double* RefWhite, IlluminantEnum illuminant = Illuminant
 */
 RgbParams get_rgb_params(RgbEnum color_space, AdaptationEnum adaptation, IlluminantEnum illuminant)
 {
+	COLORPP_STATS_SCOPE("get_rgb_params", 0);
 	RgbParams result;
 	result.RefWhiteRGB[1] = 1.00000;
 	double xr, yr, xg, yg, xb, yb;
@@ -439,11 +418,33 @@ RgbParams get_rgb_params(RgbEnum color_space, AdaptationEnum adaptation, Illumin
 
 		result.GammaRGB = 2.2;
 		break;
+	case RgbEnum::Rec2020Rgb:	/* ITU-R BT.2020 */
+	case RgbEnum::Rec2100Pq:	/* ITU-R BT.2100 PQ */
+	case RgbEnum::Rec2100Hlg:	/* ITU-R BT.2100 HLG */
+		xr = 0.708;
+		yr = 0.292;
+		xg = 0.170;
+		yg = 0.797;
+		xb = 0.131;
+		yb = 0.046;
+
+		result.RefWhiteRGB[0] = 0.95047;
+		result.RefWhiteRGB[2] = 1.08883;
+
+		result.GammaRGB = 2.4;
+		break;
 	}
 
+	if (color_space == RgbEnum::Rec2100Pq)
+		result.TransferRGB = TransferEnum::PQ;
+	else if (color_space == RgbEnum::Rec2100Hlg)
+		result.TransferRGB = TransferEnum::HLG;
+	else
+		result.TransferRGB = get_transfer(result.GammaRGB);
+
 	Mtx3x3 m = { {xr / yr, xg / yg, xb / yb}, {1.0, 1.0, 1.0}, {(1.0 - xr - yr) / yr, (1.0 - xg - yg) / yg, (1.0 - xb - yb) / yb} };
 	Mtx3x3 mi = { {1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0} };
-	MtxInvert3x3(m, mi);
+	invert_matrix(m, mi);
 
 	double sr = result.RefWhiteRGB[0] * mi[0][0] + result.RefWhiteRGB[1] * mi[0][1] + result.RefWhiteRGB[2] * mi[0][2];
 	double sg = result.RefWhiteRGB[0] * mi[1][0] + result.RefWhiteRGB[1] * mi[1][1] + result.RefWhiteRGB[2] * mi[1][2];
@@ -461,16 +462,310 @@ RgbParams get_rgb_params(RgbEnum color_space, AdaptationEnum adaptation, Illumin
 
 	MtxTranspose3x3(result.MtxRGB2XYZ);
 
-	MtxInvert3x3(result.MtxRGB2XYZ, result.MtxXYZ2RGB);
+	invert_matrix(result.MtxRGB2XYZ, result.MtxXYZ2RGB);
 
 	// Adaptation
 	result.AdaptationMethod = adaptation;
 	
 	GetRefWhite(result.RefWhite, illuminant);
+	update_adaptation(result);
 
 	return result;
 }
 
+/*!
+	\brief Create parameters for RGB color space adapted to an arbitrary reference white
+	\param[in] color_space - Color space (see RgbEnum)
+	\param[in] adaptation - Chromatic adaptation method (see AdaptationEnum)
+	\param[in] white - XYZ of the reference white (e.g. from cct_to_white)
+	\return RGB ColorSpace parameters
+*/
+RgbParams get_rgb_params(RgbEnum color_space, AdaptationEnum adaptation, const XYZ& white)
+{
+	RgbParams result = get_rgb_params(color_space, adaptation);
+	set_ref_white(result, white);
+	return result;
+}
+
+/*!
+	\brief Change the reference white of existing parameters
+	\param[in,out] params - RGB ColorSpace parameters
+	\param[in] white - XYZ of the reference white
+*/
+void set_ref_white(RgbParams& params, const XYZ& white)
+{
+	params.RefWhite[0] = white[0];
+	params.RefWhite[1] = white[1];
+	params.RefWhite[2] = white[2];
+	update_adaptation(params);
+}
+
+/*!
+	\brief Recompute the adaptation matrices of parameters
+	\param[in,out] params - RGB ColorSpace parameters
+*/
+void update_adaptation(RgbParams& params)
+{
+	get_adaptation_matrix(params.AdaptationMethod, params.RefWhiteRGB, params.RefWhite, params.MtxAdaptation);
+	get_adaptation_matrix(params.AdaptationMethod, params.RefWhite, params.RefWhiteRGB, params.MtxInvAdaptation);
+	for (int i = 0; i < 3; ++i)
+	{
+		params.AdaptedWhiteRGB[i] = params.RefWhiteRGB[i];
+		params.AdaptedWhite[i] = params.RefWhite[i];
+	}
+	params.AdaptedMethod = params.AdaptationMethod;
+}
+
+// the adaptation fields were not edited since update_adaptation
+static bool IsAdaptationFresh(const RgbParams& params)
+{
+	return params.AdaptedMethod == params.AdaptationMethod &&
+		std::equal(params.RefWhiteRGB, params.RefWhiteRGB + 3, params.AdaptedWhiteRGB) &&
+		std::equal(params.RefWhite, params.RefWhite + 3, params.AdaptedWhite);
+}
+
+/*!
+	\brief Get the RefWhiteRGB to RefWhite adaptation matrix of parameters
+	\param[in] params - RGB ColorSpace parameters
+	\param[out] m - matrix in the library convention
+*/
+void get_adaptation_matrix(const RgbParams& params, Mtx3x3 m)
+{
+	if (IsAdaptationFresh(params))
+		std::copy(&params.MtxAdaptation[0][0], &params.MtxAdaptation[0][0] + 9, &m[0][0]);
+	else
+		get_adaptation_matrix(params.AdaptationMethod, params.RefWhiteRGB, params.RefWhite, m);
+}
+
+/*!
+	\brief Get the RefWhite to RefWhiteRGB adaptation matrix of parameters
+	\param[in] params - RGB ColorSpace parameters
+	\param[out] m - matrix in the library convention
+*/
+void get_inv_adaptation_matrix(const RgbParams& params, Mtx3x3 m)
+{
+	if (IsAdaptationFresh(params))
+		std::copy(&params.MtxInvAdaptation[0][0], &params.MtxInvAdaptation[0][0] + 9, &m[0][0]);
+	else
+		get_adaptation_matrix(params.AdaptationMethod, params.RefWhite, params.RefWhiteRGB, m);
+}
+
+/*!
+	\brief Get the combined chromatic adaptation matrix between two whites
+	\param[in] method - Chromatic adaptation method (see AdaptationEnum)
+	\param[in] src_white - XYZ of the source white
+	\param[in] dst_white - XYZ of the destination white
+	\param[out] m - matrix in the library convention (x' = x * m[0][0] + y * m[1][0] + z * m[2][0])
+*/
+void get_adaptation_matrix(AdaptationEnum method, const XYZ& src_white, const XYZ& dst_white, Mtx3x3 m)
+{
+	// the identity cone matrices of amNone would still scale by the whites
+	if (method == AdaptationEnum::amNone)
+	{
+		for (int i = 0; i < 3; ++i)
+			for (int j = 0; j < 3; ++j)
+				m[i][j] = i == j ? 1.0 : 0.0;
+		return;
+	}
+	auto& MtxAdaptMa = Adaptations[static_cast<size_t>(method)][0];
+	auto& MtxAdaptMaI = Adaptations[static_cast<size_t>(method)][1];
+	double scale[3];
+	for (int k = 0; k < 3; ++k)
+	{
+		auto s = src_white[0] * MtxAdaptMa[0][k] + src_white[1] * MtxAdaptMa[1][k] + src_white[2] * MtxAdaptMa[2][k];
+		auto d = dst_white[0] * MtxAdaptMa[0][k] + dst_white[1] * MtxAdaptMa[1][k] + dst_white[2] * MtxAdaptMa[2][k];
+		scale[k] = d / s;
+	}
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 3; ++j)
+			m[i][j] = MtxAdaptMa[i][0] * scale[0] * MtxAdaptMaI[0][j] +
+				MtxAdaptMa[i][1] * scale[1] * MtxAdaptMaI[1][j] +
+				MtxAdaptMa[i][2] * scale[2] * MtxAdaptMaI[2][j];
+}
+
+/*!
+    \brief Batch chromatic adaptation of interleaved XYZ
+    \param[in] src - source pixels, 3 * count floats
+    \param[out] dst - adapted pixels, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+	\param[in] src_white - XYZ of the source white
+	\param[in] dst_white - XYZ of the destination white
+	\param[in] method - Chromatic adaptation method (see AdaptationEnum)
+*/
+void adapt(const float* src, float* dst, size_t count, const XYZ& src_white, const XYZ& dst_white,
+	AdaptationEnum method)
+{
+	COLORPP_STATS_SCOPE("adapt", count);
+	Mtx3x3 m;
+	get_adaptation_matrix(method, src_white, dst_white, m);
+	const float m00 = static_cast<float>(m[0][0]), m01 = static_cast<float>(m[0][1]), m02 = static_cast<float>(m[0][2]);
+	const float m10 = static_cast<float>(m[1][0]), m11 = static_cast<float>(m[1][1]), m12 = static_cast<float>(m[1][2]);
+	const float m20 = static_cast<float>(m[2][0]), m21 = static_cast<float>(m[2][1]), m22 = static_cast<float>(m[2][2]);
+	for (size_t i = 0; i < count; ++i)
+	{
+		auto x = src[3 * i];
+		auto y = src[3 * i + 1];
+		auto z = src[3 * i + 2];
+		dst[3 * i] = x * m00 + y * m10 + z * m20;
+		dst[3 * i + 1] = x * m01 + y * m11 + z * m21;
+		dst[3 * i + 2] = x * m02 + y * m12 + z * m22;
+	}
+}
+
+/*!
+	\brief Get the reference white of an illuminant
+	\param[in] illuminant - Illuminant (see IlluminantEnum)
+	\param[out] white - XYZ of the reference white with Y = 1
+*/
+void get_ref_white(IlluminantEnum illuminant, XYZ white)
+{
+	GetRefWhite(white, illuminant);
+}
+
+/*!
+	\brief Get the transfer function of a legacy GammaRGB value
+	\param[in] gamma - gamma (> 0), sRGB (< 0) or L* (0)
+	\return transfer function (see TransferEnum)
+*/
+TransferEnum get_transfer(double gamma)
+{
+	if (gamma > 0.0)
+		return TransferEnum::Gamma;
+	return gamma < 0.0 ? TransferEnum::sRGB : TransferEnum::LStar;
+}
+
+/*!
+	\brief Get the transfer function of RGB parameters
+	\param[in] params - RGB ColorSpace parameters
+	\return transfer function (see TransferEnum)
+*/
+TransferEnum get_transfer(const RgbParams& params)
+{
+	if (params.TransferRGB == TransferEnum::PQ || params.TransferRGB == TransferEnum::HLG)
+		return params.TransferRGB;
+	return get_transfer(params.GammaRGB);
+}
+
+/*!
+	\brief Encode a linear value with a transfer function
+	\param[in] linear - linear value, negative values are mirrored
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] gamma - exponent of TransferEnum::Gamma
+	\return encoded value
+*/
+double compand(double linear, TransferEnum transfer, double gamma)
+{
+	double sign = 1.0;
+	if (linear < 0.0)
+	{
+		sign = -1.0;
+		linear = -linear;
+	}
+	double companded;
+	switch (transfer)
+	{
+	default:
+	case TransferEnum::Gamma:
+		companded = std::pow(linear, 1.0 / gamma);
+		break;
+	case TransferEnum::sRGB:
+		companded = (linear <= 0.0031308) ? (linear * 12.92) : (1.055 * std::pow(linear, 1.0 / 2.4) - 0.055);
+		break;
+	case TransferEnum::LStar:
+		companded = (linear <= (216.0 / 24389.0)) ? (linear * 24389.0 / 2700.0) : (1.16 * std::pow(linear, 1.0 / 3.0) - 0.16);
+		break;
+	case TransferEnum::PQ:
+	{
+		double lp = std::pow(linear, PqM1);
+		companded = std::pow((PqC1 + PqC2 * lp) / (1.0 + PqC3 * lp), PqM2);
+		break;
+	}
+	case TransferEnum::HLG:
+		companded = (linear <= 1.0 / 12.0) ? std::sqrt(3.0 * linear) : (HlgA * std::log(12.0 * linear - HlgB) + HlgC);
+		break;
+	}
+	return companded * sign;
+}
+
+/*!
+	\brief Decode an encoded value with a transfer function
+	\param[in] companded - encoded value, negative values are mirrored
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] gamma - exponent of TransferEnum::Gamma
+	\return linear value
+*/
+double inv_compand(double companded, TransferEnum transfer, double gamma)
+{
+	double sign = 1.0;
+	if (companded < 0.0)
+	{
+		sign = -1.0;
+		companded = -companded;
+	}
+	double linear;
+	switch (transfer)
+	{
+	default:
+	case TransferEnum::Gamma:
+		linear = std::pow(companded, gamma);
+		break;
+	case TransferEnum::sRGB:
+		linear = (companded <= 0.04045) ? (companded / 12.92) : std::pow((companded + 0.055) / 1.055, 2.4);
+		break;
+	case TransferEnum::LStar:
+		linear = (companded <= 0.08) ? (2700.0 * companded / 24389.0) : ((((1000000.0 * companded + 480000.0) * companded + 76800.0) * companded + 4096.0) / 1560896.0);
+		break;
+	case TransferEnum::PQ:
+	{
+		double ep = std::pow(companded, 1.0 / PqM2);
+		linear = std::pow(std::max(ep - PqC1, 0.0) / (PqC2 - PqC3 * ep), 1.0 / PqM1);
+		break;
+	}
+	case TransferEnum::HLG:
+		linear = (companded <= 0.5) ? (companded * companded / 3.0) : ((std::exp((companded - HlgC) / HlgA) + HlgB) / 12.0);
+		break;
+	}
+	return linear * sign;
+}
+
+/*!
+	\brief Conversion from XYZ to CIE L*a*b*
+	\param[in] x - x channel
+	\param[in] y - y channel
+	\param[in] z - z channel
+	\param[out] l - L* in 0..100 range
+	\param[out] a - a* channel
+	\param[out] b - b* channel
+	\param[in] white - XYZ of the reference white
+*/
+void xyz_to_lab(double x, double y, double z, double& l, double& a, double& b, const XYZ white)
+{
+	auto fx = LabF(x / white[0]);
+	auto fy = LabF(y / white[1]);
+	auto fz = LabF(z / white[2]);
+	l = 116.0 * fy - 16.0;
+	a = 500.0 * (fx - fy);
+	b = 200.0 * (fy - fz);
+}
+
+/*!
+	\brief Conversion from CIE L*a*b* to XYZ
+	\param[in] l - L* in 0..100 range
+	\param[in] a - a* channel
+	\param[in] b - b* channel
+	\param[out] x - x channel
+	\param[out] y - y channel
+	\param[out] z - z channel
+	\param[in] white - XYZ of the reference white
+*/
+void lab_to_xyz(double l, double a, double b, double& x, double& y, double& z, const XYZ white)
+{
+	auto fy = (l + 16.0) / 116.0;
+	x = LabFInv(fy + a / 500.0) * white[0];
+	y = LabFInv(fy) * white[1];
+	z = LabFInv(fy - b / 200.0) * white[2];
+}
+
 /*!
     \brief Conversion from RGB to XYZ color model
     \param[in] r - red channel in 0..1.0 range
@@ -484,9 +779,11 @@ RgbParams get_rgb_params(RgbEnum color_space, AdaptationEnum adaptation, Illumin
 void rgb_to_xyz(double r, double g, double b,
 	double& x, double& y, double& z, const RgbParams& params)
 {
-	r = InvCompand(r, params.GammaRGB);
-	g = InvCompand(g, params.GammaRGB);
-	b = InvCompand(b, params.GammaRGB);
+	COLORPP_STATS_SCOPE("rgb_to_xyz", 1);
+	auto transfer = get_transfer(params);
+	r = inv_compand(r, transfer, params.GammaRGB);
+	g = inv_compand(g, transfer, params.GammaRGB);
+	b = inv_compand(b, transfer, params.GammaRGB);
 	
 	x = r * params.MtxRGB2XYZ[0][0] + g * params.MtxRGB2XYZ[1][0] + b * params.MtxRGB2XYZ[2][0];
 	y = r * params.MtxRGB2XYZ[0][1] + g * params.MtxRGB2XYZ[1][1] + b * params.MtxRGB2XYZ[2][1];
@@ -494,30 +791,14 @@ void rgb_to_xyz(double r, double g, double b,
 
 	if (params.AdaptationMethod != AdaptationEnum::amNone)
 	{
-		auto& MtxAdaptMa = Adaptations[static_cast<size_t>(params.AdaptationMethod)][0];
-		auto& MtxAdaptMaI = Adaptations[static_cast<size_t>(params.AdaptationMethod)][1];
-		auto& RefWhite = params.RefWhite;
-		auto& RefWhiteRGB = params.RefWhiteRGB;
-
-		auto Ad = RefWhite[0] * MtxAdaptMa[0][0] + RefWhite[1] * MtxAdaptMa[1][0] + RefWhite[2] * MtxAdaptMa[2][0];
-		auto Bd = RefWhite[0] * MtxAdaptMa[0][1] + RefWhite[1] * MtxAdaptMa[1][1] + RefWhite[2] * MtxAdaptMa[2][1];
-		auto Cd = RefWhite[0] * MtxAdaptMa[0][2] + RefWhite[1] * MtxAdaptMa[1][2] + RefWhite[2] * MtxAdaptMa[2][2];
-
-		auto As = RefWhiteRGB[0] * MtxAdaptMa[0][0] + RefWhiteRGB[1] * MtxAdaptMa[1][0] + RefWhiteRGB[2] * MtxAdaptMa[2][0];
-		auto Bs = RefWhiteRGB[0] * MtxAdaptMa[0][1] + RefWhiteRGB[1] * MtxAdaptMa[1][1] + RefWhiteRGB[2] * MtxAdaptMa[2][1];
-		auto Cs = RefWhiteRGB[0] * MtxAdaptMa[0][2] + RefWhiteRGB[1] * MtxAdaptMa[1][2] + RefWhiteRGB[2] * MtxAdaptMa[2][2];
-
-		auto X = x * MtxAdaptMa[0][0] + y * MtxAdaptMa[1][0] + z * MtxAdaptMa[2][0];
-		auto Y = x * MtxAdaptMa[0][1] + y * MtxAdaptMa[1][1] + z * MtxAdaptMa[2][1];
-		auto Z = x * MtxAdaptMa[0][2] + y * MtxAdaptMa[1][2] + z * MtxAdaptMa[2][2];
-
-		X *= (Ad / As);
-		Y *= (Bd / Bs);
-		Z *= (Cd / Cs);
-
-		x = X * MtxAdaptMaI[0][0] + Y * MtxAdaptMaI[1][0] + Z * MtxAdaptMaI[2][0];
-		y = X * MtxAdaptMaI[0][1] + Y * MtxAdaptMaI[1][1] + Z * MtxAdaptMaI[2][1];
-		z = X * MtxAdaptMaI[0][2] + Y * MtxAdaptMaI[1][2] + Z * MtxAdaptMaI[2][2];
+		Mtx3x3 m;
+		get_adaptation_matrix(params, m);
+		auto X = x * m[0][0] + y * m[1][0] + z * m[2][0];
+		auto Y = x * m[0][1] + y * m[1][1] + z * m[2][1];
+		auto Z = x * m[0][2] + y * m[1][2] + z * m[2][2];
+		x = X;
+		y = Y;
+		z = Z;
 	}
 }
 
@@ -534,37 +815,25 @@ void rgb_to_xyz(double r, double g, double b,
 void xyz_to_rgb(double x, double y, double z,
 	double& r, double& g, double& b, const RgbParams& params)
 {
+	COLORPP_STATS_SCOPE("xyz_to_rgb", 1);
 	if (params.AdaptationMethod != AdaptationEnum::amNone)
 	{
-		auto& MtxAdaptMa = Adaptations[static_cast<size_t>(params.AdaptationMethod)][0];
-		auto& MtxAdaptMaI = Adaptations[static_cast<size_t>(params.AdaptationMethod)][1];
-		auto& RefWhite = params.RefWhite;
-		auto& RefWhiteRGB = params.RefWhiteRGB;
-
-		double As = RefWhite[0] * MtxAdaptMa[0][0] + RefWhite[1] * MtxAdaptMa[1][0] + RefWhite[2] * MtxAdaptMa[2][0];
-		double Bs = RefWhite[0] * MtxAdaptMa[0][1] + RefWhite[1] * MtxAdaptMa[1][1] + RefWhite[2] * MtxAdaptMa[2][1];
-		double Cs = RefWhite[0] * MtxAdaptMa[0][2] + RefWhite[1] * MtxAdaptMa[1][2] + RefWhite[2] * MtxAdaptMa[2][2];
-
-		double Ad = RefWhiteRGB[0] * MtxAdaptMa[0][0] + RefWhiteRGB[1] * MtxAdaptMa[1][0] + RefWhiteRGB[2] * MtxAdaptMa[2][0];
-		double Bd = RefWhiteRGB[0] * MtxAdaptMa[0][1] + RefWhiteRGB[1] * MtxAdaptMa[1][1] + RefWhiteRGB[2] * MtxAdaptMa[2][1];
-		double Cd = RefWhiteRGB[0] * MtxAdaptMa[0][2] + RefWhiteRGB[1] * MtxAdaptMa[1][2] + RefWhiteRGB[2] * MtxAdaptMa[2][2];
-
-		double X1 = x * MtxAdaptMa[0][0] + y * MtxAdaptMa[1][0] + z * MtxAdaptMa[2][0];
-		double Y1 = x * MtxAdaptMa[0][1] + y * MtxAdaptMa[1][1] + z * MtxAdaptMa[2][1];
-		double Z1 = x * MtxAdaptMa[0][2] + y * MtxAdaptMa[1][2] + z * MtxAdaptMa[2][2];
-
-		X1 *= (Ad / As);
-		Y1 *= (Bd / Bs);
-		Z1 *= (Cd / Cs);
-
-		x = X1 * MtxAdaptMaI[0][0] + Y1 * MtxAdaptMaI[1][0] + Z1 * MtxAdaptMaI[2][0];
-		y = X1 * MtxAdaptMaI[0][1] + Y1 * MtxAdaptMaI[1][1] + Z1 * MtxAdaptMaI[2][1];
-		z = X1 * MtxAdaptMaI[0][2] + Y1 * MtxAdaptMaI[1][2] + Z1 * MtxAdaptMaI[2][2];
+		Mtx3x3 m;
+		get_inv_adaptation_matrix(params, m);
+		auto X = x * m[0][0] + y * m[1][0] + z * m[2][0];
+		auto Y = x * m[0][1] + y * m[1][1] + z * m[2][1];
+		auto Z = x * m[0][2] + y * m[1][2] + z * m[2][2];
+		x = X;
+		y = Y;
+		z = Z;
 	}
 	
-	r = Compand(x * params.MtxXYZ2RGB[0][0] + y * params.MtxXYZ2RGB[1][0] + z * params.MtxXYZ2RGB[2][0], params.GammaRGB);
-	g = Compand(x * params.MtxXYZ2RGB[0][1] + y * params.MtxXYZ2RGB[1][1] + z * params.MtxXYZ2RGB[2][1], params.GammaRGB);
-	b = Compand(x * params.MtxXYZ2RGB[0][2] + y * params.MtxXYZ2RGB[1][2] + z * params.MtxXYZ2RGB[2][2], params.GammaRGB);
+	auto transfer = get_transfer(params);
+	r = compand(x * params.MtxXYZ2RGB[0][0] + y * params.MtxXYZ2RGB[1][0] + z * params.MtxXYZ2RGB[2][0], transfer, params.GammaRGB);
+	g = compand(x * params.MtxXYZ2RGB[0][1] + y * params.MtxXYZ2RGB[1][1] + z * params.MtxXYZ2RGB[2][1], transfer, params.GammaRGB);
+	b = compand(x * params.MtxXYZ2RGB[0][2] + y * params.MtxXYZ2RGB[1][2] + z * params.MtxXYZ2RGB[2][2], transfer, params.GammaRGB);
+	// out of gamut colors
+	COLORPP_STATS_CLIPPED((r < 0. || r > 1.) + (g < 0. || g > 1.) + (b < 0. || b > 1.));
 }
 
 }
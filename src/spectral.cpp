@@ -0,0 +1,407 @@
+/*!
+\file spectral.cpp
+\brief Spectral integration to XYZ
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#include "spectral.h"
+#include "parallel.h"
+#include "stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace colorpp
+{
+
+namespace
+{
+	// tables sampled at 380..780 nm in 10 nm steps
+	const double TableStart = 380.;
+	const double TableStep = 10.;
+	const int TableCount = 41;
+	const int FineCount = 2 * TableCount - 1;
+
+	// CIE 1931 2 degree standard observer
+	const double Cmf[TableCount][3] = {
+		{0.001368, 0.000039, 0.006450}, {0.004243, 0.000120, 0.020050}, {0.014310, 0.000396, 0.067850},
+		{0.043510, 0.001210, 0.207400}, {0.134380, 0.004000, 0.645600}, {0.283900, 0.011600, 1.385600},
+		{0.348280, 0.023000, 1.747060}, {0.336200, 0.038000, 1.772110}, {0.290800, 0.060000, 1.669200},
+		{0.195360, 0.090980, 1.287640}, {0.095640, 0.139020, 0.812950}, {0.032010, 0.208020, 0.465180},
+		{0.004900, 0.323000, 0.272000}, {0.009300, 0.503000, 0.158200}, {0.063270, 0.710000, 0.078250},
+		{0.165500, 0.862000, 0.042160}, {0.290400, 0.954000, 0.020300}, {0.433450, 0.994950, 0.008750},
+		{0.594500, 0.995000, 0.003900}, {0.762100, 0.952000, 0.002100}, {0.916300, 0.870000, 0.001650},
+		{1.026300, 0.757000, 0.001100}, {1.062200, 0.631000, 0.000800}, {1.002600, 0.503000, 0.000340},
+		{0.854450, 0.381000, 0.000190}, {0.642400, 0.265000, 0.000050}, {0.447900, 0.175000, 0.000020},
+		{0.283500, 0.107000, 0.000000}, {0.164900, 0.061000, 0.000000}, {0.087400, 0.032000, 0.000000},
+		{0.046770, 0.017000, 0.000000}, {0.022700, 0.008210, 0.000000}, {0.011359, 0.004102, 0.000000},
+		{0.005790, 0.002091, 0.000000}, {0.002899, 0.001047, 0.000000}, {0.001440, 0.000520, 0.000000},
+		{0.000690, 0.000249, 0.000000}, {0.000332, 0.000120, 0.000000}, {0.000166, 0.000060, 0.000000},
+		{0.000083, 0.000030, 0.000000}, {0.000042, 0.000015, 0.000000}
+	};
+
+	// CIE daylight basis functions S0, S1, S2
+	const double Daylight[TableCount][3] = {
+		{63.4, 38.5, 3.0}, {65.8, 35.0, 1.2}, {94.8, 43.4, -1.1}, {104.8, 46.3, -0.5}, {105.9, 43.9, -0.7},
+		{96.8, 37.1, -1.2}, {113.9, 36.7, -2.6}, {125.6, 35.9, -2.9}, {125.5, 32.6, -2.8}, {121.3, 27.9, -2.6},
+		{121.3, 24.3, -2.6}, {113.5, 20.1, -1.8}, {113.1, 16.2, -1.5}, {110.8, 13.2, -1.3}, {106.5, 8.6, -1.2},
+		{108.8, 6.1, -1.0}, {105.3, 4.2, -0.5}, {104.4, 1.9, -0.3}, {100.0, 0.0, 0.0}, {96.0, -1.6, 0.2},
+		{95.1, -3.5, 0.5}, {89.1, -3.5, 2.1}, {90.5, -5.8, 3.2}, {90.3, -7.2, 4.1}, {88.4, -8.6, 4.7},
+		{84.0, -9.5, 5.1}, {85.1, -10.9, 6.7}, {81.9, -10.7, 7.3}, {82.6, -12.0, 8.6}, {84.9, -14.0, 9.8},
+		{81.3, -13.6, 10.2}, {71.9, -12.0, 8.3}, {74.3, -13.3, 9.6}, {76.4, -12.9, 8.5}, {63.3, -10.6, 7.0},
+		{71.7, -11.6, 7.6}, {77.0, -12.2, 8.0}, {65.2, -10.2, 6.7}, {47.7, -7.8, 5.2}, {68.6, -11.2, 7.4},
+		{65.0, -10.4, 6.8}
+	};
+
+	// CIE illuminant B, 10 nm
+	const double IlluminantB[TableCount] = {
+		22.40, 31.30, 41.30, 52.10, 63.20, 73.10, 80.80, 85.40, 88.30, 92.00,
+		95.20, 96.50, 94.20, 90.70, 89.50, 92.20, 96.90, 101.00, 102.80, 102.60,
+		101.00, 99.20, 98.00, 98.50, 99.70, 101.00, 102.20, 103.90, 105.00, 104.90,
+		103.90, 101.60, 99.10, 96.20, 92.90, 89.40, 86.90, 85.20, 84.70, 85.40,
+		87.00
+	};
+
+	// CIE illuminant C, 10 nm
+	const double IlluminantC[TableCount] = {
+		33.00, 47.40, 63.30, 80.60, 98.10, 112.40, 121.50, 124.00, 123.10, 123.80,
+		123.90, 120.70, 112.10, 102.30, 96.90, 98.00, 102.10, 105.20, 105.30, 102.30,
+		97.80, 93.20, 89.70, 88.40, 88.10, 88.00, 87.80, 88.20, 87.90, 86.30,
+		84.00, 80.20, 76.30, 72.40, 68.30, 64.40, 61.50, 59.20, 58.10, 58.20,
+		59.10
+	};
+
+	// CIE illuminants F2, F7 and F11 at 5 nm, the mercury lines fall between the 10 nm samples
+	const double IlluminantF2[FineCount] = {
+		1.18, 1.48, 1.84, 2.15, 3.44, 15.69, 3.85, 3.74, 4.19, 4.62,
+		5.06, 34.98, 11.81, 6.27, 6.63, 6.93, 7.19, 7.40, 7.54, 7.62,
+		7.65, 7.62, 7.62, 7.45, 7.28, 7.15, 7.05, 7.04, 7.16, 7.47,
+		8.04, 8.88, 10.01, 24.88, 16.64, 14.59, 16.16, 17.56, 18.62, 21.47,
+		22.79, 19.29, 18.66, 17.73, 16.54, 15.21, 13.80, 12.36, 10.95, 9.65,
+		8.40, 7.32, 6.31, 5.43, 4.68, 4.02, 3.45, 2.96, 2.55, 2.19,
+		1.89, 1.64, 1.53, 1.27, 1.10, 0.99, 0.88, 0.76, 0.68, 0.61,
+		0.56, 0.54, 0.51, 0.47, 0.47, 0.43, 0.46, 0.47, 0.40, 0.33,
+		0.27
+	};
+
+	const double IlluminantF7[FineCount] = {
+		2.56, 3.18, 3.84, 4.53, 6.15, 19.37, 7.37, 7.05, 7.71, 8.41,
+		9.15, 44.14, 17.52, 11.35, 12.00, 12.58, 13.08, 13.45, 13.71, 13.88,
+		13.95, 13.93, 13.82, 13.64, 13.43, 13.25, 13.08, 12.93, 12.78, 12.60,
+		12.44, 12.33, 12.26, 29.52, 17.05, 12.44, 12.58, 12.72, 12.83, 15.46,
+		16.75, 12.83, 12.67, 12.45, 12.19, 11.89, 11.60, 11.35, 11.12, 10.95,
+		10.76, 10.42, 10.11, 10.04, 10.02, 10.11, 9.87, 8.65, 7.27, 6.44,
+		5.83, 5.41, 5.04, 4.57, 4.12, 3.77, 3.46, 3.08, 2.73, 2.47,
+		2.25, 2.06, 1.90, 1.75, 1.62, 1.54, 1.45, 1.32, 1.17, 0.99,
+		0.81
+	};
+
+	const double IlluminantF11[FineCount] = {
+		0.91, 0.63, 0.46, 0.37, 1.29, 12.68, 1.59, 1.79, 2.46, 3.33,
+		4.49, 33.94, 12.13, 6.95, 7.19, 7.12, 6.72, 6.13, 5.46, 4.79,
+		5.66, 14.29, 14.96, 8.97, 4.72, 2.33, 1.47, 1.10, 0.89, 0.83,
+		1.18, 4.90, 39.59, 72.84, 32.61, 7.52, 2.83, 1.96, 1.67, 4.43,
+		11.28, 14.76, 12.73, 9.74, 7.33, 9.72, 55.27, 42.58, 13.18, 13.16,
+		12.26, 5.11, 2.07, 2.34, 3.58, 3.01, 2.48, 2.14, 1.54, 1.33,
+		1.46, 1.94, 2.00, 1.20, 1.35, 4.10, 5.58, 2.51, 0.57, 0.27,
+		0.23, 0.21, 0.24, 0.24, 0.20, 0.24, 0.32, 0.26, 0.16, 0.12,
+		0.09
+	};
+
+	// accumulation lanes of the dot products, a multiple of the widest vector
+	const size_t Lanes = 8;
+	const size_t SpectrumGrain = 256;
+
+	// linear interpolation of a table column, 0 outside of the table
+	double interpolate(const double table[][3], int column, double wavelength)
+	{
+		const double pos = (wavelength - TableStart) / TableStep;
+		if (pos < 0. || pos > TableCount - 1)
+			return 0.;
+		const int i = std::min(static_cast<int>(pos), TableCount - 2);
+		const double t = pos - i;
+		return table[i][column] + t * (table[i + 1][column] - table[i][column]);
+	}
+
+	// linear interpolation of a measured spectrum from TableStart, 0 outside of the table
+	double interpolate(const double* table, double step, int count, double wavelength)
+	{
+		const double pos = (wavelength - TableStart) / step;
+		if (pos < 0. || pos > count - 1)
+			return 0.;
+		const int i = std::min(static_cast<int>(pos), count - 2);
+		const double t = pos - i;
+		return table[i] + t * (table[i + 1] - table[i]);
+	}
+
+	double wavelength(const SpectralFormat& format, size_t i)
+	{
+		return format.Start + i * format.Step;
+	}
+
+	// Planck law with the c2 of the definition of illuminant A, 100 at 560 nm
+	void planck_spectrum(const SpectralFormat& format, double* spd)
+	{
+		const double c2 = 1.435e7;
+		const double t = 2848.;
+		const double norm = std::expm1(c2 / (t * 560.));
+		for (size_t i = 0; i < format.Count; ++i)
+		{
+			const double l = wavelength(format, i);
+			spd[i] = l > 0. ? 100. * std::pow(560. / l, 5.) * norm / std::expm1(c2 / (t * l)) : 0.;
+		}
+	}
+
+	// measured spectrum scaled to 100 at 560 nm
+	void measured_spectrum(const double* table, double step, int count, const SpectralFormat& format, double* spd)
+	{
+		const double scale = 100. / interpolate(table, step, count, 560.);
+		for (size_t i = 0; i < format.Count; ++i)
+			spd[i] = scale * interpolate(table, step, count, wavelength(format, i));
+	}
+
+	// CIE daylight at the chromaticity of a white
+	void daylight_spectrum(const XYZ white, const SpectralFormat& format, double* spd)
+	{
+		const double sum = white[0] + white[1] + white[2];
+		const double x = white[0] / sum;
+		const double y = white[1] / sum;
+		const double m = 0.0241 + 0.2562 * x - 0.7341 * y;
+		const double m1 = (-1.3515 - 1.7703 * x + 5.9114 * y) / m;
+		const double m2 = (0.0300 - 31.4424 * x + 30.0717 * y) / m;
+		for (size_t i = 0; i < format.Count; ++i)
+		{
+			const double l = wavelength(format, i);
+			spd[i] = interpolate(Daylight, 0, l) + m1 * interpolate(Daylight, 1, l) + m2 * interpolate(Daylight, 2, l);
+		}
+	}
+
+	// unscaled weights, false if they have no luminance
+	bool fill_weights(const double* spd, const SpectralFormat& format, SpectralWeights& weights, XYZ white)
+	{
+		if (format.Count == 0 || !(format.Step > 0.))
+			return false;
+		weights.Format = format;
+		weights.Stride = (format.Count + Lanes - 1) / Lanes * Lanes;
+		weights.Weights.assign(3 * weights.Stride, 0.f);
+		std::vector<double> rows(3 * format.Count);
+		for (int j = 0; j < 3; ++j)
+		{
+			white[j] = 0.;
+			for (size_t i = 0; i < format.Count; ++i)
+			{
+				rows[j * format.Count + i] = spd[i] * interpolate(Cmf, j, wavelength(format, i)) * format.Step;
+				white[j] += rows[j * format.Count + i];
+			}
+		}
+		if (!(white[1] > 0.))
+			return false;
+		for (int j = 0; j < 3; ++j)
+			for (size_t i = 0; i < format.Count; ++i)
+				weights.Weights[j * weights.Stride + i] = static_cast<float>(rows[j * format.Count + i] / white[1]);
+		for (int j = 0; j < 3; ++j)
+			weights.White[j] = white[j] / white[1];
+		return true;
+	}
+}
+
+/*!
+	\brief Get a spectral format
+	\param[in] start - first wavelength in nm
+	\param[in] step - sampling interval in nm
+	\param[in] count - number of samples
+	\return format, 380..780 nm in 10 nm steps by default
+*/
+SpectralFormat get_spectral_format(double start, double step, size_t count)
+{
+	SpectralFormat format;
+	format.Start = start;
+	format.Step = step;
+	format.Count = count;
+	return format;
+}
+
+/*!
+	\brief Get the relative spectral power distribution of an illuminant
+	\param[in] illuminant - Illuminant (see IlluminantEnum)
+	\param[in] format - wavelengths
+	\param[out] spd - format.Count values, 100 at 560 nm
+	\return false for an unknown illuminant
+*/
+bool get_illuminant_spectrum(IlluminantEnum illuminant, const SpectralFormat& format, double* spd)
+{
+	switch (illuminant)
+	{
+	case IlluminantEnum::A:
+		planck_spectrum(format, spd);
+		return true;
+	case IlluminantEnum::D50:
+	case IlluminantEnum::D55:
+	case IlluminantEnum::D65:
+	case IlluminantEnum::D75:
+	{
+		XYZ white;
+		get_ref_white(illuminant, white);
+		daylight_spectrum(white, format, spd);
+		return true;
+	}
+	case IlluminantEnum::E:
+		for (size_t i = 0; i < format.Count; ++i)
+			spd[i] = 100.;
+		return true;
+	case IlluminantEnum::B:
+		measured_spectrum(IlluminantB, TableStep, TableCount, format, spd);
+		return true;
+	case IlluminantEnum::C:
+		measured_spectrum(IlluminantC, TableStep, TableCount, format, spd);
+		return true;
+	case IlluminantEnum::F2:
+		measured_spectrum(IlluminantF2, TableStep / 2, FineCount, format, spd);
+		return true;
+	case IlluminantEnum::F7:
+		measured_spectrum(IlluminantF7, TableStep / 2, FineCount, format, spd);
+		return true;
+	case IlluminantEnum::F11:
+		measured_spectrum(IlluminantF11, TableStep / 2, FineCount, format, spd);
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*!
+	\brief Get the integration weights of an illuminant
+	\param[in] illuminant - Illuminant (see IlluminantEnum)
+	\param[in] format - wavelengths of the integrated spectra
+	\param[out] weights - integration weights
+	\return false for an unknown illuminant
+*/
+bool get_spectral_weights(IlluminantEnum illuminant, const SpectralFormat& format, SpectralWeights& weights)
+{
+	std::vector<double> spd(format.Count);
+	if (!get_illuminant_spectrum(illuminant, format, spd.data()) || !get_spectral_weights(spd.data(), format, weights))
+		return false;
+	// the tabulated whites are the reference, sampling and rounding errors go to the scale
+	XYZ white;
+	get_ref_white(illuminant, white);
+	for (int j = 0; j < 3; ++j)
+	{
+		const float scale = static_cast<float>(white[j] / weights.White[j]);
+		for (size_t i = 0; i < format.Count; ++i)
+			weights.Weights[j * weights.Stride + i] *= scale;
+		weights.White[j] = white[j];
+	}
+	return true;
+}
+
+/*!
+	\brief Get the integration weights of a custom illuminant
+	\param[in] spd - relative spectral power distribution, format.Count values
+	\param[in] format - wavelengths of the SPD and the integrated spectra
+	\param[out] weights - integration weights
+	\return false if the SPD has no luminance
+*/
+bool get_spectral_weights(const double* spd, const SpectralFormat& format, SpectralWeights& weights)
+{
+	XYZ white;
+	return fill_weights(spd, format, weights, white);
+}
+
+/*!
+	\brief Reflectance spectrum to XYZ
+	\param[in] spectrum - reflectance factors in 0..1.0 range, weights.Format.Count values
+	\param[out] xyz - XYZ, Y of the perfect reflecting diffuser is 1.0
+	\param[in] weights - integration weights
+*/
+void spectrum_to_xyz(const double* spectrum, XYZ xyz, const SpectralWeights& weights)
+{
+	COLORPP_STATS_SCOPE("spectrum_to_xyz", 1);
+	for (int j = 0; j < 3; ++j)
+	{
+		const float* w = weights.Weights.data() + j * weights.Stride;
+		xyz[j] = 0.;
+		for (size_t i = 0; i < weights.Format.Count; ++i)
+			xyz[j] += spectrum[i] * w[i];
+	}
+}
+
+/*!
+	\brief Batch reflectance spectra to XYZ
+	\param[in] src - count spectra of weights.Format.Count floats each
+	\param[out] dst - XYZ, 3 * count floats
+	\param[in] count - number of spectra
+	\param[in] weights - integration weights
+*/
+void spectrum_to_xyz(const float* src, float* dst, size_t count, const SpectralWeights& weights)
+{
+	COLORPP_STATS_SCOPE("spectrum_to_xyz/float", count);
+	const size_t n = weights.Format.Count;
+	const size_t stride = weights.Stride;
+	const float* wx = weights.Weights.data();
+	const float* wy = wx + stride;
+	const float* wz = wy + stride;
+	parallel_for(count, SpectrumGrain, [&](size_t begin, size_t end) {
+		for (size_t k = begin; k < end; ++k)
+		{
+			const float* s = src + k * n;
+			// fixed size lane loops, the sums aren't reordered so no fast math is needed
+			float x[Lanes] = {};
+			float y[Lanes] = {};
+			float z[Lanes] = {};
+			size_t i = 0;
+			for (; i + Lanes <= n; i += Lanes)
+				for (size_t l = 0; l < Lanes; ++l)
+				{
+					x[l] += s[i + l] * wx[i + l];
+					y[l] += s[i + l] * wy[i + l];
+					z[l] += s[i + l] * wz[i + l];
+				}
+			for (size_t l = 0; i < n; ++i, ++l)
+			{
+				x[l] += s[i] * wx[i];
+				y[l] += s[i] * wy[i];
+				z[l] += s[i] * wz[i];
+			}
+			float sum[3] = {0.f, 0.f, 0.f};
+			for (size_t l = 0; l < Lanes; ++l)
+			{
+				sum[0] += x[l];
+				sum[1] += y[l];
+				sum[2] += z[l];
+			}
+			dst[3 * k] = sum[0];
+			dst[3 * k + 1] = sum[1];
+			dst[3 * k + 2] = sum[2];
+		}
+	});
+}
+
+}
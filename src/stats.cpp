@@ -0,0 +1,224 @@
+/*!
+\file stats.cpp
+\brief This file contains the source code of the instrumentation counters and trace export
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include "stats.h"
+#include <fstream>
+#include <sstream>
+
+#ifdef COLORPP_STATS
+#include <deque>
+#include <mutex>
+#endif
+
+namespace colorpp
+{
+
+#ifdef COLORPP_STATS
+
+namespace
+{
+	// events beyond the limit are dropped
+	const size_t MaxTraceEvents = 1 << 20;
+
+	typedef struct _TraceEvent
+	{
+		const char* Name;
+		int64_t Start;	// ns since the trace epoch
+		int64_t Duration;	// ns
+		size_t Thread;
+		size_t Pixels;
+	} TraceEvent;
+
+	struct Registry
+	{
+		std::mutex mutex;
+		std::deque<detail::KernelCounter> counters;	// stable addresses for the static references
+		std::vector<TraceEvent> events;
+		std::atomic<bool> tracing{false};
+		std::chrono::steady_clock::time_point epoch{std::chrono::steady_clock::now()};
+		std::atomic<size_t> threads{0};
+	};
+
+	Registry& get_registry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	size_t get_thread_index()
+	{
+		thread_local size_t index = get_registry().threads.fetch_add(1);
+		return index;
+	}
+}
+
+namespace detail
+{
+
+KernelCounter& get_kernel_counter(const char* name)
+{
+	auto& registry = get_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.counters.emplace_back();
+	auto& counter = registry.counters.back();
+	counter.name = name;
+	counter.calls = 0;
+	counter.pixels = 0;
+	counter.nanoseconds = 0;
+	counter.clipped = 0;
+	return counter;
+}
+
+void add_trace_event(const char* name, std::chrono::steady_clock::time_point start,
+	std::chrono::steady_clock::time_point end, size_t pixels)
+{
+	auto& registry = get_registry();
+	if (!registry.tracing.load(std::memory_order_relaxed))
+		return;
+	TraceEvent event{name,
+		std::chrono::duration_cast<std::chrono::nanoseconds>(start - registry.epoch).count(),
+		std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+		get_thread_index(), pixels};
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	if (registry.events.size() < MaxTraceEvents)
+		registry.events.push_back(event);
+}
+
+}
+
+#endif
+
+/*!
+	\brief Check if the library is built with instrumentation (COLORPP_STATS)
+	\return true if the counters are collected
+*/
+bool is_stats_enabled()
+{
+#ifdef COLORPP_STATS
+	return true;
+#else
+	return false;
+#endif
+}
+
+/*!
+	\brief Get the counters of the entry points called so far
+	\return counters in the order of the first calls, empty without COLORPP_STATS
+*/
+std::vector<KernelStats> get_kernel_stats()
+{
+	std::vector<KernelStats> result;
+#ifdef COLORPP_STATS
+	auto& registry = get_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (auto& counter : registry.counters)
+		result.push_back(KernelStats{counter.name, counter.calls.load(), counter.pixels.load(),
+			counter.nanoseconds.load(), counter.clipped.load()});
+#endif
+	return result;
+}
+
+/*!
+	\brief Reset the counters and drop the recorded trace events
+*/
+void reset_kernel_stats()
+{
+#ifdef COLORPP_STATS
+	auto& registry = get_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (auto& counter : registry.counters)
+	{
+		counter.calls = 0;
+		counter.pixels = 0;
+		counter.nanoseconds = 0;
+		counter.clipped = 0;
+	}
+	registry.events.clear();
+#endif
+}
+
+/*!
+	\brief Turn on or off recording of trace events
+	\param[in] enable - true to record
+*/
+void set_trace_enabled(bool enable)
+{
+#ifdef COLORPP_STATS
+	get_registry().tracing = enable;
+#else
+	(void)enable;
+#endif
+}
+
+/*!
+	\brief Get the recorded events in the Chrome trace JSON format
+	\return JSON document
+*/
+std::string get_trace_json()
+{
+	std::ostringstream json;
+	json << "{\"traceEvents\":[";
+#ifdef COLORPP_STATS
+	auto& registry = get_registry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	json.setf(std::ios::fixed);
+	json.precision(3);
+	for (size_t i = 0; i < registry.events.size(); ++i)
+	{
+		auto& event = registry.events[i];
+		// complete events, timestamps in microseconds
+		json << (i ? ",\n" : "\n") << "{\"name\":\"" << event.Name << "\",\"cat\":\"colorpp\",\"ph\":\"X\",\"ts\":"
+			<< event.Start / 1000. << ",\"dur\":" << event.Duration / 1000. << ",\"pid\":1,\"tid\":"
+			<< event.Thread << ",\"args\":{\"pixels\":" << event.Pixels << "}}";
+	}
+#endif
+	json << "\n],\"displayTimeUnit\":\"ns\"}\n";
+	return json.str();
+}
+
+/*!
+	\brief Write the recorded events to a Chrome trace JSON file
+	\param[in] path - file name
+	\return false if the file can't be written
+*/
+bool write_trace(const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+	file << get_trace_json();
+	return static_cast<bool>(file);
+}
+
+}
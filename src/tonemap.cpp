@@ -0,0 +1,389 @@
+/*!
+\file tonemap.cpp
+\brief This file contains the source code of HDR to SDR tone mapping
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "tonemap.h"
+#include "arena.h"
+#include "transfer.h"
+#include "parallel.h"
+#include "stats.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace colorpp
+{
+
+namespace
+{
+	const size_t StatsGrain = 16384;
+	const size_t MapGrain = 4096;	// pixels mapped and encoded while they are in L1/L2
+	const size_t EetfLutSize = 4096;
+	const double LogDelta = 1e-6;	// keeps log() finite on black pixels
+
+	// Uncharted 2 constants
+	const double HableA = 0.15;
+	const double HableB = 0.50;
+	const double HableC = 0.10;
+	const double HableD = 0.20;
+	const double HableE = 0.02;
+	const double HableF = 0.30;
+
+	template<typename T>
+	T hable(T x)
+	{
+		return (x * (T(HableA) * x + T(HableC * HableB)) + T(HableD * HableE)) /
+			(x * (T(HableA) * x + T(HableB)) + T(HableD * HableF)) - T(HableE / HableF);
+	}
+
+	/*
+		Curves are plain functors over exposed values, so the batch loops below
+		are instantiated per operator without a switch inside.
+	*/
+	template<typename T>
+	struct ReinhardCurve
+	{
+		T exposure;
+		T inv_white2;
+		T operator()(T x) const
+		{
+			// out of gamut negatives would reach the pole at -1
+			x = std::max(x * exposure, T(0));
+			return std::min(x * (T(1) + x * inv_white2) / (T(1) + x), T(1));
+		}
+	};
+
+	template<typename T>
+	struct HableCurve
+	{
+		T exposure;
+		T inv_white;	// 1 / hable(white)
+		T operator()(T x) const
+		{
+			// the rational has a pole just below 0
+			return std::min(hable(std::max(x * exposure, T(0))) * inv_white, T(1));
+		}
+	};
+
+	template<typename T>
+	struct AcesCurve
+	{
+		T exposure;
+		T operator()(T x) const
+		{
+			// negatives climb back up the rational towards 1
+			x = std::max(x * exposure, T(0));
+			auto y = (x * (T(2.51) * x + T(0.03))) / (x * (T(2.43) * x + T(0.59)) + T(0.14));
+			return std::min(y, T(1));
+		}
+	};
+
+	template<typename T>
+	struct LutCurve
+	{
+		T exposure;
+		T scale;	// table intervals per exposed unit
+		const T* lut;
+		T operator()(T x) const
+		{
+			auto pos = std::min(std::max(x * exposure * scale, T(0)), T(EetfLutSize));
+			auto i = std::min(static_cast<size_t>(pos), EetfLutSize - 1);
+			auto t = pos - static_cast<T>(i);
+			return lut[i] + t * (lut[i + 1] - lut[i]);
+		}
+	};
+
+	// BT.2390-9 EETF without the black level lift, in SDR white relative units
+	double eetf(double x, double source_peak, double target_nits)
+	{
+		if (source_peak <= 1.0)
+			return std::min(std::max(x, 0.0), 1.0);
+		const double nits = target_nits / 10000.0;
+		auto source_pq = compand(source_peak * nits, TransferEnum::PQ);
+		auto max_lum = compand(nits, TransferEnum::PQ) / source_pq;
+		auto e1 = compand(std::min(std::max(x, 0.0), source_peak) * nits, TransferEnum::PQ) / source_pq;
+		auto ks = 1.5 * max_lum - 0.5;
+		auto e2 = e1;
+		if (e1 >= ks)
+		{
+			auto t = (e1 - ks) / (1.0 - ks);
+			auto t2 = t * t;
+			auto t3 = t2 * t;
+			e2 = (2.0 * t3 - 3.0 * t2 + 1.0) * ks + (t3 - 2.0 * t2 + t) * (1.0 - ks) +
+				(-2.0 * t3 + 3.0 * t2) * max_lum;
+		}
+		return std::min(inv_compand(e2 * source_pq, TransferEnum::PQ) / nits, 1.0);
+	}
+
+	template<typename Curve>
+	void map_pixels(const float* src, float* dst, size_t count, ToneModeEnum mode,
+		const float luma[3], const Curve& curve)
+	{
+		if (mode == ToneModeEnum::PerChannel)
+		{
+			for (size_t i = 0; i < 3 * count; ++i)
+				dst[i] = curve(src[i]);
+			return;
+		}
+		const float l0 = luma[0], l1 = luma[1], l2 = luma[2];
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto r = src[3 * i];
+			auto g = src[3 * i + 1];
+			auto b = src[3 * i + 2];
+			auto l = std::max(l0 * r + l1 * g + l2 * b, 0.f);
+			auto s = l > 0.f ? curve(l) / l : 0.f;
+			dst[3 * i] = r * s;
+			dst[3 * i + 1] = g * s;
+			dst[3 * i + 2] = b * s;
+		}
+	}
+
+	// resolved parameters and the BT.2390 table shared by the chunks
+	struct Mapper
+	{
+		ToneMapParams params;
+		ArenaBuffer<float> lut;
+		float luma[3];
+
+		Mapper(const float* src, size_t count, const ToneMapParams& p) :
+			params(p), lut(p.Operator == ToneMapEnum::Bt2390 ? EetfLutSize + 1 : 0)
+		{
+			if (need_tone_stats(params))
+			{
+				ToneStats stats;
+				get_tone_stats(src, count, params.Luma, stats);
+				set_tone_stats(params, stats);
+			}
+			for (int i = 0; i < 3; ++i)
+				luma[i] = static_cast<float>(params.Luma[i]);
+			if (params.Operator == ToneMapEnum::Bt2390)
+			{
+				auto peak = std::max(params.SourcePeak, 1.0);
+				for (size_t i = 0; i <= EetfLutSize; ++i)
+					lut[i] = static_cast<float>(eetf(peak * i / EetfLutSize, params.SourcePeak, params.TargetNits));
+			}
+		}
+
+		void operator()(const float* src, float* dst, size_t count) const
+		{
+			auto exposure = static_cast<float>(params.Exposure);
+			switch (params.Operator)
+			{
+			default:
+			case ToneMapEnum::Reinhard:
+			{
+				ReinhardCurve<float> curve{exposure, static_cast<float>(1.0 / (params.WhitePoint * params.WhitePoint))};
+				map_pixels(src, dst, count, params.Mode, luma, curve);
+				break;
+			}
+			case ToneMapEnum::Hable:
+			{
+				HableCurve<float> curve{exposure, static_cast<float>(1.0 / hable(params.WhitePoint))};
+				map_pixels(src, dst, count, params.Mode, luma, curve);
+				break;
+			}
+			case ToneMapEnum::Aces:
+			{
+				AcesCurve<float> curve{exposure};
+				map_pixels(src, dst, count, params.Mode, luma, curve);
+				break;
+			}
+			case ToneMapEnum::Bt2390:
+			{
+				LutCurve<float> curve{exposure, static_cast<float>(EetfLutSize / std::max(params.SourcePeak, 1.0)), lut.data()};
+				map_pixels(src, dst, count, params.Mode, luma, curve);
+				break;
+			}
+			}
+		}
+	};
+}
+
+/*!
+	\brief Create tone mapping parameters
+	\param[in] op - tone mapping operator (see ToneMapEnum)
+	\param[in] mode - luminance or per channel (see ToneModeEnum)
+	\return tone mapping parameters
+*/
+ToneMapParams get_tone_map_params(ToneMapEnum op, ToneModeEnum mode)
+{
+	ToneMapParams result;
+	result.Operator = op;
+	result.Mode = mode;
+	result.Exposure = 1.0;
+	result.Key = 0.0;
+	result.WhitePoint = op == ToneMapEnum::Hable ? 11.2 : 0.0;
+	result.SourcePeak = 0.0;
+	result.TargetNits = 100.0;
+	result.Luma[0] = 0.2126;
+	result.Luma[1] = 0.7152;
+	result.Luma[2] = 0.0722;
+	return result;
+}
+
+/*!
+	\brief Tone curve of a single value
+	\param[in] value - linear value before the exposure
+	\param[in] params - tone mapping parameters with the statistics applied
+	\return mapped value in 0..1.0 range
+*/
+double tone_map(double value, const ToneMapParams& params)
+{
+	switch (params.Operator)
+	{
+	default:
+	case ToneMapEnum::Reinhard:
+		return ReinhardCurve<double>{params.Exposure, 1.0 / (params.WhitePoint * params.WhitePoint)}(value);
+	case ToneMapEnum::Hable:
+		return HableCurve<double>{params.Exposure, 1.0 / hable(params.WhitePoint)}(value);
+	case ToneMapEnum::Aces:
+		return AcesCurve<double>{params.Exposure}(value);
+	case ToneMapEnum::Bt2390:
+		return eetf(value * params.Exposure, params.SourcePeak, params.TargetNits);
+	}
+}
+
+/*!
+	\brief Parallel pre-pass computing the image statistics
+	\param[in] src - interleaved linear RGB or XYZ, 3 * count floats
+	\param[in] count - number of pixels
+	\param[in] luma - luminance weights of the channels
+	\param[out] stats - image statistics
+*/
+void get_tone_stats(const float* src, size_t count, const double luma[3], ToneStats& stats)
+{
+	COLORPP_STATS_SCOPE("get_tone_stats", count);
+	std::mutex mutex;
+	double max_luminance = 0.0;
+	double log_sum = 0.0;
+	const float l0 = static_cast<float>(luma[0]);
+	const float l1 = static_cast<float>(luma[1]);
+	const float l2 = static_cast<float>(luma[2]);
+	parallel_for(count, StatsGrain, [&](size_t begin, size_t end) {
+		float chunk_max = 0.f;
+		double chunk_sum = 0.0;
+		for (size_t i = begin; i < end; ++i)
+		{
+			auto l = std::max(l0 * src[3 * i] + l1 * src[3 * i + 1] + l2 * src[3 * i + 2], 0.f);
+			chunk_max = std::max(chunk_max, l);
+			chunk_sum += std::log(LogDelta + l);
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		max_luminance = std::max(max_luminance, static_cast<double>(chunk_max));
+		log_sum += chunk_sum;
+	});
+	stats.MaxLuminance = max_luminance;
+	stats.LogAverage = count ? std::exp(log_sum / count) : 0.0;
+}
+
+/*!
+	\brief Resolve the statistics dependent parameters
+	\param[in,out] params - tone mapping parameters
+	\param[in] stats - image statistics
+*/
+void set_tone_stats(ToneMapParams& params, const ToneStats& stats)
+{
+	if (params.Key > 0.0 && stats.LogAverage > 0.0)
+	{
+		params.Exposure = params.Key / stats.LogAverage;
+		params.Key = 0.0;
+	}
+	if (params.WhitePoint <= 0.0)
+		params.WhitePoint = std::max(stats.MaxLuminance * params.Exposure, 1.0);
+	if (params.SourcePeak <= 0.0)
+		params.SourcePeak = std::max(stats.MaxLuminance, 1.0);
+}
+
+/*!
+	\brief Check if the parameters need the statistics pre-pass
+	\param[in] params - tone mapping parameters
+	\return true if set_tone_stats must be called before mapping
+*/
+bool need_tone_stats(const ToneMapParams& params)
+{
+	if (params.Key > 0.0)
+		return true;
+	switch (params.Operator)
+	{
+	case ToneMapEnum::Reinhard:
+	case ToneMapEnum::Hable:
+		return params.WhitePoint <= 0.0;
+	case ToneMapEnum::Bt2390:
+		return params.SourcePeak <= 0.0;
+	default:
+		return false;
+	}
+}
+
+/*!
+    \brief Batch tone mapping of interleaved linear pixels
+    \param[in] src - linear RGB or XYZ, 3 * count floats
+    \param[out] dst - mapped pixels, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+	\param[in] params - tone mapping parameters
+*/
+void tone_map(const float* src, float* dst, size_t count, const ToneMapParams& params)
+{
+	COLORPP_STATS_SCOPE("tone_map", count);
+	const Mapper mapper(src, count, params);
+	parallel_for(count, MapGrain, [&](size_t begin, size_t end) {
+		mapper(src + 3 * begin, dst + 3 * begin, end - begin);
+	});
+}
+
+/*!
+    \brief Batch tone mapping fused with companding
+    \param[in] src - linear RGB, 3 * count floats
+    \param[out] dst - encoded RGB, 3 * count floats (may alias src)
+    \param[in] count - number of pixels
+	\param[in] params - tone mapping parameters
+	\param[in] transfer - transfer function of the output (see TransferEnum)
+	\param[in] gamma - exponent of TransferEnum::Gamma
+*/
+void tone_map(const float* src, float* dst, size_t count, const ToneMapParams& params,
+	TransferEnum transfer, double gamma)
+{
+	COLORPP_STATS_SCOPE("tone_map+compand", count);
+	const Mapper mapper(src, count, params);
+	parallel_for(count, MapGrain, [&](size_t begin, size_t end) {
+		// chunks larger than MapGrain are still walked in cache sized pieces
+		for (size_t i = begin; i < end; i += MapGrain)
+		{
+			auto n = std::min(MapGrain, end - i);
+			mapper(src + 3 * i, dst + 3 * i, n);
+			compand(dst + 3 * i, dst + 3 * i, 3 * n, transfer, gamma);
+		}
+	});
+}
+
+}
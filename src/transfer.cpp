@@ -0,0 +1,246 @@
+/*!
+\file transfer.cpp
+\brief This file contains the source code of batch transfer functions
+	as a part of Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "transfer.h"
+#include "stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace colorpp
+{
+
+namespace
+{
+	// intervals of the decoding table uniform in the encoded domain
+	const size_t DecodeLutSize = 4096;
+
+	// the encoding table covers 2^-EncodeOctaves..1.0 with 2^EncodeSubBits intervals per octave
+	const int EncodeOctaves = 48;
+	const int EncodeSubBits = 7;
+	const size_t EncodeLutSize = static_cast<size_t>(EncodeOctaves) << EncodeSubBits;
+
+	// cached tables of custom gammas, the tables of further gammas are built per call
+	const size_t MaxGammaTables = 32;
+
+	enum class TableEnum
+	{
+		Codes = 0,
+		Decode = 1,
+		Encode = 2
+	};
+
+	typedef std::vector<float> Table;
+
+	std::shared_ptr<const Table> build_table(TableEnum kind, TransferEnum transfer, int bit_depth, double gamma)
+	{
+		std::shared_ptr<Table> table(new Table());
+		switch (kind)
+		{
+		case TableEnum::Codes:
+		{
+			size_t count = static_cast<size_t>(1) << bit_depth;
+			double max_code = static_cast<double>(count - 1);
+			table->resize(count);
+			for (size_t i = 0; i < count; ++i)
+				(*table)[i] = static_cast<float>(inv_compand(i / max_code, transfer, gamma));
+			break;
+		}
+		case TableEnum::Decode:
+			// one extra knot, so 1.0 interpolates without a bounds check
+			table->resize(DecodeLutSize + 2);
+			for (size_t i = 0; i <= DecodeLutSize; ++i)
+				(*table)[i] = static_cast<float>(inv_compand(static_cast<double>(i) / DecodeLutSize, transfer, gamma));
+			table->back() = (*table)[DecodeLutSize];
+			break;
+		case TableEnum::Encode:
+			table->resize(EncodeLutSize + 2);
+			for (size_t i = 0; i <= EncodeLutSize; ++i)
+			{
+				auto octave = static_cast<int>(i >> EncodeSubBits);
+				auto sub = static_cast<double>(i & ((1 << EncodeSubBits) - 1)) / (1 << EncodeSubBits);
+				auto linear = std::ldexp(1.0 + sub, octave - EncodeOctaves);
+				(*table)[i] = static_cast<float>(compand(linear, transfer, gamma));
+			}
+			table->back() = (*table)[EncodeLutSize];
+			break;
+		}
+		return table;
+	}
+
+	// tables are built once per transfer, bit depth and gamma
+	std::shared_ptr<const Table> get_table(TableEnum kind, TransferEnum transfer, int bit_depth, double gamma)
+	{
+		static std::mutex mutex;
+		static std::map<std::tuple<int, int, int, double>, std::shared_ptr<const Table>> tables;
+		static size_t gamma_tables = 0;
+		if (transfer != TransferEnum::Gamma)
+			gamma = 0.0;
+		// NaN can't be ordered in the map
+		if (std::isnan(gamma))
+			return build_table(kind, transfer, bit_depth, gamma);
+		auto key = std::make_tuple(static_cast<int>(kind), static_cast<int>(transfer), bit_depth, gamma);
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = tables.find(key);
+		if (it != tables.end())
+			return it->second;
+		if (transfer == TransferEnum::Gamma && gamma_tables >= MaxGammaTables)
+			return build_table(kind, transfer, bit_depth, gamma);
+		if (transfer == TransferEnum::Gamma)
+			++gamma_tables;
+		return tables.emplace(key, build_table(kind, transfer, bit_depth, gamma)).first->second;
+	}
+
+	int clamp_depth(int bit_depth)
+	{
+		return std::min(std::max(bit_depth, 8), 16);
+	}
+
+	// NaN compares false and goes to 0 like the negative values, so it can't reach the index
+	inline float clamp_unit(float value)
+	{
+		return value > 0.f ? std::min(value, 1.f) : 0.f;
+	}
+
+	inline float decode(const float* lut, float value)
+	{
+		auto pos = clamp_unit(value) * DecodeLutSize;
+		auto i = static_cast<int32_t>(pos);
+		auto t = pos - i;
+		return lut[i] + t * (lut[i + 1] - lut[i]);
+	}
+
+	inline float encode(const float* lut, float value)
+	{
+		const float min_value = std::ldexp(1.f, -EncodeOctaves);
+		value = clamp_unit(value);
+		// below the table the curve is continued by a line through zero
+		auto ramp = value * (lut[0] / min_value);
+		uint32_t bits;
+		auto clamped = std::max(value, min_value);
+		std::memcpy(&bits, &clamped, sizeof(bits));
+		auto i = static_cast<int32_t>(bits >> (23 - EncodeSubBits)) - ((127 - EncodeOctaves) << EncodeSubBits);
+		auto t = static_cast<float>(bits & ((1u << (23 - EncodeSubBits)) - 1)) * (1.f / (1 << (23 - EncodeSubBits)));
+		auto result = lut[i] + t * (lut[i + 1] - lut[i]);
+		return value < min_value ? ramp : result;
+	}
+}
+
+/*!
+    \brief Batch decoding of integer code values to linear values
+    \param[in] src - source samples in 0..2^bit_depth-1 (3 per RGB pixel)
+    \param[out] dst - linear samples
+    \param[in] count - number of samples
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] bit_depth - 8..16 bits per sample
+	\param[in] gamma - exponent of TransferEnum::Gamma
+*/
+void inv_compand(const unsigned short* src, float* dst, size_t count,
+	TransferEnum transfer, int bit_depth, double gamma)
+{
+	COLORPP_STATS_SCOPE("inv_compand/16", count);
+	bit_depth = clamp_depth(bit_depth);
+	auto table = get_table(TableEnum::Codes, transfer, bit_depth, gamma);
+	auto lut = table->data();
+	const unsigned max_code = (1u << bit_depth) - 1;
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = lut[std::min(static_cast<unsigned>(src[i]), max_code)];
+}
+
+/*!
+    \brief Batch encoding of linear values to integer code values
+    \param[in] src - linear samples, clamped to 0..1.0 (3 per RGB pixel)
+    \param[out] dst - encoded samples in 0..2^bit_depth-1
+    \param[in] count - number of samples
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] bit_depth - 8..16 bits per sample
+	\param[in] gamma - exponent of TransferEnum::Gamma
+*/
+void compand(const float* src, unsigned short* dst, size_t count,
+	TransferEnum transfer, int bit_depth, double gamma)
+{
+	COLORPP_STATS_SCOPE("compand/16", count);
+	COLORPP_STATS_CLIPPED(detail::count_outside(src, count, 0.f, 1.f));
+	bit_depth = clamp_depth(bit_depth);
+	auto table = get_table(TableEnum::Encode, transfer, 0, gamma);
+	auto lut = table->data();
+	const float max_code = static_cast<float>((1u << bit_depth) - 1);
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = static_cast<unsigned short>(encode(lut, src[i]) * max_code + 0.5f);
+}
+
+/*!
+    \brief Batch decoding of encoded values to linear values
+    \param[in] src - encoded samples, clamped to 0..1.0 (3 per RGB pixel)
+    \param[out] dst - linear samples (may alias src)
+    \param[in] count - number of samples
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] gamma - exponent of TransferEnum::Gamma
+*/
+void inv_compand(const float* src, float* dst, size_t count,
+	TransferEnum transfer, double gamma)
+{
+	COLORPP_STATS_SCOPE("inv_compand/float", count);
+	COLORPP_STATS_CLIPPED(detail::count_outside(src, count, 0.f, 1.f));
+	auto table = get_table(TableEnum::Decode, transfer, 0, gamma);
+	auto lut = table->data();
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = decode(lut, src[i]);
+}
+
+/*!
+    \brief Batch encoding of linear values to encoded values
+    \param[in] src - linear samples, clamped to 0..1.0 (3 per RGB pixel)
+    \param[out] dst - encoded samples (may alias src)
+    \param[in] count - number of samples
+	\param[in] transfer - transfer function (see TransferEnum)
+	\param[in] gamma - exponent of TransferEnum::Gamma
+*/
+void compand(const float* src, float* dst, size_t count,
+	TransferEnum transfer, double gamma)
+{
+	COLORPP_STATS_SCOPE("compand/float", count);
+	COLORPP_STATS_CLIPPED(detail::count_outside(src, count, 0.f, 1.f));
+	auto table = get_table(TableEnum::Encode, transfer, 0, gamma);
+	auto lut = table->data();
+	for (size_t i = 0; i < count; ++i)
+		dst[i] = encode(lut, src[i]);
+}
+
+}
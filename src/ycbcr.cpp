@@ -0,0 +1,374 @@
+/*!
+\file ycbcr.cpp
+\brief This file contains the source code of YCbCr conversion as a part of
+	Color++ library
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+\version 1.0
+\date 19/10/2026 (DD/MM/YYYY)
+\warning Unstable code. Under development.
+
+The MIT License
+
+Copyright(c) 2020 Konstantin Pankov, explorus@mail.ru
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "ycbcr.h"
+#include "ycbcr_fix.h"
+#include "stats.h"
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+namespace colorpp
+{
+
+namespace
+{
+	using detail::FixCoefs;
+	using detail::FixShift;
+	using detail::FixHalf;
+
+	// Kr, Kb luma coefficients (ITU-R BT.601-7, BT.709-6, BT.2020-2)
+	const double LumaCoefs[3][2] = {
+		{0.299, 0.114},
+		{0.2126, 0.0722},
+		{0.2627, 0.0593}
+	};
+
+	int32_t to_fix(double v)
+	{
+		return static_cast<int32_t>(std::lround(v * (1 << FixShift)));
+	}
+
+	// scale and offset of the integer Y and C codes for the unit signal
+	void get_quantization(RangeEnum range, int bit_depth,
+		double& scale_y, double& off_y, double& scale_c, double& off_c)
+	{
+		double max_code = static_cast<double>((1 << bit_depth) - 1);
+		off_c = static_cast<double>(1 << (bit_depth - 1));
+		if (range == RangeEnum::Full)
+		{
+			scale_y = max_code;
+			off_y = 0.;
+			scale_c = max_code;
+		}
+		else
+		{
+			double k = static_cast<double>(1 << (bit_depth - 8));
+			scale_y = 219. * k;
+			off_y = 16. * k;
+			scale_c = 224. * k;
+		}
+	}
+
+	FixCoefs get_forward_coefs(YCbCrEnum matrix, RangeEnum range, int bit_depth)
+	{
+		auto kr = LumaCoefs[static_cast<size_t>(matrix)][0];
+		auto kb = LumaCoefs[static_cast<size_t>(matrix)][1];
+		auto kg = 1. - kr - kb;
+		double scale_y, off_y, scale_c, off_c;
+		get_quantization(range, bit_depth, scale_y, off_y, scale_c, off_c);
+		double max_code = static_cast<double>((1 << bit_depth) - 1);
+
+		const double m[3][3] = {
+			{kr, kg, kb},
+			{-kr / (2. * (1. - kb)), -kg / (2. * (1. - kb)), 0.5},
+			{0.5, -kg / (2. * (1. - kr)), -kb / (2. * (1. - kr))}
+		};
+		FixCoefs result;
+		for (int i = 0; i < 3; ++i)
+		{
+			auto scale = (i == 0 ? scale_y : scale_c) / max_code;
+			for (int j = 0; j < 3; ++j)
+				result.m[i][j] = to_fix(m[i][j] * scale);
+			result.add[i] = to_fix(i == 0 ? off_y : off_c) + FixHalf;
+			result.off[i] = 0;
+		}
+		result.max_value = (1 << bit_depth) - 1;
+		return result;
+	}
+
+	FixCoefs get_inverse_coefs(YCbCrEnum matrix, RangeEnum range, int bit_depth)
+	{
+		auto kr = LumaCoefs[static_cast<size_t>(matrix)][0];
+		auto kb = LumaCoefs[static_cast<size_t>(matrix)][1];
+		auto kg = 1. - kr - kb;
+		double scale_y, off_y, scale_c, off_c;
+		get_quantization(range, bit_depth, scale_y, off_y, scale_c, off_c);
+		double max_code = static_cast<double>((1 << bit_depth) - 1);
+
+		const double m[3][3] = {
+			{1., 0., 2. * (1. - kr)},
+			{1., -2. * kb * (1. - kb) / kg, -2. * kr * (1. - kr) / kg},
+			{1., 2. * (1. - kb), 0.}
+		};
+		FixCoefs result;
+		for (int i = 0; i < 3; ++i)
+		{
+			result.m[i][0] = to_fix(m[i][0] * max_code / scale_y);
+			result.m[i][1] = to_fix(m[i][1] * max_code / scale_c);
+			result.m[i][2] = to_fix(m[i][2] * max_code / scale_c);
+			result.add[i] = FixHalf;
+		}
+		result.off[0] = static_cast<int32_t>(off_y);
+		result.off[1] = static_cast<int32_t>(off_c);
+		result.off[2] = static_cast<int32_t>(off_c);
+		result.max_value = (1 << bit_depth) - 1;
+		return result;
+	}
+
+	/*
+		Branch-free 3x3 fixed point kernel: plain int32 arithmetic and min/max clamping
+		so the compiler can vectorize the loop.
+	*/
+	template<typename T>
+	void fix_kernel(const T* src, T* dst, size_t count, const FixCoefs& c)
+	{
+		const int32_t m00 = c.m[0][0], m01 = c.m[0][1], m02 = c.m[0][2];
+		const int32_t m10 = c.m[1][0], m11 = c.m[1][1], m12 = c.m[1][2];
+		const int32_t m20 = c.m[2][0], m21 = c.m[2][1], m22 = c.m[2][2];
+		const int32_t a0 = c.add[0], a1 = c.add[1], a2 = c.add[2];
+		const int32_t o0 = c.off[0], o1 = c.off[1], o2 = c.off[2];
+		const int32_t max_value = c.max_value;
+		for (size_t i = 0; i < count; ++i)
+		{
+			int32_t s0 = static_cast<int32_t>(src[3 * i]) - o0;
+			int32_t s1 = static_cast<int32_t>(src[3 * i + 1]) - o1;
+			int32_t s2 = static_cast<int32_t>(src[3 * i + 2]) - o2;
+			int32_t d0 = (m00 * s0 + m01 * s1 + m02 * s2 + a0) >> FixShift;
+			int32_t d1 = (m10 * s0 + m11 * s1 + m12 * s2 + a1) >> FixShift;
+			int32_t d2 = (m20 * s0 + m21 * s1 + m22 * s2 + a2) >> FixShift;
+			dst[3 * i] = static_cast<T>(std::min(std::max(d0, 0), max_value));
+			dst[3 * i + 1] = static_cast<T>(std::min(std::max(d1, 0), max_value));
+			dst[3 * i + 2] = static_cast<T>(std::min(std::max(d2, 0), max_value));
+		}
+	}
+
+	// coefficients are tiny, so all the combinations are built once
+	struct FixTables
+	{
+		FixCoefs forward[3][2][5];
+		FixCoefs inverse[3][2][5];
+		FixTables()
+		{
+			for (int m = 0; m < 3; ++m)
+				for (int r = 0; r < 2; ++r)
+					for (int d = 0; d < 5; ++d)
+					{
+						forward[m][r][d] = get_forward_coefs(static_cast<YCbCrEnum>(m), static_cast<RangeEnum>(r), d + 8);
+						inverse[m][r][d] = get_inverse_coefs(static_cast<YCbCrEnum>(m), static_cast<RangeEnum>(r), d + 8);
+					}
+		}
+	};
+
+	const FixTables& get_fix_tables()
+	{
+		static const FixTables tables;
+		return tables;
+	}
+
+	int depth_index(int bit_depth)
+	{
+		return std::min(std::max(bit_depth, 8), 12) - 8;
+	}
+}
+
+namespace detail
+{
+
+const FixCoefs& get_fix_coefs(bool inverse, YCbCrEnum matrix, RangeEnum range, int bit_depth)
+{
+	auto& tables = get_fix_tables();
+	auto m = static_cast<size_t>(matrix);
+	auto r = static_cast<size_t>(range);
+	auto d = depth_index(bit_depth);
+	return inverse ? tables.inverse[m][r][d] : tables.forward[m][r][d];
+}
+
+}
+
+/*!
+    \brief Conversion from RGB to YCbCr color model
+    \param[in] r - red channel in 0..1.0 range
+	\param[in] g - green channel in 0..1.0 range
+ 	\param[in] b - blue channel in 0..1.0 range
+ 	\param[out] y - luma channel in 0..1.0 range
+  	\param[out] cb - blue-difference channel in 0..1.0 range (0.5 is neutral)
+  	\param[out] cr - red-difference channel in 0..1.0 range (0.5 is neutral)
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+*/
+void rgb_to_ycbcr(double r, double g, double b,
+	double& y, double& cb, double& cr, YCbCrEnum matrix)
+{
+	auto kr = LumaCoefs[static_cast<size_t>(matrix)][0];
+	auto kb = LumaCoefs[static_cast<size_t>(matrix)][1];
+	y = kr * r + (1. - kr - kb) * g + kb * b;
+	cb = 0.5 + (b - y) / (2. * (1. - kb));
+	cr = 0.5 + (r - y) / (2. * (1. - kr));
+}
+
+/*!
+    \brief Conversion from YCbCr to RGB color model
+ 	\param[in] y - luma channel in 0..1.0 range
+  	\param[in] cb - blue-difference channel in 0..1.0 range (0.5 is neutral)
+  	\param[in] cr - red-difference channel in 0..1.0 range (0.5 is neutral)
+    \param[out] r - red channel in 0..1.0 range
+	\param[out] g - green channel in 0..1.0 range
+ 	\param[out] b - blue channel in 0..1.0 range
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+*/
+void ycbcr_to_rgb(double y, double cb, double cr,
+	double& r, double& g, double& b, YCbCrEnum matrix)
+{
+	auto kr = LumaCoefs[static_cast<size_t>(matrix)][0];
+	auto kb = LumaCoefs[static_cast<size_t>(matrix)][1];
+	r = y + 2. * (1. - kr) * (cr - 0.5);
+	b = y + 2. * (1. - kb) * (cb - 0.5);
+	g = (y - kr * r - kb * b) / (1. - kr - kb);
+}
+
+/*!
+	\brief Create parameters for the RGB color space the YCbCr matrix is defined on
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] adaptation - Chromatic adaptation method (see AdaptationEnum)
+	\param[in] illuminant - Illuminant (see IlluminantEnum)
+	\return RGB ColorSpace parameters
+*/
+RgbParams get_ycbcr_rgb_params(YCbCrEnum matrix, AdaptationEnum adaptation, IlluminantEnum illuminant)
+{
+	switch (matrix)
+	{
+	case YCbCrEnum::Bt601:
+		return get_rgb_params(RgbEnum::SmpteCRgb, adaptation, illuminant);
+	case YCbCrEnum::Bt2020:
+		return get_rgb_params(RgbEnum::Rec2020Rgb, adaptation, illuminant);
+	default:
+	case YCbCrEnum::Bt709:
+		return get_rgb_params(RgbEnum::sRGB, adaptation, illuminant);
+	}
+}
+
+/*!
+    \brief Conversion from YCbCr to XYZ color model
+ 	\param[in] y - luma channel in 0..1.0 range
+  	\param[in] cb - blue-difference channel in 0..1.0 range
+  	\param[in] cr - red-difference channel in 0..1.0 range
+ 	\param[out] x - x channel in 0..1.0 range
+  	\param[out] y_ - y channel in 0..1.0 range
+  	\param[out] z - z channel in 0..1.0 range
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] params - RGB ColorSpace parameters (see get_ycbcr_rgb_params)
+*/
+void ycbcr_to_xyz(double y, double cb, double cr,
+	double& x, double& y_, double& z, YCbCrEnum matrix, const RgbParams& params)
+{
+	double r, g, b;
+	ycbcr_to_rgb(y, cb, cr, r, g, b, matrix);
+	rgb_to_xyz(r, g, b, x, y_, z, params);
+}
+
+/*!
+    \brief Conversion from XYZ to YCbCr color model
+ 	\param[in] x - x channel in 0..1.0 range
+  	\param[in] y_ - y channel in 0..1.0 range
+  	\param[in] z - z channel in 0..1.0 range
+ 	\param[out] y - luma channel in 0..1.0 range
+  	\param[out] cb - blue-difference channel in 0..1.0 range
+  	\param[out] cr - red-difference channel in 0..1.0 range
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] params - RGB ColorSpace parameters (see get_ycbcr_rgb_params)
+*/
+void xyz_to_ycbcr(double x, double y_, double z,
+	double& y, double& cb, double& cr, YCbCrEnum matrix, const RgbParams& params)
+{
+	double r, g, b;
+	xyz_to_rgb(x, y_, z, r, g, b, params);
+	rgb_to_ycbcr(r, g, b, y, cb, cr, matrix);
+}
+
+/*!
+    \brief Batch conversion of interleaved 8-bit RGB to interleaved 8-bit YCbCr
+    \param[in] rgb - source pixels, 3 * count bytes
+    \param[out] ycbcr - destination pixels, 3 * count bytes (may alias rgb)
+    \param[in] count - number of pixels
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the destination (see RangeEnum)
+*/
+void rgb_to_ycbcr(const unsigned char* rgb, unsigned char* ycbcr, size_t count,
+	YCbCrEnum matrix, RangeEnum range)
+{
+	COLORPP_STATS_SCOPE("rgb_to_ycbcr/8", count);
+	fix_kernel(rgb, ycbcr, count,
+		detail::get_fix_coefs(false, matrix, range, 8));
+}
+
+/*!
+    \brief Batch conversion of interleaved 8-bit YCbCr to interleaved 8-bit RGB
+    \param[in] ycbcr - source pixels, 3 * count bytes
+    \param[out] rgb - destination pixels, 3 * count bytes (may alias ycbcr)
+    \param[in] count - number of pixels
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the source (see RangeEnum)
+*/
+void ycbcr_to_rgb(const unsigned char* ycbcr, unsigned char* rgb, size_t count,
+	YCbCrEnum matrix, RangeEnum range)
+{
+	COLORPP_STATS_SCOPE("ycbcr_to_rgb/8", count);
+	fix_kernel(ycbcr, rgb, count,
+		detail::get_fix_coefs(true, matrix, range, 8));
+}
+
+/*!
+    \brief Batch conversion of interleaved high bit depth RGB to YCbCr
+    \param[in] rgb - source pixels, 3 * count words in 0..2^bit_depth-1
+    \param[out] ycbcr - destination pixels, 3 * count words (may alias rgb)
+    \param[in] count - number of pixels
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the destination (see RangeEnum)
+	\param[in] bit_depth - 8..12 bits per sample
+*/
+void rgb_to_ycbcr(const unsigned short* rgb, unsigned short* ycbcr, size_t count,
+	YCbCrEnum matrix, RangeEnum range, int bit_depth)
+{
+	COLORPP_STATS_SCOPE("rgb_to_ycbcr/16", count);
+	fix_kernel(rgb, ycbcr, count,
+		detail::get_fix_coefs(false, matrix, range, bit_depth));
+}
+
+/*!
+    \brief Batch conversion of interleaved high bit depth YCbCr to RGB
+    \param[in] ycbcr - source pixels, 3 * count words
+    \param[out] rgb - destination pixels, 3 * count words in 0..2^bit_depth-1 (may alias ycbcr)
+    \param[in] count - number of pixels
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range of the source (see RangeEnum)
+	\param[in] bit_depth - 8..12 bits per sample
+*/
+void ycbcr_to_rgb(const unsigned short* ycbcr, unsigned short* rgb, size_t count,
+	YCbCrEnum matrix, RangeEnum range, int bit_depth)
+{
+	COLORPP_STATS_SCOPE("ycbcr_to_rgb/16", count);
+	fix_kernel(ycbcr, rgb, count,
+		detail::get_fix_coefs(true, matrix, range, bit_depth));
+}
+
+}
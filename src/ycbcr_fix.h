@@ -0,0 +1,49 @@
+/*!
+\file ycbcr_fix.h
+\brief Fixed point YCbCr coefficients shared by the integer kernels
+\authors Konstantin A. Pankov, explorus@mail.ru
+\copyright MIT License
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include "ycbcr.h"
+
+namespace colorpp
+{
+
+namespace detail
+{
+
+// fixed point precision of the integer kernels
+const int FixShift = 16;
+const int32_t FixHalf = 1 << (FixShift - 1);
+
+/*
+	Integer kernel coefficients. Forward: out[i] = (sum(m[i][j] * in[j]) + add[i]) >> FixShift,
+	inverse: out[i] = (sum(m[i][j] * (in[j] - off[j])) + add[i]) >> FixShift.
+	Both are clamped to 0..max_value.
+*/
+struct FixCoefs
+{
+	int32_t m[3][3];
+	int32_t add[3];
+	int32_t off[3];
+	int32_t max_value;
+};
+
+/*!
+	\brief Get precomputed fixed point coefficients
+	\param[in] inverse - false for RGB to YCbCr, true for YCbCr to RGB
+	\param[in] matrix - YCbCr matrix coefficients (see YCbCrEnum)
+	\param[in] range - quantization range (see RangeEnum)
+	\param[in] bit_depth - 8..12 bits per sample
+	\return coefficients
+*/
+const FixCoefs& get_fix_coefs(bool inverse, YCbCrEnum matrix, RangeEnum range, int bit_depth);
+
+}
+
+}
@@ -1,8 +1,63 @@
 #include <iostream>
 #include <cmath>
+#include <limits>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <stdexcept>
 
 #include "gtest/gtest.h"
 #include "color.h"
+#include "planar.h"
+#include "parallel.h"
+#include "cct.h"
+#include "icc.h"
+#include "transfer.h"
+#include "tonemap.h"
+#include "jobs.h"
+#include "dither.h"
+#include "stats.h"
+#include "adjust.h"
+#include "gradient.h"
+#include "color_lut.h"
+#include "lut_cache.h"
+#include "convert.h"
+#include "arena.h"
+#include "pipeline.h"
+#include "spectral.h"
+#include "palette.h"
+#include "histogram.h"
+#include "oklab.h"
+#include "hwb.h"
+#include "hsi.h"
+#include "cmyk.h"
+#include "../samples/utils/convserver.h"
+
+namespace
+{
+	// count pixels of channels samples on levels steps of 0..1.0; the prime stride and the
+	// pixel index keep the neighbors and the channels of a pixel apart
+	std::vector<float> make_test_pixels(size_t count, size_t levels, size_t channels = 3)
+	{
+		std::vector<float> pixels(count * channels);
+		for (size_t i = 0; i < pixels.size(); ++i)
+			pixels[i] = static_cast<float>((i * 7919 + i / channels) % levels) / (levels - 1);
+		return pixels;
+	}
+
+	// 8-bit codes of make_test_pixels(count, 256, channels)
+	std::vector<unsigned char> make_test_codes(size_t count, size_t channels = 3)
+	{
+		std::vector<unsigned char> codes(count * channels);
+		for (size_t i = 0; i < codes.size(); ++i)
+			codes[i] = static_cast<unsigned char>((i * 7919 + i / channels) % 256);
+		return codes;
+	}
+}
 
 TEST(rgb_to_hsv_to_rgb, colorpp_proc_test)
 {
@@ -164,4 +219,1980 @@ TEST(rgb_to_xyz_to_rgb, colorpp_proc_test)
 				ASSERT_LT(std::abs(B - b_res), value_epsilon) <<
 					"rgb is: " << r << ", " << g << ", " << b;
 			}
-}
\ No newline at end of file
+}
+
+TEST(xyz_to_lab_to_xyz, colorpp_proc_test)
+{
+	colorpp::XYZ white;
+	colorpp::get_ref_white(colorpp::IlluminantEnum::D65, white);
+	double l, a, b;
+	colorpp::xyz_to_lab(white[0], white[1], white[2], l, a, b, white);
+	EXPECT_NEAR(l, 100., 1e-9);
+	EXPECT_NEAR(a, 0., 1e-9);
+	EXPECT_NEAR(b, 0., 1e-9);
+	// sRGB red
+	colorpp::xyz_to_lab(0.4124564, 0.2126729, 0.0193339, l, a, b, white);
+	EXPECT_NEAR(l, 53.2408, 1e-3);
+	EXPECT_NEAR(a, 80.0925, 1e-3);
+	EXPECT_NEAR(b, 67.2032, 1e-3);
+	// both sides of the linear segment near black
+	for (double y : {0.001, 0.005, 0.2, 0.9})
+	{
+		double X, Y, Z;
+		colorpp::xyz_to_lab(y * 0.9, y, y * 1.2, l, a, b, white);
+		colorpp::lab_to_xyz(l, a, b, X, Y, Z, white);
+		EXPECT_NEAR(X, y * 0.9, 1e-12);
+		EXPECT_NEAR(Y, y, 1e-12);
+		EXPECT_NEAR(Z, y * 1.2, 1e-12);
+	}
+}
+
+TEST(rgb_to_ycbcr_to_rgb, colorpp_proc_test)
+{
+	const double value_epsilon = 1e-14;
+	const colorpp::YCbCrEnum matrices[] = {colorpp::YCbCrEnum::Bt601,
+		colorpp::YCbCrEnum::Bt709, colorpp::YCbCrEnum::Bt2020};
+	for (auto matrix : matrices)
+		for (int r = 0; r < 256; r += 5)
+			for (int g = 0; g < 256; g += 5)
+				for (int b = 0; b < 256; b += 5)
+				{
+					double R = static_cast<double>(r) / 255.;
+					double G = static_cast<double>(g) / 255.;
+					double B = static_cast<double>(b) / 255.;
+					double Y = 0.;
+					double Cb = 0.;
+					double Cr = 0.;
+					colorpp::rgb_to_ycbcr(R, G, B, Y, Cb, Cr, matrix);
+					ASSERT_GT(Cb, -value_epsilon);
+					ASSERT_LT(Cb, 1. + value_epsilon);
+					ASSERT_GT(Cr, -value_epsilon);
+					ASSERT_LT(Cr, 1. + value_epsilon);
+					double r_res = 0.;
+					double g_res = 0.;
+					double b_res = 0.;
+					colorpp::ycbcr_to_rgb(Y, Cb, Cr, r_res, g_res, b_res, matrix);
+					ASSERT_LT(std::abs(R - r_res), value_epsilon) <<
+						"rgb is: " << r << ", " << g << ", " << b;
+					ASSERT_LT(std::abs(G - g_res), value_epsilon) <<
+						"rgb is: " << r << ", " << g << ", " << b;
+					ASSERT_LT(std::abs(B - b_res), value_epsilon) <<
+						"rgb is: " << r << ", " << g << ", " << b;
+				}
+}
+
+TEST(rgb_to_ycbcr_to_rgb, colorpp_batch_test)
+{
+	const colorpp::YCbCrEnum matrices[] = {colorpp::YCbCrEnum::Bt601,
+		colorpp::YCbCrEnum::Bt709, colorpp::YCbCrEnum::Bt2020};
+	const colorpp::RangeEnum ranges[] = {colorpp::RangeEnum::Full, colorpp::RangeEnum::Limited};
+	std::vector<unsigned char> rgb(256 * 256 * 3);
+	std::vector<unsigned char> ycbcr(rgb.size());
+	std::vector<unsigned char> result(rgb.size());
+	for (auto matrix : matrices)
+		for (auto range : ranges)
+			for (int r = 0; r < 256; r += 3)
+			{
+				for (int i = 0; i < 256 * 256; ++i)
+				{
+					rgb[3 * i] = static_cast<unsigned char>(r);
+					rgb[3 * i + 1] = static_cast<unsigned char>(i >> 8);
+					rgb[3 * i + 2] = static_cast<unsigned char>(i & 0xff);
+				}
+				colorpp::rgb_to_ycbcr(rgb.data(), ycbcr.data(), 256 * 256, matrix, range);
+				colorpp::ycbcr_to_rgb(ycbcr.data(), result.data(), 256 * 256, matrix, range);
+				for (int i = 0; i < 256 * 256; ++i)
+				{
+					// reference: rounded floating point conversion
+					double Y = 0.;
+					double Cb = 0.;
+					double Cr = 0.;
+					colorpp::rgb_to_ycbcr(rgb[3 * i] / 255., rgb[3 * i + 1] / 255., rgb[3 * i + 2] / 255.,
+						Y, Cb, Cr, matrix);
+					double ref[3] = {Y * 255., (Cb - 0.5) * 255. + 128., (Cr - 0.5) * 255. + 128.};
+					if (range == colorpp::RangeEnum::Limited)
+					{
+						ref[0] = 16. + Y * 219.;
+						ref[1] = 128. + (Cb - 0.5) * 224.;
+						ref[2] = 128. + (Cr - 0.5) * 224.;
+					}
+					for (int c = 0; c < 3; ++c)
+					{
+						ASSERT_LE(std::abs(ref[c] - ycbcr[3 * i + c]), 0.51) <<
+							"rgb is: " << r << ", " << (i >> 8) << ", " << (i & 0xff) << " channel " << c;
+						ASSERT_LE(std::abs(static_cast<int>(rgb[3 * i + c]) - result[3 * i + c]), 3) <<
+							"rgb is: " << r << ", " << (i >> 8) << ", " << (i & 0xff) << " channel " << c;
+					}
+				}
+			}
+
+	// 10-bit: white and black map onto the nominal limited range codes
+	unsigned short rgb10[6] = {1023, 1023, 1023, 0, 0, 0};
+	unsigned short ycbcr10[6];
+	colorpp::rgb_to_ycbcr(rgb10, ycbcr10, 2);
+	EXPECT_EQ(ycbcr10[0], 940);
+	EXPECT_EQ(ycbcr10[1], 512);
+	EXPECT_EQ(ycbcr10[2], 512);
+	EXPECT_EQ(ycbcr10[3], 64);
+	colorpp::ycbcr_to_rgb(ycbcr10, ycbcr10, 2);
+	for (int i = 0; i < 6; ++i)
+		EXPECT_EQ(ycbcr10[i], rgb10[i]);
+}
+
+TEST(ycbcr_to_xyz, colorpp_class_test)
+{
+	auto params = colorpp::get_ycbcr_rgb_params(colorpp::YCbCrEnum::Bt709);
+	colorpp::rgb256 rgb(200, 100, 50);
+	colorpp::ycbcr709 ycc(rgb);
+	colorpp::rgb256 result(ycc);
+	EXPECT_LE(std::abs(rgb.get_red() - result.get_red()), 2);
+	EXPECT_LE(std::abs(rgb.get_green() - result.get_green()), 2);
+	EXPECT_LE(std::abs(rgb.get_blue() - result.get_blue()), 2);
+
+	double X = 0., Y = 0., Z = 0.;
+	colorpp::ycbcr_to_xyz(1., 0.5, 0.5, X, Y, Z, colorpp::YCbCrEnum::Bt709, params);
+	// white maps onto the reference white (D50 after Bradford adaptation)
+	EXPECT_NEAR(X, 0.96422, 1e-4);
+	EXPECT_NEAR(Y, 1., 1e-4);
+	EXPECT_NEAR(Z, 0.82521, 1e-4);
+}
+
+TEST(rgb_to_planar_to_rgb, colorpp_batch_test)
+{
+	const colorpp::PlanarEnum formats[] = {colorpp::PlanarEnum::I420, colorpp::PlanarEnum::NV12,
+		colorpp::PlanarEnum::P010, colorpp::PlanarEnum::I422};
+	// odd sizes to cover the frame edges
+	const size_t width = 67;
+	const size_t height = 41;
+	for (auto format : formats)
+	{
+		bool is_p010 = format == colorpp::PlanarEnum::P010;
+		int max_value = is_p010 ? 1023 : 255;
+		std::vector<unsigned char> data(colorpp::get_planar_size(format, width, height));
+		auto frame = colorpp::get_planar_frame(format, width, height, data.data());
+
+		// flat color: chroma filtering must not change anything
+		std::vector<unsigned short> src(width * height * 3);
+		for (size_t i = 0; i < width * height; ++i)
+		{
+			src[3 * i] = static_cast<unsigned short>(max_value * 200 / 255);
+			src[3 * i + 1] = static_cast<unsigned short>(max_value * 100 / 255);
+			src[3 * i + 2] = static_cast<unsigned short>(max_value * 50 / 255);
+		}
+		std::vector<unsigned short> ycbcr(src);
+		colorpp::rgb_to_ycbcr(ycbcr.data(), ycbcr.data(), 1, colorpp::YCbCrEnum::Bt709,
+			colorpp::RangeEnum::Limited, is_p010 ? 10 : 8);
+		std::vector<unsigned short> expected(ycbcr.begin(), ycbcr.begin() + 3);
+		colorpp::ycbcr_to_rgb(expected.data(), expected.data(), 1, colorpp::YCbCrEnum::Bt709,
+			colorpp::RangeEnum::Limited, is_p010 ? 10 : 8);
+
+		std::vector<unsigned short> res(src.size());
+		if (is_p010)
+		{
+			ASSERT_FALSE(colorpp::rgb_to_planar(std::vector<unsigned char>(src.size()).data(), width * 3, frame));
+			ASSERT_TRUE(colorpp::rgb_to_planar(src.data(), width * 6, frame, colorpp::YCbCrEnum::Bt709));
+			ASSERT_TRUE(colorpp::planar_to_rgb(frame, res.data(), width * 6, colorpp::YCbCrEnum::Bt709));
+		}
+		else
+		{
+			std::vector<unsigned char> src8(src.begin(), src.end());
+			std::vector<unsigned char> res8(src.size());
+			ASSERT_TRUE(colorpp::rgb_to_planar(src8.data(), width * 3, frame));
+			ASSERT_TRUE(colorpp::planar_to_rgb(frame, res8.data(), width * 3));
+			res.assign(res8.begin(), res8.end());
+		}
+		for (size_t i = 0; i < res.size(); ++i)
+			ASSERT_EQ(res[i], expected[i % 3]) << "format " << static_cast<int>(format) << " sample " << i;
+
+		// smooth gradient: round trip stays close
+		for (size_t y = 0; y < height; ++y)
+			for (size_t x = 0; x < width; ++x)
+			{
+				auto i = 3 * (y * width + x);
+				src[i] = static_cast<unsigned short>(max_value * x / width);
+				src[i + 1] = static_cast<unsigned short>(max_value * y / height);
+				src[i + 2] = static_cast<unsigned short>(max_value / 2);
+			}
+		if (is_p010)
+		{
+			colorpp::rgb_to_planar(src.data(), width * 6, frame);
+			colorpp::planar_to_rgb(frame, res.data(), width * 6);
+		}
+		else
+		{
+			std::vector<unsigned char> src8(src.begin(), src.end());
+			std::vector<unsigned char> res8(src.size());
+			colorpp::rgb_to_planar(src8.data(), width * 3, frame);
+			colorpp::planar_to_rgb(frame, res8.data(), width * 3);
+			res.assign(res8.begin(), res8.end());
+		}
+		int tolerance = max_value / 255 * 8;
+		for (size_t i = 0; i < res.size(); ++i)
+			ASSERT_LE(std::abs(static_cast<int>(res[i]) - static_cast<int>(src[i])), tolerance) <<
+				"format " << static_cast<int>(format) << " sample " << i;
+	}
+
+	// down and up sampling use the same chroma sites: a horizontal ramp isn't shifted
+	std::vector<unsigned char> data(colorpp::get_planar_size(colorpp::PlanarEnum::I420, width, height));
+	auto frame = colorpp::get_planar_frame(colorpp::PlanarEnum::I420, width, height, data.data());
+	std::vector<unsigned char> ramp(width * height * 3), res(ramp.size());
+	for (size_t y = 0; y < height; ++y)
+		for (size_t x = 0; x < width; ++x)
+		{
+			auto i = 3 * (y * width + x);
+			ramp[i] = static_cast<unsigned char>(20 + 3 * x);
+			ramp[i + 1] = 128;
+			ramp[i + 2] = static_cast<unsigned char>(230 - 3 * x);
+		}
+	colorpp::rgb_to_planar(ramp.data(), width * 3, frame);
+	colorpp::planar_to_rgb(frame, res.data(), width * 3);
+	double bias = 0.;
+	for (size_t y = 0; y < height; ++y)
+		for (size_t x = 2; x + 2 < width; ++x)
+		{
+			auto i = 3 * (y * width + x);
+			bias += static_cast<int>(res[i]) - static_cast<int>(ramp[i]);
+		}
+	EXPECT_LT(std::abs(bias / (height * (width - 4))), 0.5);
+}
+
+TEST(parallel_for, colorpp_proc_test)
+{
+	std::vector<int> items(100000);
+	colorpp::set_thread_count(4);
+	ASSERT_EQ(colorpp::get_thread_count(), 4u);
+	colorpp::parallel_for(items.size(), 16, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			items[i] += 1;
+		// nested calls run on the current thread
+		colorpp::parallel_for(2, 1, [](size_t, size_t) {});
+	});
+	for (auto item : items)
+		ASSERT_EQ(item, 1);
+
+	// exceptions of any thread reach the caller, and the pool keeps working
+	for (size_t fail : {size_t(0), size_t(50000), size_t(99999)})
+	{
+		EXPECT_THROW(colorpp::parallel_for(items.size(), 16, [&](size_t begin, size_t end) {
+			if (begin <= fail && fail < end)
+				throw std::runtime_error("chunk");
+		}), std::runtime_error) << fail;
+	}
+	EXPECT_THROW(colorpp::parallel_for(4, 16, [](size_t, size_t) { throw std::runtime_error("serial"); }),
+		std::runtime_error);
+	colorpp::parallel_for(items.size(), 16, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			items[i] += 1;
+		colorpp::parallel_for(2, 1, [](size_t, size_t) {});
+	});
+	colorpp::set_thread_count(0);
+	for (auto item : items)
+		ASSERT_EQ(item, 2);
+}
+
+TEST(cct_to_white_to_cct, colorpp_proc_test)
+{
+	double x = 0.;
+	double y = 0.;
+	// CIE D65 and D50 chromaticities
+	ASSERT_TRUE(colorpp::cct_to_xy(6504., x, y));
+	EXPECT_NEAR(x, 0.3127, 2e-4);
+	EXPECT_NEAR(y, 0.3290, 2e-4);
+	ASSERT_TRUE(colorpp::cct_to_xy(5003., x, y));
+	EXPECT_NEAR(x, 0.3457, 2e-4);
+	EXPECT_NEAR(y, 0.3585, 2e-4);
+	EXPECT_FALSE(colorpp::cct_to_xy(3000., x, y));
+	ASSERT_TRUE(colorpp::cct_to_xy(3000., x, y, colorpp::LocusEnum::Planckian));
+
+	// illuminant A is a 2856 K black body
+	colorpp::XYZ white;
+	colorpp::get_ref_white(colorpp::IlluminantEnum::A, white);
+	EXPECT_NEAR(colorpp::xyz_to_cct(white[0], white[1], white[2]), 2856., 5.);
+	EXPECT_EQ(colorpp::xyz_to_cct(0., 0., 0.), -1.);
+
+	// colors off the locus have a CCT up to Duv 0.05
+	ASSERT_TRUE(colorpp::cct_to_white(5000., white, colorpp::LocusEnum::Planckian));
+	auto u0 = 4. * white[0] / (white[0] + 15. * white[1] + 3. * white[2]);
+	auto v0 = 6. * white[1] / (white[0] + 15. * white[1] + 3. * white[2]);
+	for (double dv : {-0.08, -0.02, 0.02, 0.08})
+	{
+		auto d = 2. * u0 - 8. * (v0 + dv) + 4.;
+		auto cx = 3. * u0 / d;
+		auto cy = 2. * (v0 + dv) / d;
+		auto cct = colorpp::xyz_to_cct(cx / cy, 1., (1. - cx - cy) / cy);
+		if (std::abs(dv) < 0.05)
+		{
+			EXPECT_GT(cct, 4000.) << dv;
+			EXPECT_LT(cct, 7000.) << dv;
+		}
+		else
+		{
+			EXPECT_EQ(cct, -1.) << dv;
+		}
+	}
+
+	for (int t = 1700; t <= 25000; t += 100)
+	{
+		ASSERT_TRUE(colorpp::cct_to_white(t, white, colorpp::LocusEnum::Planckian));
+		auto cct = colorpp::xyz_to_cct(white[0], white[1], white[2]);
+		ASSERT_NEAR(cct, t, t * 0.005) << "cct is: " << t;
+	}
+
+	// parameters for an arbitrary white are the illuminant ones with a new RefWhite
+	colorpp::get_ref_white(colorpp::IlluminantEnum::D65, white);
+	auto by_white = colorpp::get_rgb_params(colorpp::RgbEnum::AdobeRgb, colorpp::AdaptationEnum::amBradford, white);
+	auto by_illuminant = colorpp::get_rgb_params(colorpp::RgbEnum::AdobeRgb, colorpp::AdaptationEnum::amBradford,
+		colorpp::IlluminantEnum::D65);
+	double X1, Y1, Z1, X2, Y2, Z2;
+	colorpp::rgb_to_xyz(0.2, 0.5, 0.7, X1, Y1, Z1, by_white);
+	colorpp::rgb_to_xyz(0.2, 0.5, 0.7, X2, Y2, Z2, by_illuminant);
+	EXPECT_DOUBLE_EQ(X1, X2);
+	EXPECT_DOUBLE_EQ(Y1, Y2);
+	EXPECT_DOUBLE_EQ(Z1, Z2);
+
+	// direct edits of the white and the method don't leave stale matrices
+	auto edited = colorpp::get_rgb_params(colorpp::RgbEnum::AdobeRgb, colorpp::AdaptationEnum::amBradford,
+		colorpp::IlluminantEnum::D50);
+	for (int i = 0; i < 3; ++i)
+		edited.RefWhite[i] = white[i];
+	colorpp::rgb_to_xyz(0.2, 0.5, 0.7, X1, Y1, Z1, edited);
+	EXPECT_DOUBLE_EQ(X1, X2);
+	EXPECT_DOUBLE_EQ(Y1, Y2);
+	EXPECT_DOUBLE_EQ(Z1, Z2);
+	double r, g, b;
+	colorpp::xyz_to_rgb(X1, Y1, Z1, r, g, b, edited);
+	EXPECT_NEAR(r, 0.2, 1e-6);
+	EXPECT_NEAR(g, 0.5, 1e-6);
+	EXPECT_NEAR(b, 0.7, 1e-6);
+	edited.AdaptationMethod = colorpp::AdaptationEnum::amCat02;
+	auto by_cat02 = colorpp::get_rgb_params(colorpp::RgbEnum::AdobeRgb, colorpp::AdaptationEnum::amCat02,
+		colorpp::IlluminantEnum::D65);
+	colorpp::rgb_to_xyz(0.2, 0.5, 0.7, X1, Y1, Z1, edited);
+	colorpp::rgb_to_xyz(0.2, 0.5, 0.7, X2, Y2, Z2, by_cat02);
+	EXPECT_DOUBLE_EQ(X1, X2);
+	EXPECT_DOUBLE_EQ(Y1, Y2);
+	EXPECT_DOUBLE_EQ(Z1, Z2);
+}
+
+namespace
+{
+	void put_u32(std::vector<unsigned char>& data, size_t offset, uint32_t value)
+	{
+		for (int i = 0; i < 4; ++i)
+			data[offset + i] = static_cast<unsigned char>(value >> (24 - 8 * i));
+	}
+
+	// ICC tag: type signature, 4 reserved bytes (function type for 'para') and s15Fixed16 values
+	void put_tag(std::vector<unsigned char>& data, const char* type, uint32_t reserved, const std::vector<double>& values)
+	{
+		auto offset = data.size();
+		data.resize(offset + 8 + 4 * values.size());
+		std::copy(type, type + 4, data.begin() + offset);
+		put_u32(data, offset + 4, reserved);
+		for (size_t i = 0; i < values.size(); ++i)
+			put_u32(data, offset + 8 + 4 * i, static_cast<uint32_t>(static_cast<int32_t>(std::lround(values[i] * 65536.))));
+	}
+
+	// minimal ICC v4 sRGB matrix/TRC profile with a 'para' or a sampled 'curv' TRC
+	std::vector<unsigned char> make_icc_profile(bool sampled_trc)
+	{
+		const char* names[7] = {"rXYZ", "gXYZ", "bXYZ", "wtpt", "rTRC", "gTRC", "bTRC"};
+		std::vector<unsigned char> data(128 + 4 + 7 * 12);
+		std::copy_n("RGB XYZ ", 8, data.begin() + 16);
+		std::copy_n("acsp", 4, data.begin() + 36);
+		put_u32(data, 68, 63190);	// D50 PCS illuminant
+		put_u32(data, 72, 65536);
+		put_u32(data, 76, 54061);
+		put_u32(data, 128, 7);
+		size_t offsets[8];
+		offsets[0] = data.size();
+		put_tag(data, "XYZ ", 0, {0.4360747, 0.2225045, 0.0139322});
+		offsets[1] = data.size();
+		put_tag(data, "XYZ ", 0, {0.3850649, 0.7168786, 0.0971045});
+		offsets[2] = data.size();
+		put_tag(data, "XYZ ", 0, {0.1430804, 0.0606169, 0.7141733});
+		offsets[3] = data.size();
+		put_tag(data, "XYZ ", 0, {0.9642, 1.0, 0.8249});
+		offsets[4] = data.size();
+		if (sampled_trc)
+		{
+			const uint32_t count = 1024;
+			put_tag(data, "curv", 0, {});
+			data.resize(data.size() + 4 + 2 * count);
+			put_u32(data, offsets[4] + 8, count);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				auto v = std::lround(std::pow(static_cast<double>(i) / (count - 1), 1.8) * 65535.);
+				data[offsets[4] + 12 + 2 * i] = static_cast<unsigned char>(v >> 8);
+				data[offsets[4] + 13 + 2 * i] = static_cast<unsigned char>(v & 0xff);
+			}
+		}
+		else
+			// function type 3 is 0x00030000 in the first word after the reserved one
+			put_tag(data, "para", 0, {3., 2.4, 1. / 1.055, 0.055 / 1.055, 1. / 12.92, 0.04045});
+		offsets[5] = data.size();
+		for (int i = 0; i < 7; ++i)
+		{
+			// all three TRCs share one tag
+			auto begin = offsets[std::min(i, 4)];
+			auto end = offsets[std::min(i, 4) + 1];
+			std::copy_n(names[i], 4, data.begin() + 132 + 12 * i);
+			put_u32(data, 136 + 12 * i, static_cast<uint32_t>(begin));
+			put_u32(data, 140 + 12 * i, static_cast<uint32_t>(end - begin));
+		}
+		put_u32(data, 0, static_cast<uint32_t>(data.size()));
+		return data;
+	}
+}
+
+TEST(icc_rgb_to_xyz_to_rgb, colorpp_proc_test)
+{
+	colorpp::clear_icc_cache();
+	auto data = make_icc_profile(false);
+	auto transform = colorpp::get_icc_transform(data.data(), data.size());
+	ASSERT_TRUE(transform != nullptr);
+	EXPECT_TRUE(transform->UseGamma);
+	EXPECT_EQ(transform->Params.GammaRGB, -2.2);
+	// the same profile is compiled once
+	EXPECT_EQ(colorpp::get_icc_transform(data.data(), data.size()), transform);
+	// bytes after the declared size are not part of the profile
+	auto padded = data;
+	padded.resize(data.size() + 16, 0xFF);
+	EXPECT_EQ(colorpp::get_icc_transform(padded.data(), padded.size()), transform);
+	EXPECT_EQ(colorpp::get_icc_cache_size(), 1u);
+
+	auto sampled = make_icc_profile(true);
+	auto lut = colorpp::get_icc_transform(sampled.data(), sampled.size());
+	ASSERT_TRUE(lut != nullptr);
+	EXPECT_FALSE(lut->UseGamma);
+	EXPECT_EQ(colorpp::get_icc_cache_size(), 2u);
+
+	// ICC colorants are D50 adapted sRGB, Bradford from D65 matches them
+	auto params = colorpp::get_rgb_params(colorpp::RgbEnum::sRGB, colorpp::AdaptationEnum::amBradford,
+		colorpp::IlluminantEnum::D50);
+	for (double r = 0.; r <= 1.; r += 0.1)
+		for (double g = 0.; g <= 1.; g += 0.1)
+			for (double b = 0.; b <= 1.; b += 0.1)
+			{
+				double X1, Y1, Z1, X2, Y2, Z2;
+				colorpp::icc_rgb_to_xyz(r, g, b, X1, Y1, Z1, *transform);
+				colorpp::rgb_to_xyz(r, g, b, X2, Y2, Z2, params);
+				ASSERT_NEAR(X1, X2, 2e-3);
+				ASSERT_NEAR(Y1, Y2, 2e-3);
+				ASSERT_NEAR(Z1, Z2, 2e-3);
+
+				double R, G, B;
+				colorpp::icc_xyz_to_rgb(X1, Y1, Z1, R, G, B, *transform);
+				ASSERT_NEAR(R, r, 1e-5);
+				ASSERT_NEAR(G, g, 1e-5);
+				ASSERT_NEAR(B, b, 1e-5);
+
+				colorpp::icc_rgb_to_xyz(r, g, b, X1, Y1, Z1, *lut);
+				colorpp::icc_xyz_to_rgb(X1, Y1, Z1, R, G, B, *lut);
+				ASSERT_NEAR(R, r, 1e-4);
+				ASSERT_NEAR(G, g, 1e-4);
+				ASSERT_NEAR(B, b, 1e-4);
+			}
+	double X, Y, Z;
+	colorpp::icc_rgb_to_xyz(0.5, 0.5, 0.5, X, Y, Z, *lut);
+	EXPECT_NEAR(Y, std::pow(0.5, 1.8), 1e-4);
+
+	// not a profile
+	data[36] = 'x';
+	EXPECT_TRUE(colorpp::get_icc_transform(data.data(), data.size()) == nullptr);
+	EXPECT_TRUE(colorpp::load_icc_profile("no such profile.icc") == nullptr);
+	colorpp::clear_icc_cache();
+	EXPECT_EQ(colorpp::get_icc_cache_size(), 0u);
+}
+
+TEST(compand_to_inv_compand, colorpp_proc_test)
+{
+	// reference points of SMPTE ST 2084 and ARIB STD-B67
+	EXPECT_NEAR(colorpp::compand(100. / 10000., colorpp::TransferEnum::PQ), 0.5081, 1e-4);
+	EXPECT_NEAR(colorpp::compand(1., colorpp::TransferEnum::PQ), 1., 1e-12);
+	EXPECT_NEAR(colorpp::compand(1. / 12., colorpp::TransferEnum::HLG), 0.5, 1e-12);
+	EXPECT_NEAR(colorpp::compand(1., colorpp::TransferEnum::HLG), 1., 1e-7);
+	EXPECT_EQ(colorpp::get_rgb_params(colorpp::RgbEnum::Rec2100Pq).TransferRGB, colorpp::TransferEnum::PQ);
+	EXPECT_EQ(colorpp::get_rgb_params(colorpp::RgbEnum::sRGB).TransferRGB, colorpp::TransferEnum::sRGB);
+
+	// legacy GammaRGB codes edited after get_rgb_params still select the curves
+	auto params = colorpp::get_rgb_params(colorpp::RgbEnum::AdobeRgb);
+	params.GammaRGB = -2.2;
+	EXPECT_EQ(colorpp::get_transfer(params), colorpp::TransferEnum::sRGB);
+	params.GammaRGB = 0.;
+	EXPECT_EQ(colorpp::get_transfer(params), colorpp::TransferEnum::LStar);
+	double x, y, z, r, g, b;
+	colorpp::rgb_to_xyz(0.5, 0.5, 0.5, x, y, z, params);
+	EXPECT_NEAR(y, colorpp::inv_compand(0.5, colorpp::TransferEnum::LStar), 1e-6);
+	colorpp::xyz_to_rgb(x, y, z, r, g, b, params);
+	EXPECT_NEAR(g, 0.5, 1e-6);
+	params.GammaRGB = 1.8;
+	EXPECT_EQ(colorpp::get_transfer(params), colorpp::TransferEnum::Gamma);
+	// a gamma on an sRGB space is a pure power curve
+	params = colorpp::get_rgb_params(colorpp::RgbEnum::sRGB);
+	params.GammaRGB = 2.2;
+	EXPECT_EQ(colorpp::get_transfer(params), colorpp::TransferEnum::Gamma);
+	colorpp::rgb_to_xyz(0.5, 0.5, 0.5, x, y, z, params);
+	EXPECT_NEAR(y, std::pow(0.5, 2.2), 1e-6);
+	EXPECT_EQ(colorpp::get_transfer(colorpp::get_rgb_params(colorpp::RgbEnum::Rec2100Hlg)), colorpp::TransferEnum::HLG);
+
+	const colorpp::TransferEnum transfers[5] = {colorpp::TransferEnum::Gamma, colorpp::TransferEnum::sRGB,
+		colorpp::TransferEnum::LStar, colorpp::TransferEnum::PQ, colorpp::TransferEnum::HLG};
+	const size_t count = 100001;
+	std::vector<float> src(count), dst(count), res(count);
+	std::vector<unsigned short> codes(count);
+	for (size_t i = 0; i < count; ++i)
+		src[i] = static_cast<float>(std::pow(static_cast<double>(i) / (count - 1), 3.));
+	for (auto transfer : transfers)
+	{
+		for (size_t i = 0; i < count; i += 97)
+		{
+			double v = src[i];
+			ASSERT_NEAR(colorpp::inv_compand(colorpp::compand(v, transfer, 2.4), transfer, 2.4), v, 1e-12) <<
+				"transfer " << static_cast<int>(transfer);
+		}
+		colorpp::compand(src.data(), dst.data(), count, transfer, 2.4);
+		for (size_t i = 0; i < count; ++i)
+			ASSERT_NEAR(dst[i], colorpp::compand(src[i], transfer, 2.4), 1e-5) <<
+				"transfer " << static_cast<int>(transfer) << " sample " << src[i];
+		colorpp::inv_compand(dst.data(), res.data(), count, transfer, 2.4);
+		for (size_t i = 0; i < count; ++i)
+			ASSERT_NEAR(res[i], colorpp::inv_compand(dst[i], transfer, 2.4), 1e-6) <<
+				"transfer " << static_cast<int>(transfer) << " sample " << dst[i];
+
+		// 10-bit codes round trip exactly
+		for (size_t i = 0; i < 1024; ++i)
+			codes[i] = static_cast<unsigned short>(i);
+		colorpp::inv_compand(codes.data(), dst.data(), 1024, transfer, 10, 2.4);
+		colorpp::compand(dst.data(), codes.data(), 1024, transfer, 10, 2.4);
+		for (size_t i = 0; i < 1024; ++i)
+			ASSERT_EQ(codes[i], i) << "transfer " << static_cast<int>(transfer);
+
+		// NaN and infinities are clamped like out of range values
+		const float special[4] = {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(),
+			-std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::quiet_NaN()};
+		float out[4];
+		colorpp::compand(special, out, 4, transfer, 2.4);
+		EXPECT_EQ(out[0], 0.f);
+		EXPECT_NEAR(out[1], 1.f, 1e-6);
+		EXPECT_EQ(out[2], 0.f);
+		EXPECT_EQ(out[3], 0.f);
+		colorpp::inv_compand(special, out, 4, transfer, 2.4);
+		EXPECT_EQ(out[0], 0.f);
+		EXPECT_NEAR(out[1], 1.f, 1e-6);
+		EXPECT_EQ(out[2], 0.f);
+		EXPECT_EQ(out[3], 0.f);
+		unsigned short special_codes[4];
+		colorpp::compand(special, special_codes, 4, transfer, 10, 2.4);
+		EXPECT_EQ(special_codes[0], 0);
+		EXPECT_EQ(special_codes[1], 1023);
+		EXPECT_EQ(special_codes[2], 0);
+		EXPECT_EQ(special_codes[3], 0);
+	}
+
+	// gammas past the cached tables are built per call
+	for (int k = 0; k < 40; ++k)
+	{
+		double gamma = 1.5 + 0.01 * k;
+		unsigned short code = 512;
+		float linear;
+		colorpp::inv_compand(&code, &linear, 1, colorpp::TransferEnum::Gamma, 10, gamma);
+		ASSERT_NEAR(linear, std::pow(512. / 1023., gamma), 1e-6) << gamma;
+	}
+}
+
+TEST(tone_map, colorpp_batch_test)
+{
+	const size_t count = 50000;
+	std::vector<float> src(3 * count), dst(3 * count), res(3 * count);
+	for (size_t i = 0; i < 3 * count; ++i)
+		src[i] = static_cast<float>(10. * std::pow(static_cast<double>(i % 997) / 996., 2.));
+	src[3] = src[4] = src[5] = 10.f;
+
+	colorpp::ToneStats stats;
+	const double luma[3] = {0.2126, 0.7152, 0.0722};
+	colorpp::get_tone_stats(src.data(), count, luma, stats);
+	EXPECT_NEAR(stats.MaxLuminance, 10., 1e-4);
+	EXPECT_GT(stats.LogAverage, 0.);
+	EXPECT_LT(stats.LogAverage, 10.);
+
+	const colorpp::ToneMapEnum operators[4] = {colorpp::ToneMapEnum::Reinhard, colorpp::ToneMapEnum::Hable,
+		colorpp::ToneMapEnum::Aces, colorpp::ToneMapEnum::Bt2390};
+	for (auto op : operators)
+	{
+		auto params = colorpp::get_tone_map_params(op, colorpp::ToneModeEnum::PerChannel);
+		ASSERT_EQ(colorpp::need_tone_stats(params), op == colorpp::ToneMapEnum::Reinhard || op == colorpp::ToneMapEnum::Bt2390);
+		colorpp::tone_map(src.data(), dst.data(), count, params);
+		colorpp::set_tone_stats(params, stats);
+		EXPECT_NEAR(colorpp::tone_map(0., params), 0., 1e-6);
+		// the maximum is the white unless the white point is fixed (Hable)
+		if (op == colorpp::ToneMapEnum::Reinhard || op == colorpp::ToneMapEnum::Bt2390)
+		{
+			EXPECT_NEAR(colorpp::tone_map(10., params), 1., 1e-6) << "operator " << static_cast<int>(op);
+		}
+		for (size_t i = 0; i < 3 * count; ++i)
+			ASSERT_NEAR(dst[i], colorpp::tone_map(src[i], params), 1e-5) << "operator " << static_cast<int>(op);
+		for (double v = 0.; v < 10.; v += 0.01)
+			ASSERT_LE(colorpp::tone_map(v, params), colorpp::tone_map(v + 0.01, params) + 1e-12);
+
+		// out of gamut negatives of xyz_to_rgb go to black, away from the poles of the curves
+		const float negative[6] = {-3.f, -1.f, -0.5f, -0.125f, -1e-3f, -100.f};
+		float mapped[6];
+		colorpp::tone_map(negative, mapped, 2, params);
+		for (int i = 0; i < 6; ++i)
+		{
+			EXPECT_EQ(colorpp::tone_map(negative[i], params), 0.) << "operator " << static_cast<int>(op);
+			EXPECT_EQ(mapped[i], 0.f) << "operator " << static_cast<int>(op);
+		}
+
+		// fused companding matches the separate passes
+		colorpp::compand(dst.data(), dst.data(), 3 * count, colorpp::TransferEnum::sRGB);
+		colorpp::tone_map(src.data(), res.data(), count, params, colorpp::TransferEnum::sRGB);
+		for (size_t i = 0; i < 3 * count; ++i)
+			ASSERT_NEAR(res[i], dst[i], 1e-6);
+	}
+
+	// BT.2390 keeps the values below the knee and luminance mode keeps the hue
+	auto params = colorpp::get_tone_map_params(colorpp::ToneMapEnum::Bt2390);
+	params.SourcePeak = 10.;
+	EXPECT_NEAR(colorpp::tone_map(0.1, params), 0.1, 1e-9);
+	colorpp::tone_map(src.data(), dst.data(), count, params);
+	for (size_t i = 0; i < count; ++i)
+		if (src[3 * i] > 0.f && dst[3 * i] > 0.f)
+		{
+			ASSERT_NEAR(dst[3 * i + 1] / dst[3 * i], src[3 * i + 1] / src[3 * i], 1e-4);
+		}
+}
+
+TEST(adapt, colorpp_batch_test)
+{
+	colorpp::XYZ d65, d50;
+	colorpp::get_ref_white(colorpp::IlluminantEnum::D65, d65);
+	colorpp::get_ref_white(colorpp::IlluminantEnum::D50, d50);
+	const colorpp::AdaptationEnum methods[5] = {colorpp::AdaptationEnum::amBradford, colorpp::AdaptationEnum::amVonKries,
+		colorpp::AdaptationEnum::amXYZScaling, colorpp::AdaptationEnum::amCat02, colorpp::AdaptationEnum::amCat16};
+	const size_t count = 1000;
+	std::vector<float> src(3 * count), dst(3 * count);
+	for (size_t i = 0; i < 3 * count; ++i)
+		src[i] = static_cast<float>((i * 37 % 101) / 100.);
+	for (auto method : methods)
+	{
+		// the source white maps to the destination one and back
+		float white[3] = {static_cast<float>(d65[0]), static_cast<float>(d65[1]), static_cast<float>(d65[2])};
+		colorpp::adapt(white, white, 1, d65, d50, method);
+		for (int i = 0; i < 3; ++i)
+			ASSERT_NEAR(white[i], d50[i], 1e-6) << "method " << static_cast<int>(method);
+		colorpp::adapt(src.data(), dst.data(), count, d65, d50, method);
+		colorpp::adapt(dst.data(), dst.data(), count, d50, d65, method);
+		for (size_t i = 0; i < 3 * count; ++i)
+			ASSERT_NEAR(dst[i], src[i], 1e-5) << "method " << static_cast<int>(method);
+
+		// precomputed parameters match the adaptation of the unadapted conversion
+		auto params = colorpp::get_rgb_params(colorpp::RgbEnum::sRGB, method, colorpp::IlluminantEnum::D50);
+		auto none = colorpp::get_rgb_params(colorpp::RgbEnum::sRGB, colorpp::AdaptationEnum::amNone);
+		double X1, Y1, Z1, X2, Y2, Z2;
+		colorpp::rgb_to_xyz(0.2, 0.5, 0.7, X1, Y1, Z1, params);
+		colorpp::rgb_to_xyz(0.2, 0.5, 0.7, X2, Y2, Z2, none);
+		float xyz[3] = {static_cast<float>(X2), static_cast<float>(Y2), static_cast<float>(Z2)};
+		colorpp::adapt(xyz, xyz, 1, d65, d50, method);
+		EXPECT_NEAR(xyz[0], X1, 1e-6);
+		EXPECT_NEAR(xyz[1], Y1, 1e-6);
+		EXPECT_NEAR(xyz[2], Z1, 1e-6);
+	}
+
+	// no adaptation leaves the pixels alone whatever the whites
+	float gray[3] = {0.5f, 0.5f, 0.5f};
+	colorpp::adapt(gray, gray, 1, d65, d50, colorpp::AdaptationEnum::amNone);
+	for (int i = 0; i < 3; ++i)
+		EXPECT_EQ(gray[i], 0.5f);
+	colorpp::Mtx3x3 m;
+	colorpp::get_adaptation_matrix(colorpp::AdaptationEnum::amNone, d65, d50, m);
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 3; ++j)
+			EXPECT_EQ(m[i][j], i == j ? 1. : 0.);
+}
+
+TEST(submit, colorpp_proc_test)
+{
+	colorpp::set_job_thread_count(4);
+	ASSERT_EQ(colorpp::get_job_thread_count(), 4u);
+
+	// many tiny jobs
+	std::vector<std::future<int>> results;
+	for (int i = 0; i < 10000; ++i)
+		results.push_back(colorpp::submit([i] { return i * 2; }));
+	for (int i = 0; i < 10000; ++i)
+		ASSERT_EQ(results[i].get(), i * 2);
+
+	// a large job split into parts running batch kernels
+	const size_t count = 300000;
+	std::vector<unsigned char> src(3 * count), dst(3 * count), ref(3 * count);
+	for (size_t i = 0; i < 3 * count; ++i)
+		src[i] = static_cast<unsigned char>(i * 7);
+	colorpp::rgb_to_ycbcr(src.data(), ref.data(), count);
+	std::atomic<size_t> parts{0};
+	colorpp::submit(count, 1024, [&](size_t begin, size_t end) {
+		colorpp::rgb_to_ycbcr(src.data() + 3 * begin, dst.data() + 3 * begin, end - begin);
+		++parts;
+	}).get();
+	EXPECT_GT(parts.load(), 1u);
+	EXPECT_EQ(dst, ref);
+	colorpp::submit(0, 1, [](size_t, size_t) {}).get();
+	colorpp::set_job_thread_count(0);
+}
+
+TEST(quantize, colorpp_batch_test)
+{
+	const size_t width = 256;
+	const size_t height = 64;
+	const size_t channels = 3;
+	const size_t stride = width * channels;
+	std::vector<float> src(stride * height, static_cast<float>(100.3 / 256.));
+	std::vector<unsigned char> dst(stride * height);
+	std::vector<unsigned char> ref(stride * height);
+
+	// truncation matches from_dbl
+	ASSERT_TRUE(colorpp::quantize(src.data(), stride * sizeof(float), dst.data(), stride, width, height, channels,
+		colorpp::DitherEnum::None));
+	for (auto v : dst)
+		ASSERT_EQ(v, colorpp::from_dbl<colorpp::byte>(100.3 / 256.));
+
+	// dithered codes average to the value
+	const colorpp::DitherEnum methods[3] = {colorpp::DitherEnum::Bayer, colorpp::DitherEnum::BlueNoise,
+		colorpp::DitherEnum::FloydSteinberg};
+	for (auto method : methods)
+	{
+		ASSERT_TRUE(colorpp::quantize(src.data(), stride * sizeof(float), dst.data(), stride, width, height, channels, method));
+		double sum = 0.;
+		for (auto v : dst)
+		{
+			ASSERT_TRUE(v == 100 || v == 101) << "method " << static_cast<int>(method);
+			sum += v;
+		}
+		EXPECT_NEAR(sum / dst.size(), 100.3, 0.01) << "method " << static_cast<int>(method);
+	}
+
+	std::vector<unsigned short> words(stride * height);
+	ASSERT_TRUE(colorpp::quantize(src.data(), stride * sizeof(float), words.data(), stride * 2, width, height, channels,
+		colorpp::DitherEnum::BlueNoise, 10));
+	double sum = 0.;
+	for (auto v : words)
+		sum += v;
+	EXPECT_NEAR(sum / words.size(), 100.3 * 4., 0.01);
+
+	// the row pipeline gives the serial result
+	src = make_test_pixels(width * height, 1000, channels);
+	colorpp::set_thread_count(1);
+	colorpp::quantize(src.data(), stride * sizeof(float), ref.data(), stride, width, height, channels,
+		colorpp::DitherEnum::FloydSteinberg);
+	colorpp::set_thread_count(4);
+	colorpp::quantize(src.data(), stride * sizeof(float), dst.data(), stride, width, height, channels,
+		colorpp::DitherEnum::FloydSteinberg);
+	colorpp::set_thread_count(0);
+	EXPECT_EQ(dst, ref);
+
+	// NaN samples give 0 and leave their neighbors alone
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	const float holes[8] = {nan, 0.5f, nan, 1.f, 0.f, nan, 1.f, nan};
+	unsigned char codes[8];
+	const colorpp::DitherEnum all[4] = {colorpp::DitherEnum::None, colorpp::DitherEnum::Bayer,
+		colorpp::DitherEnum::BlueNoise, colorpp::DitherEnum::FloydSteinberg};
+	for (auto method : all)
+	{
+		ASSERT_TRUE(colorpp::quantize(holes, 4 * sizeof(float), codes, 4, 4, 2, 1, method));
+		for (int i = 0; i < 8; ++i)
+		{
+			if (std::isnan(holes[i]))
+			{
+				EXPECT_EQ(codes[i], 0) << "method " << static_cast<int>(method);
+			}
+			else
+			{
+				EXPECT_NEAR(codes[i], holes[i] * 255.f, 1.f) << "method " << static_cast<int>(method);
+			}
+		}
+	}
+
+	EXPECT_FALSE(colorpp::quantize(src.data(), stride * sizeof(float), dst.data(), stride, width, height, 5,
+		colorpp::DitherEnum::Bayer));
+}
+
+TEST(kernel_stats, colorpp_proc_test)
+{
+	colorpp::reset_kernel_stats();
+	colorpp::set_trace_enabled(true);
+	const float src[6] = {0.25f, 0.5f, 1.5f, -0.5f, 0.f, 1.f};
+	float dst[6];
+	colorpp::compand(src, dst, 6, colorpp::TransferEnum::sRGB);
+	colorpp::compand(src, dst, 3, colorpp::TransferEnum::sRGB);
+	colorpp::set_trace_enabled(false);
+
+	auto stats = colorpp::get_kernel_stats();
+	auto trace = colorpp::get_trace_json();
+	ASSERT_EQ(trace.find("{\"traceEvents\":["), 0u);
+	if (!colorpp::is_stats_enabled())
+	{
+		EXPECT_TRUE(stats.empty());
+		return;
+	}
+	auto it = std::find_if(stats.begin(), stats.end(),
+		[](const colorpp::KernelStats& s) { return s.Name == "compand/float"; });
+	ASSERT_TRUE(it != stats.end());
+	EXPECT_EQ(it->Calls, 2u);
+	EXPECT_EQ(it->Pixels, 9u);
+	EXPECT_EQ(it->Clipped, 3u);
+	EXPECT_NE(trace.find("\"name\":\"compand/float\",\"cat\":\"colorpp\",\"ph\":\"X\""), std::string::npos);
+
+	colorpp::reset_kernel_stats();
+	stats = colorpp::get_kernel_stats();
+	for (auto& s : stats)
+		EXPECT_EQ(s.Calls, 0u);
+}
+
+TEST(adjust, colorpp_batch_test)
+{
+	std::vector<float> src;
+	for (int r = 0; r <= 8; ++r)
+		for (int g = 0; g <= 8; ++g)
+			for (int b = 0; b <= 8; ++b)
+			{
+				src.push_back(r / 8.f);
+				src.push_back(g / 8.f);
+				src.push_back(b / 8.f);
+			}
+	size_t count = src.size() / 3;
+	std::vector<float> dst(src.size());
+
+	// HSV and HSL models give the round trip through the color models
+	const double hues[3] = {0., 77., -200.};
+	for (auto hue : hues)
+		for (int hsl = 0; hsl < 2; ++hsl)
+		{
+			auto params = colorpp::get_adjust_params(hsl ? colorpp::AdjustEnum::Hsl : colorpp::AdjustEnum::Hsv);
+			params.Hue = hue;
+			params.Saturation = 1.5;
+			params.Brightness = 0.8;
+			params.Contrast = 1.2;
+			colorpp::adjust(src.data(), dst.data(), count, params);
+			for (size_t i = 0; i < count; ++i)
+			{
+				double h, s, v, rgb[3];
+				if (hsl)
+					colorpp::rgb_to_hsl(src[3 * i], src[3 * i + 1], src[3 * i + 2], h, s, v);
+				else
+					colorpp::rgb_to_hsv(src[3 * i], src[3 * i + 1], src[3 * i + 2], h, s, v);
+				h = std::fmod(h + hue / 360. + 1., 1.);
+				s = std::min(s * params.Saturation, 1.);
+				v = std::min(v * params.Brightness, 1.);
+				if (hsl)
+					colorpp::hsl_to_rgb(h, s, v, rgb[0], rgb[1], rgb[2]);
+				else
+					colorpp::hsv_to_rgb(h, s, v, rgb[0], rgb[1], rgb[2]);
+				for (int c = 0; c < 3; ++c)
+					ASSERT_NEAR(dst[3 * i + c], std::min(std::max((rgb[c] - 0.5) * 1.2 + 0.5, 0.), 1.), 1e-5)
+						<< "hsl " << hsl << " hue " << hue << " pixel " << i;
+			}
+		}
+
+	// Luminance model keeps the luminance and the grays
+	auto params = colorpp::get_adjust_params();
+	params.Hue = 120.;
+	params.Saturation = 0.7;
+	const float colors[6] = {0.6f, 0.4f, 0.4f, 0.3f, 0.3f, 0.3f};
+	float out[6];
+	colorpp::adjust(colors, out, 2, params);
+	auto luma = [&](const float* p) { return params.Luma[0] * p[0] + params.Luma[1] * p[1] + params.Luma[2] * p[2]; };
+	EXPECT_NEAR(luma(out), luma(colors), 1e-6);
+	EXPECT_GT(out[1], out[0]);
+	EXPECT_GT(out[1], out[2]);
+	for (int c = 3; c < 6; ++c)
+		EXPECT_NEAR(out[c], 0.3f, 1e-6);
+
+	// neutral parameters keep 8-bit images
+	std::vector<unsigned char> bytes(3 * 256), result(bytes.size());
+	for (size_t i = 0; i < bytes.size(); ++i)
+		bytes[i] = static_cast<unsigned char>(i * 7);
+	const colorpp::AdjustEnum modes[3] = {colorpp::AdjustEnum::Luminance, colorpp::AdjustEnum::Hsv, colorpp::AdjustEnum::Hsl};
+	for (auto mode : modes)
+	{
+		colorpp::adjust(bytes.data(), result.data(), 256, colorpp::get_adjust_params(mode));
+		EXPECT_EQ(result, bytes) << "mode " << static_cast<int>(mode);
+	}
+}
+
+TEST(map_gradient, colorpp_batch_test)
+{
+	const colorpp::GradientStop stops[3] = {{1.0, {0., 0., 1.}}, {0.0, {1., 0., 0.}}, {0.25, {0.5, 0.5, 0.5}}};
+	// shortest hue arc from red to blue goes through magenta
+	auto hsv = colorpp::get_gradient(colorpp::GradientEnum::Hsv, stops, 2);
+	double rgb[3];
+	colorpp::get_gradient_color(hsv, 0.5, rgb);
+	EXPECT_NEAR(rgb[0], 1., 1e-9);
+	EXPECT_NEAR(rgb[1], 0., 1e-9);
+	EXPECT_NEAR(rgb[2], 1., 1e-9);
+	// stops are sorted and the ends are clamped
+	colorpp::get_gradient_color(hsv, -1., rgb);
+	EXPECT_EQ(rgb[0], 1.);
+	EXPECT_EQ(rgb[2], 0.);
+
+	// gray stops keep the hue of the other stop
+	auto hsl = colorpp::get_gradient(colorpp::GradientEnum::Hsl, stops + 1, 2);
+	colorpp::get_gradient_color(hsl, 0.125, rgb);
+	EXPECT_GT(rgb[0], rgb[1]);
+	EXPECT_NEAR(rgb[1], rgb[2], 1e-9);
+
+	// Lab endpoints round trip
+	const colorpp::GradientStop bw[2] = {{0.0, {0., 0., 0.}}, {1.0, {1., 1., 1.}}};
+	auto lab = colorpp::get_gradient(colorpp::GradientEnum::Lab, bw, 2);
+	colorpp::get_gradient_color(lab, 1.0, rgb);
+	EXPECT_NEAR(rgb[1], 1., 1e-6);
+	colorpp::get_gradient_color(lab, 0.5, rgb);
+	EXPECT_NEAR(rgb[1], 0.4663, 1e-3);	// L* = 50
+
+	auto lut = colorpp::bake_gradient(colorpp::get_gradient(colorpp::GradientEnum::Rgb, bw, 2), 4096, -1., 1.);
+	ASSERT_EQ(lut.Size, 4096u);
+	const float samples[5] = {-1.f, 0.f, 1.f, 7.f, std::nanf("")};
+	unsigned char bytes[15];
+	float floats[15];
+	colorpp::map_gradient(samples, bytes, 5, lut);
+	colorpp::map_gradient(samples, floats, 5, lut);
+	EXPECT_EQ(bytes[0], 0);
+	EXPECT_EQ(bytes[3], 128);
+	EXPECT_EQ(bytes[6], 255);
+	EXPECT_EQ(bytes[9], 255);
+	EXPECT_EQ(bytes[12], 0);
+	EXPECT_NEAR(floats[4], 0.5f, 1e-3f);
+	EXPECT_EQ(floats[7], 1.f);
+
+	const unsigned short codes[3] = {0, 512, 1023};
+	lut = colorpp::bake_gradient(colorpp::get_gradient(colorpp::GradientEnum::Rgb, bw, 2), 256);
+	colorpp::map_gradient(codes, bytes, 3, lut, 10);
+	EXPECT_EQ(bytes[0], 0);
+	EXPECT_EQ(bytes[3], 128);
+	EXPECT_EQ(bytes[6], 255);
+
+	// parallel mapping of a large field
+	std::vector<float> field(1 << 20);
+	for (size_t i = 0; i < field.size(); ++i)
+		field[i] = static_cast<float>(i) / field.size();
+	std::vector<unsigned char> image(3 * field.size());
+	colorpp::map_gradient(field.data(), image.data(), field.size(), lut);
+	for (size_t i = 0; i < field.size(); i += 997)
+		ASSERT_EQ(image[3 * i], lut.Rgb256[3 * static_cast<size_t>(field[i] * 255.f + 0.5f)]);
+}
+
+TEST(lut_rgb_to_hsv, colorpp_class_test)
+{
+	EXPECT_EQ(colorpp::get_color_lut_memory(colorpp::ColorLutEnum::HsvToRgb), 0u);
+	// bit-identical to the template conversion on every third level of the channels
+	for (int r = 0; r < 256; r += 3)
+		for (int g = 0; g < 256; g += 3)
+			for (int b = 0; b < 256; b += 3)
+			{
+				colorpp::rgb256 rgb(static_cast<unsigned char>(r), static_cast<unsigned char>(g),
+					static_cast<unsigned char>(b));
+				colorpp::hsv360_100 hsv(rgb);
+				auto lut_hsv = colorpp::lut_rgb_to_hsv(rgb);
+				ASSERT_TRUE(hsv.get_hue() == lut_hsv.get_hue() && hsv.get_saturation() == lut_hsv.get_saturation() &&
+					hsv.get_value() == lut_hsv.get_value()) << rgb;
+				colorpp::hsl360_100 hsl(rgb);
+				auto lut_hsl = colorpp::lut_rgb_to_hsl(rgb);
+				ASSERT_TRUE(hsl.get_hue() == lut_hsl.get_hue() && hsl.get_saturation() == lut_hsl.get_saturation() &&
+					hsl.get_lightness() == lut_hsl.get_lightness()) << rgb;
+			}
+	EXPECT_EQ(colorpp::get_color_lut_memory(colorpp::ColorLutEnum::RgbToHsv), 3u << 24);
+
+	// every model color back to RGB, in batches
+	std::vector<colorpp::hsv360_100> hsv;
+	std::vector<colorpp::hsl360_100> hsl;
+	for (unsigned short h = 0; h <= 360; ++h)
+		for (unsigned char s = 0; s <= 100; ++s)
+			for (unsigned char x = 0; x <= 100; ++x)
+			{
+				hsv.emplace_back(h, s, x);
+				hsl.emplace_back(h, s, x);
+			}
+	hsv.emplace_back(500, 200, 100);
+	std::vector<colorpp::rgb256> rgb(hsv.size());
+	colorpp::lut_hsv_to_rgb(hsv.data(), rgb.data(), hsv.size());
+	for (size_t i = 0; i < hsv.size(); ++i)
+	{
+		colorpp::rgb256 ref(hsv[i]);
+		ASSERT_TRUE(ref.get_red() == rgb[i].get_red() && ref.get_green() == rgb[i].get_green() &&
+			ref.get_blue() == rgb[i].get_blue()) << hsv[i];
+	}
+	colorpp::lut_hsl_to_rgb(hsl.data(), rgb.data(), hsl.size());
+	for (size_t i = 0; i < hsl.size(); ++i)
+	{
+		colorpp::rgb256 ref(hsl[i]);
+		ASSERT_TRUE(ref.get_red() == rgb[i].get_red() && ref.get_green() == rgb[i].get_green() &&
+			ref.get_blue() == rgb[i].get_blue()) << hsl[i];
+	}
+	EXPECT_EQ(colorpp::get_color_lut_memory(colorpp::ColorLutEnum::HsvToRgb), 3u * 361 * 101 * 101);
+}
+
+TEST(get_cached_table, colorpp_proc_test)
+{
+	EXPECT_FALSE(colorpp::set_lut_cache_dir("./no/such/dir"));
+	EXPECT_TRUE(colorpp::get_lut_cache_dir().empty());
+	ASSERT_TRUE(colorpp::set_lut_cache_dir("."));
+
+	const std::string key = "test/get_cached_table/1";
+	const size_t size = 10007;
+	size_t builds = 0;
+	auto build = [&builds, size](unsigned char* out) {
+		++builds;
+		for (size_t i = 0; i < size; ++i)
+			out[i] = static_cast<unsigned char>(i * 7);
+	};
+	std::remove(colorpp::get_lut_cache_path(key).c_str());
+	auto table = colorpp::get_cached_table(key, size, build);
+	ASSERT_TRUE(table.Data != nullptr);
+	EXPECT_EQ(builds, 1u);
+	EXPECT_EQ(table.Size, size);
+	std::vector<unsigned char> ref(size);
+	build(ref.data());
+	--builds;
+	EXPECT_EQ(std::memcmp(table.Data, ref.data(), size), 0);
+
+	// the second use maps the stored file
+	auto mapped = colorpp::get_cached_table(key, size, build);
+	EXPECT_EQ(builds, 1u);
+	ASSERT_TRUE(mapped.Data != nullptr);
+	EXPECT_EQ(std::memcmp(mapped.Data, ref.data(), size), 0);
+	EXPECT_TRUE(colorpp::load_cached_table(key, size + 1).Data == nullptr);
+	EXPECT_TRUE(colorpp::load_cached_table("test/get_cached_table/2", size).Data == nullptr);
+
+	// a damaged payload fails the checksum and the table is rebuilt
+	auto file = std::fopen(colorpp::get_lut_cache_path(key).c_str(), "r+b");
+	ASSERT_TRUE(file != nullptr);
+	std::fseek(file, -1, SEEK_END);
+	std::fputc(0x55, file);
+	std::fclose(file);
+	EXPECT_TRUE(colorpp::load_cached_table(key, size).Data == nullptr);
+	auto rebuilt = colorpp::get_cached_table(key, size, build);
+	EXPECT_EQ(builds, 2u);
+	ASSERT_TRUE(rebuilt.Data != nullptr);
+	EXPECT_EQ(std::memcmp(rebuilt.Data, ref.data(), size), 0);
+	EXPECT_TRUE(colorpp::load_cached_table(key, size).Data != nullptr);
+
+	// tables written by another build of the library are not used
+	file = std::fopen(colorpp::get_lut_cache_path(key).c_str(), "r+b");
+	ASSERT_TRUE(file != nullptr);
+	// the build hash follows the magic, version and byte order mark
+	std::fseek(file, 16, SEEK_SET);
+	auto build_byte = std::fgetc(file);
+	std::fseek(file, 16, SEEK_SET);
+	std::fputc(build_byte ^ 1, file);
+	std::fclose(file);
+	EXPECT_TRUE(colorpp::load_cached_table(key, size).Data == nullptr);
+
+	// without the cache tables are built in memory
+	std::remove(colorpp::get_lut_cache_path(key).c_str());
+	colorpp::set_lut_cache_dir("");
+	auto built = colorpp::get_cached_table(key, size, build);
+	EXPECT_EQ(builds, 3u);
+	EXPECT_FALSE(built.IsMapped);
+	EXPECT_EQ(std::memcmp(built.Data, ref.data(), size), 0);
+}
+
+TEST(convert, colorpp_class_test)
+{
+	static_assert(colorpp::get_conversion_steps<colorpp::rgb, colorpp::rgb256>() == 0, "same model");
+	static_assert(colorpp::get_conversion_steps<colorpp::hsv, colorpp::rgb256>() == 1, "direct");
+	static_assert(colorpp::get_conversion_steps<colorpp::hsl360_100, colorpp::hsv360_100>() == 1, "direct");
+	static_assert(colorpp::get_conversion_steps<colorpp::ycbcr601, colorpp::hsv360_100>() == 2, "through RGB");
+	static_assert(colorpp::get_conversion_steps<colorpp::ycbcr601, colorpp::ycbcr709>() == 2, "through RGB");
+	static_assert(colorpp::get_conversion_steps<colorpp::oklch100_360, colorpp::rgb256>() == 2, "through Oklab");
+	static_assert(colorpp::get_conversion_steps<colorpp::hwb360_100, colorpp::hsv360_100>() == 1, "direct");
+	static_assert(colorpp::get_conversion_steps<colorpp::cmyk100, colorpp::hsi360_100>() == 2, "through RGB");
+
+	for (unsigned short h = 0; h <= 360; h += 7)
+		for (unsigned char s = 0; s <= 100; s += 3)
+			for (unsigned char v = 0; v <= 100; v += 3)
+			{
+				colorpp::hsv360_100 hsv(h, s, v);
+				// one step is the constructor
+				auto rgb = colorpp::convert<colorpp::rgb256>(hsv);
+				colorpp::rgb256 ref(hsv);
+				ASSERT_TRUE(rgb.get_red() == ref.get_red() && rgb.get_green() == ref.get_green() &&
+					rgb.get_blue() == ref.get_blue()) << hsv;
+				auto hsl = colorpp::convert<colorpp::hsl360_100>(hsv);
+				colorpp::hsl360_100 ref_hsl(hsv);
+				ASSERT_TRUE(hsl.get_hue() == ref_hsl.get_hue() && hsl.get_saturation() == ref_hsl.get_saturation() &&
+					hsl.get_lightness() == ref_hsl.get_lightness()) << hsv;
+				// two steps don't quantize the intermediate RGB
+				auto ycbcr = colorpp::convert<colorpp::ycbcr601>(hsv);
+				colorpp::rgb mid(hsv);
+				colorpp::ycbcr601 ref_ycbcr(mid);
+				ASSERT_TRUE(ycbcr.get_luma() == ref_ycbcr.get_luma() && ycbcr.get_cb() == ref_ycbcr.get_cb() &&
+					ycbcr.get_cr() == ref_ycbcr.get_cr()) << hsv;
+				auto back = colorpp::convert<colorpp::hsv>(colorpp::convert<colorpp::hsl>(hsv));
+				EXPECT_NEAR(back.get_value(), v / 101., 1e-9);
+			}
+
+	// same model only requantizes
+	auto rgb = colorpp::convert<colorpp::rgb256>(colorpp::rgb(0.5, 1.0, 0.0));
+	EXPECT_TRUE(rgb.get_red() == 128 && rgb.get_green() == 255 && rgb.get_blue() == 0);
+	auto ycbcr = colorpp::convert<colorpp::ycbcr709>(colorpp::ycbcr601(colorpp::rgb256(255, 255, 255)));
+	EXPECT_EQ(ycbcr.get_luma(), 235);
+}
+
+TEST(arena_buffer, colorpp_proc_test)
+{
+	colorpp::release_arena_memory();
+	auto before = colorpp::get_arena_stats();
+	void* first = nullptr;
+	{
+		colorpp::ArenaBuffer<float> buffer(1000);
+		ASSERT_TRUE(buffer.data() != nullptr);
+		EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.data()) % 64, 0u);
+		EXPECT_EQ(buffer.size(), 1000u);
+		std::fill(buffer.data(), buffer.data() + buffer.size(), 1.f);
+		first = buffer.data();
+		// nested buffers get their own blocks
+		colorpp::ArenaBuffer<float> nested(1000);
+		EXPECT_NE(nested.data(), buffer.data());
+		EXPECT_GE(colorpp::get_arena_stats().InUse, before.InUse + 8192);
+	}
+	// the block is reused by the next buffer of the size class
+	{
+		colorpp::ArenaBuffer<unsigned char> buffer(3000);
+		EXPECT_EQ(static_cast<void*>(buffer.data()), first);
+	}
+	auto stats = colorpp::get_arena_stats();
+	EXPECT_EQ(stats.InUse, before.InUse);
+	EXPECT_GE(stats.Peak, before.InUse + 8192);
+	EXPECT_EQ(stats.Allocations - before.Allocations, 3u);
+	EXPECT_EQ(stats.Misses - before.Misses, 2u);
+	colorpp::ArenaBuffer<int> empty(0);
+	EXPECT_EQ(empty.size(), 0u);
+
+	// large blocks may go to huge pages, regular ones if they are unavailable
+	colorpp::set_arena_huge_pages(colorpp::HugePageEnum::Transparent, 1 << 20);
+	{
+		colorpp::ArenaBuffer<float> frame(3840 * 2160 * 3);
+		frame[frame.size() - 1] = 1.f;
+		EXPECT_EQ(reinterpret_cast<uintptr_t>(frame.data()) % 64, 0u);
+	}
+	colorpp::set_arena_huge_pages(colorpp::HugePageEnum::Explicit, 1 << 21);
+	{
+		colorpp::ArenaBuffer<float> frame(1 << 20);
+		frame[0] = 1.f;
+	}
+	// blocks below the huge page size take a whole page
+	colorpp::set_arena_huge_pages(colorpp::HugePageEnum::Explicit, 4096);
+	{
+		colorpp::ArenaBuffer<float> small(1000);
+		small[small.size() - 1] = 1.f;
+		EXPECT_EQ(colorpp::get_arena_stats().HugePages % (2 << 20), 0u);
+	}
+	colorpp::set_arena_huge_pages(colorpp::HugePageEnum::None);
+	colorpp::release_arena_memory();
+	stats = colorpp::get_arena_stats();
+	EXPECT_EQ(stats.Reserved, before.Reserved);
+
+	// blocks over the cache limit are freed on release
+	colorpp::set_arena_cache_limit(1 << 20);
+	{
+		colorpp::ArenaBuffer<float> small(1000);
+		colorpp::ArenaBuffer<float> large(1 << 20);
+	}
+	EXPECT_EQ(colorpp::get_arena_stats().Reserved, before.Reserved + 4096);
+	colorpp::set_arena_cache_limit(64 << 20);
+
+	// the caches of the other threads are trimmed too
+	std::promise<void> cached, trimmed;
+	std::thread worker([&]()
+	{
+		{
+			colorpp::ArenaBuffer<float> buffer(1 << 16);
+		}
+		cached.set_value();
+		trimmed.get_future().wait();
+	});
+	cached.get_future().wait();
+	EXPECT_EQ(colorpp::get_arena_stats().Reserved, before.Reserved + 4096 + (1 << 18));
+	colorpp::release_arena_memory();
+	EXPECT_EQ(colorpp::get_arena_stats().Reserved, before.Reserved);
+	trimmed.set_value();
+	worker.join();
+	stats = colorpp::get_arena_stats();
+	colorpp::reset_arena_peak();
+	EXPECT_EQ(colorpp::get_arena_stats().Peak, stats.InUse);
+}
+
+TEST(run_pipeline, colorpp_batch_test)
+{
+	const size_t count = 100003;
+	auto src = make_test_pixels(count, 1000);
+	auto params = colorpp::get_rgb_params(colorpp::RgbEnum::sRGB, colorpp::AdaptationEnum::amBradford,
+		colorpp::IlluminantEnum::D50);
+
+	// single stage against the scalar conversion
+	colorpp::Pipeline pipeline{{colorpp::get_rgb_to_xyz_stage(params)}, 0};
+	std::vector<float> xyz(3 * count);
+	colorpp::run_pipeline(pipeline, src.data(), xyz.data(), count);
+	for (size_t i = 0; i < count; i += 101)
+	{
+		double x, y, z;
+		colorpp::rgb_to_xyz(src[3 * i], src[3 * i + 1], src[3 * i + 2], x, y, z, params);
+		ASSERT_NEAR(xyz[3 * i], x, 1e-4) << i;
+		ASSERT_NEAR(xyz[3 * i + 1], y, 1e-4) << i;
+		ASSERT_NEAR(xyz[3 * i + 2], z, 1e-4) << i;
+	}
+
+	// RGB -> XYZ -> Lab -> XYZ -> RGB round trip
+	pipeline.Stages.push_back(colorpp::get_xyz_to_lab_stage(params.RefWhite));
+	pipeline.Stages.push_back(colorpp::get_lab_to_xyz_stage(params.RefWhite));
+	pipeline.Stages.push_back(colorpp::get_xyz_to_rgb_stage(params));
+	std::vector<float> dst(3 * count);
+	colorpp::run_pipeline(pipeline, src.data(), dst.data(), count);
+	for (size_t i = 0; i < dst.size(); ++i)
+		ASSERT_NEAR(dst[i], src[i], 1e-3) << i;
+
+	// strips give the same result as whole stages, in place too
+	pipeline.Stages.insert(pipeline.Stages.begin() + 2, [](const float* s, float* d, size_t n) {
+		for (size_t i = 0; i < n; ++i)
+		{
+			d[3 * i] = s[3 * i];
+			d[3 * i + 1] = 0.5f * s[3 * i + 1];
+			d[3 * i + 2] = 0.5f * s[3 * i + 2];
+		}
+	});
+	auto adjust = colorpp::get_adjust_params();
+	adjust.Hue = 30.;
+	pipeline.Stages.push_back(colorpp::get_adjust_stage(adjust));
+	pipeline.StripPixels = count;
+	std::vector<float> whole(3 * count);
+	colorpp::run_pipeline(pipeline, src.data(), whole.data(), count);
+	for (size_t strip : {size_t(0), size_t(1000), size_t(4099)})
+	{
+		pipeline.StripPixels = strip;
+		std::copy(src.begin(), src.end(), dst.begin());
+		colorpp::run_pipeline(pipeline, dst.data(), dst.data(), count);
+		ASSERT_TRUE(dst == whole) << strip;
+	}
+	EXPECT_GE(colorpp::get_strip_pixels(), 1024u);
+}
+
+TEST(spectrum_to_xyz, colorpp_batch_test)
+{
+	// the tables reproduce the library whites before scaling
+	auto format = colorpp::get_spectral_format();
+	std::vector<double> spd(format.Count);
+	colorpp::SpectralWeights weights;
+	ASSERT_TRUE(colorpp::get_illuminant_spectrum(colorpp::IlluminantEnum::D65, format, spd.data()));
+	ASSERT_TRUE(colorpp::get_spectral_weights(spd.data(), format, weights));
+	colorpp::XYZ white;
+	colorpp::get_ref_white(colorpp::IlluminantEnum::D65, white);
+	for (int j = 0; j < 3; ++j)
+		EXPECT_NEAR(weights.White[j], white[j], 1e-3);
+
+	// the measured tables are close to the library whites too, the fluorescent ones at 5 nm
+	const colorpp::IlluminantEnum measured[] = {colorpp::IlluminantEnum::B, colorpp::IlluminantEnum::C,
+		colorpp::IlluminantEnum::F2, colorpp::IlluminantEnum::F7, colorpp::IlluminantEnum::F11};
+	auto fine = colorpp::get_spectral_format(380., 5., 81);
+	std::vector<double> fine_spd(fine.Count);
+	for (auto illuminant : measured)
+	{
+		ASSERT_TRUE(colorpp::get_illuminant_spectrum(illuminant, fine, fine_spd.data()));
+		EXPECT_NEAR(fine_spd[36], 100., 1e-9);
+		ASSERT_TRUE(colorpp::get_spectral_weights(fine_spd.data(), fine, weights));
+		colorpp::get_ref_white(illuminant, white);
+		for (int j = 0; j < 3; ++j)
+			EXPECT_NEAR(weights.White[j], white[j], 1e-2) << static_cast<int>(illuminant);
+		ASSERT_TRUE(colorpp::get_spectral_weights(illuminant, format, weights));
+	}
+
+	// a neutral reflector is neutral in RGB of the same white
+	auto params = colorpp::get_rgb_params(colorpp::RgbEnum::sRGB, colorpp::AdaptationEnum::amBradford,
+		colorpp::IlluminantEnum::D65);
+	ASSERT_TRUE(colorpp::get_spectral_weights(colorpp::IlluminantEnum::D65, format, weights));
+	std::vector<double> grey(format.Count, 0.18);
+	colorpp::XYZ xyz;
+	colorpp::spectrum_to_xyz(grey.data(), xyz, weights);
+	EXPECT_NEAR(xyz[1], 0.18, 1e-6);
+	double r, g, b;
+	colorpp::xyz_to_rgb(xyz[0], xyz[1], xyz[2], r, g, b, params);
+	EXPECT_NEAR(r, g, 1e-5);
+	EXPECT_NEAR(b, g, 1e-5);
+
+	// batch against the scalar integration, with and without a partial lane block
+	for (size_t samples : {size_t(41), size_t(81), size_t(16)})
+	{
+		format = colorpp::get_spectral_format(380., 400. / (samples - 1), samples);
+		ASSERT_TRUE(colorpp::get_spectral_weights(colorpp::IlluminantEnum::A, format, weights));
+		const size_t count = 3000;
+		auto src = make_test_pixels(count, 1000, samples);
+		std::vector<float> dst(3 * count);
+		colorpp::spectrum_to_xyz(src.data(), dst.data(), count, weights);
+		for (size_t k = 0; k < count; k += 97)
+		{
+			std::vector<double> spectrum(src.begin() + k * samples, src.begin() + (k + 1) * samples);
+			colorpp::spectrum_to_xyz(spectrum.data(), xyz, weights);
+			for (int j = 0; j < 3; ++j)
+				ASSERT_NEAR(dst[3 * k + j], xyz[j], 1e-5) << samples << " " << k;
+		}
+	}
+}
+
+TEST(get_palette, colorpp_batch_test)
+{
+	// four colors in different proportions, with a little noise
+	const unsigned char colors[4][3] = {{200, 30, 40}, {20, 180, 60}, {30, 40, 220}, {240, 240, 230}};
+	const size_t populations[4] = {40000, 30000, 20000, 10000};
+	std::vector<unsigned char> src;
+	for (int c = 0; c < 4; ++c)
+		for (size_t i = 0; i < populations[c]; ++i)
+			for (int j = 0; j < 3; ++j)
+				src.push_back(static_cast<unsigned char>(colors[c][j] + (i * 7 + j * 3) % 5 - 2));
+	const size_t count = src.size() / 3;
+
+	// k-means finds the clusters
+	auto palette = colorpp::get_palette(src.data(), count, colorpp::get_palette_params(colorpp::PaletteEnum::KMeans, 4));
+	ASSERT_EQ(palette.size(), 4u);
+	for (int c = 0; c < 4; ++c)
+	{
+		EXPECT_EQ(palette[c].Population, populations[c]) << c;
+		EXPECT_NEAR(palette[c].Rgb.get_red(), colors[c][0], 2) << c;
+		EXPECT_NEAR(palette[c].Rgb.get_green(), colors[c][1], 2) << c;
+		EXPECT_NEAR(palette[c].Rgb.get_blue(), colors[c][2], 2) << c;
+		auto hsv = colorpp::hsv360_100(palette[c].Rgb);
+		EXPECT_EQ(palette[c].Hsv.get_hue(), hsv.get_hue());
+	}
+	// median cut splits populations in halves, every cluster gets a box of its own with 8 colors
+	palette = colorpp::get_palette(src.data(), count, colorpp::get_palette_params(colorpp::PaletteEnum::MedianCut, 8));
+	ASSERT_EQ(palette.size(), 8u);
+	for (int c = 0; c < 4; ++c)
+	{
+		bool found = false;
+		for (auto& color : palette)
+			found |= std::abs(color.Rgb.get_red() - colors[c][0]) <= 3 && std::abs(color.Rgb.get_green() - colors[c][1]) <= 3 &&
+				std::abs(color.Rgb.get_blue() - colors[c][2]) <= 3;
+		EXPECT_TRUE(found) << c;
+	}
+
+	for (auto method : {colorpp::PaletteEnum::MedianCut, colorpp::PaletteEnum::KMeans})
+	{
+		// more colors split the clusters, the populations still add up
+		auto params = colorpp::get_palette_params(method, 16);
+		palette = colorpp::get_palette(src.data(), count, params);
+		EXPECT_LE(palette.size(), 16u);
+		EXPECT_GT(palette.size(), 4u);
+		size_t total = 0;
+		for (auto& color : palette)
+			total += color.Population;
+		EXPECT_EQ(total, count);
+		auto again = colorpp::get_palette(src.data(), count, params);
+		ASSERT_EQ(again.size(), palette.size());
+		for (size_t i = 0; i < again.size(); ++i)
+		{
+			EXPECT_EQ(again[i].Rgb.get_red(), palette[i].Rgb.get_red());
+			EXPECT_EQ(again[i].Rgb.get_green(), palette[i].Rgb.get_green());
+			EXPECT_EQ(again[i].Rgb.get_blue(), palette[i].Rgb.get_blue());
+			EXPECT_EQ(again[i].Population, palette[i].Population);
+		}
+	}
+
+	// a single color
+	std::vector<unsigned char> flat(300, 77);
+	palette = colorpp::get_palette(flat.data(), 100);
+	ASSERT_EQ(palette.size(), 1u);
+	EXPECT_EQ(palette[0].Rgb.get_red(), 77);
+	EXPECT_EQ(palette[0].Population, 100u);
+}
+
+TEST(get_channel_histograms, colorpp_batch_test)
+{
+	const size_t count = 200000;
+	auto src = make_test_codes(count);
+
+	// 361 hue and 101 saturation/value bins are the hsv360_100 values
+	std::vector<uint64_t> hue(3 * 361);
+	std::vector<uint64_t> hist(3 * 101);
+	colorpp::get_channel_histograms(src.data(), count, hue.data(), 361, colorpp::HistogramEnum::Hsv);
+	colorpp::get_channel_histograms(src.data(), count, hist.data(), 101, colorpp::HistogramEnum::Hsv);
+	std::vector<uint64_t> expected(361 + 2 * 101, 0);
+	for (size_t i = 0; i < count; ++i)
+	{
+		colorpp::hsv360_100 hsv(colorpp::rgb256(src[3 * i], src[3 * i + 1], src[3 * i + 2]));
+		++expected[hsv.get_hue()];
+		++expected[361 + hsv.get_saturation()];
+		++expected[361 + 101 + hsv.get_value()];
+	}
+	EXPECT_TRUE(std::equal(hue.begin(), hue.begin() + 361, expected.begin()));
+	EXPECT_TRUE(std::equal(hist.begin() + 101, hist.end(), expected.begin() + 361));
+
+	// 3D RGB bins are the high bits of the codes
+	hist.assign(1 << 12, 0);
+	colorpp::get_histogram_3d(src.data(), count, hist.data(), 4, colorpp::HistogramEnum::Rgb);
+	expected.assign(1 << 12, 0);
+	for (size_t i = 0; i < count; ++i)
+		++expected[((src[3 * i] >> 4) << 8) | ((src[3 * i + 1] >> 4) << 4) | (src[3 * i + 2] >> 4)];
+	EXPECT_TRUE(hist == expected);
+
+	// white and black are on the L* ends, neutral a*b* at the middle
+	std::vector<unsigned char> grey = {255, 255, 255, 0, 0, 0, 255, 255, 255};
+	hist.assign(1 << 9, 0);
+	colorpp::get_histogram_3d(grey.data(), 3, hist.data(), 3, colorpp::HistogramEnum::Lab);
+	uint64_t white = 0;
+	uint64_t black = 0;
+	for (int a = 3; a <= 4; ++a)
+		for (int b = 3; b <= 4; ++b)
+		{
+			white += hist[(7 << 6) | (a << 3) | b];
+			black += hist[(0 << 6) | (a << 3) | b];
+		}
+	EXPECT_EQ(white, 2u);
+	EXPECT_EQ(black, 1u);
+}
+
+TEST(get_color_stats, colorpp_batch_test)
+{
+	// half black, half white: the mean is the linear middle, not the code 128
+	std::vector<unsigned char> src;
+	for (int i = 0; i < 1000; ++i)
+		for (int c = 0; c < 3; ++c)
+			src.push_back(i % 2 ? 255 : 0);
+	auto params = colorpp::get_rgb_params(colorpp::RgbEnum::sRGB);
+	auto stats = colorpp::get_color_stats(src.data(), 1000, colorpp::HueMeanEnum::Circular, params);
+	for (int c = 0; c < 3; ++c)
+	{
+		EXPECT_NEAR(stats.LinearMean[c], 0.5, 1e-6);
+		EXPECT_NEAR(stats.LinearStdDev[c], 0.5, 1e-6);
+		EXPECT_NEAR(stats.Mean[c], colorpp::compand(0.5, colorpp::TransferEnum::sRGB), 1e-6);
+	}
+	EXPECT_NEAR(stats.Luminance, 0.5, 1e-6);
+	EXPECT_EQ(stats.Chromatic, 0u);
+
+	// reds on both sides of 0 degrees
+	src.clear();
+	for (int i = 0; i < 1000; ++i)
+	{
+		colorpp::rgb256 rgb(colorpp::hsv360_100(i % 2 ? 350 : 10, 100, 100));
+		src.push_back(rgb.get_red());
+		src.push_back(rgb.get_green());
+		src.push_back(rgb.get_blue());
+	}
+	stats = colorpp::get_color_stats(src.data(), 1000, colorpp::HueMeanEnum::Circular, params);
+	EXPECT_EQ(stats.Chromatic, 1000u);
+	EXPECT_NEAR(std::min(stats.Hue, 1. - stats.Hue), 0., 2e-3);
+	EXPECT_LT(stats.HueSpread, 0.02);
+	EXPECT_GT(stats.Saturation, 0.98);
+	stats = colorpp::get_color_stats(src.data(), 1000, colorpp::HueMeanEnum::Arithmetic, params);
+	EXPECT_NEAR(stats.Hue, 0.5, 2e-3);
+	EXPECT_GT(stats.HueSpread, 0.4);
+}
+
+TEST(hsv_to_hsl, colorpp_proc_test)
+{
+	// same as the conversions through RGB
+	for (int i = 0; i <= 20; ++i)
+		for (int j = 0; j <= 20; ++j)
+			for (int k = 0; k <= 20; ++k)
+			{
+				double h = i / 21., s = j / 20., v = k / 20.;
+				double r, g, b, rh, rs, rl, dh, ds, dl;
+				colorpp::hsv_to_rgb(h, s, v, r, g, b);
+				colorpp::rgb_to_hsl(r, g, b, rh, rs, rl);
+				colorpp::hsv_to_hsl(h, s, v, dh, ds, dl);
+				ASSERT_NEAR(dl, rl, 1e-12) << h << " " << s << " " << v;
+				ASSERT_NEAR(ds, rs, 1e-12) << h << " " << s << " " << v;
+				if (s > 0. && v > 0.)
+				{
+					ASSERT_NEAR(dh, rh, 1e-12);
+				}
+				double bh, bs, bv;
+				colorpp::hsl_to_hsv(dh, ds, dl, bh, bs, bv);
+				ASSERT_NEAR(bv, v, 1e-12);
+				if (v > 0.)
+				{
+					ASSERT_NEAR(bs, s, 1e-12);
+				}
+				EXPECT_EQ(bh, h);
+			}
+
+	// batch kernels, grays, black and white first
+	const size_t count = 40000;
+	auto hsv = make_test_pixels(count, 1000);
+	const float edges[] = {0.3f, 0.f, 0.5f, 0.6f, 0.f, 1.f, 0.9f, 0.7f, 0.f, 0.1f, 1.f, 1.f, 0.f, 0.f, 0.f};
+	std::copy(std::begin(edges), std::end(edges), hsv.begin());
+	std::vector<float> hsl(3 * count);
+	colorpp::hsv_to_hsl(hsv.data(), hsl.data(), count);
+	std::vector<float> back(3 * count);
+	colorpp::hsl_to_hsv(hsl.data(), back.data(), count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		double h, s, l;
+		colorpp::hsv_to_hsl(hsv[3 * i], hsv[3 * i + 1], hsv[3 * i + 2], h, s, l);
+		ASSERT_EQ(hsl[3 * i], hsv[3 * i]);
+		ASSERT_NEAR(hsl[3 * i + 1], s, 1e-5) << i;
+		ASSERT_NEAR(hsl[3 * i + 2], l, 1e-6) << i;
+		ASSERT_NEAR(back[3 * i + 2], hsv[3 * i + 2], 1e-6) << i;
+		if (hsv[3 * i + 2] > 0.01f)
+		{
+			ASSERT_NEAR(back[3 * i + 1], hsv[3 * i + 1], 1e-4) << i;
+		}
+	}
+
+	// the direct constructors keep the hue and lose less without the 8-bit RGB
+	int direct_error = 0;
+	int rgb_error = 0;
+	for (unsigned short h = 0; h <= 360; h += 5)
+		for (unsigned char s = 1; s <= 100; s += 3)
+			for (unsigned char v = 1; v <= 100; v += 3)
+			{
+				colorpp::hsv360_100 src(h, s, v);
+				colorpp::hsl360_100 direct(src);
+				EXPECT_EQ(direct.get_hue(), h);
+				colorpp::hsv360_100 direct_back(direct);
+				colorpp::hsl360_100 via_rgb{colorpp::rgb256(src)};
+				colorpp::hsv360_100 rgb_back{colorpp::rgb256(via_rgb)};
+				direct_error += std::abs(direct_back.get_saturation() - s) + std::abs(direct_back.get_value() - v);
+				rgb_error += std::abs(rgb_back.get_saturation() - s) + std::abs(rgb_back.get_value() - v);
+			}
+	EXPECT_LT(direct_error, rgb_error);
+}
+
+TEST(rgb_to_oklab, colorpp_batch_test)
+{
+	// reference values of the CSS Color 4 sample code, a and b stored as 0.5 + a / 0.8
+	double l, a, b;
+	colorpp::rgb_to_oklab(1., 1., 1., l, a, b);
+	EXPECT_NEAR(l, 1., 1e-6);
+	EXPECT_NEAR(a, 0.5, 1e-6);
+	EXPECT_NEAR(b, 0.5, 1e-6);
+	colorpp::rgb_to_oklab(1., 0., 0., l, a, b);
+	EXPECT_NEAR(l, 0.627955, 1e-5);
+	EXPECT_NEAR((a - 0.5) * 0.8, 0.224863, 1e-5);
+	EXPECT_NEAR((b - 0.5) * 0.8, 0.125846, 1e-5);
+	double lc, c, h;
+	colorpp::oklab_to_oklch(l, a, b, lc, c, h);
+	EXPECT_NEAR(c * 0.4, 0.257683, 1e-5);
+	EXPECT_NEAR(h * 360., 29.2339, 1e-3);
+	double la, aa, ba;
+	colorpp::oklch_to_oklab(lc, c, h, la, aa, ba);
+	EXPECT_NEAR(aa, a, 1e-12);
+	EXPECT_NEAR(ba, b, 1e-12);
+	double r, g, bl;
+	colorpp::oklab_to_rgb(l, a, b, r, g, bl);
+	EXPECT_NEAR(r, 1., 1e-6);
+	EXPECT_NEAR(g, 0., 1e-6);
+	EXPECT_NEAR(bl, 0., 1e-6);
+
+	// batch kernels against the scalar functions, grays first
+	const size_t count = 40000;
+	auto codes = make_test_codes(count);
+	const unsigned char grays[] = {0, 0, 0, 128, 128, 128, 255, 255, 255};
+	std::copy(std::begin(grays), std::end(grays), codes.begin());
+	std::vector<float> src(codes.begin(), codes.end());
+	for (auto& v : src)
+		v /= 255.f;
+	std::vector<float> lab(3 * count);
+	colorpp::rgb_to_oklab(src.data(), lab.data(), count);
+	std::vector<float> fused(3 * count);
+	colorpp::rgb_to_oklab(codes.data(), fused.data(), count);
+	std::vector<float> lch(3 * count);
+	colorpp::oklab_to_oklch(lab.data(), lch.data(), count);
+	std::vector<float> back(3 * count);
+	colorpp::oklch_to_oklab(lch.data(), back.data(), count);
+	colorpp::oklab_to_rgb(back.data(), back.data(), count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		colorpp::rgb_to_oklab(codes[3 * i] / 255., codes[3 * i + 1] / 255., codes[3 * i + 2] / 255., l, a, b);
+		ASSERT_NEAR(lab[3 * i], l, 1e-5) << i;
+		ASSERT_NEAR(lab[3 * i + 1], a, 1e-5) << i;
+		ASSERT_NEAR(lab[3 * i + 2], b, 1e-5) << i;
+		ASSERT_NEAR(fused[3 * i], l, 1e-5) << i;
+		ASSERT_NEAR(fused[3 * i + 1], a, 1e-5) << i;
+		ASSERT_NEAR(fused[3 * i + 2], b, 1e-5) << i;
+		colorpp::oklab_to_oklch(l, a, b, lc, c, h);
+		ASSERT_NEAR(lch[3 * i + 1], c, 1e-5) << i;
+		if (c > 1e-3)
+		{
+			ASSERT_NEAR(std::remainder(lch[3 * i + 2] - h, 1.), 0., 1e-4) << i;
+		}
+		for (int j = 0; j < 3; ++j)
+			ASSERT_NEAR(back[3 * i + j], src[3 * i + j], 1e-4) << i;
+	}
+	for (size_t i = 0; i < 3; ++i)
+	{
+		EXPECT_NEAR(lab[3 * i + 1], 0.5f, 1e-6) << i;
+		EXPECT_NEAR(lab[3 * i + 2], 0.5f, 1e-6) << i;
+		EXPECT_NEAR(lch[3 * i + 1], 0.f, 1e-5) << i;
+	}
+
+	// out of gamut colors are clamped by the batch conversion only
+	const float outside[] = {0.9f, 0.9f, 0.5f, 0.2f, 0.5f, 0.1f};
+	std::vector<float> clamped(6);
+	colorpp::oklab_to_rgb(outside, clamped.data(), 2);
+	for (size_t i = 0; i < 2; ++i)
+	{
+		colorpp::oklab_to_rgb(outside[3 * i], outside[3 * i + 1], outside[3 * i + 2], r, g, bl);
+		EXPECT_TRUE(r < 0. || r > 1. || g < 0. || g > 1. || bl < 0. || bl > 1.) << i;
+		EXPECT_NEAR(clamped[3 * i], std::min(std::max(r, 0.), 1.), 1e-5) << i;
+		EXPECT_NEAR(clamped[3 * i + 1], std::min(std::max(g, 0.), 1.), 1e-5) << i;
+		EXPECT_NEAR(clamped[3 * i + 2], std::min(std::max(bl, 0.), 1.), 1e-5) << i;
+	}
+
+	// color types
+	colorpp::oklch orange{colorpp::rgb256(255, 128, 0)};
+	colorpp::rgb256 rgb(orange);
+	EXPECT_NEAR(rgb.get_red(), 255, 1);
+	EXPECT_NEAR(rgb.get_green(), 128, 1);
+	EXPECT_NEAR(rgb.get_blue(), 0, 1);
+	colorpp::oklch100_360 orange100{colorpp::rgb256(255, 128, 0)};
+	rgb = orange100;
+	colorpp::oklab256 lab256{colorpp::rgb256(128, 128, 128)};
+	EXPECT_EQ(lab256.get_a(), 128);
+	EXPECT_EQ(lab256.get_b(), 128);
+	colorpp::rgb256 converted = colorpp::convert<colorpp::rgb256>(orange100);
+	EXPECT_EQ(converted.get_red(), rgb.get_red());
+	EXPECT_EQ(converted.get_green(), rgb.get_green());
+	EXPECT_EQ(converted.get_blue(), rgb.get_blue());
+}
+
+TEST(rgb_to_hwb, colorpp_batch_test)
+{
+	// CSS Color 4: hwb(h w b) is the HSV color with s = 1 - w / v, v = 1 - b
+	double h, w, b;
+	colorpp::rgb_to_hwb(1., 0.5, 0., h, w, b);
+	EXPECT_NEAR(h * 360., 30., 1e-9);
+	EXPECT_EQ(w, 0.);
+	EXPECT_EQ(b, 0.);
+	double r, g, bl;
+	colorpp::hwb_to_rgb(0., 0.6, 0.6, r, g, bl);
+	EXPECT_NEAR(r, 0.5, 1e-12);
+	EXPECT_NEAR(g, 0.5, 1e-12);
+	EXPECT_NEAR(bl, 0.5, 1e-12);
+
+	// batch kernels against the scalar functions, grays first
+	const size_t count = 40000;
+	auto src = make_test_pixels(count, 256);
+	const float grays[] = {0.f, 0.f, 0.f, 0.5f, 0.5f, 0.5f, 1.f, 1.f, 1.f};
+	std::copy(std::begin(grays), std::end(grays), src.begin());
+	std::vector<float> hwb(3 * count);
+	colorpp::rgb_to_hwb(src.data(), hwb.data(), count);
+	std::vector<float> back(3 * count);
+	colorpp::hwb_to_rgb(hwb.data(), back.data(), count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		colorpp::rgb_to_hwb(src[3 * i], src[3 * i + 1], src[3 * i + 2], h, w, b);
+		if (w + b < 1.)
+		{
+			ASSERT_NEAR(hwb[3 * i], h, 1e-6) << i;
+		}
+		ASSERT_EQ(hwb[3 * i + 1], static_cast<float>(w)) << i;
+		ASSERT_NEAR(hwb[3 * i + 2], b, 1e-7) << i;
+		for (int j = 0; j < 3; ++j)
+			ASSERT_NEAR(back[3 * i + j], src[3 * i + j], 1e-5) << i;
+	}
+
+	// whiteness and blackness above 1 in sum are scaled down to the gray w / (w + b)
+	const float over[] = {0.2f, 0.7f, 0.6f, 0.8f, 1.f, 1.f, 0.5f, 0.9f, 0.3f};
+	std::vector<float> scaled(9);
+	colorpp::hwb_to_rgb(over, scaled.data(), 3);
+	for (size_t i = 0; i < 3; ++i)
+	{
+		colorpp::hwb_to_rgb(over[3 * i], over[3 * i + 1], over[3 * i + 2], r, g, bl);
+		auto expected = over[3 * i + 1] / (over[3 * i + 1] + over[3 * i + 2]);
+		EXPECT_NEAR(r, expected, 1e-6) << i;
+		for (int j = 0; j < 3; ++j)
+			EXPECT_NEAR(scaled[3 * i + j], expected, 1e-6) << i;
+	}
+
+	// color types: the direct HSV conversion keeps the hue
+	colorpp::hwb360_100 orange{colorpp::rgb256(255, 128, 0)};
+	EXPECT_EQ(orange.get_whiteness(), 0);
+	EXPECT_EQ(orange.get_blackness(), 0);
+	colorpp::hsv360_100 hsv(123, 40, 80);
+	colorpp::hwb360_100 direct(hsv);
+	EXPECT_EQ(direct.get_hue(), 123);
+	EXPECT_EQ(colorpp::hsv360_100(direct).get_hue(), 123);
+	EXPECT_EQ(colorpp::convert<colorpp::hwb360_100>(hsv).get_hue(), 123);
+	colorpp::rgb256 gray(colorpp::hwb360_100(200, 70, 70));
+	EXPECT_EQ(gray.get_red(), 128);
+	EXPECT_EQ(gray.get_green(), 128);
+	EXPECT_EQ(gray.get_blue(), 128);
+}
+
+TEST(rgb_to_hsi, colorpp_batch_test)
+{
+	// primaries are 0, 120 and 240 degrees, with saturation 1 and intensity 1/3
+	const double primaries[3][3] = {{1., 0., 0.}, {0., 1., 0.}, {0., 0., 1.}};
+	for (int k = 0; k < 3; ++k)
+	{
+		double h, s, i;
+		colorpp::rgb_to_hsi(primaries[k][0], primaries[k][1], primaries[k][2], h, s, i);
+		EXPECT_NEAR(h, k / 3., 1e-12);
+		EXPECT_NEAR(s, 1., 1e-12);
+		EXPECT_NEAR(i, 1. / 3., 1e-12);
+	}
+	// Gonzalez & Woods arc cosine formula
+	double r = 0.7, g = 0.2, b = 0.4;
+	double theta = std::acos(0.5 * ((r - g) + (r - b)) / std::sqrt((r - g) * (r - g) + (r - b) * (g - b)));
+	double h, s, i;
+	colorpp::rgb_to_hsi(r, g, b, h, s, i);
+	EXPECT_NEAR(h * 2. * 3.14159265358979323846, b > g ? 2. * 3.14159265358979323846 - theta : theta, 1e-12);
+	EXPECT_NEAR(s, 1. - 0.2 / i, 1e-12);
+	double rb, gb, bb;
+	colorpp::hsi_to_rgb(h, s, i, rb, gb, bb);
+	EXPECT_NEAR(rb, r, 1e-12);
+	EXPECT_NEAR(gb, g, 1e-12);
+	EXPECT_NEAR(bb, b, 1e-12);
+
+	// batch kernels against the scalar functions, grays first
+	const size_t count = 40000;
+	auto src = make_test_pixels(count, 256);
+	const float grays[] = {0.f, 0.f, 0.f, 0.5f, 0.5f, 0.5f, 1.f, 1.f, 1.f};
+	std::copy(std::begin(grays), std::end(grays), src.begin());
+	std::vector<float> hsi(3 * count);
+	colorpp::rgb_to_hsi(src.data(), hsi.data(), count);
+	std::vector<float> back(3 * count);
+	colorpp::hsi_to_rgb(hsi.data(), back.data(), count);
+	for (size_t k = 0; k < count; ++k)
+	{
+		colorpp::rgb_to_hsi(src[3 * k], src[3 * k + 1], src[3 * k + 2], h, s, i);
+		ASSERT_NEAR(std::remainder(hsi[3 * k] - h, 1.), 0., 1e-6) << k;
+		ASSERT_NEAR(hsi[3 * k + 1], s, 1e-6) << k;
+		ASSERT_NEAR(hsi[3 * k + 2], i, 1e-6) << k;
+		for (int j = 0; j < 3; ++j)
+			ASSERT_NEAR(back[3 * k + j], src[3 * k + j], 1e-5) << k;
+	}
+	for (size_t k = 0; k < 3; ++k)
+		EXPECT_EQ(hsi[3 * k + 1], 0.f) << k;
+
+	// out of gamut colors are clamped by the batch conversion only
+	const float outside[] = {0.f, 1.f, 0.8f, 0.5f, 0.9f, 0.8f};
+	std::vector<float> clamped(6);
+	colorpp::hsi_to_rgb(outside, clamped.data(), 2);
+	for (size_t k = 0; k < 2; ++k)
+	{
+		colorpp::hsi_to_rgb(outside[3 * k], outside[3 * k + 1], outside[3 * k + 2], rb, gb, bb);
+		EXPECT_TRUE(rb > 1. || gb > 1. || bb > 1.) << k;
+		EXPECT_NEAR(clamped[3 * k], std::min(std::max(rb, 0.), 1.), 1e-5) << k;
+		EXPECT_NEAR(clamped[3 * k + 1], std::min(std::max(gb, 0.), 1.), 1e-5) << k;
+		EXPECT_NEAR(clamped[3 * k + 2], std::min(std::max(bb, 0.), 1.), 1e-5) << k;
+	}
+
+	// color types
+	colorpp::hsi hsi_color{colorpp::rgb256(200, 50, 100)};
+	colorpp::rgb256 rgb(hsi_color);
+	EXPECT_NEAR(rgb.get_red(), 200, 1);
+	EXPECT_NEAR(rgb.get_green(), 50, 1);
+	EXPECT_NEAR(rgb.get_blue(), 100, 1);
+	colorpp::hsi360_100 gray{colorpp::rgb256(90, 90, 90)};
+	EXPECT_EQ(gray.get_hue(), 0);
+	EXPECT_EQ(gray.get_saturation(), 0);
+}
+
+TEST(rgb_to_cmyk, colorpp_batch_test)
+{
+	double c, m, y, k;
+	colorpp::rgb_to_cmyk(1., 0.5, 0., c, m, y, k);
+	EXPECT_EQ(c, 0.);
+	EXPECT_EQ(m, 0.5);
+	EXPECT_EQ(y, 1.);
+	EXPECT_EQ(k, 0.);
+	colorpp::rgb_to_cmyk(0., 0., 0., c, m, y, k);
+	EXPECT_EQ(c + m + y, 0.);
+	EXPECT_EQ(k, 1.);
+
+	// batch kernels against the scalar functions, black and white first
+	const size_t count = 40000;
+	auto src = make_test_pixels(count, 256);
+	const float edges[] = {0.f, 0.f, 0.f, 1.f, 1.f, 1.f};
+	std::copy(std::begin(edges), std::end(edges), src.begin());
+	std::vector<float> cmyk(4 * count);
+	colorpp::rgb_to_cmyk(src.data(), cmyk.data(), count);
+	std::vector<float> back(3 * count);
+	colorpp::cmyk_to_rgb(cmyk.data(), back.data(), count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		colorpp::rgb_to_cmyk(src[3 * i], src[3 * i + 1], src[3 * i + 2], c, m, y, k);
+		ASSERT_NEAR(cmyk[4 * i], c, 1e-6) << i;
+		ASSERT_NEAR(cmyk[4 * i + 1], m, 1e-6) << i;
+		ASSERT_NEAR(cmyk[4 * i + 2], y, 1e-6) << i;
+		ASSERT_NEAR(cmyk[4 * i + 3], k, 1e-6) << i;
+		for (int j = 0; j < 3; ++j)
+			ASSERT_NEAR(back[3 * i + j], src[3 * i + j], 1e-6) << i;
+	}
+	EXPECT_EQ(cmyk[0] + cmyk[1] + cmyk[2], 0.f);
+	EXPECT_EQ(cmyk[3], 1.f);
+	EXPECT_EQ(cmyk[7], 0.f);
+
+	// K = 1 is black whatever the inks
+	const float full[] = {0.3f, 0.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f};
+	std::vector<float> dark(6, 1.f);
+	colorpp::cmyk_to_rgb(full, dark.data(), 2);
+	for (auto v : dark)
+		EXPECT_EQ(v, 0.f);
+
+	// color types and the four channel conversion paths
+	colorpp::cmyk100 orange{colorpp::rgb256(255, 128, 0)};
+	EXPECT_EQ(orange.get_cyan(), 0);
+	EXPECT_EQ(orange.get_magenta(), 50);
+	EXPECT_EQ(orange.get_yellow(), 100);
+	EXPECT_EQ(orange.get_black(), 0);
+	colorpp::cmyk256 black{colorpp::rgb256(0, 0, 0)};
+	EXPECT_EQ(black.get_cyan(), 0);
+	EXPECT_EQ(black.get_black(), 255);
+	colorpp::cmyk100 via_hsv = colorpp::convert<colorpp::cmyk100>(colorpp::hsv(0., 1., 0.5));
+	EXPECT_EQ(via_hsv.get_magenta(), 100);
+	EXPECT_EQ(via_hsv.get_black(), 50);
+	colorpp::cmyk100 copy = colorpp::convert<colorpp::cmyk100>(orange);
+	EXPECT_EQ(copy.get_black(), orange.get_black());
+	EXPECT_EQ(copy.get_magenta(), orange.get_magenta());
+}
+
+#ifdef __linux__
+namespace
+{
+	// memfd of size bytes, optionally sealed against shrinking like conv_client buffers
+	int make_test_memfd(size_t size, bool seal)
+	{
+		int fd = ::memfd_create("test", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(size)) != 0)
+			return -1;
+		if (seal)
+			::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK);
+		return fd;
+	}
+
+	// sends a request with an optional descriptor over the socket and waits for the reply
+	ConvStatusEnum send_test_request(int socket, ConvRequest request, int fd)
+	{
+		iovec iov = {&request, sizeof(request)};
+		union
+		{
+			cmsghdr header;
+			char data[CMSG_SPACE(sizeof(int))];
+		} control;
+		std::memset(&control, 0, sizeof(control));
+		msghdr msg;
+		std::memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		if (fd >= 0)
+		{
+			msg.msg_control = control.data;
+			msg.msg_controllen = sizeof(control.data);
+			auto cmsg = CMSG_FIRSTHDR(&msg);
+			cmsg->cmsg_level = SOL_SOCKET;
+			cmsg->cmsg_type = SCM_RIGHTS;
+			cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+			std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+		}
+		if (::sendmsg(socket, &msg, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(request)))
+			return ConvStatusEnum::NoServer;
+		ConvReply reply;
+		if (::recv(socket, &reply, sizeof(reply), 0) != static_cast<ssize_t>(sizeof(reply)))
+			return ConvStatusEnum::NoServer;
+		return static_cast<ConvStatusEnum>(reply.Status);
+	}
+}
+
+TEST(conv_server, colorpp_proc_test)
+{
+	int sockets[2];
+	ASSERT_EQ(::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sockets), 0);
+	conv_server server;
+	server.add_client(sockets[0]);
+	std::atomic<bool> stop(false);
+	std::thread thread([&]() { server.run(stop); });
+
+	// 64 float pixels decoded from sRGB in a sealed buffer
+	const size_t count = 64;
+	const size_t size = 4096;
+	int sealed = make_test_memfd(size, true);
+	ASSERT_GE(sealed, 0);
+	auto buffer = static_cast<float*>(::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, sealed, 0));
+	ASSERT_NE(buffer, MAP_FAILED);
+	for (size_t i = 0; i < 3 * count; ++i)
+		buffer[i] = static_cast<float>(i) / (3 * count);
+	ConvRequest request;
+	std::memset(&request, 0, sizeof(request));
+	request.Magic = convserver_detail::Magic;
+	request.Version = convserver_detail::Version;
+	request.Src = {static_cast<uint32_t>(ConvSpaceEnum::Rgb), static_cast<uint32_t>(ConvFormatEnum::F32)};
+	request.Dst = {static_cast<uint32_t>(ConvSpaceEnum::LinearRgb), static_cast<uint32_t>(ConvFormatEnum::F32)};
+	request.Transfer = static_cast<uint32_t>(colorpp::TransferEnum::sRGB);
+	request.Count = count;
+	request.SrcOffset = 0;
+	request.DstOffset = 2048;
+	EXPECT_EQ(send_test_request(sockets[1], request, sealed), ConvStatusEnum::Ok);
+	EXPECT_NEAR(buffer[512 + 100], colorpp::inv_compand(100. / (3 * count), colorpp::TransferEnum::sRGB), 1e-6);
+	// in place
+	auto in_place = request;
+	in_place.DstOffset = 0;
+	EXPECT_EQ(send_test_request(sockets[1], in_place, sealed), ConvStatusEnum::Ok);
+
+	// bounds
+	auto bad = request;
+	bad.DstOffset = size - 4;
+	EXPECT_EQ(send_test_request(sockets[1], bad, sealed), ConvStatusEnum::BadBuffer);
+	bad = request;
+	bad.SrcOffset = size + 12;
+	EXPECT_EQ(send_test_request(sockets[1], bad, sealed), ConvStatusEnum::BadBuffer);
+	bad = request;
+	bad.Count = uint64_t(1) << 62;
+	EXPECT_EQ(send_test_request(sockets[1], bad, sealed), ConvStatusEnum::BadBuffer);
+	bad = request;
+	bad.DstOffset = 2;
+	EXPECT_EQ(send_test_request(sockets[1], bad, sealed), ConvStatusEnum::BadBuffer);
+	// overlapping regions that aren't the same
+	bad = request;
+	bad.DstOffset = 12;
+	EXPECT_EQ(send_test_request(sockets[1], bad, sealed), ConvStatusEnum::BadBuffer);
+
+	// descriptors: none, not sealed, not a memfd
+	EXPECT_EQ(send_test_request(sockets[1], request, -1), ConvStatusEnum::BadRequest);
+	int unsealed = make_test_memfd(size, false);
+	EXPECT_EQ(send_test_request(sockets[1], request, unsealed), ConvStatusEnum::BadBuffer);
+	int pipe_fds[2];
+	ASSERT_EQ(::pipe(pipe_fds), 0);
+	EXPECT_EQ(send_test_request(sockets[1], request, pipe_fds[0]), ConvStatusEnum::BadBuffer);
+	bad = request;
+	bad.Transfer = 100;
+	EXPECT_EQ(send_test_request(sockets[1], bad, sealed), ConvStatusEnum::Unsupported);
+	// gammas that would add transfer tables without bound or break the batch keys
+	bad = request;
+	bad.Transfer = static_cast<uint32_t>(colorpp::TransferEnum::Gamma);
+	bad.Gamma = 2.2;
+	EXPECT_EQ(send_test_request(sockets[1], bad, sealed), ConvStatusEnum::Ok);
+	for (double gamma : {0., -2.2, 1e6, std::numeric_limits<double>::quiet_NaN(),
+		std::numeric_limits<double>::infinity()})
+	{
+		bad.Gamma = gamma;
+		EXPECT_EQ(send_test_request(sockets[1], bad, sealed), ConvStatusEnum::BadRequest) << gamma;
+	}
+	bad = request;
+	bad.Gamma = std::numeric_limits<double>::quiet_NaN();
+	EXPECT_EQ(send_test_request(sockets[1], bad, sealed), ConvStatusEnum::BadRequest);
+	// still serving
+	EXPECT_EQ(send_test_request(sockets[1], request, sealed), ConvStatusEnum::Ok);
+
+	stop = true;
+	thread.join();
+	EXPECT_EQ(server.get_request_count(), 19u);
+	::munmap(buffer, size);
+	::close(sealed);
+	::close(unsealed);
+	::close(pipe_fds[0]);
+	::close(pipe_fds[1]);
+	::close(sockets[1]);
+
+	// the daemon never replaces a file that isn't a socket
+	char path[] = "/tmp/colorpp_serverXXXXXX";
+	int file = ::mkstemp(path);
+	ASSERT_GE(file, 0);
+	::close(file);
+	EXPECT_FALSE(server.open(path));
+	struct stat st;
+	EXPECT_EQ(::lstat(path, &st), 0);
+	::unlink(path);
+	EXPECT_TRUE(server.open(path));
+	server.close();
+}
+#endif